@@ -37,6 +37,7 @@ set(SDKLIB_HEADERS
     include/mega/nodemanager.h
     include/mega/setandelement.h
     include/mega/testhooks.h
+    include/mega/timerqueue.h
     include/mega/share.h
     include/mega/gfx/GfxProcCG.h
     include/mega/gfx/freeimage.h
@@ -68,7 +69,11 @@ set(SDKLIB_HEADERS
     include/mega/utils_optional.h
     include/mega/account.h
     include/mega/transfer.h
+    include/mega/transfercontroller.h
+    include/mega/transferscheduler.h
     include/mega/transferstats.h
+    include/mega/openmetrics.h
+    include/mega/trace.h
     include/mega/totp.h
     include/mega/treeproc.h
     include/mega/arguments.h
@@ -78,6 +83,7 @@ set(SDKLIB_HEADERS
     include/mega/fileattributefetch.h
     include/mega/version.h
     include/mega/node.h
+    include/mega/noderecord.h
     include/mega/mediafileattribute.h
     include/mega/process.h
     include/mega/name_collision.h
@@ -131,6 +137,7 @@ set(SDKLIB_SOURCES
     src/mediafileattribute.cpp
     src/megaclient.cpp
     src/node.cpp
+    src/noderecord.cpp
     src/pendingcontactrequest.cpp
     src/textchat.cpp
     src/proxy.cpp
@@ -151,9 +158,14 @@ set(SDKLIB_SOURCES
     src/syncinternals/syncuploadthrottlingmanager.cpp
     src/heartbeats.cpp
     src/testhooks.cpp
+    src/timerqueue.cpp
     src/transfer.cpp
     src/transferslot.cpp
+    src/transfercontroller.cpp
+    src/transferscheduler.cpp
     src/transferstats.cpp
+    src/openmetrics.cpp
+    src/trace.cpp
     src/treeproc.cpp
     src/totp.cpp
     src/user.cpp
@@ -214,8 +226,10 @@ target_sources_conditional(SDKlib
     PRIVATE
     include/mega/win32/gfx/worker/comms.h
     include/mega/win32/gfx/worker/comms_client.h
+    include/mega/win32/gfx/worker/shared_memory.h
     src/win32/gfx/worker/comms.cpp
     src/win32/gfx/worker/comms_client.cpp
+    src/win32/gfx/worker/shared_memory.cpp
 )
 
 target_sources_conditional(SDKlib
@@ -223,9 +237,11 @@ target_sources_conditional(SDKlib
     PRIVATE
     include/mega/posix/gfx/worker/comms.h
     include/mega/posix/gfx/worker/comms_client.h
+    include/mega/posix/gfx/worker/shared_memory.h
     include/mega/posix/gfx/worker/socket_utils.h
     src/posix/gfx/worker/comms.cpp
     src/posix/gfx/worker/comms_client.cpp
+    src/posix/gfx/worker/shared_memory.cpp
     src/posix/gfx/worker/socket_utils.cpp
 )
 
@@ -240,6 +256,7 @@ target_sources_conditional(SDKlib
     include/mega/gfx/worker/client.h
     include/mega/gfx/worker/comms_client_common.h
     include/mega/gfx/worker/comms_client.h
+    include/mega/gfx/worker/shared_memory.h
     src/gfx/isolatedprocess.cpp
     src/gfx/worker/client.cpp
     src/gfx/worker/commands.cpp
@@ -397,6 +414,11 @@ if((NOT (WIN32 OR APPLE OR ANDROID)) AND CMAKE_CXX_STANDARD LESS_EQUAL 17)
     target_link_libraries(SDKlib PRIVATE stdc++fs)
 endif()
 
+if((NOT (WIN32 OR APPLE OR ANDROID)) AND ENABLE_ISOLATED_GFX)
+    # Needed for shm_open before glibc 2.34. Harmless afterwards.
+    target_link_libraries(SDKlib PRIVATE rt)
+endif()
+
 if(ENABLE_DRIVE_NOTIFICATIONS)
     if(WIN32)
         target_link_libraries(SDKlib PRIVATE wbemuuid)
@@ -25,30 +25,224 @@
 #include "name_id.h"
 #include "utils.h"
 
+#include <algorithm>
+#include <initializer_list>
 #include <optional>
+#include <stdexcept>
 #include <string_view>
+#include <vector>
 
 namespace mega {
 
 // maps attribute names to attribute values
-struct attr_map : map<nameid, string>
+//
+// Nodes have a handful of attributes and millions of them may be in memory,
+// so the pairs are kept in a vector sorted by name: one allocation per map
+// rather than one per attribute, and no tree links. Lookups, iteration order
+// and the interface are those of the std::map this used to be.
+//
+// Unlike with std::map, inserting or erasing any attribute may move the
+// others: iterators, references, and pointers into values (such as the
+// c_str() behind Node::displayname()) are invalidated by any insert or erase,
+// not only of their own key. Copy values that must outlive such an update.
+class attr_map
 {
+public:
+    using key_type = nameid;
+    using mapped_type = string;
+    using value_type = std::pair<nameid, string>;
+    using size_type = size_t;
+    using iterator = std::vector<value_type>::iterator;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
     attr_map() {}
 
     attr_map(nameid key, string value)
     {
-        (*this)[key] = std::move(value);
+        mValues.emplace_back(key, std::move(value));
     }
 
     attr_map(map<nameid, string>&& m)
     {
-        m.swap(*this);
+        mValues.reserve(m.size());
+
+        for (auto& value: m)
+        {
+            mValues.emplace_back(value.first, std::move(value.second));
+        }
+    }
+
+    attr_map(std::initializer_list<value_type> values)
+    {
+        for (auto& value: values)
+        {
+            insert(value);
+        }
+    }
+
+    iterator begin()
+    {
+        return mValues.begin();
+    }
+
+    iterator end()
+    {
+        return mValues.end();
+    }
+
+    const_iterator begin() const
+    {
+        return mValues.begin();
+    }
+
+    const_iterator end() const
+    {
+        return mValues.end();
+    }
+
+    const_iterator cbegin() const
+    {
+        return mValues.cbegin();
+    }
+
+    const_iterator cend() const
+    {
+        return mValues.cend();
+    }
+
+    bool empty() const
+    {
+        return mValues.empty();
+    }
+
+    size_type size() const
+    {
+        return mValues.size();
+    }
+
+    void clear()
+    {
+        mValues.clear();
+    }
+
+    iterator find(nameid k)
+    {
+        auto it = lowerBound(k);
+        return it != end() && it->first == k ? it : end();
+    }
+
+    const_iterator find(nameid k) const
+    {
+        return const_cast<attr_map*>(this)->find(k);
     }
 
     bool contains(nameid k) const
     {
-        return this->find(k) != this->end();
+        return find(k) != end();
+    }
+
+    size_type count(nameid k) const
+    {
+        return contains(k);
+    }
+
+    string& at(nameid k)
+    {
+        auto it = find(k);
+
+        if (it == end())
+        {
+            throw std::out_of_range("attr_map::at");
+        }
+
+        return it->second;
+    }
+
+    const string& at(nameid k) const
+    {
+        return const_cast<attr_map*>(this)->at(k);
+    }
+
+    string& operator[](nameid k)
+    {
+        return emplace(k, string()).first->second;
+    }
+
+    template<typename V>
+    std::pair<iterator, bool> emplace(nameid k, V&& value)
+    {
+        auto it = lowerBound(k);
+
+        if (it != end() && it->first == k)
+        {
+            return {it, false};
+        }
+
+        return {mValues.emplace(it, k, std::forward<V>(value)), true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return emplace(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        return emplace(value.first, std::move(value.second));
+    }
+
+    iterator erase(const_iterator it)
+    {
+        return mValues.erase(it);
+    }
+
+    size_type erase(nameid k)
+    {
+        auto it = find(k);
+
+        if (it == end())
+        {
+            return 0;
+        }
+
+        mValues.erase(it);
+        return 1;
+    }
+
+    void swap(attr_map& other)
+    {
+        mValues.swap(other.mValues);
     }
+
+    // release the spare capacity left by inserting one by one
+    void shrink_to_fit()
+    {
+        mValues.shrink_to_fit();
+    }
+
+    bool operator==(const attr_map& other) const
+    {
+        return mValues == other.mValues;
+    }
+
+    bool operator!=(const attr_map& other) const
+    {
+        return mValues != other.mValues;
+    }
+
+private:
+    iterator lowerBound(nameid k)
+    {
+        return std::lower_bound(mValues.begin(),
+                                mValues.end(),
+                                k,
+                                [](const value_type& value, nameid key)
+                                {
+                                    return value.first < key;
+                                });
+    }
+
+    std::vector<value_type> mValues;
 };
 
 struct MEGA_API AttrMap
@@ -39,6 +39,9 @@ public:
     static string atob(const string&);
     static int atob(const char*, byte*, int);   // deprecated
 
+    // decode at most alen characters, stopping at the first one that isn't valid
+    static int atob(const char* a, size_t alen, byte* b, int blen);
+
     static void itoa(int64_t, string *);
     static int64_t atoi(string *);
 
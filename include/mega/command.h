@@ -741,7 +741,11 @@ private:
     NodeHandle targethandle;
     Completion mResultFunction;
 
+    // tags of the other uploads sent along with the one in tag
+    vector<int> mBatchedTags;
+
     void removePendingDBRecordsAndTempFiles();
+    void removePendingDBRecordsAndTempFiles(int uploadTag);
     void performAppCallback(Error e,
                             vector<NewNode>&,
                             bool targetOverride = false,
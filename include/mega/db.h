@@ -41,6 +41,18 @@ public:
     std::string mNodeCounter;
 };
 
+// A file as recent actions see it, read from the DB without loading its node
+struct RecentFile
+{
+    NodeHandle nodeHandle;
+    NodeHandle parentHandle;
+    handle owner = UNDEF;
+    m_time_t ctime = 0;
+    uint64_t flags = 0;
+    bool media = false;   // a photo or a video, by its extension
+    bool updated = false; // has previous versions
+};
+
 enum class DBError
 {
     DB_ERROR_UNKNOWN = 0,
@@ -78,9 +90,9 @@ using DBErrorCallback = std::function<void(DBError)>;
 
 class MEGA_API DbTable
 {
+protected:
     PrnGen &rng;
 
-protected:
     bool mCheckAlwaysTransacted = false;
     DBTableTransactionCommitter* mTransactionCommitter = nullptr;
     DBErrorCallback mDBErrorCallBack;
@@ -98,6 +110,9 @@ public:
     virtual bool next(uint32_t*, string*) = 0;
     bool next(uint32_t*, string*, SymmCipher*);
 
+    // as above, leaving the record encrypted for the caller to decrypt
+    bool nextEncrypted(uint32_t*, string*);
+
     // get specific record by key
     virtual bool get(uint32_t, string*) = 0;
 
@@ -106,6 +121,13 @@ public:
     bool put(uint32_t, string*);
     bool put(uint32_t, Cacheable *, SymmCipher*);
 
+    // as above, in two steps: encode() serializes, pads and encrypts a record
+    // without touching the table (and can run on any thread, as no IV is
+    // generated), putEncoded() assigns the record's id and writes what encode()
+    // produced (nullptr if the record couldn't be serialized)
+    bool encode(const Cacheable&, SymmCipher&, string&) const;
+    bool putEncoded(uint32_t, Cacheable*, string*);
+
     // delete specific record
     virtual bool del(uint32_t) = 0;
 
@@ -193,9 +215,10 @@ public:
                                   const std::string& pattern)
         -> std::optional<std::set<std::string>> = 0;
 
-    virtual bool getRecentNodes(const NodeSearchPage& page,
+    // Files not older than since, excluding versions and the rubbish bin, newest first
+    virtual bool getRecentFiles(const NodeSearchPage& page,
                                 m_time_t since,
-                                std::vector<std::pair<NodeHandle, NodeSerialized>>& nodes) = 0;
+                                std::vector<RecentFile>& files) = 0;
     virtual bool getNodeByFingerprint(const std::string& fingerprint, mega::NodeSerialized& node, NodeHandle& handle) = 0;
     virtual bool
         getNodesByFingerprintNoMtime(const std::string& fingerprint,
@@ -229,6 +252,30 @@ public:
 
     virtual void dropSearchDBIndexes() = 0;
     virtual void dropLexicographicDBIndexes() = 0;
+
+    // A read-only view of the committed contents of the table, that can be queried from
+    // another thread while this one keeps writing, even within a transaction. The view must
+    // be released before the table is destroyed. Returns nullptr if none is available (e.g.
+    // every view is in use).
+    virtual std::shared_ptr<DBTableNodes> readOnlyView()
+    {
+        return nullptr;
+    }
+
+    // Increases with every change written to the table
+    virtual uint64_t changeCount() const
+    {
+        return 0;
+    }
+
+    // What changeCount() was when the last transaction was committed. Views only see
+    // the table as of then.
+    virtual uint64_t committedChangeCount() const
+    {
+        return 0;
+    }
+
+    virtual ~DBTableNodes() = default;
 };
 
 class MEGA_API DBTableTransactionCommitter
@@ -333,6 +380,7 @@ struct MEGA_API DbAccess
     static const int LAST_DB_VERSION_WITHOUT_NOD;
     static const int LAST_DB_VERSION_WITHOUT_SRW;
     static const int LAST_DB_VERSION_WITHOUT_VFINGERPRINT;
+    static const int LAST_DB_VERSION_WITHOUT_NODE_RECORD;
 
     DbAccess();
 
@@ -27,7 +27,10 @@
 
 #include "mega/db.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <filesystem>
+#include <mutex>
 #include <optional>
 #include <sqlite3.h>
 
@@ -50,6 +53,12 @@ protected:
     // whether an unmatched begin() has been issued
     bool inTransaction() const;
 
+    // changes written to the table
+    std::atomic<uint64_t> mChanges{0};
+
+    // changes written to the table, as of the last commit
+    std::atomic<uint64_t> mCommittedChanges{0};
+
 public:
     void rewind() override;
     bool next(uint32_t*, string*) override;
@@ -62,8 +71,16 @@ public:
     void abort() override;
     void remove() override;
 
+    // A copy of the time spent committing transactions, in all tables
+    static CodeCounter::ScopeStats commitTimeSnapshot(bool reset = false);
+
     SqliteDbTable(PrnGen &rng, sqlite3*, FileSystemAccess &fsAccess, const LocalPath &path, const bool checkAlwaysTransacted, DBErrorCallback dBErrorCallBack);
     ~SqliteDbTable() override;
+
+private:
+    // Tables commit on several threads, so commitTime is only accessed under commitTimeMutex
+    static std::mutex commitTimeMutex;
+    static CodeCounter::ScopeStats commitTime;
 };
 
 /**
@@ -122,11 +139,10 @@ public:
     bool getNodeByFingerprint(const std::string& fingerprint,
                               mega::NodeSerialized& node,
                               NodeHandle& handle) override;
-    // getRecentNodes() is for the deprecated method MegaClient::getRecentActions without
-    // excludeSensitives flag
-    bool getRecentNodes(const NodeSearchPage& page,
+    // Served from recentsindex alone, so neither node blobs nor counters are read
+    bool getRecentFiles(const NodeSearchPage& page,
                         m_time_t since,
-                        std::vector<std::pair<NodeHandle, NodeSerialized>>& nodes) override;
+                        std::vector<RecentFile>& files) override;
     bool getFavouritesHandles(NodeHandle node, uint32_t count, std::vector<mega::NodeHandle>& nodes) override;
     bool childNodeByNameType(NodeHandle parentHanlde, const std::string& name, nodetype_t nodeType, std::pair<NodeHandle, NodeSerialized>& node) override;
     bool getNodeSizeTypeAndFlags(NodeHandle node, m_off_t& size, nodetype_t& nodeType, uint64_t &oldFlags) override;
@@ -146,11 +162,26 @@ public:
     void dropSearchDBIndexes() override;
     void dropLexicographicDBIndexes() override;
 
+    // Read-only connections are only handed out in WAL mode, where they don't block writes
+    std::shared_ptr<DBTableNodes> readOnlyView() override;
+    uint64_t changeCount() const override;
+    uint64_t committedChangeCount() const override;
+
     void remove() override;
     SqliteAccountState(PrnGen &rng, sqlite3*, FileSystemAccess &fsAccess, const mega::LocalPath &path, const bool checkAlwaysTransacted, DBErrorCallback dBErrorCallBack);
     void finalise();
     virtual ~SqliteAccountState();
 
+    // Register the functions and collations used by the queries and virtual columns of
+    // table `nodes`
+    static bool registerNodeFunctions(sqlite3* db);
+
+    // Most read-only connections open at once
+    static const unsigned MAX_READERS;
+
+    // Bytes of the database mapped in memory by read-only connections
+    static const sqlite3_int64 READER_MMAP_SIZE;
+
     // Callback registered by some long-time running queries, so they can be canceled
     // If the progress callback returns non-zero, the operation is interrupted
     static int progressHandler(void *);
@@ -170,6 +201,14 @@ public:
     // Gets the node size from node counter (blob)
     static void getSizeFromNodeCounter(sqlite3_context* context, int argc, sqlite3_value** argv);
 
+    // Method called when query uses 'getOwnerFromNode'
+    // Gets the owner's user handle from the serialized node (blob)
+    static void getOwnerFromNode(sqlite3_context* context, int argc, sqlite3_value** argv);
+
+    // Method called when query uses 'ismedia'
+    // Returns 1 if the file extension is that of a photo or a video, as recent actions bucket them
+    static void userIsMedia(sqlite3_context* context, int argc, sqlite3_value** argv);
+
     /**
      * @brief This method is designed to apply all the filtering options in various methods that
      * perform a query to the database and use a NodeSearchFilter object.
@@ -209,7 +248,7 @@ private:
     sqlite3_stmt* mStmtChildNode = nullptr;
     sqlite3_stmt* mStmtIsAncestor = nullptr;
     sqlite3_stmt* mStmtNumChild = nullptr;
-    sqlite3_stmt* mStmtRecents = nullptr; // For getRecentNodes()
+    sqlite3_stmt* mStmtRecents = nullptr; // For getRecentFiles()
     sqlite3_stmt* mStmtFavourites = nullptr;
 
     // how many SQLite instructions will be executed between callbacks to the progress handler
@@ -218,6 +257,25 @@ private:
 
     // Helper method to drop index with the provided names
     void dropDBIndexes(const std::vector<std::string>& indicesToDelete);
+
+    // Read-only connections to the same database, shared with the views handed out so that
+    // they can be returned after this table is gone
+    struct Readers
+    {
+        std::mutex mMutex;
+        std::condition_variable mReturned;
+        std::vector<std::unique_ptr<SqliteAccountState>> mIdle;
+        std::set<sqlite3*> mLeased;
+        unsigned mOpen = 0;
+        bool mClosed = false;
+    };
+
+    std::shared_ptr<Readers> mReaders;
+
+    SqliteAccountState* openReader();
+
+    // Close idle connections, interrupt leased ones and wait until they are returned
+    void closeReaders();
 };
 
 class MEGA_API SqliteDbAccess : public DbAccess
@@ -348,6 +406,9 @@ private:
     bool stripExistingColumns(sqlite3* db, vector<NewColumn>& cols);
     bool addColumn(sqlite3* db, const string& name, const string& type);
     bool migrateDataToColumns(sqlite3* db, vector<NewColumn>&& cols);
+
+    // Rewrites nodes stored in the legacy format as NodeRecords, tracked by the DB's user_version
+    bool migrateNodesToRecords(sqlite3* db);
 };
 
 class OrderByClause
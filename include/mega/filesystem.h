@@ -499,6 +499,10 @@ struct MEGA_API FileAccess
         return fopen(path, OpenFlag::OPEN_RDONLY, fsl);
     }
 
+    // Hint that [offset, offset + length) will be read soon, so the OS can start fetching it.
+    // Only meaningful on an open file. Default implementation does nothing.
+    virtual void readAhead(m_off_t /*offset*/, m_off_t /*length*/) {}
+
     // check if a local path is a folder
     bool isfolder(const LocalPath& path);
 
@@ -917,6 +921,30 @@ int compareUtf(const string&, bool unescaping1, const LocalPath&, bool unescapin
 int compareUtf(const LocalPath&, bool unescaping1, const string&, bool unescaping2, bool caseInsensitive);
 int compareUtf(const LocalPath&, bool unescaping1, const LocalPath&, bool unescaping2, bool caseInsensitive);
 
+// A name prepared once for ordering by compareUtf, so that sorting many names
+// compares bytes rather than decoding (and case folding) both names every time.
+// The key holds the name's codepoints, upper cased if case insensitive, as UTF-8,
+// which orders as codepoints do. Names that compareUtf can't order by codepoint
+// alone (escapes to decode, invalid UTF-8) fall back to compareUtf.
+class MEGA_API UtfCollationKey
+{
+public:
+    UtfCollationKey(const string& name, bool unescaping, bool caseInsensitive);
+
+    int compare(const UtfCollationKey& other) const;
+
+    bool keyed() const { return mKeyed; }
+
+    const string& name() const { return *mName; }
+
+private:
+    const string* mName;
+    bool mUnescaping;
+    bool mCaseInsensitive;
+    bool mKeyed;
+    string mKey;
+};
+
 // Same as above except case insensitivity is determined by build platform.
 int platformCompareUtf(const string&, bool unescape1, const string&, bool unescape2);
 int platformCompareUtf(const string&, bool unescape1, const LocalPath&, bool unescape2);
@@ -105,6 +105,18 @@ public:
     virtual std::vector<std::string> generateImages(const LocalPath& localfilepath,
                                                     const std::vector<GfxDimension>& dimensions) = 0;
 
+    struct ImagesRequest
+    {
+        LocalPath localfilepath;
+        std::vector<GfxDimension> dimensions;
+    };
+
+    // It generates thumbnails for several files, returning the images of each request in
+    // the same order, as generateImages does. By default the files are processed one by
+    // one, providers able to process them concurrently should override it.
+    virtual std::vector<std::vector<std::string>>
+        generateImagesBatch(const std::vector<ImagesRequest>& requests);
+
     // list of supported extensions (NULL if no pre-filtering is needed)
     virtual const char* supportedformats() = 0;
 
@@ -174,6 +186,11 @@ class MEGA_API GfxProc
 
     std::vector<GfxDimension> getJobDimensions(GfxJob *job);
 
+    // maximum number of queued jobs handed to the provider at once
+    static const size_t MAX_BATCH_JOBS;
+
+    void processJobs(std::vector<GfxJob*>& jobs);
+
     // Caller should give dimensions from high resolution to low resolution
     std::vector<std::string> generateImages(const LocalPath& localfilepath, const std::vector<GfxDimension>& dimensions);
 
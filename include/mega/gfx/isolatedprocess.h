@@ -156,6 +156,10 @@ public:
     std::vector<std::string> generateImages(const LocalPath& localfilepath,
                                             const std::vector<GfxDimension>& dimensions) override;
 
+    // The worker processes the files of a batch concurrently
+    std::vector<std::vector<std::string>>
+        generateImagesBatch(const std::vector<ImagesRequest>& requests) override;
+
     const char* supportedformats() override;
 
     const char* supportedvideoformats() override;
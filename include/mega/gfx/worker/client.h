@@ -21,6 +21,7 @@
 #include "mega/gfx.h"
 #include "mega/gfx/worker/comms.h"
 #include "mega/gfx/worker/comms_client.h"
+#include "mega/gfx/worker/tasks.h"
 
 #include <chrono>
 #include <memory>
@@ -53,6 +54,17 @@ public:
                     const std::vector<GfxDimension>& dimensions,
                     std::vector<std::string>& images);
 
+    /**
+     * @brief Process several files in one command so that the worker handles them concurrently.
+     *
+     * Large images come back through a shared memory when one can be created.
+     *
+     * @param tasks Up to CommandNewGfxBatch::MAX_TASKS tasks, whose Path is a local path.
+     * @param results One result per task, in the same order, on success.
+     * @return false if the batch couldn't be processed at all.
+     */
+    bool runGfxBatch(const std::vector<GfxTask>& tasks, std::vector<GfxTaskResult>& results);
+
     bool runSupportFormats(std::string& formats, std::string& videoformats);
 
     static GfxClient create(const std::string& endpointName);
@@ -72,6 +84,12 @@ private:
                        std::chrono::milliseconds sendTimeout = std::chrono::milliseconds{5000},
                        std::chrono::milliseconds receiveTimeout = std::chrono::milliseconds{5000});
 
+    // Shared memory reserved for each image of a batch. Pages are only
+    // backed once written, so this only bounds the largest image.
+    static constexpr size_t SHARED_BYTES_PER_IMAGE = 1024 * 1024;
+
+    static constexpr size_t MAX_SHARED_BYTES = 256 * 1024 * 1024;
+
     std::unique_ptr<IGfxCommunicationsClient> mComms;
 };
 
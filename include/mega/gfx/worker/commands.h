@@ -38,7 +38,9 @@ enum class CommandType
     HELLO_RESPONSE              = 7,
     SUPPORT_FORMATS             = 8,
     SUPPORT_FORMATS_RESPONSE    = 9,
-    END                         = 10  // 1 more than the last valid one
+    NEW_GFX_BATCH               = 10,
+    NEW_GFX_BATCH_RESPONSE      = 11,
+    END                         = 12  // 1 more than the last valid one
 };
 
 class ICommand
@@ -112,6 +114,40 @@ struct CommandNewGfxResponse : public ICommand
     bool unserialize(const std::string& data) override;
 };
 
+// Several files to be processed concurrently by the worker
+struct CommandNewGfxBatch : public ICommand
+{
+    static constexpr size_t MAX_TASKS = 64;
+
+    std::vector<GfxTask> Tasks;
+
+    // Shared memory where the worker may write the images, empty if none
+    std::string SharedMemoryName;
+    uint32_t    SharedMemorySize = 0;
+
+    CommandType type() const override { return CommandType::NEW_GFX_BATCH; }
+
+    std::string typeStr() const override { return "NEW_GFX_BATCH"; };
+
+    std::string serialize() const override;
+
+    bool unserialize(const std::string& data) override;
+};
+
+// One result per task, in the same order
+struct CommandNewGfxBatchResponse : public ICommand
+{
+    std::vector<GfxBatchResult> Results;
+
+    CommandType type() const override { return CommandType::NEW_GFX_BATCH_RESPONSE; }
+
+    std::string typeStr() const override { return "NEW_GFX_BATCH_RESPONSE"; };
+
+    std::string serialize() const override;
+
+    bool unserialize(const std::string& data) override;
+};
+
 struct CommandHello : public ICommand
 {
     std::string Text;
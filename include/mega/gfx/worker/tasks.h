@@ -20,6 +20,7 @@
 
 #include "mega/gfx.h"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <limits>
@@ -53,6 +54,27 @@ struct GfxTaskResult final
     std::vector<std::string> OutputImages;
 };
 
+/**
+ * @brief An image generated for a task of a batch.
+ *
+ * The image is either carried inline in Data or, when the client provided a shared
+ * memory large enough, written to the shared memory at Offset.
+ */
+struct GfxBatchImage final
+{
+    std::string Data;
+    uint32_t    Offset = 0;
+    uint32_t    Length = 0; // 0 when the image is inline
+
+    bool isShared() const { return Length > 0; }
+};
+
+struct GfxBatchResult final
+{
+    GfxTaskProcessStatus       ProcessStatus = GfxTaskProcessStatus::ERR;
+    std::vector<GfxBatchImage> Images;
+};
+
 } //namespace gfx
 } //namespace mega
 
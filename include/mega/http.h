@@ -323,6 +323,34 @@ struct MEGA_API HttpIO : public EventTrigger
         return false;
     }
 
+    // open a connection to the host of a tempurl before the transfer needs it,
+    // so that the TCP and TLS handshakes are out of the way for the first chunk
+    virtual void prewarm(const string&, direction_t) { }
+
+    // negotiate HTTP/2 with the servers supporting it, so that concurrent requests
+    // to the same host share a connection (false if the network layer can't)
+    virtual bool setHttp2(bool)
+    {
+        return false;
+    }
+
+    // serialize the TLS sessions known to the network layer, so that they can
+    // be resumed after a restart (false if the network layer can't export them)
+    virtual bool exportTlsSessions(string&)
+    {
+        return false;
+    }
+
+    // restore TLS sessions previously serialized by exportTlsSessions()
+    virtual bool importTlsSessions(const string&)
+    {
+        return false;
+    }
+
+    // set when a request completes over a new connection, whose TLS session
+    // the client may want to export
+    bool newtlssessions = false;
+
     HttpIO();
     virtual ~HttpIO() { }
 
@@ -41,7 +41,9 @@
 #include "setandelement.h"
 #include "sharenodekeys.h"
 #include "sync.h"
+#include "timerqueue.h"
 #include "transfer.h"
+#include "transferscheduler.h"
 #include "transferstats.h"
 #include "treeproc.h"
 #include "user.h"
@@ -732,6 +734,12 @@ public:
     // fetchnodes stats
     FetchNodesStats fnstats;
 
+    // set while the stats wait for the cached transfers to be resumed
+    bool mFnStatsReportPending = false;
+
+    // record when transfers were resumed and send the fetchnodes stats
+    void sendFetchNodesStats();
+
     // check existence and integrity of keys and signatures, initialize if missing
     void initializekeys();
 
@@ -978,6 +986,20 @@ public:
     // send files/folders to user
     void putnodes(const char*, vector<NewNode>&&, int tag, CommandPutNodes::Completion&& completion = nullptr);
 
+    // add the node of a small-file upload along with others going to the same parent node,
+    // reporting its result through completion (or putnodes_result) as putnodes() would
+    void putnodesOfSmallUpload(NodeHandle parent,
+                               VersioningOption vo,
+                               NewNode&& newnode,
+                               int tag,
+                               putsource_t source,
+                               CommandPutNodes::Completion&& completion,
+                               bool canChangeVault,
+                               std::optional<Pitag> pitag);
+
+    // send the nodes added by putnodesOfSmallUpload()
+    void sendBatchedPutnodes();
+
     void putFileAttributes(handle h, fatype t, const std::string& encryptedAttributes, int tag);
 
     // attach file attribute to upload or node handle
@@ -1087,6 +1109,12 @@ public:
     // add timer
     error addtimer(TimerWithBackoff *twb);
 
+    // run callback from exec() once delay has elapsed, with millisecond precision
+    TimerQueue::TimerId scheduleTimer(std::chrono::milliseconds delay, TimerQueue::Callback callback);
+
+    // stop a timer added by scheduleTimer() from running
+    bool cancelTimer(TimerQueue::TimerId id);
+
 #ifdef ENABLE_SYNC
     /**
      * @brief Check if a given node is syncable
@@ -1624,10 +1652,55 @@ public:
     // finish downloaded chunks in order
     bool orderdownloadedchunks;
 
+    // adapt the connections and request size of non-raid transfers to the measured throughput,
+    // using connections[] as the upper bound
+    bool mAdaptiveTransfers = false;
+
+    // decides which queued transfers get a slot first, and how many slots are used
+    TransferScheduler mTransferScheduler{MAXTOTALTRANSFERS};
+
+    // complete small-file uploads going to the same folder with a single putnodes
+    bool mBatchSmallUploads = false;
+
+    // largest upload whose putnodes may be batched with others
+    static const m_off_t MAX_BATCHED_UPLOAD_SIZE;
+
     // retry API_ESSL errors
     bool retryessl;
 
 private:
+    // putnodes of small-file uploads waiting to be sent together
+    struct PutnodesBatch
+    {
+        NodeHandle target;
+        VersioningOption versioning;
+        putsource_t source;
+        bool canChangeVault;
+        std::optional<Pitag> pitag;
+
+        vector<NewNode> nodes;
+        vector<int> tags;
+        vector<CommandPutNodes::Completion> completions;
+    };
+
+    vector<PutnodesBatch> mPutnodesBatches;
+
+    void sendPutnodesBatch(PutnodesBatch&& batch);
+
+    // Reads the transfer cache, decrypting the records on the worker threads.
+    // As when decrypting while reading, records after one that can't be
+    // decrypted are left out.
+    vector<std::pair<uint32_t, string>> readTransferCache();
+
+    static constexpr size_t TRANSFER_RECORDS_PER_CHUNK = 256;
+
+    // Records prepared by encodesc, until putsc writes them (nullopt if the
+    // record couldn't be serialized).
+    std::unordered_map<const Cacheable*, std::optional<string>> mEncodedScRecords;
+
+    // Writes a record to sctable, as prepared by encodesc if it was.
+    bool putsc(uint32_t type, Cacheable* record);
+
     // The current request's status in millis.
     //
     // This member is maintained by procreqstat(...) whether request
@@ -1771,6 +1844,9 @@ private:
 
     vector<TimerWithBackoff *> bttimers;
 
+    // work to run from exec() at a precise time, possibly sooner than the next decisecond
+    TimerQueue mTimers;
+
     // server-client command trigger connection
     std::unique_ptr<HttpReq> pendingsc;
     std::unique_ptr<HttpReq> pendingscUserAlerts;
@@ -1995,7 +2071,17 @@ public:
     void disabletransferresumption();
 
     void resumeTransfersForNotLoggedInInstance();
+
+    // Resumes the next RESUMED_FILES_PER_ROUND cached files, in the order they were
+    // queued, so the first transfers can start before all of them are resumed.
+    // Rounds continue from exec() while resumingTransfers() is true.
     void resumeTransferFromDB();
+    bool resumingTransfers() const;
+
+    static constexpr size_t RESUMED_FILES_PER_ROUND = 500;
+
+    // open connections to the storage hosts of cached transfers while the account loads
+    void prewarmCachedTransfers();
 
     // application callbacks
     struct MegaApp* app;
@@ -2107,6 +2193,13 @@ public:
 
     void persistAlert(UserAlert::Base* a);
 
+    // Serializes and encrypts, on the worker threads, records about to be
+    // written to sctable, so that the writes (through putsc) only have to
+    // store them, in their usual order and transaction.
+    void encodesc(const vector<std::pair<uint32_t, Cacheable*>>& records);
+
+    static constexpr size_t SC_RECORDS_PER_CHUNK = 32;
+
     // record type indicator for statusTable
     enum StatusTableRecType { CACHEDSTATUS };
 
@@ -2185,7 +2278,6 @@ public:
 
     // active/pending direct reads
     handledrn_map hdrns;   // DirectReadNodes, main ownership.  One per file, each with one DirectRead per client request.
-    dsdrn_map dsdrns;      // indicates the time at which DRNs should be retried
     dr_list drq;           // DirectReads that are in DirectReadNodes which have fectched URLs
     drs_list drss;         // DirectReadSlot for each DR in drq, up to Max
     void removeAppData(void* t); // remove appdata (usually a MegaTransfer*) from every DirectRead
@@ -2248,6 +2340,9 @@ public:
     vector<string> cachedfiles;
     vector<uint32_t> cachedfilesdbids;
 
+    // cached files resumed so far
+    size_t cachedfilesresumed = 0;
+
     // database IDs of cached files and transfers
     // waiting for the completion of a putnodes
     pendingdbid_map pendingtcids;
@@ -2868,6 +2963,9 @@ public:
     struct PerformanceStats
     {
         CodeCounter::ScopeStats execFunction = { "MegaClient_exec" };
+        CodeCounter::ScopeStats execCsRequests = { "MegaClient_exec_cs" };
+        CodeCounter::ScopeStats execScChannel = { "MegaClient_exec_sc" };
+        CodeCounter::ScopeStats execTransferSlots = { "MegaClient_exec_slots" };
         CodeCounter::ScopeStats transferslotDoio = { "TransferSlot_doio" };
         CodeCounter::ScopeStats execdirectreads = { "execdirectreads" };
         CodeCounter::ScopeStats transferComplete = { "transfer_complete" };
@@ -2896,14 +2994,44 @@ public:
         CodeCounter::ScopeStats syncItemCSF = { "syncItemCSF" };
         CodeCounter::ScopeStats clientThreadActions = { "clientThreadActions" };
 #endif
+
+        // State cache records by type: time spent serializing and encrypting them
+        // (each timed on the thread that encoded it) and writing them to the table
+        struct CacheRecordStats
+        {
+            CodeCounter::ScopeStats encode;
+            CodeCounter::ScopeStats write;
+            CacheRecordStats(const std::string& name): encode(name + "_encode"), write(name + "_write") {}
+        };
+        CacheRecordStats scUsers = { "sc_users" };
+        CacheRecordStats scPcrs = { "sc_pcrs" };
+        CacheRecordStats scSets = { "sc_sets" };
+        CacheRecordStats scSetElements = { "sc_setelements" };
+        CacheRecordStats scChats = { "sc_chats" };
+        CacheRecordStats scAlerts = { "sc_alerts" };
+        CacheRecordStats scOther = { "sc_other" };
+        CacheRecordStats& scRecords(uint32_t type);
+
+#ifdef USE_SQLITE
+        // copied from SqliteDbTable by scopes(), as tables commit on other threads too
+        CodeCounter::ScopeStats sqliteCommitTime = { "sqlite_commit" };
+#endif
+
         uint64_t transferStarts = 0, transferFinishes = 0;
         uint64_t transferTempErrors = 0, transferFails = 0;
         uint64_t prepwaitImmediate = 0, prepwaitZero = 0, prepwaitHttpio = 0, prepwaitFsaccess = 0, nonzeroWait = 0;
         CodeCounter::DurationSum csRequestWaitTime;
         CodeCounter::DurationSum transfersActiveTime;
         std::string report(bool reset, HttpIO* httpio, Waiter* waiter, const RequestDispatcher& reqs);
+
+        // every ScopeStats above and elsewhere, as exported by openMetrics()
+        std::vector<CodeCounter::ScopeStats*> scopes(HttpIO* httpio);
     } performanceStats;
 
+    // The performance and transfer statistics, and the state of each sync,
+    // in the OpenMetrics text format.
+    std::string openMetrics();
+
     std::string getDeviceidHash();
 
     /**
@@ -3034,6 +3162,26 @@ public:
     // ViewID is employed by apps for event logging. It is generated by the SDK to ensure consistent and shared logic across applications.
     static string generateViewId(PrnGen& rng);
 
+//
+// TLS session persistence
+//
+    // Keep the TLS sessions of the network layer in a cache file (in the same folder as the
+    // databases), so that the first connections after a restart resume them instead of doing
+    // full handshakes. Disabling it removes the cache file.
+    // Returns false if there is no local cache folder or the network layer can't export sessions.
+    bool setTlsSessionPersistence(bool enable);
+
+    // Save the current TLS sessions into the cache file, if persistence is enabled.
+    bool storeTlsSessions();
+
+    // Path of the TLS session cache file (empty if persistence is disabled).
+    LocalPath mTlsSessionCachePath;
+
+    // The cache file is also updated from exec() when new connections were made,
+    // at most once per TLS_SESSION_STORE_INTERVAL_DS, besides at logout.
+    static constexpr dstime TLS_SESSION_STORE_INTERVAL_DS = 600;
+    dstime mNextTlsSessionStoreDs = 0;
+
 //
 // Sets and Elements
 //
@@ -27,6 +27,7 @@
 #include "backofftimer.h"
 #include "file.h"
 #include "filefingerprint.h"
+#include "noderecord.h"
 #include "syncfilter.h"
 #include "syncinternals/mac_computation_state.h"
 #include "syncinternals/syncuploadthrottlingfile.h"
@@ -261,6 +262,19 @@ struct MEGA_API Node : public NodeCore, FileFingerprint
     // try to resolve node key string
     bool applykey();
 
+    // the steps of applykey(), so that the decryption in between can be done off the client
+    // thread for many nodes at once (see NodeManager::applyKeys):
+    // locate the encrypted key (k) and the cipher to decrypt it with (sc), false if not
+    // available yet
+    bool locatekey(const char*& k, SymmCipher*& sc);
+
+    // install the decrypted key (nullptr if it couldn't be decrypted) and set the
+    // attributes, already decrypted with it if decryptedAttrs is given
+    bool applyunwrappedkey(const byte* key, const byte* decryptedAttrs);
+
+    // length of the decrypted key for this node type
+    unsigned nodekeylength() const;
+
     // Returns false if the share key can't correctly decrypt the key and the
     // attributes of the node. Otherwise, it returns true. There are cases in
     // which it's not possible to check if the key is valid (for example when
@@ -276,7 +290,10 @@ struct MEGA_API Node : public NodeCore, FileFingerprint
     // decrypt attribute string, set fileattrs and save fingerprint
     void setattr();
 
-    // display name (UTF-8)
+    // same, from the attribute string already decrypted by decryptattr()
+    void setattr(const byte* decryptedAttrs);
+
+    // display name (UTF-8), valid until the node's attributes change
     const char* displayname(LogCondition log = LOG_CONDITION_NONE) const;
 
     // check if the name matches (UTF-8)
@@ -542,6 +559,11 @@ inline const string& Node::nodekeyUnchecked() const
     return nodekeydata;
 }
 
+inline unsigned Node::nodekeylength() const
+{
+    return (type == FILENODE) ? FILENODEKEYLENGTH : FOLDERNODEKEYLENGTH;
+}
+
 inline bool Node::keyApplied() const
 {
     return nodekeydata.size() == size_t((type == FILENODE) ? FILENODEKEYLENGTH : FOLDERNODEKEYLENGTH);
@@ -563,7 +585,7 @@ inline bool Node::hasZeroKey(const string& nodekeydata)
 class NodeData
 {
 public:
-    NodeData(const char* ptr, size_t size, int component) : mStart(ptr), mEnd(ptr + size), mComp(component) {}
+    NodeData(const char* ptr, size_t size, int component);
 
     m_time_t getMtime();
     int getLabel();
@@ -575,6 +597,9 @@ public:
                                      bool fromOldCache,
                                      std::list<std::unique_ptr<NewShare>>& ownNewshares);
 
+    // Writes the node as a NodeRecord, converting it if in the legacy format
+    bool toRecord(std::string& record);
+
     enum
     {
         COMPONENT_ALL = -1,
@@ -588,12 +613,36 @@ public:
 
 private:
     bool readComponents();
-    bool readFailed() { return (mReadAttempted && !mReadSucceeded) || (!mReadAttempted && !readComponents()); }
+    bool readFailed()
+    {
+        if (mRecord)
+        {
+            return !mRecord->valid();
+        }
+
+        return (mReadAttempted && !mReadSucceeded) || (!mReadAttempted && !readComponents());
+    }
+
+    nodetype_t type() const
+    {
+        return mRecord ? mRecord->type() : mType;
+    }
+
+    std::optional<std::string_view> attribute(nameid name) const;
+
+    std::shared_ptr<Node> createNodeFromRecord(MegaClient& client,
+                                               bool fromOldCache,
+                                               std::list<std::unique_ptr<NewShare>>& ownNewshares);
+
+    void applyKey(MegaClient& client, const std::shared_ptr<Node>& n, bool encrypted) const;
 
     const char* mStart;
     const char* mEnd;
     int mComp;
 
+    // read in place when the data is a record, otherwise the members below are read from it
+    std::optional<NodeRecord> mRecord;
+
     m_off_t mSize = 0;
     nodetype_t mType = TYPE_UNKNOWN;
     handle mHandle = 0;
@@ -911,16 +960,18 @@ struct MEGA_API LocalNode
          * for large files, so it runs incrementally across sync iterations using worker threads.
          *
          * Architecture:
-         * - Sync thread reads file in large chunks (10-20MB) with FILE_SHARE_DELETE
-         * - Worker thread (mAsyncQueue) computes MACs for chunks
+         * - Sync thread queues the file in large ranges (10MB), several at a time, opening it
+         *   for each range (with FILE_SHARE_DELETE) and checking its size before queueing
+         * - Worker threads (mAsyncQueue) read the range, close the file and compute its MACs
+         * - A queued range keeps its descriptor open while it waits in the async queue, so
+         *   ranges in flight are bounded per file and by the throttle's global read budget
          * - Progress tracked across sync iterations
-         * - File opened/closed per chunk to minimize lock duration
          *
          * Thread safety:
          * - Context fields are immutable after construction
-         * - chunkInProgress flag: sync thread sets true before queueing, worker clears when done
-         * - completed flag: worker sets when all chunks processed
-         * - partialMacs protected by mutex (worker writes, sync reads only when !chunkInProgress)
+         * - rangesInFlight: sync thread increments when queueing, worker decrements when done
+         * - completed flag: set by the worker whose range completes the file
+         * - partialMacs protected by mutex (workers merge into it as ranges finish)
          *
          * Lifetime:
          * - Sync thread holds shared_ptr in RareFields
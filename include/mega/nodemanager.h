@@ -28,7 +28,9 @@
 
 #include <limits>
 #include <map>
+#include <optional>
 #include <set>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -39,6 +41,7 @@ struct FileFingerprint;
 class FingerprintContainer;
 class MegaClient;
 class NodeSerialized;
+struct RecentFile;
 
 class NodeSearchFilter
 {
@@ -315,11 +318,11 @@ public:
 
     sharedNode_vector getChildren(const NodeSearchFilter& filter, int order, CancelToken cancelFlag, const NodeSearchPage& page);
 
-    // get up to "maxcount" nodes, not older than "since", ordered by creation time
-    // Note: nodes are read from DB and loaded in memory
-    sharedNode_vector getRecentNodes(unsigned maxcount,
-                                     m_time_t since,
-                                     bool excludeSensitives = false);
+    // get up to "maxcount" files, not older than "since", ordered by creation time
+    // Note: files are read from the DB's recents index, without loading their nodes
+    std::vector<RecentFile> getRecentFiles(unsigned maxcount,
+                                           m_time_t since,
+                                           bool excludeSensitives = false);
 
     sharedNode_vector searchNodes(const NodeSearchFilter& filter, int order, CancelToken cancelFlag, const NodeSearchPage& page);
 
@@ -510,7 +513,13 @@ public:
 
     void removeNodePendingApplyKeys(const Node* node);
 
+    // below this many nodes pending, keys are applied on the client thread only
+    static constexpr size_t MIN_NODES_TO_APPLY_KEYS_IN_PARALLEL = 1024;
+
 private:
+    // nodes decrypted by each job handed to the worker threads
+    static constexpr size_t NODES_PER_APPLY_KEYS_CHUNK = 256;
+
     class NoKeyLogger
     {
     public:
@@ -536,6 +545,9 @@ private:
     // interface to handle accesses to "nodes" table
     DBTableNodes* mTable = nullptr;
 
+    // increased every time mTable is set
+    uint64_t mTableGeneration = 0;
+
     // logger with rate limitting for no key
     static NoKeyLogger mNoKeyLogger;
 
@@ -626,10 +638,25 @@ private:
     // If a valid object is passed, it must be kept alive until this method returns.
     sharedNode_vector processUnserializedNodes(const std::vector<std::pair<NodeHandle, NodeSerialized>>& nodesFromTable, NodeHandle ancestorHandle = NodeHandle(), CancelToken cancelFlag = CancelToken());
 
+    // These release mMutex while the DB is queried, if a read-only view of it is available
     sharedNode_vector searchNodes_internal(const NodeSearchFilter& filter, int order, CancelToken cancelFlag, const NodeSearchPage& page);
     sharedNode_vector processUnserializedNodes(const std::vector<std::pair<NodeHandle, NodeSerialized>>& nodesFromTable, CancelToken cancelFlag);
     sharedNode_vector getChildren_internal(const NodeSearchFilter& filter, int order, CancelToken cancelFlag, const NodeSearchPage& page);
-    sharedNode_vector getRecentNodes_internal(const NodeSearchPage& page, m_time_t since);
+    std::vector<RecentFile> getRecentFiles_internal(const NodeSearchPage& page, m_time_t since);
+
+    // Run query on a read-only view of the table with mMutex released, so that long queries
+    // from the app don't hold up the SDK thread while it writes to the DB.
+    // Returns nullopt if no view is available or the table has uncommitted changes, and the
+    // query should be run on mTable.
+    // Returns a default constructed result if the table was replaced meanwhile.
+    template<typename Query>
+    auto queryReadOnlyView(Query&& query, bool& changed)
+        -> std::optional<std::invoke_result_t<Query, DBTableNodes&>>;
+
+    // Query the nodes with query, on a read-only view of the table if possible.
+    // If the table had changes the view didn't see, the query is run again on mTable.
+    template<typename Query>
+    bool queryNodes(Query&& query, std::vector<std::pair<NodeHandle, NodeSerialized>>& nodes);
 
     // node temporary in memory, which will be removed upon write to DB
     std::shared_ptr<Node> mNodeToWriteInDb;
@@ -684,6 +711,8 @@ private:
     void cleanNodes_internal();
     std::shared_ptr<Node> getNodeFromBlob_internal(const string* nodeSerialized);
     void applyKeys_internal();
+    // decrypt the keys and attributes of many nodes on the worker threads
+    void applyKeysInParallel(const sharedNode_vector& nodes);
     void notifyNode_internal(std::shared_ptr<Node> node, sharedNode_vector* nodesToReport);
     bool loadNodes_internal();
     uint64_t getNodeCount_internal();
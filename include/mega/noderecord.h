@@ -0,0 +1,163 @@
+/**
+ * @file mega/noderecord.h
+ * @brief Binary record of a node, as stored in the nodes table
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#pragma once
+
+#include "attrmap.h"
+#include "types.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace mega
+{
+
+// A node's fields at fixed offsets, followed by its variable-length sections.
+//
+// The header holds the scalar fields and the end offset of each section, so
+// any of them can be read in place, straight from the DB's pages, without
+// unserializing the rest. Attributes are a table of names sorted as in
+// attr_map, with the offsets of their values, so one can be found by binary
+// search.
+//
+//   0  tag        int64   RECORD_TAG, never a size or type of the legacy format
+//   8  version    uint8   FORMAT_VERSION
+//   9  type       int8
+//  10  flags      uint8
+//  11  reserved   uint8
+//  12  numShares  int16   -1 for an inshare, else the number of out and pending shares
+//  14  reserved   uint16
+//  16  size       int64   for files, else the negated type, as in the legacy format
+//  24  handle     uint64
+//  32  parent     uint64
+//  40  owner      uint64
+//  48  ctime      int64
+//  56  sectionEnd uint32[NUM_SECTIONS]
+//  88  sections
+//
+// Numbers are in host byte order, as in the legacy format.
+class NodeRecord
+{
+public:
+    static constexpr uint8_t FORMAT_VERSION = 1;
+
+    static constexpr int64_t RECORD_TAG = -0x4e4f44455245434fLL;
+
+    enum Section
+    {
+        NODE_KEY,
+        FILE_ATTRIBUTES,
+        AUTH_KEY,
+        LINK,      // handle, expiry and creation time of the public link
+        SHARE_KEY,
+        SHARES,    // each as written by Share::serialize()
+        ATTRIBUTES,
+        ATTRIBUTE_STRING,
+        NUM_SECTIONS
+    };
+
+    enum Flag : uint8_t
+    {
+        EXPORTED = 1,
+        LINK_TAKEN_DOWN = 2,
+        ENCRYPTED = 4,
+    };
+
+    static constexpr size_t HEADER_SIZE = 56 + NUM_SECTIONS * sizeof(uint32_t);
+
+    static constexpr size_t LINK_SIZE = sizeof(handle) + 2 * sizeof(m_time_t);
+
+    // What a record is written from, by Node::serialize() or from a node in the legacy format
+    struct Fields
+    {
+        nodetype_t type = TYPE_UNKNOWN;
+        uint8_t flags = 0;
+        int16_t numShares = 0;
+        m_off_t size = 0;
+        handle nodeHandle = UNDEF;
+        handle parentHandle = UNDEF;
+        handle owner = UNDEF;
+        m_time_t ctime = 0;
+
+        handle linkHandle = UNDEF;
+        m_time_t linkExpiry = 0;
+        m_time_t linkCreation = 0;
+
+        // all but LINK and ATTRIBUTES, which are written from the fields above and below
+        std::string_view sections[NUM_SECTIONS];
+
+        const attr_map* attributes = nullptr;
+    };
+
+    static void write(const Fields& fields, std::string& out);
+
+    // Whether data is a record rather than a node in the legacy format
+    static bool isRecord(const char* data, size_t size);
+
+    // data must outlive the record
+    NodeRecord(const char* data, size_t size);
+
+    // Whether the header and every offset in it are consistent
+    bool valid() const
+    {
+        return mValid;
+    }
+
+    nodetype_t type() const;
+    uint8_t flags() const;
+    int16_t numShares() const;
+    m_off_t size() const;
+    handle nodeHandle() const;
+    handle parentHandle() const;
+    handle owner() const;
+    m_time_t ctime() const;
+
+    handle linkHandle() const;
+    m_time_t linkExpiry() const;
+    m_time_t linkCreation() const;
+
+    std::string_view section(Section section) const;
+
+    // The value of the attribute, if the node has it
+    std::optional<std::string_view> attribute(nameid name) const;
+
+    // Adds every attribute to attrs
+    void attributes(attr_map& attrs) const;
+
+private:
+    static constexpr size_t ATTRIBUTE_ENTRY_SIZE = sizeof(nameid) + sizeof(uint32_t);
+
+    bool validate() const;
+
+    template<typename T>
+    T get(size_t offset) const;
+
+    size_t numAttributes() const;
+    nameid attributeName(size_t i) const;
+    std::string_view attributeValue(size_t i) const;
+
+    const char* mData;
+    size_t mSize;
+    bool mValid;
+};
+
+} // namespace mega
@@ -0,0 +1,94 @@
+/**
+ * @file mega/openmetrics.h
+ * @brief Write metrics in the OpenMetrics text format
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mega::stats
+{
+
+/**
+ * @brief Builds an exposition in the OpenMetrics text format.
+ *
+ * Metrics are written family by family: each call to family() starts a new
+ * one, and the samples that follow belong to it until the next call.
+ * Names are prefixed with "mega_".
+ */
+class OpenMetricsWriter
+{
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    static constexpr const char* CONTENT_TYPE =
+        "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+    enum class Type
+    {
+        COUNTER,
+        GAUGE,
+        HISTOGRAM,
+    };
+
+    /**
+     * @brief Start a metric family.
+     *
+     * @param name Name of the family, without the "mega_" prefix. For
+     * counters, without the "_total" suffix either.
+     * @param unit Unit the values are in, which must end the name when given.
+     */
+    void family(const std::string& name,
+                Type type,
+                const std::string& help,
+                const std::string& unit = std::string());
+
+    // Add a sample to the current counter or gauge family.
+    void sample(const Labels& labels, double value);
+
+    /**
+     * @brief Add a histogram to the current histogram family.
+     *
+     * @param bounds Upper bound of each bucket but the last, ascending.
+     * @param counts Observations in each bucket, not cumulative, with one
+     * more entry than bounds for the observations above the last bound.
+     */
+    void histogram(const Labels& labels,
+                   const std::vector<double>& bounds,
+                   const std::vector<uint64_t>& counts,
+                   double sum);
+
+    // Terminate the exposition and return it.
+    std::string finish();
+
+    static std::string escape(const std::string& value);
+
+private:
+    void line(const std::string& suffix, const Labels& labels, double value);
+
+    std::string mOut;
+    std::string mName;
+    Type mType = Type::GAUGE;
+};
+
+} // namespace mega::stats
@@ -186,6 +186,8 @@ public:
     bool sysopen(bool async, FSLogging) override;
     void sysclose() override;
 
+    void readAhead(m_off_t offset, m_off_t length) override;
+
     PosixFileAccess(Waiter *w, int defaultfilepermissions = 0600, bool followSymLinks = true);
 
     // async interface
@@ -240,7 +242,54 @@ public:
                             const LocalPath& rootPath,
                             Waiter* waiter) override;
 
+    // Size of the buffer events are read into: a burst of changes is
+    // drained with a few read() calls rather than one per event.
+    static constexpr size_t EVENT_BUFFER_SIZE = 64 * 1024;
+
+    // Events each inotify watch is added for.
+    static constexpr uint32_t INOTIFY_EVENTS =
+        IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_EXCL_UNLINK |
+        IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+    // Calls handler for each event read from an inotify descriptor, until
+    // there are no more to read.
+    static void readInotifyEvents(int fd,
+                                  vector<char>& buffer,
+                                  std::function<void(const inotify_event&)> handler);
+
+#ifdef USE_FANOTIFY
+    // Monitor the syncs of instances initialized from now on with a
+    // fanotify mark on each filesystem rather than an inotify watch per
+    // folder. That needs CAP_SYS_ADMIN: syncs are monitored with inotify
+    // when fanotify can't be initialized or their filesystem can't be
+    // marked.
+    static void setUseFanotify(bool useFanotify);
+
+    // Events each filesystem is marked for.
+    static constexpr uint64_t FANOTIFY_EVENTS = FAN_ATTRIB | FAN_CLOSE_WRITE | FAN_CREATE |
+                                                FAN_DELETE | FAN_DELETE_SELF | FAN_MOVED_FROM |
+                                                FAN_MOVED_TO | FAN_ONDIR;
+
+    // Identifies a directory as fanotify reports it: the ID of its
+    // filesystem followed by its file handle.
+    static bool fanotifyKey(const LocalPath& path, const string& fsid, string& key);
+
+    // The ID of the filesystem containing path, as fanotify reports it.
+    static bool fanotifyFsid(const LocalPath& path, string& fsid);
+
+    // Calls handler with the directory key and entry name of each event
+    // read from a fanotify descriptor, until there are no more to read.
+    // The name is empty for events on the directory itself.
+    static void readFanotifyEvents(
+        int fd,
+        vector<char>& buffer,
+        std::function<void(const fanotify_event_metadata&, const string&, const char*)> handler);
+#endif // USE_FANOTIFY
+
 private:
+    // Queue notifications for each node watched under handle.
+    int notifyAll(WatchMap& watches, int handle, const char* name, bool deletedSelf, bool attribDir);
+
     // Tracks which notifiers were created by this instance.
     list<DirNotify*> mNotifiers;
 
@@ -250,6 +299,30 @@ private:
     // Tracks which nodes are associated with what inotify handle.
     WatchMap mWatches;
 
+    // Events are read into this buffer.
+    vector<char> mEventBuffer;
+
+#ifdef USE_FANOTIFY
+    // Whether new instances should try to use fanotify.
+    static std::atomic<bool> mUseFanotify;
+
+    // Fanotify descriptor, if in use.
+    int mFanotifyFd = -EINVAL;
+
+    // Tracks which nodes are associated with which fanotify handle.
+    //
+    // The handles are allocated by us, one for each directory key. They
+    // are negative so they can't be mistaken for inotify handles.
+    WatchMap mFanotifyWatches;
+
+    map<string, int> mFanotifyHandles;
+    map<int, string> mFanotifyKeys;
+    int mNextFanotifyHandle = 0;
+
+    // How many notifiers rely on the mark of each filesystem.
+    map<string, size_t> mFanotifyMarks;
+#endif // USE_FANOTIFY
+
 #endif // ENABLE_SYNC
 }; // LinuxFileSystemAccess
 
@@ -278,6 +351,31 @@ private:
 
     // Our position in our owner's mNotifiers list.
     list<DirNotify*>::iterator mNotifiersIt;
+
+#ifdef USE_FANOTIFY
+    // Mark the filesystem fsid, which contains path, for fanotify events
+    // unless another notifier already has.
+    bool markFilesystem(const string& fsid, const LocalPath& path);
+
+    // Release a mark added by markFilesystem().
+    void unmarkFilesystem(const string& fsid, const LocalPath& path);
+
+    // Whether the folder at path can be monitored through fanotify,
+    // marking its filesystem if it's not the one our root is on.
+    bool fanotifyFilesystem(const LocalPath& path, string& fsid);
+
+    // Set if our filesystem is marked for fanotify events, to the ID of
+    // that filesystem.
+    string mFanotifyFsid;
+
+    // Other filesystems mounted within our sync that we marked, each with
+    // the path it was marked through.
+    map<string, LocalPath> mOtherFanotifyMarks;
+
+    // Filesystems mounted within our sync that couldn't be marked: their
+    // folders are monitored with inotify.
+    set<string> mUnmarkedFilesystems;
+#endif // USE_FANOTIFY
 }; // LinuxDirNotify
 
 #endif // ENABLE_SYNC
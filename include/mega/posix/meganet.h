@@ -182,10 +182,35 @@ protected:
     void closecurlevents(direction_t d);
     void processcurlevents(direction_t d);
     SockInfoMap curlsockets[3];
-    m_time_t curltimeoutreset[3];
+    m_time_t curltimeoutreset[3]; // monotonic time in milliseconds, or -1 if none
     bool arerequestspaused[3];
     int numconnections[3];
     set<CURL *>pausedrequests[3];
+
+    // in-flight connection prewarming handles, with the direction they were added to
+    struct PrewarmContext
+    {
+        direction_t d;
+        std::unique_ptr<curl_slist, decltype(&curl_slist_free_all)> dnsList{nullptr,
+                                                                            curl_slist_free_all};
+    };
+    std::map<CURL*, PrewarmContext> prewarmrequests;
+
+    // hosts (scheme://host:port) prewarmed for GET and PUT, and when
+    std::map<string, dstime> prewarmedhosts[2];
+
+    void cancelprewarm();
+
+    // negotiate HTTP/2 and multiplex concurrent requests to the same host
+    bool http2 = false;
+
+    // consecutive HTTP/2 protocol errors per host, hosts reaching
+    // MAX_HTTP2_ERRORS are spoken to over HTTP/1.1 from then on
+    std::map<string, unsigned> http2errors;
+    static const unsigned MAX_HTTP2_ERRORS = 3;
+
+    void setmultiplexing();
+    void sethttpversion(CURL* curl, const string& hostname);
     m_off_t partialdata[2];
     m_off_t maxspeed[2];
 
@@ -222,6 +247,15 @@ public:
     m_off_t getmaxuploadspeed() override;
 
     int cacheresolvedurls(const std::vector<string>& urls, const std::vector<string>& ips) override;
+
+    void prewarm(const string& url, direction_t d) override;
+
+    bool setHttp2(bool enable) override;
+    bool exportTlsSessions(string& data) override;
+    bool importTlsSessions(const string& data) override;
+
+    // how long a prewarmed host is considered warm (idle connections are kept by cURL's pool)
+    static const dstime PREWARM_VALIDITY_DS = 600;
     void addDnsResolution(CURL* curl,
                           std::unique_ptr<curl_slist, decltype(&curl_slist_free_all)>& dnsList,
                           const string& host,
@@ -296,4 +330,37 @@ int populateDNSCache(std::map<std::string, DNSEntry>& cache,
                      const std::vector<std::string>& ips,
                      const std::vector<std::string>& uris);
 
+// A TLS session exported by cURL, in a form that can be persisted.
+struct TlsSession
+{
+    bool operator==(const TlsSession& rhs) const
+    {
+        return key == rhs.key && shmac == rhs.shmac && data == rhs.data &&
+               validUntil == rhs.validUntil;
+    }
+
+    // cURL's session key (peer and TLS configuration), empty if only the hash is known.
+    std::string key;
+
+    // Salted hash of the session key.
+    std::string shmac;
+
+    // The serialized session (ticket and parameters).
+    std::string data;
+
+    // When the session expires (seconds since the epoch).
+    m_time_t validUntil = 0;
+}; // TlsSession
+
+// Serializes a set of TLS sessions into a versioned blob.
+void serializeTlsSessions(const std::vector<TlsSession>& sessions, std::string& data);
+
+// Restores TLS sessions serialized by serializeTlsSessions().
+//
+// Sessions that expired before `now` are dropped.
+// Returns false if the blob is malformed or of an unknown version.
+bool unserializeTlsSessions(const std::string& data,
+                            m_time_t now,
+                            std::vector<TlsSession>& sessions);
+
 } // namespace
@@ -106,6 +106,20 @@
 
 #ifdef USE_INOTIFY
     #include <sys/inotify.h>
+
+    // this flag was introduced in glibc 2.13 and Linux 2.6.36 (released October 20, 2010)
+    #ifndef IN_EXCL_UNLINK
+        #define IN_EXCL_UNLINK 0x04000000
+    #endif
+#endif
+
+// fanotify reports directory entry events with names since Linux 5.9.
+#if defined(__linux__) && !defined(__ANDROID__) && defined(USE_INOTIFY) && \
+    __has_include(<sys/fanotify.h>)
+    #include <sys/fanotify.h>
+    #ifdef FAN_REPORT_DFID_NAME
+        #define USE_FANOTIFY 1
+    #endif
 #endif
 
 #include <sys/select.h>
@@ -257,13 +257,15 @@ public:
     // uses the full file position in the Transfer object, as it used to prior to raid.
     m_off_t& transferPos(unsigned connectionNum) override;
 
-    // Get the file position to upload/download to on the specified connection
+    // Get the file position to upload/download to on the specified connection.
+    // For non-raid transfers, a non-zero targetRequestSize replaces the size heuristics.
     std::pair<m_off_t, m_off_t> nextNPosForConnection(unsigned connectionNum,
                                                       m_off_t maxDownloadRequestSize,
                                                       unsigned connectionCount,
                                                       bool& newBufferSupplied,
                                                       bool& pauseConnectionForRaid,
-                                                      m_off_t uploadspeed);
+                                                      m_off_t uploadspeed,
+                                                      m_off_t targetRequestSize = 0);
 
     TransferBufferManager();
 
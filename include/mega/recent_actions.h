@@ -27,6 +27,7 @@ namespace mega
 {
 
 class MegaClient;
+struct RecentFile;
 
 class RecentActions
 {
@@ -36,7 +37,7 @@ public:
     /**
      * @brief Fetch recent action buckets for an account.
      *
-     * Queries the node tree for recently changed files, then groups them into action
+     * Queries the DB for recently changed files, then groups them into action
      * buckets (by owner, parent, time window, media/updated flags), sorts nodes within
      * each bucket and sorts buckets by time.
      *
@@ -81,9 +82,13 @@ public:
 
 private:
     /**
-     * @brief Build a recentactions_vector from a pre-fetched node vector.
+     * @brief Build a recentactions_vector from pre-fetched files.
+     *
+     * Files are grouped by what the DB returned for them, and only the nodes of the
+     * resulting buckets are loaded.
      */
-    recentactions_vector buildFromNodes(sharedNode_vector&& v, bool excludeSensitives) const;
+    recentactions_vector buildFromFiles(const std::vector<RecentFile>& files,
+                                        bool excludeSensitives) const;
 
     /**
      * @brief Fetch candidate nodes for a recent action bucket.
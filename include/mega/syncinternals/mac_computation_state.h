@@ -63,7 +63,8 @@ struct MacComputationContext
  * @brief State for asynchronous local file MAC computation.
  *
  * Tracks progress of incremental MAC computation across sync iterations.
- * Thread-safe: sync thread reads/writes, worker thread (mAsyncQueue) computes.
+ * Thread-safe: sync thread queues ranges of the file, worker threads (mAsyncQueue)
+ * read them and compute their chunk MACs, several ranges at a time.
  *
  * Lifetime management:
  * - Owner (LocalNode::RareFields or SyncUpload_inClient) holds shared_ptr
@@ -83,20 +84,25 @@ struct MacComputationState
     std::array<byte, SymmCipher::KEYLENGTH> transferkey{};
     int64_t ctriv = 0;
 
-    // Progress tracking
-    m_off_t currentPosition = 0;
+    // Start of the next range to queue (sync thread only)
+    m_off_t nextReadPosition = 0;
 
-    // Accumulated chunk MACs - protected by mutex
+    // Accumulated chunk MACs, and the bytes they cover - protected by mutex
     mutable std::mutex macsMutex;
     chunkmac_map partialMacs;
+    m_off_t completedBytes = 0;
 
-    // Buffer size for reading chunks (10MB)
+    // Buffer size for reading ranges (10MB)
     static constexpr m_off_t BUFFER_SIZE = 10 * 1024 * 1024;
 
+    // Ranges of the same file that may be read and MACed at once
+    static constexpr unsigned MAX_RANGES_IN_FLIGHT = 4;
+
     // State flags (atomic for thread safety)
-    std::atomic<bool> chunkInProgress{false}; // True while worker processing
+    std::atomic<unsigned> rangesInFlight{0}; // Ranges queued but not yet finished
     std::atomic<bool> completed{false}; // True when local MAC computed
     std::atomic<bool> failed{false}; // True if read/compute error
+    std::atomic<bool> obsolete{false}; // True if the file changed size while being read
 
     // True when initialization is complete (first advanceMacComputation has returned).
     // Used to prevent checkPendingCloneMac from racing with initCloneCandidateMacComputation.
@@ -128,22 +134,39 @@ struct MacComputationState
     ~MacComputationState();
 
     /**
-     * @brief Thread-safe: called by worker thread when chunk MAC is computed.
+     * @brief Thread-safe: called by worker thread when the chunk MACs of a range are computed.
+     *
+     * Ranges may finish in any order.
+     *
+     * @return true if this range completed the file, so the local MAC can be computed.
      */
-    void addChunkMacs(chunkmac_map&& chunkMacs, m_off_t newPosition)
+    bool addChunkMacs(chunkmac_map&& chunkMacs, m_off_t bytes)
     {
         std::lock_guard<std::mutex> g(macsMutex);
         chunkMacs.copyEntriesTo(partialMacs);
-        currentPosition = newPosition;
+        completedBytes += bytes;
+        return completedBytes == totalSize;
     }
 
+    /**
+     * @brief Sync thread: reserve a slot and read buffer budget for the next range.
+     *
+     * @return false if the file already has MAX_RANGES_IN_FLIGHT ranges queued, or the
+     *         throttle's read budget is spent.
+     */
+    bool tryStartRange(m_off_t bytes);
+
+    /**
+     * @brief Thread-safe: release what tryStartRange() reserved, once the range is done with.
+     */
+    void finishRange(m_off_t bytes);
+
     /**
      * @brief Thread-safe: called by worker thread when local MAC computation completes.
      */
     void setComplete(const int64_t computedLocalMac)
     {
         localMac = computedLocalMac;
-        chunkInProgress.store(false, std::memory_order_release);
         completed.store(true, std::memory_order_release);
     }
 
@@ -152,16 +175,23 @@ struct MacComputationState
      */
     void setFailed()
     {
-        chunkInProgress.store(false, std::memory_order_release);
         failed.store(true, std::memory_order_release);
     }
 
     /**
-     * @brief Thread-safe: check if a chunk is currently being processed.
+     * @brief Thread-safe: called by worker thread if the file is no longer the expected size.
      */
-    bool isChunkInProgress() const
+    void setObsolete()
     {
-        return chunkInProgress.load(std::memory_order_acquire);
+        obsolete.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Thread-safe: check if any range is currently being read or processed.
+     */
+    bool hasRangesInFlight() const
+    {
+        return rangesInFlight.load(std::memory_order_acquire) > 0;
     }
 
     /**
@@ -180,6 +210,14 @@ struct MacComputationState
         return failed.load(std::memory_order_acquire);
     }
 
+    /**
+     * @brief Thread-safe: check if the file changed while being read.
+     */
+    bool isObsolete() const
+    {
+        return obsolete.load(std::memory_order_acquire);
+    }
+
     /**
      * @brief Thread-safe: check if initialization is complete.
      *
@@ -216,6 +254,9 @@ struct MacComputationState
 
 private:
     MacComputationThrottle& mThrottle;
+
+    // Read budget held by ranges in flight, given back on destruction if they never finish
+    std::atomic<m_off_t> mReservedBytes{0};
 };
 
 } // namespace mega
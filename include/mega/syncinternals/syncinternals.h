@@ -509,6 +509,9 @@ void clientDownload(MegaClient& mc,
 
 constexpr uint32_t kDefaultMaxConcurrentMacComputations = 8;
 
+// Read buffers of all MAC computations together (several ranges per file may be in flight)
+constexpr m_off_t kDefaultMacComputationReadBudget = 128 * 1024 * 1024;
+
 /**
  * @brief Throttle for MAC computation to prevent resource exhaustion.
  *
@@ -516,18 +519,21 @@ constexpr uint32_t kDefaultMaxConcurrentMacComputations = 8;
  * Prevents the sync engine from overwhelming the system with too many
  * simultaneous MAC calculations.
  *
- * We track FILES only (one chunk at a time per file).
+ * We track FILES, and the bytes of read buffers held by their ranges in flight.
  *
  * Usage:
  * - Call tryAcquireFile() before starting MAC computation for a new file
  * - Call releaseFile() when file computation completes
+ * - Call tryAcquireBytes() before queuing a range, releaseBytes() once it's done with
  */
 class MacComputationThrottle
 {
 public:
     explicit MacComputationThrottle(
-        uint32_t maxConcurrentFiles = kDefaultMaxConcurrentMacComputations):
-        mMaxConcurrentFiles(maxConcurrentFiles)
+        uint32_t maxConcurrentFiles = kDefaultMaxConcurrentMacComputations,
+        m_off_t maxBytesInFlight = kDefaultMacComputationReadBudget):
+        mMaxConcurrentFiles(maxConcurrentFiles),
+        mMaxBytesInFlight(maxBytesInFlight)
     {}
 
     bool tryAcquireFile()
@@ -561,12 +567,78 @@ public:
         return mCurrentFiles;
     }
 
+    // Always succeeds when nothing is in flight, so a range bigger than the budget still gets read
+    bool tryAcquireBytes(const m_off_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (mCurrentBytes && mCurrentBytes + bytes > mMaxBytesInFlight)
+        {
+            return false;
+        }
+
+        mCurrentBytes += bytes;
+        return true;
+    }
+
+    void releaseBytes(const m_off_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mCurrentBytes < bytes)
+        {
+            assert(false && "MacComputationThrottle: releaseBytes called for more bytes than are "
+                            "in flight");
+            mCurrentBytes = 0;
+            return;
+        }
+        mCurrentBytes -= bytes;
+    }
+
+    m_off_t currentBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mCurrentBytes;
+    }
+
 private:
     mutable std::mutex mMutex;
     uint32_t mMaxConcurrentFiles;
     uint32_t mCurrentFiles{0};
+    m_off_t mMaxBytesInFlight;
+    m_off_t mCurrentBytes{0};
 };
 
+/**
+ * @brief Result of advanceMacComputation.
+ */
+enum class MacAdvanceResult
+{
+    Pending, // Ranges queued or in progress
+    Ready, // Local MAC is computed (check state->localMac)
+    Obsolete, // Local file changed; discard state and rescan
+    Failed // Error occurred
+};
+
+/**
+ * @brief Advance local file MAC computation.
+ *
+ * This is the shared core for both CSF and clone candidate MAC computation.
+ * It queues the following ranges of the file to mAsyncQueue, up to
+ * MacComputationState::MAX_RANGES_IN_FLIGHT at once and within the read budget
+ * of the state's throttle. The workers read the ranges and compute their chunk
+ * MACs in parallel, so the sync thread never blocks on the file.
+ *
+ * @param mc MegaClient for file access and async queue.
+ * @param state The MAC computation state (must have cipher params initialized).
+ *              Passed by value to ensure the state stays alive during the function,
+ *              even if another thread resets the original shared_ptr.
+ * @param logPrefix Prefix for log messages.
+ * @return MacAdvanceResult indicating current state.
+ */
+MacAdvanceResult advanceMacComputation(MegaClient& mc,
+                                       std::shared_ptr<MacComputationState> state,
+                                       const std::string& logPrefix);
+
 enum class FingerprintMismatch : std::uint8_t
 {
     None = 0,
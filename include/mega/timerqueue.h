@@ -0,0 +1,95 @@
+/**
+ * @file mega/timerqueue.h
+ * @brief High-resolution timers run from the client's event loop
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace mega
+{
+
+// One-shot callbacks due at a point on the steady clock, kept in a heap.
+//
+// Unlike BackoffTimer, which counts in deciseconds and is polled by
+// preparewait(), a TimerQueue can be asked for its next deadline with
+// sub-millisecond precision, so the waiter can sleep exactly until then and
+// no longer. Used from a single thread (the client's).
+class TimerQueue
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+    using TimerId = uint64_t;
+
+    // Run callback once delay has elapsed, at the next fire() after that
+    TimerId schedule(Clock::duration delay, Callback callback);
+
+    // Stops a timer from firing. Returns false if it already fired or was cancelled.
+    bool cancel(TimerId id);
+
+    // Runs every callback that is due, in deadline order. Timers that those
+    // callbacks schedule run at a later fire(). Returns how many ran.
+    size_t fire(Clock::time_point now = Clock::now());
+
+    // How long until the next timer is due (zero if one is overdue), if any is pending
+    std::optional<Clock::duration> timeUntilNext(Clock::time_point now = Clock::now());
+
+    bool empty() const
+    {
+        return mCallbacks.empty();
+    }
+
+    size_t size() const
+    {
+        return mCallbacks.size();
+    }
+
+private:
+    struct Entry
+    {
+        Clock::time_point due;
+        TimerId id;
+
+        // ties are broken by id, so timers due at once fire in the order they were scheduled
+        bool operator>(const Entry& other) const
+        {
+            return due != other.due ? due > other.due : id > other.id;
+        }
+    };
+
+    // Drops cancelled entries from the top of the heap
+    void discardCancelled();
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> mHeap;
+
+    // Cancelling erases here only; the heap entry is dropped when it reaches the top
+    std::unordered_map<TimerId, Callback> mCallbacks;
+
+    TimerId mNextId = 1;
+};
+
+} // namespace mega
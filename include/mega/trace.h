@@ -0,0 +1,105 @@
+/**
+ * @file mega/trace.h
+ * @brief Record spans of time spent in the SDK, for viewing as a trace
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace mega::trace
+{
+
+// Tracing is off unless started, and each span then costs a single check.
+//
+// While tracing, each thread appends the spans it completes to its own buffer,
+// without locking, and the buffers are gathered when the trace is exported.
+// A thread keeps up to MAX_EVENTS_PER_THREAD spans per trace, dropping any
+// further ones.
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+extern std::atomic<bool> g_tracing;
+
+inline bool enabled()
+{
+    return g_tracing.load(std::memory_order_relaxed);
+}
+
+// Discard any previous trace and start recording a new one.
+void start();
+
+// Stop recording. The trace is kept until exported or restarted.
+void stop();
+
+// The trace recorded since the last start(), in the Chrome trace event
+// format, which both chrome://tracing and the Perfetto UI can open.
+std::string chromeJson();
+
+// Name shown for the calling thread in subsequent traces.
+void setThreadName(const std::string& name);
+
+// Returns a copy of name that lives as long as the process, so spans
+// outlive whatever they were named after.
+const char* intern(const std::string& name);
+
+// Add a span to the calling thread's buffer.
+void record(const char* name, Clock::time_point begin, Clock::time_point end);
+
+// Records the enclosing block as a span, when tracing.
+class Span
+{
+public:
+    explicit Span(const char* name)
+    {
+        if (enabled())
+        {
+            mName = name;
+            mBegin = Clock::now();
+        }
+    }
+
+    ~Span()
+    {
+        complete();
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    // can be called early, in which case the destructor's call is ignored
+    void complete()
+    {
+        if (mName)
+        {
+            record(mName, mBegin, Clock::now());
+            mName = nullptr;
+        }
+    }
+
+private:
+    const char* mName = nullptr;
+    Clock::time_point mBegin;
+};
+
+} // namespace mega::trace
@@ -27,6 +27,7 @@
 #include "filefingerprint.h"
 #include "http.h"
 #include "raid.h"
+#include "timerqueue.h"
 
 #include <variant>
 
@@ -47,6 +48,7 @@ struct TransferCategory
 };
 
 class TransferDbCommitter;
+class TransferScheduler;
 
 #ifdef ENABLE_SYNC
 class TransferBackstop
@@ -274,9 +276,12 @@ public:
     transfer_list::iterator begin(direction_t direction);
     transfer_list::iterator end(direction_t direction);
     bool getIterator(Transfer *transfer, transfer_list::iterator&, bool canHandleErasedElements = false);
+    // If a scheduler is given, it orders every ready transfer before continuefunction picks
+    // the ones to start, rather than taking them in queue order.
     std::array<vector<Transfer*>, 6> nexttransfers(std::function<bool(Transfer*)>& continuefunction,
 	                                               std::function<bool(direction_t)>& directionContinuefunction,
-                                                   TransferDbCommitter& committer);
+                                                   TransferDbCommitter& committer,
+                                                   const TransferScheduler* scheduler = nullptr);
     Transfer *transferat(direction_t direction, unsigned int position);
 
     std::array<transfer_list, 2> transfers;
@@ -1253,7 +1258,9 @@ struct MEGA_API DirectReadNode
     MegaClient* client;
 
     handledrn_map::iterator hdrn_it;
-    dsdrn_map::iterator dsdrn_it;
+
+    // the client's timer for the next retry or dispatch, if any
+    TimerQueue::TimerId mScheduledTimer = 0;
 
     // API command result
     void cmdresult(const Error&, dstime = 0);
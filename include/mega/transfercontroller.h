@@ -0,0 +1,141 @@
+/**
+ * @file mega/transfercontroller.h
+ * @brief Adapt a transfer's connections and request size to the measured throughput
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace mega
+{
+
+// Decides how many connections a transfer keeps busy and how big its requests
+// are, from the delivery rate and time to first byte of completed requests.
+//
+// Loosely modelled on BBR. The transfer progresses in rounds, a round ending
+// once as many requests have completed as connections were busy when it
+// began. During startup the connections are doubled for as long as the
+// delivery rate of each round keeps growing. Once it plateaus, the controller
+// settles on the connections that reached the best rate, backs off when
+// requests fail or the time to first byte inflates (a sign that queues are
+// building up along the path) and periodically probes with an extra
+// connection, keeping it only if the rate improves.
+//
+// Requests are sized to take a couple of seconds at the rate measured per
+// connection, and no less than several times the time to first byte, so that
+// the cost of each request is amortized without making timeouts likely.
+//
+// Time is supplied by the caller, so the controller can be driven by a
+// simulation as well as by a real transfer.
+class MEGA_API AdaptiveTransferController
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum Phase
+    {
+        STARTUP,
+        STEADY
+    };
+
+    struct Limits
+    {
+        unsigned minConnections = 1;
+        unsigned maxConnections = 1;
+        m_off_t minRequestSize = 0;
+        m_off_t maxRequestSize = 0;
+    };
+
+    AdaptiveTransferController(const Limits& limits, Clock::time_point now);
+
+    // A request has been posted on connection.
+    void requestStarted(unsigned connection, Clock::time_point now);
+
+    // The request on connection delivered bytes, the first of them after firstByte.
+    void requestCompleted(unsigned connection,
+                          m_off_t bytes,
+                          std::optional<std::chrono::milliseconds> firstByte,
+                          Clock::time_point now);
+
+    // The request on connection failed or timed out.
+    void requestFailed(unsigned connection, Clock::time_point now);
+
+    // Number of connections that should have a request in flight.
+    unsigned connections() const;
+
+    // Size of new requests, or 0 while there is no estimate yet.
+    m_off_t requestSize() const;
+
+    // Best delivery rate of recent rounds, in bytes per second.
+    m_off_t bandwidth() const;
+
+    // Lowest recent time to first byte, if any has been measured.
+    std::optional<std::chrono::milliseconds> minFirstByte() const;
+
+    Phase phase() const;
+
+    // Number of rounds completed so far.
+    unsigned rounds() const;
+
+private:
+    void completed(unsigned connection, Clock::time_point now);
+    void endRound(Clock::time_point now);
+    void setConnections(unsigned connections, const char* reason);
+    void updateRequestSize(bool failed);
+
+    Limits mLimits;
+    Phase mPhase = STARTUP;
+    unsigned mConnections = 1;
+    m_off_t mRequestSize = 0;
+    m_off_t mRequestSizeCap = 0;
+
+    // When the request in flight on each connection was started.
+    std::vector<std::optional<Clock::time_point>> mStarted;
+
+    // Current round.
+    Clock::time_point mRoundStart;
+    unsigned mRoundLength = 1;
+    unsigned mRoundCompletions = 0;
+    unsigned mRoundFailures = 0;
+    m_off_t mRoundBytes = 0;
+    std::vector<std::chrono::milliseconds> mRoundFirstBytes;
+    unsigned mRounds = 0;
+
+    // Delivery rate of recent rounds and recent times to first byte.
+    std::deque<m_off_t> mRates;
+    std::deque<std::chrono::milliseconds> mFirstBytes;
+
+    // Startup.
+    m_off_t mFullRate = 0;
+    unsigned mFullRateConnections = 1;
+    unsigned mPlateauRounds = 0;
+
+    // Steady state.
+    unsigned mRoundsSinceProbe = 0;
+    bool mProbing = false;
+    m_off_t mRateBeforeProbe = 0;
+}; // AdaptiveTransferController
+
+} // mega
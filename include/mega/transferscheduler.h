@@ -0,0 +1,153 @@
+/**
+ * @file mega/transferscheduler.h
+ * @brief Decide which queued transfers get a slot, and how many slots to use
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include <array>
+#include <vector>
+
+namespace mega
+{
+
+// Orders the transfers that are ready to start, and bounds the number of
+// transfer slots by the throughput they achieve.
+//
+// Transfers belong to flows (those started by the app and those started by
+// syncs). Once weights are set, flows share the slots through weighted fair
+// queuing: each flow is charged the bytes of the transfers it starts (plus a
+// fixed cost per transfer) divided by its weight, and the flow that has been
+// charged the least goes next. Within a flow, transfers keep their queue
+// order or go smallest first, depending on the policy.
+//
+// With adaptive slots, the number of slots only grows while doing so
+// increases the aggregate throughput.
+class MEGA_API TransferScheduler
+{
+public:
+    enum Policy
+    {
+        // Queue order, as set by the priorities of the transfers.
+        POLICY_PRIORITY,
+
+        // Smallest files first.
+        POLICY_SMALLEST_FIRST,
+
+        // Least bytes left first, so that resumed transfers count what they lack.
+        POLICY_SHORTEST_REMAINING
+    };
+
+    enum Flow
+    {
+        FLOW_APP,
+        FLOW_SYNC,
+        NUM_FLOWS
+    };
+
+    struct Job
+    {
+        Flow flow = FLOW_APP;
+        m_off_t size = 0;
+        m_off_t remaining = 0;
+    };
+
+    // Cost charged to a flow for each transfer it starts, besides its bytes.
+    static const m_off_t TRANSFER_COST;
+
+    // Bounds of the slot limit when slots are adaptive.
+    static const unsigned MIN_SLOTS;
+    static const unsigned INITIAL_SLOTS;
+
+    // Slots added when probing for more throughput.
+    static const unsigned SLOT_STEP;
+
+    // Time between throughput samples (deciseconds).
+    static const dstime SAMPLE_INTERVAL;
+
+    // Samples to wait after a probe that didn't pay off.
+    static const unsigned PROBE_HOLDOFF;
+
+    // Ready transfers considered at once in each direction, from the head of the queue,
+    // so that long queues don't have to be walked and sorted on every dispatch.
+    static const size_t CANDIDATE_WINDOW;
+
+    explicit TransferScheduler(unsigned maxSlots);
+
+    void setPolicy(Policy policy);
+    Policy policy() const;
+
+    // Share of the slots of each flow relative to the others (at least 1).
+    // Setting any weight enables fair queuing between flows.
+    void setWeight(Flow flow, unsigned weight);
+    unsigned weight(Flow flow) const;
+
+    // Stop fair queuing: flows share the queue order again.
+    void clearWeights();
+
+    void setAdaptiveSlots(bool enable);
+    bool adaptiveSlots() const;
+
+    // Order in which jobs should be given a slot, as indices into jobs.
+    std::vector<size_t> order(const std::vector<Job>& jobs) const;
+
+    // A job has been given a slot.
+    void started(const Job& job);
+
+    // Whether small files should be considered before large ones.
+    bool smallFilesFirst() const;
+
+    // Report the slots in use and the aggregate throughput.
+    void sample(unsigned slots, m_off_t bytesPerSecond, dstime now);
+
+    // How many slots can be in use.
+    unsigned slotLimit() const;
+
+    // Helpers for the client's transfers.
+    static Job job(const Transfer& transfer);
+    void schedule(std::vector<Transfer*>& transfers) const;
+
+    // Whether schedule() changes the queue order at all.
+    bool reordersQueue() const;
+
+private:
+    double cost(const Job& job) const;
+
+    Policy mPolicy = POLICY_PRIORITY;
+    std::array<unsigned, NUM_FLOWS> mWeights;
+    bool mFairQueuing = false;
+
+    // Virtual bytes charged to each flow, and the start tag of the last job started.
+    std::array<double, NUM_FLOWS> mService{};
+    double mVirtualTime = 0;
+
+    // Slot governor.
+    bool mAdaptiveSlots = false;
+    unsigned mMaxSlots;
+    unsigned mSlotLimit;
+    dstime mLastSample = 0;
+    bool mSampled = false;
+    bool mProbing = false;
+    m_off_t mSpeedBeforeProbe = 0;
+    unsigned mHoldoff = 0;
+}; // TransferScheduler
+
+} // mega
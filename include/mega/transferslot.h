@@ -27,6 +27,7 @@
 #include "node.h"
 #include "backofftimer.h"
 #include "raid.h"
+#include "transfercontroller.h"
 
 namespace mega {
 
@@ -104,6 +105,9 @@ struct MEGA_API TransferSlot
     // maximum gap between chunks for uploads
     static const m_off_t MAX_GAP_SIZE;
 
+    // min request size chosen by the adaptive controller
+    static const m_off_t MIN_ADAPTIVE_REQ_SIZE;
+
     m_off_t maxRequestSize;
 
     m_off_t progressreported;
@@ -123,6 +127,11 @@ struct MEGA_API TransferSlot
     int connections;
     vector<std::shared_ptr<HttpReqXfer>> reqs;
 
+    // Adapts the connections in use and the request size to the measured throughput.
+    // Only set for non-raid transfers when MegaClient::mAdaptiveTransfers is enabled, in which
+    // case connections is the most that can be used.
+    std::unique_ptr<AdaptiveTransferController> mAdaptiveController;
+
     // Keep track of transfer network speed per channel, and overall
     vector<SpeedController> mReqSpeeds;
     SpeedController mTransferSpeed;
@@ -50,6 +50,9 @@ public:
         double mLatency{}; // Latency of the transfer (in milliseconds).
         double mFailedRequestRatio{}; // Number of failed requests during the transfer.
         bool mIsRaided{}; // Flag indicating if the transfer is raided (true) or not (false).
+        unsigned mConnections{}; // Connections the transfer ended up using.
+        m_off_t mRequestSize{}; // Request size chosen for an adaptive transfer (in bytes), 0 if
+                                // the transfer wasn't adaptive.
         std::chrono::steady_clock::time_point
             mTimestamp{}; // Timestamp indicating when the transfer was added.
 
@@ -78,6 +81,9 @@ public:
         double
             mFailedRequestRatio{}; // Ratio of failed requests to total requests, between 0 and 1.
         double mRaidedTransferRatio{}; // Ratio of raided transfers in the set, between 0 and 1.
+        double mAvgConnections{}; // Average number of connections used by the transfers.
+        m_off_t mMedianRequestSize{}; // Median request size of the adaptive transfers (in bytes).
+                                      // Informative, not sent with the rest of the metrics.
         size_t mNumTransfers{}; // Number of transfers used to calculate these metrics. Informative,
                                 // not used for stats analysis.
 
@@ -121,6 +127,8 @@ public:
      * @param TransferData::mFailedRequestRatio Number of failed requests
      *     divided by the number of total requests.
      * @param TransferData::mIsRaided Boolean indicating whether the transfer was raided.
+     * @param TransferData::mConnections Number of connections used by the transfer (optional).
+     * @param TransferData::mRequestSize Request size chosen for an adaptive transfer (optional).
      *
      * The TransferData::timestamp field will be assigned during the operation.
      *
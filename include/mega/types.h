@@ -64,8 +64,10 @@ namespace mega {
 #endif
 
 #include "mega/crypto/sodium.h"
+#include "mega/trace.h"
 #include "mega/user_attribute_types.h"
 
+#include <array>
 #include <chrono>
 #include <memory>
 #include <mutex>
@@ -771,7 +773,6 @@ struct StringCmp
 };
 
 typedef map<handle, DirectReadNode*> handledrn_map;
-typedef multimap<dstime, DirectReadNode*> dsdrn_map;
 typedef list<DirectRead*> dr_list;
 typedef list<DirectReadSlot*> drs_list;
 
@@ -931,6 +932,7 @@ namespace CodeCounter
     // Some classes that allow us to easily measure the number of times a block of code is called, and the sum of the time it takes.
     // Only enabled if MEGA_MEASURE_CODE is turned on.
     // Usage generally doesn't need to be protected by the macro as the classes and methods will be empty when not enabled.
+    // Independently of the macro, each ScopeTimer is recorded as a trace span while tracing (see mega/trace.h).
 
     using namespace std::chrono;
 
@@ -943,7 +945,15 @@ namespace CodeCounter
         high_resolution_clock::duration timeSpent{};
         high_resolution_clock::duration longest{};
         std::string name;
-        ScopeStats(std::string s) : name(std::move(s)) {}
+        const char* traceName;
+        ScopeStats(std::string s) : name(std::move(s)), traceName(trace::intern(name)) {}
+
+        // how many blocks took up to each of the BUCKET_BOUNDS, and longer than the last
+        static constexpr size_t NUM_BUCKETS = 8;
+        static constexpr microseconds BUCKET_BOUNDS[NUM_BUCKETS - 1] = {
+            microseconds(100), microseconds(1000), microseconds(10000), microseconds(100000),
+            microseconds(1000000), microseconds(10000000), microseconds(100000000)};
+        std::array<uint64_t, NUM_BUCKETS> buckets{};
 
         inline string report(bool reset = false)
         {
@@ -957,11 +967,33 @@ namespace CodeCounter
                 finishes = 0;
                 timeSpent = high_resolution_clock::duration{};
                 longest = high_resolution_clock::duration{};
+                buckets.fill(0);
             }
             return s;
         }
+
+        inline void record(high_resolution_clock::duration spent)
+        {
+            ++count;
+            ++finishes;
+            timeSpent += spent;
+            if (spent > longest) longest = spent;
+
+            size_t i = 0;
+            while (i < NUM_BUCKETS - 1 && spent > BUCKET_BOUNDS[i]) ++i;
+            ++buckets[i];
+        }
+
+        // for blocks timed on other threads, reported here afterwards
+        inline void add(high_resolution_clock::duration spent)
+        {
+            ++starts;
+            record(spent);
+        }
 #else
-        ScopeStats(std::string) {}
+        const char* traceName;
+        ScopeStats(std::string s) : traceName(trace::intern(s)) {}
+        inline void add(high_resolution_clock::duration) {}
 #endif
     };
 
@@ -988,13 +1020,16 @@ namespace CodeCounter
 
     struct ScopeTimer
     {
+        // also recorded as a span when tracing, whether or not MEGA_MEASURE_CODE is on
+        trace::Span span;
+
 #ifdef MEGA_MEASURE_CODE
         ScopeStats& scope;
         high_resolution_clock::time_point blockStart;
         high_resolution_clock::duration diff{};
         bool done = false;
 
-        ScopeTimer(ScopeStats& sm) : scope(sm), blockStart(high_resolution_clock::now())
+        ScopeTimer(ScopeStats& sm) : span(sm.traceName), scope(sm), blockStart(high_resolution_clock::now())
         {
             ++scope.starts;
         }
@@ -1011,17 +1046,15 @@ namespace CodeCounter
             // can be called early in which case the destructor's call is ignored
             if (!done)
             {
-                ++scope.count;
-                ++scope.finishes;
                 diff = high_resolution_clock::now() - blockStart;
-                scope.timeSpent += diff;
-                if (diff > scope.longest) scope.longest = diff;
+                scope.record(diff);
                 done = true;
             }
+            span.complete();
         }
 #else
-        ScopeTimer(ScopeStats&) {}
-        void complete() {}
+        ScopeTimer(ScopeStats& sm) : span(sm.traceName) {}
+        void complete() { span.complete(); }
 #endif
     };
 }
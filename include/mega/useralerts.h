@@ -590,6 +590,10 @@ private:
     void clearNotedSharedMembers();
 
     void trimAlertsToMaxCount(); // mark as removed the excess from 200
+
+    // serialize and encrypt, on the client's worker threads, the alerts about to be persisted
+    template<class AlertContainer>
+    void encodeAlerts(const AlertContainer& container);
     void notifyAlert(UserAlert::Base* alert, bool seen, int tag);
 
     UserAlert::Base* findAlertToCombineWith(const UserAlert::Base* a, nameid t) const;
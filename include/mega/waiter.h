@@ -23,6 +23,8 @@
 #define MEGA_WAITER_H 1
 
 #include <atomic>
+#include <chrono>
+#include <limits>
 
 #include "types.h"
 
@@ -48,24 +50,30 @@ struct MEGA_API Waiter
     // current time (processwide)
     static std::atomic<dstime> ds;
 
-    // set ds to current time
+    // set ds to current time (never moves it backwards if several threads race)
     static void bumpds();
 
-    // This mutex protects concurrent updates of the value stored by the atomic "ds" 
-    // when multiple threads are in bumpds()
-    static std::mutex dsMutex;
-
     // wait ceiling
     std::atomic<dstime> maxds;
 
+    // wait ceiling for events due sooner than a whole decisecond (NEVER_MS if none)
+    static constexpr int64_t NEVER_MS = std::numeric_limits<int64_t>::max();
+    std::atomic<int64_t> maxms{NEVER_MS};
+
     // begin waiting cycle with timeout
     virtual void init(dstime);
 
+    // lower the wait ceiling to the given number of milliseconds
+    void wakeupwithin(std::chrono::milliseconds);
+
+    // effective wait ceiling in milliseconds, or -1 to wait until woken
+    int64_t timeoutms() const;
+
     // add wakeup events
     void wakeupby(EventTrigger*, int);
 
-    // wait for all added wakeup criteria (plus the host app's own), up to the
-    // specified number of deciseconds
+    // wait for all added wakeup criteria (plus the host app's own), up to
+    // timeoutms()
     virtual int wait() = 0;
 
     // force a wakeup
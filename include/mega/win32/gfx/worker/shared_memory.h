@@ -0,0 +1,66 @@
+#pragma once
+
+#include "mega/types.h"
+
+#include <memory>
+#include <string>
+
+namespace mega {
+namespace gfx {
+
+/**
+ * @brief A region of memory shared between the client and the gfx worker, backed by a
+ * file mapping in the Local namespace.
+ *
+ * The client creates it with a unique name and passes that name along with a
+ * command, so that the worker can write large results directly into it rather
+ * than through the pipe.
+ */
+class SharedMemory
+{
+public:
+    /**
+     * @brief Create a new uniquely named region
+     * @param size The size of the region in bytes.
+     * @return The region or nullptr on failure. The region is removed once destroyed.
+     */
+    static std::unique_ptr<SharedMemory> create(size_t size);
+
+    /**
+     * @brief Map a region created by another process
+     * @param name The name of the region as returned by name().
+     * @param size The size of the region in bytes.
+     * @return The region or nullptr on failure.
+     */
+    static std::unique_ptr<SharedMemory> open(const std::string& name, size_t size);
+
+    SharedMemory(const SharedMemory&) = delete;
+
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    ~SharedMemory();
+
+    const std::string& name() const { return mName; }
+
+    char* data() const { return mData; }
+
+    size_t size() const { return mSize; }
+
+private:
+    SharedMemory(const std::string& name, HANDLE mapping, void* data, size_t size);
+
+    static bool isValidName(const std::string& name);
+
+    static std::string newName();
+
+    std::string mName;
+
+    char* mData;
+
+    size_t mSize;
+
+    HANDLE mMapping;
+};
+
+} // namespace gfx
+} // namespace mega
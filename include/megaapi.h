@@ -11007,6 +11007,18 @@ public:
      * for other uploads keep the default value to avoid interfering with internal logic.
      */
     char pitagTarget = PITAG_TARGET_NOT_APPLICABLE;
+
+    /**
+     * For folder uploads: if true, the local tree is scanned by several threads, folders are
+     * created in MEGA as soon as they are found, and the files of each folder start uploading
+     * as soon as that folder exists, instead of each of these stages waiting for the previous
+     * one to finish for the whole tree.
+     *
+     * The stages reported by MegaTransferListener::onTransferUpdate for the folder transfer
+     * then overlap: STAGE_TRANSFERRING_FILES is still only reported once every file has been
+     * queued, but file transfers can start and finish before it.
+     */
+    bool pipelineFolderUpload = false;
 };
 
 /**
@@ -11312,6 +11324,13 @@ class MegaApi
             TRANSFER_STATS_MAX = TRANSFER_STATS_BOTH,
         };
 
+        enum
+        {
+            TRANSFER_SCHEDULING_PRIORITY = 0,
+            TRANSFER_SCHEDULING_SMALLEST_FIRST = 1,
+            TRANSFER_SCHEDULING_SHORTEST_REMAINING = 2,
+        };
+
         /**
          * @enum ActionType
          * @brief Enumeration representing different types of trigger actions for surveys.
@@ -11775,6 +11794,44 @@ class MegaApi
          */
         void setDnsServers(const char *dnsServers, MegaRequestListener* listener = NULL);
 
+        /**
+         * @brief Enable or disable the persistence of TLS sessions
+         *
+         * When enabled, the TLS sessions negotiated with MEGA servers are saved in a cache
+         * file inside the base path of this MegaApi, and loaded again the next time this
+         * function is called with enable = true. Connections after a restart can then resume
+         * those sessions instead of doing a full TLS handshake, reducing the latency of the
+         * first requests and transfers.
+         *
+         * The cache file contains the secrets of the saved sessions, so the base path should
+         * be a location that only the app can access. Disabling the persistence removes the
+         * cache file.
+         *
+         * This feature requires a curl library with support for exporting TLS sessions
+         * (curl 8.12 or newer). Otherwise this function returns false.
+         *
+         * @param enable True to persist TLS sessions, false to stop persisting them
+         * @return True if the setting was applied
+         */
+        bool setTlsSessionPersistence(bool enable);
+
+        /**
+         * @brief Enable or disable HTTP/2 for the connections to MEGA servers
+         *
+         * When enabled, HTTP/2 is negotiated with the servers that support it, and concurrent
+         * requests to the same server (for example, the chunks of parallel transfers) are
+         * multiplexed over a shared connection instead of each one opening its own. Servers
+         * that don't support HTTP/2 keep being used over HTTP/1.1, and the SDK falls back to
+         * HTTP/1.1 for a server after several consecutive HTTP/2 protocol errors.
+         *
+         * HTTP/2 is disabled by default. The setting applies to new requests.
+         *
+         * @param enable True to enable HTTP/2, false to use HTTP/1.1 only
+         * @return True if the setting was applied, false if the curl library in use
+         * was built without HTTP/2 support
+         */
+        bool setHttp2(bool enable);
+
         /**
          * @brief Check if server-side Rubbish Bin autopurging is enabled for the current account
          *
@@ -17024,6 +17081,12 @@ class MegaApi
          *
          * For more information about MegaTransfer stages please refer to onTransferUpdate documentation.
          *
+         * Folders from the account (that is, other than foreign nodes such as those of a public
+         * folder link that isn't logged into) are downloaded as their tree is read: each local folder
+         * is created, and its files start downloading, as soon as it has been found. So file transfers
+         * can start and finish during MegaTransfer::STAGE_SCAN, and MegaTransfer::STAGE_CREATE_TREE
+         * is reported once the whole tree exists locally.
+         *
          * @param node MegaNode that identifies the file or folder
          * @param localPath Destination path for the file or folder
          * If this path is a local folder, it must end with a '\' or '/' character and the file name
@@ -17492,6 +17555,80 @@ class MegaApi
          */
         void setMaxConnections(int connections, MegaRequestListener* listener = NULL);
 
+        /**
+         * @brief Adapt the connections and request size of each transfer to its throughput
+         *
+         * When enabled, transfers that aren't served from several storage servers (raid) start
+         * with few connections and add more only while that increases the measured throughput,
+         * backing off when requests fail or the time to the first byte grows. The size of each
+         * request follows the throughput measured per connection.
+         *
+         * The number of connections set with MegaApi::setMaxConnections remains the upper bound.
+         * The change applies to transfers that start after this call. It's disabled by default.
+         *
+         * @param enable True to adapt transfers to their throughput, false to use fixed values
+         */
+        void setAdaptiveTransfers(bool enable);
+
+        /**
+         * @brief Choose the order in which queued transfers start
+         *
+         * Valid values for the policy are:
+         * - MegaApi::TRANSFER_SCHEDULING_PRIORITY = 0
+         * Transfers start in queue order, as set by their priority (MegaApi::moveTransferUp and
+         * the like). This is the default.
+         * - MegaApi::TRANSFER_SCHEDULING_SMALLEST_FIRST = 1
+         * Small files start before large ones, so that many small files aren't held back by a few
+         * large ones.
+         * - MegaApi::TRANSFER_SCHEDULING_SHORTEST_REMAINING = 2
+         * Transfers with the fewest bytes left start first, counting what resumed transfers have
+         * already transferred.
+         *
+         * @param policy Scheduling policy
+         * @return False if the policy isn't valid
+         */
+        bool setTransferSchedulingPolicy(int policy);
+
+        /**
+         * @brief Share the transfer slots between the app and syncs
+         *
+         * Once set, transfers started by the app and by syncs take turns to start, each getting
+         * a share of the transferred bytes proportional to its weight. For example, weights 1 and
+         * 3 give syncs about three times the bandwidth of the app's transfers while both have
+         * transfers queued. By default, no share is enforced and transfers start as the
+         * scheduling policy dictates.
+         *
+         * Pass 0 for both weights to stop enforcing a share.
+         *
+         * @param appWeight Weight of the transfers started by the app (at least 1, or 0 to stop)
+         * @param syncWeight Weight of the transfers started by syncs (at least 1, or 0 to stop)
+         * @return False if any weight is less than 1, unless both are 0
+         */
+        bool setTransferWeights(int appWeight, int syncWeight);
+
+        /**
+         * @brief Only open more transfer slots while that increases throughput
+         *
+         * When enabled, fewer transfers run at once to begin with, and more are allowed only if
+         * the aggregate throughput grows with them. The limit never exceeds the usual maximum of
+         * concurrent transfers. It's disabled by default.
+         *
+         * @param enable True to adapt the concurrent transfers to the throughput
+         */
+        void setAdaptiveTransferSlots(bool enable);
+
+        /**
+         * @brief Complete small uploads to the same folder together
+         *
+         * When enabled, the nodes of uploads up to 128 KB that finish at about the same time and
+         * go to the same folder are created with a single request, rather than one each. Every
+         * transfer still finishes, successfully or not, with its own callbacks. This saves round
+         * trips when uploading many small files, as backups often do. It's disabled by default.
+         *
+         * @param enable True to complete small uploads together
+         */
+        void setSmallUploadBatching(bool enable);
+
         /**
          * @brief Get the maximum number of connections per upload transfer.
          *
@@ -21104,6 +21241,60 @@ class MegaApi
          */
         bool isOnline();
 
+        /**
+         * @brief Get the SDK's statistics in the OpenMetrics text format
+         *
+         * These include:
+         * - Statistics of the latest uploads and downloads, with a "direction" label
+         * - The files, folders and transfers of each running sync, with a "sync" label
+         *   holding the sync's backup ID
+         * - When the SDK is built with MEGA_MEASURE_CODE, the count, total time,
+         *   latency histogram and longest duration of its instrumented blocks of
+         *   code, with a "scope" label
+         *
+         * See MegaApi::metricsServerStart to have these served over HTTP.
+         *
+         * You take the ownership of the returned value. Use delete [] to free it.
+         *
+         * @return The statistics, ending with "# EOF"
+         */
+        char* getMetrics();
+
+        /**
+         * @brief Start recording a trace of the time spent in the SDK
+         *
+         * While tracing, each execution of the SDK's instrumented blocks of code
+         * (the phases of its event loop, the processing of API command batches and
+         * action packets, sync passes, database commits, transfer I/O and others)
+         * is recorded as a span on the thread that ran it. Each thread keeps up to
+         * a million spans.
+         *
+         * Any trace recorded previously is discarded.
+         *
+         * @see MegaApi::stopTracing, MegaApi::exportTrace
+         */
+        void startTracing();
+
+        /**
+         * @brief Stop recording the trace started by MegaApi::startTracing
+         *
+         * The trace is kept, so that it can still be exported.
+         */
+        void stopTracing();
+
+        /**
+         * @brief Save the trace recorded since MegaApi::startTracing to a file
+         *
+         * The trace is written in the Chrome trace event format (JSON), which can be
+         * opened with the Perfetto UI (https://ui.perfetto.dev) or chrome://tracing.
+         *
+         * Tracing may still be in progress.
+         *
+         * @param localPath Path of the file to write, which is replaced if it exists
+         * @return true if the trace was written, otherwise false
+         */
+        bool exportTrace(const char* localPath);
+
 #ifdef HAVE_LIBUV
 
         enum {
@@ -21797,6 +21988,39 @@ class MegaApi
          */
         int ftpServerGetMaxOutputSize();
 
+        /**
+         * @brief Start an HTTP server serving the SDK's statistics
+         *
+         * The statistics are those returned by MegaApi::getMetrics, served at
+         * http://127.0.0.1:<port>/metrics in the OpenMetrics text format, for
+         * monitoring systems such as Prometheus to scrape.
+         *
+         * If this function returns true, that means that the server is
+         * ready to accept connections. The initialization is synchronous.
+         *
+         * @param localOnly true to listen on 127.0.0.1 only, false to listen on all network
+         * interfaces
+         * @param port Port in which the server must accept connections. A free port is selected if
+         * it is 0.
+         * @param useIPv6 true to use [::1] as host, false to use 127.0.0.1
+         * @return True if the server is ready, false if the initialization failed
+         */
+        bool metricsServerStart(bool localOnly = true, int port = 9464, bool useIPv6 = false);
+
+        /**
+         * @brief Stop the HTTP server serving the SDK's statistics
+         *
+         * When this function returns, the server is already shutdown.
+         * If the server isn't running, this functions does nothing
+         */
+        void metricsServerStop();
+
+        /**
+         * @brief Check if the HTTP server serving the SDK's statistics is running
+         * @return 0 if the server is not running. Otherwise the port in which it's listening to
+         */
+        int metricsServerIsRunning();
+
 #endif
 
         /**
@@ -111,6 +111,7 @@ class MegaTCPServer;
 class MegaHTTPServer;
 class MegaFTPServer;
 class MegaFTPDataServer;
+class MegaMetricsServer;
 #endif
 
 typedef std::vector<int8_t> MegaSmallIntVector;
@@ -238,7 +239,7 @@ public:
     bool isCancelledByFolderTransferToken() const;
 
     // check if we have received onTransferFinishCallback for every transfersTotalCount
-    bool allSubtransfersResolved()              { return  transfersFinishedCount >= transfersTotalCount; }
+    bool allSubtransfersResolved()              { return  !mMoreSubtransfersToCome && transfersFinishedCount >= transfersTotalCount; }
 
     // setter/getter for transfersTotalCount
     void setTransfersTotalCount (size_t count)  { transfersTotalCount = count; }
@@ -259,6 +260,9 @@ protected:
     // number of sub-transfers finished with an error
     uint64_t mIncompleteTransfers = 0;
 
+    // error that stopped queueing sub-transfers, reported once the last of them finishes
+    Error mQueueingError = API_OK;
+
     // number of sub-transfers expected to be transferred (size of TransferQueue provided to sendPendingTransfers)
     // in case we detect that user cancelled recursive operation (via cancel token) at sendPendingTransfers,
     // those sub-transfers not processed yet (startxfer not called) will be discounted from transfersTotalCount
@@ -273,6 +277,9 @@ protected:
     // flag to notify STAGE_TRANSFERRING_FILES to apps, when all sub-transfers have been queued in SDK core already
     bool startedTransferring = false;
 
+    // set while sub-transfers are queued in several rounds, until the last one has been queued
+    bool mMoreSubtransfersToCome = false;
+
     // If the thread was started, it queues a completion before exiting
     // That will be executed when the queued request is procesed
     // We also keep a pointer to it here, so cancel() can execute it early.
@@ -291,6 +298,10 @@ protected:
     // set node handle for root folder in transfer
     void setRootNodeHandleInTransfer();
 
+    // called once the last round of sub-transfers has been queued (see mMoreSubtransfersToCome)
+    // completes the operation, or leaves that to the last sub-transfer to finish
+    void allSubtransfersQueued(Error e, bool cancelledByUser);
+
     // called from onTransferFinish for the last sub-transfer
     void complete(Error e, bool cancelledByUser = false);
 
@@ -320,7 +331,7 @@ protected:
     SymmCipher tmpnodecipher;
 
     // temporal nodeHandle for uploads from App
-    handle mCurrUploadId = 1;
+    std::atomic<handle> mCurrUploadId{1};
 
     // generates a temporal nodeHandle for uploads from App
     handle nextUploadId();
@@ -354,6 +365,15 @@ protected:
         // subfolders
         vector<unique_ptr<Tree>> subtrees;
 
+        // Pipelined mode only.
+        // The files and subtrees are filled in by one of the scan threads, and are
+        // only used on the MegaApiImpl's thread once the folder is marked scanned.
+        Tree* parent = nullptr;
+        handle uploadId = UNDEF; // newnode.nodehandle, kept as newnode is sent
+        bool scanned = false;
+        bool creating = false;
+        bool filesQueued = false;
+
         void recursiveCountFolders(unsigned& existing, unsigned& total)
         {
             total += 1;
@@ -377,8 +397,60 @@ protected:
     enum batchResult { batchResult_cancelled, batchResult_requestSent, batchResult_batchesComplete, batchResult_stillRecursing };
     batchResult createNextFolderBatch(Tree& tree, vector<NewNode>& newnodes, uint32_t filecount, bool isBatchRootLevel);
 
+    // List the entries of one folder: fingerprint its files, and add a subtree (with a
+    // newnode record ready to be sent) for each subfolder. Those are also added to subfolders.
+    // Scan progress is reported to the app if fireUpdates.
+    scanFolder_result scanOneFolder(Tree& tree,
+                                    const LocalPath& localPath,
+                                    FileSystemAccess& fsa,
+                                    PrnGen& rng,
+                                    SymmCipher& cipher,
+                                    vector<std::pair<Tree*, LocalPath>>& subfolders,
+                                    uint32_t& foldercount,
+                                    uint32_t& filecount,
+                                    bool fireUpdates);
+
+    // Pipelined mode (MegaUploadOptions::pipelineFolderUpload): several threads scan the tree,
+    // and as each folder has been scanned, it is handed to the MegaApiImpl's thread, which
+    // creates folders as soon as their parents exist, and queues the uploads of their files
+    // as soon as they exist themselves.
+    static constexpr unsigned MAX_SCAN_THREADS = 8;
+    static constexpr unsigned MAX_PIPELINED_PUTNODES = 4;
+
+    // Runs on the worker thread, along with the extra scan threads it starts
+    scanFolder_result scanInParallel(const LocalPath& path);
+
+    // Called by the scan threads, to hand a scanned folder to the MegaApiImpl's thread
+    void folderScanned(Tree* tree);
+
+    // On the MegaApiImpl's thread
+    void takeScannedFolders();
+    void folderExists(Tree& tree);
+    void advancePipeline();
+    void sendFolderBatch(Tree& parent, vector<Tree*> folders);
+    void checkPipelineFinished();
+
+    std::mutex mScannedMutex;
+    vector<Tree*> mScannedFolders;
+    bool mScannedFoldersQueued = false;
+
+    // MegaApiImpl's thread only
+    vector<Tree*> mFoldersToCreate;
+    unsigned mPendingPutnodes = 0;
+    bool mScanFinished = false;
+    scanFolder_result mScanResult = scanFolder_succeeded;
+    Error mPipelineError = API_OK;
+    size_t mFoldersKnown = 0;
+    size_t mFoldersExisting = 0;
+    size_t mFoldersQueued = 0;
+    uint32_t mFilesScanned = 0;
+
+    // putnodes tag for new folders in the given target
+    Pitag folderPitag(handle target);
+
     // Iterate through all pending files of each uploaded folder, and start all upload transfers
-    bool genUploadTransfersForFiles(Tree& tree, TransferQueue& transferQueue);
+    // (or of just the given folder's files)
+    bool genUploadTransfersForFiles(Tree& tree, TransferQueue& transferQueue, bool includeSubtrees = true);
 };
 
 
@@ -559,6 +631,50 @@ protected:
                                       LocalTree& folder,
                                       FileSystemType fsType,
                                       bool folderExists);
+
+    // Download transfer of one file into the given folder
+    MegaTransferPrivate* genDownloadTransfer(MegaNode* fileNode,
+                                             const LocalPath& folderPath,
+                                             FileSystemType fsType,
+                                             bool folderExists,
+                                             FileSystemAccess& fsa);
+
+    // Streaming mode, for folders in the node database (all but foreign ones, whose children
+    // come along with the node): instead of building the whole tree in memory first, several
+    // threads walk it listing a page of children at a time, creating each local folder and
+    // handing the downloads of its files to the MegaApiImpl's thread as soon as it exists.
+    static constexpr unsigned MAX_STREAM_THREADS = 8;
+    static constexpr size_t CHILDREN_PAGE_SIZE = 1000;
+
+    // Runs on the worker thread, along with the extra threads it starts
+    Error streamFolders(MegaHandle root, const LocalPath& path, FileSystemType fsType);
+
+    // Create one local folder and generate the downloads of its files, adding its subfolders to subfolders
+    Error streamOneFolder(MegaHandle folder,
+                          LocalPath path,
+                          FileSystemType fsType,
+                          FileSystemAccess& fsa,
+                          vector<std::pair<MegaHandle, LocalPath>>& subfolders);
+
+    // Called by the streaming threads, to hand downloads to the MegaApiImpl's thread
+    void downloadsReady(TransferQueue& downloads);
+
+    // On the MegaApiImpl's thread
+    void sendReadyDownloads();
+    void checkStreamingFinished();
+
+    std::mutex mReadyMutex;
+    unique_ptr<TransferQueue> mReadyDownloads;
+    bool mReadyDownloadsQueued = false;
+
+    std::atomic<unsigned> mFoldersFound{0};
+    std::atomic<unsigned> mFoldersCreated{0};
+    std::atomic<unsigned> mFilesFound{0};
+
+    // MegaApiImpl's thread only
+    LocalPath mStreamPath;
+    bool mStreamFinished = false;
+    Error mStreamResult = API_OK;
 };
 
 namespace totp
@@ -1644,6 +1760,7 @@ class MegaTransferPrivate : public MegaTransfer, public Cacheable
         void setSyncTransfer(bool isSyncTransfer);
         void setSourceFileTemporary(bool temporary);
         void setStartFirst(bool beFirst);
+        void setPipelinedFolderUpload(bool pipelined);
         void setBackupTransfer(bool isBackupTransfer);
         void setForeignOverquota(bool isForeignOverquota);
         void setForceNewUpload(bool isForceNewUpload);
@@ -1702,6 +1819,7 @@ class MegaTransferPrivate : public MegaTransfer, public Cacheable
         bool isFinished() const override;
         virtual bool isSourceFileTemporary() const;
         virtual bool shouldStartFirst() const;
+        bool isPipelinedFolderUpload() const;
         bool isBackupTransfer() const override;
         bool isForeignOverquota() const override;
         bool isForceNewUpload() const override;
@@ -1779,6 +1897,7 @@ protected:
             bool streamingTransfer : 1;
             bool temporarySourceFile : 1;
             bool startFirst : 1;
+            bool pipelinedFolderUpload : 1;
             bool backupTransfer : 1;
             bool foreignOverquota : 1;
             bool forceNewUpload : 1;
@@ -3759,6 +3878,8 @@ class MegaApiImpl : public MegaApp
         static const char* ebcEncryptKey(const char* encryptionKey, const char* plainKey);
         void retryPendingConnections(bool disconnect = false, bool includexfers = false, MegaRequestListener* listener = NULL);
         void setDnsServers(const char *dnsServers, MegaRequestListener* listener = NULL);
+        bool setTlsSessionPersistence(bool enable);
+        bool setHttp2(bool enable);
         void addEntropy(char* data, unsigned int size);
         static string userAttributeToString(int);
         static string userAttributeToLongName(int);
@@ -4076,6 +4197,11 @@ class MegaApiImpl : public MegaApp
         void setMaxConnections(int direction,
                                int connections,
                                MegaRequestListener* listener = NULL);
+        void setAdaptiveTransfers(bool enable);
+        bool setTransferSchedulingPolicy(int policy);
+        bool setTransferWeights(int appWeight, int syncWeight);
+        void setAdaptiveTransferSlots(bool enable);
+        void setSmallUploadBatching(bool enable);
 
     private:
         void getMaxTransferConnections(const direction_t direction,
@@ -4536,6 +4662,10 @@ public:
         void setOriginalFingerprint(MegaNode* node, const char* originalFingerprint, MegaRequestListener *listener);
 
         bool isOnline();
+        char* getMetrics();
+        void startTracing();
+        void stopTracing();
+        bool exportTrace(const char* localPath);
 
 #ifdef HAVE_LIBUV
         // start/stop
@@ -4591,6 +4721,11 @@ public:
         void ftpServerSetMaxOutputSize(int outputSize);
         int ftpServerGetMaxOutputSize();
 
+        // metrics
+        bool metricsServerStart(bool localOnly = true, int port = 9464, bool useIPv6 = false);
+        void metricsServerStop();
+        int metricsServerIsRunning();
+
         // permissions
         void ftpServerSetRestrictedMode(int mode);
         int ftpServerGetRestrictedMode();
@@ -4889,6 +5024,8 @@ public:
         int ftpServerMaxOutputSize;
         int ftpServerRestrictedMode;
         set<MegaTransferListener *> ftpServerListeners;
+
+        MegaMetricsServer* metricsServer = nullptr;
 #endif
 
         map<int, MegaScheduledCopyController *> backupsMap;
@@ -5883,6 +6020,33 @@ public:
 
 };
 
+class MegaMetricsContext : public MegaTCPContext
+{
+public:
+    // What has been received of the request so far.
+    std::string request;
+
+    // Kept until it's been written.
+    std::string response;
+};
+
+// Serves MegaApi::getMetrics to monitoring systems.
+class MegaMetricsServer: public MegaTCPServer
+{
+protected:
+    void processReceivedData(MegaTCPContext* tcpctx, ssize_t nread, const uv_buf_t* buf) override;
+    MegaTCPContext* initializeContext(uv_stream_t* server_handle) override;
+    void processWriteFinished(MegaTCPContext* tcpctx, int status) override;
+    bool respondNewConnection(MegaTCPContext* tcpctx) override;
+
+public:
+    // Connections sending longer requests are closed.
+    static constexpr size_t MAX_REQUEST_SIZE = 8192;
+
+    MegaMetricsServer(MegaApiImpl* megaApi, std::string basePath, bool useIPv6 = false);
+    ~MegaMetricsServer() override;
+};
+
 class MegaFTPContext : public MegaTCPContext
 {
 public:
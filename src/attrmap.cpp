@@ -152,6 +152,8 @@ const char* AttrMap::unserialize(const char* ptr , const char *end)
         ptr += ll;
     }
 
+    map.shrink_to_fit();
+
     return ptr;
 }
 
@@ -344,6 +346,8 @@ void AttrMap::fromjson(const char* buf)
     {
         JSON::unescape(t);
     }
+    // kept for the lifetime of the node
+    map.shrink_to_fit();
 }
 
 std::optional<AttrMap> AttrMap::getComplexNestedJsonObject(const std::string_view parentName,
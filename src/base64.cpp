@@ -22,70 +22,331 @@
 #include "mega/base64.h"
 #include "mega/utils.h"
 
+#include <array>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && \
+    (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#define MEGA_BASE64_SIMD 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
 namespace mega {
-// modified base64 conversion (no trailing '=' and '-_' instead of '+/')
-unsigned char Base64::to64(byte c)
+
+namespace {
+
+constexpr char ENCODE_TABLE[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// both the URL-safe and the standard characters are accepted
+constexpr std::array<byte, 256> makeDecodeTable()
 {
-    c &= 63;
+    std::array<byte, 256> table{};
 
-    if (c < 26)
+    for (auto& value : table)
     {
-        return static_cast<unsigned char>(c + 'A');
+        value = 255;
     }
 
-    if (c < 52)
+    for (byte i = 0; i < 64; ++i)
+    {
+        table[static_cast<byte>(ENCODE_TABLE[i])] = i;
+    }
+
+    table['+'] = 62;
+    table['/'] = 63;
+
+    return table;
+}
+
+constexpr auto DECODE_TABLE = makeDecodeTable();
+
+#ifdef MEGA_BASE64_SIMD
+
+// The vectorized routines below convert as many whole blocks as they can and
+// return how much they consumed, leaving the rest to the scalar code. They
+// produce exactly what the scalar code does for the same input.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MEGA_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define MEGA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MEGA_TARGET_SSSE3
+#define MEGA_TARGET_AVX2
+#endif
+
+// 12 bytes (within a 16 byte register) to 16 sextets
+MEGA_TARGET_SSSE3 inline __m128i unpack128(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+    auto t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    auto t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    auto t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    auto t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+
+    return _mm_or_si128(t1, t3);
+}
+
+// sextets to characters of the URL-safe alphabet
+MEGA_TARGET_SSSE3 inline __m128i encode128(__m128i sextets)
+{
+    // 0 for 26..51, 1..10 for digits, 11 for '-', 12 for '_' and 13 for 0..25
+    auto range = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+    auto upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), sextets);
+
+    range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+
+    auto shift = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                               '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62,
+                               '_' - 63, 'A', 0, 0);
+
+    return _mm_add_epi8(_mm_shuffle_epi8(shift, range), sextets);
+}
+
+// x in [lo, hi]
+MEGA_TARGET_SSSE3 inline __m128i inRange128(__m128i x, char lo, char hi)
+{
+    auto offset = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(static_cast<char>(hi - lo))), offset);
+}
+
+// characters to sextets, false if any of them isn't valid
+MEGA_TARGET_SSSE3 inline bool decode128(__m128i in, __m128i& sextets)
+{
+    auto upper = inRange128(in, 'A', 'Z');
+    auto lower = inRange128(in, 'a', 'z');
+    auto digit = inRange128(in, '0', '9');
+    auto s62 = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('-')),
+                            _mm_cmpeq_epi8(in, _mm_set1_epi8('+')));
+    auto s63 = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('_')),
+                            _mm_cmpeq_epi8(in, _mm_set1_epi8('/')));
+
+    auto valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(s62, s63)));
+    if (_mm_movemask_epi8(valid) != 0xFFFF)
     {
-        return static_cast<unsigned char>(c - 26 + 'a');
+        return false;
     }
 
-    if (c < 62)
+    auto shift = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                     _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+        _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+
+    sextets = _mm_or_si128(_mm_add_epi8(_mm_and_si128(_mm_or_si128(upper, _mm_or_si128(lower, digit)), in), shift),
+                           _mm_or_si128(_mm_and_si128(s62, _mm_set1_epi8(62)),
+                                        _mm_and_si128(s63, _mm_set1_epi8(63))));
+    return true;
+}
+
+// 16 sextets to 12 bytes (at the start of the register)
+MEGA_TARGET_SSSE3 inline __m128i pack128(__m128i sextets)
+{
+    auto merged = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+
+    return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+MEGA_TARGET_SSSE3 size_t encodeSSSE3(const byte* b, size_t blen, char* a)
+{
+    size_t i = 0;
+
+    // reads 16 bytes to encode 12
+    for (; blen - i >= 16; i += 12)
     {
-        return static_cast<unsigned char>(c - 52 + '0');
+        auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(a + i / 3 * 4), encode128(unpack128(in)));
     }
 
-    if (c == 62)
+    return i;
+}
+
+MEGA_TARGET_SSSE3 size_t decodeSSSE3(const char* a, size_t alen, byte* b, size_t blen)
+{
+    size_t i = 0;
+
+    // writes 16 bytes to decode 12
+    for (; alen - i >= 16 && blen - i / 4 * 3 >= 16; i += 16)
     {
-        return '-';
+        __m128i sextets;
+        if (!decode128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), sextets))
+        {
+            break;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b + i / 4 * 3), pack128(sextets));
     }
 
-    return '_';
+    return i;
 }
 
-unsigned char Base64::from64(byte c)
+MEGA_TARGET_AVX2 size_t encodeAVX2(const byte* b, size_t blen, char* a)
 {
-    if ((c >= 'A') && (c <= 'Z'))
+    size_t i = 0;
+
+    // reads 28 bytes to encode 24, each lane as in encodeSSSE3
+    for (; blen - i >= 28; i += 24)
     {
-        return static_cast<unsigned char>(c - 'A');
+        auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 12));
+        auto in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                                     10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+        auto t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        auto t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        auto t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        auto t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        auto sextets = _mm256_or_si256(t1, t3);
+
+        auto range = _mm256_subs_epu8(sextets, _mm256_set1_epi8(51));
+        auto upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), sextets);
+
+        range = _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+
+        auto shift = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62,
+                                      '_' - 63, 'A', 0, 0,
+                                      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62,
+                                      '_' - 63, 'A', 0, 0);
+
+        auto out = _mm256_add_epi8(_mm256_shuffle_epi8(shift, range), sextets);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i / 3 * 4), out);
     }
 
-    if ((c >= 'a') && (c <= 'z'))
+    return i;
+}
+
+MEGA_TARGET_AVX2 inline __m256i inRange256(__m256i x, char lo, char hi)
+{
+    auto offset = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(static_cast<char>(hi - lo))), offset);
+}
+
+MEGA_TARGET_AVX2 size_t decodeAVX2(const char* a, size_t alen, byte* b, size_t blen)
+{
+    size_t i = 0;
+
+    // writes 32 bytes to decode 24
+    for (; alen - i >= 32 && blen - i / 4 * 3 >= 32; i += 32)
     {
-        return static_cast<unsigned char>(c - 'a' + 26);
+        auto in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+
+        auto upper = inRange256(in, 'A', 'Z');
+        auto lower = inRange256(in, 'a', 'z');
+        auto digit = inRange256(in, '0', '9');
+        auto s62 = _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('-')),
+                                   _mm256_cmpeq_epi8(in, _mm256_set1_epi8('+')));
+        auto s63 = _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('_')),
+                                   _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/')));
+
+        auto alnum = _mm256_or_si256(upper, _mm256_or_si256(lower, digit));
+        auto valid = _mm256_or_si256(alnum, _mm256_or_si256(s62, s63));
+        if (_mm256_movemask_epi8(valid) != -1)
+        {
+            break;
+        }
+
+        auto shift = _mm256_or_si256(
+            _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                            _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+            _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+
+        auto sextets = _mm256_or_si256(_mm256_add_epi8(_mm256_and_si256(alnum, in), shift),
+                                       _mm256_or_si256(_mm256_and_si256(s62, _mm256_set1_epi8(62)),
+                                                       _mm256_and_si256(s63, _mm256_set1_epi8(63))));
+
+        auto merged = _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140));
+        merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        merged = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                              2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i / 4 * 3), merged);
     }
 
-    if ((c >= '0') && (c <= '9'))
+    return i;
+}
+
+#undef MEGA_TARGET_SSSE3
+#undef MEGA_TARGET_AVX2
+
+enum class SimdLevel
+{
+    NONE,
+    SSSE3,
+    AVX2,
+};
+
+SimdLevel detectSimdLevel()
+{
+#ifdef _MSC_VER
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7)
     {
-        return static_cast<unsigned char>(c - '0' + 52);
+        return SimdLevel::NONE;
     }
 
-    if (c == '-' || c == '+')
+    __cpuid(info, 1);
+    bool ssse3 = info[2] & (1 << 9);
+    bool osxsave = info[2] & (1 << 27);
+    bool avx = info[2] & (1 << 28);
+
+    __cpuidex(info, 7, 0);
+    bool avx2 = info[1] & (1 << 5);
+
+    // the OS must save the YMM registers
+    if (avx2 && avx && osxsave && (_xgetbv(0) & 6) == 6)
     {
-        return static_cast<unsigned char>(62);
+        return SimdLevel::AVX2;
     }
 
-    if (c == '_' || c == '/')
+    return ssse3 ? SimdLevel::SSSE3 : SimdLevel::NONE;
+#else
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
     {
-        return static_cast<unsigned char>(63);
+        return SimdLevel::AVX2;
     }
 
-    return static_cast<unsigned char>(255);
+    return __builtin_cpu_supports("ssse3") ? SimdLevel::SSSE3 : SimdLevel::NONE;
+#endif
+}
+
+const SimdLevel SIMD_LEVEL = detectSimdLevel();
+
+// Inputs shorter than this (such as handles) aren't worth the dispatch.
+constexpr size_t MIN_SIMD_LENGTH = 16;
+
+#endif // MEGA_BASE64_SIMD
+
+} // namespace
+
+// modified base64 conversion (no trailing '=' and '-_' instead of '+/')
+unsigned char Base64::to64(byte c)
+{
+    return static_cast<unsigned char>(ENCODE_TABLE[c & 63]);
+}
+
+unsigned char Base64::from64(byte c)
+{
+    return DECODE_TABLE[c];
 }
 
 
 int Base64::atob(const string &in, string &out)
 {
     out.resize(in.size() * 3 / 4 + 3);
-    out.resize(static_cast<size_t>(Base64::atob(in.data(), (byte*)out.data(), (int)out.size())));
+    out.resize(static_cast<size_t>(
+        Base64::atob(in.data(), in.size(), (byte*)out.data(), (int)out.size())));
 
     return (int)out.size();
 }
@@ -94,25 +355,59 @@ std::string Base64::atob(const std::string &in)
 {
     string out;
     out.resize(in.size() * 3 / 4 + 3);
-    out.resize(static_cast<size_t>(Base64::atob(in.data(), (byte*)out.data(), (int)out.size())));
+    out.resize(static_cast<size_t>(
+        Base64::atob(in.data(), in.size(), (byte*)out.data(), (int)out.size())));
 
     return out;
 }
 
 int Base64::atob(const char* a, byte* b, int blen)
+{
+    return atob(a, std::numeric_limits<size_t>::max(), b, blen);
+}
+
+int Base64::atob(const char* a, size_t alen, byte* b, int blen)
 {
     byte c[4]={};
     int i;
     int p = 0;
 
+#ifdef MEGA_BASE64_SIMD
+    // whole blocks of valid characters, the rest (if any) is decoded below
+    if (alen != std::numeric_limits<size_t>::max() && alen >= MIN_SIMD_LENGTH && blen > 0)
+    {
+        size_t consumed = 0;
+
+        if (SIMD_LEVEL == SimdLevel::AVX2)
+        {
+            consumed = decodeAVX2(a, alen, b, static_cast<size_t>(blen));
+        }
+
+        if (SIMD_LEVEL != SimdLevel::NONE)
+        {
+            consumed += decodeSSSE3(a + consumed,
+                                    alen - consumed,
+                                    b + consumed / 4 * 3,
+                                    static_cast<size_t>(blen) - consumed / 4 * 3);
+        }
+
+        a += consumed;
+        alen -= consumed;
+        p = static_cast<int>(consumed / 4 * 3);
+    }
+#endif
+
     for (;;)
     {
         for (i = 0; i < 4; i++)
         {
-            if ((c[i] = from64(static_cast<byte>(*a++))) == 255)
+            if (!alen || (c[i] = from64(static_cast<byte>(*a++))) == 255)
             {
+                c[i] = 255;
                 break;
             }
+
+            --alen;
         }
 
         if ((p >= blen) || !i)
@@ -223,6 +518,28 @@ size_t Base64::btoa(const byte* b, size_t blen, char* a)
 {
     size_t p = 0;
 
+#ifdef MEGA_BASE64_SIMD
+    // whole blocks of 3 bytes, the rest (if any) is encoded below
+    if (blen >= MIN_SIMD_LENGTH)
+    {
+        size_t consumed = 0;
+
+        if (SIMD_LEVEL == SimdLevel::AVX2)
+        {
+            consumed = encodeAVX2(b, blen, a);
+        }
+
+        if (SIMD_LEVEL != SimdLevel::NONE)
+        {
+            consumed += encodeSSSE3(b + consumed, blen - consumed, a + consumed / 3 * 4);
+        }
+
+        b += consumed;
+        blen -= consumed;
+        p = consumed / 3 * 4;
+    }
+#endif
+
     for (;;)
     {
         if (blen == 0)
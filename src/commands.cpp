@@ -1290,7 +1290,17 @@ CommandPutNodes::CommandPutNodes(MegaClient* client,
 // add new nodes and handle->node handle mapping
 void CommandPutNodes::removePendingDBRecordsAndTempFiles()
 {
-    pendingdbid_map::iterator it = client->pendingtcids.find(tag);
+    removePendingDBRecordsAndTempFiles(tag);
+
+    for (auto batchedTag: mBatchedTags)
+    {
+        removePendingDBRecordsAndTempFiles(batchedTag);
+    }
+}
+
+void CommandPutNodes::removePendingDBRecordsAndTempFiles(int uploadTag)
+{
+    pendingdbid_map::iterator it = client->pendingtcids.find(uploadTag);
     if (it != client->pendingtcids.end())
     {
         if (client->tctable)
@@ -1307,7 +1317,7 @@ void CommandPutNodes::removePendingDBRecordsAndTempFiles()
         }
         client->pendingtcids.erase(it);
     }
-    pendingfiles_map::iterator pit = client->pendingfiles.find(tag);
+    pendingfiles_map::iterator pit = client->pendingfiles.find(uploadTag);
     if (pit != client->pendingfiles.end())
     {
         vector<LocalPath> &pfs = pit->second;
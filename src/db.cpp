@@ -42,6 +42,26 @@ bool DbTable::put(uint32_t type, Cacheable* record, SymmCipher* key)
 {
     string data;
 
+    return putEncoded(type, record, encode(*record, *key, data) ? &data : nullptr);
+}
+
+bool DbTable::encode(const Cacheable& record, SymmCipher& key, string& data) const
+{
+    if (!record.serialize(&data))
+    {
+        return false;
+    }
+
+    if (!PaddedCBC::encrypt(rng, &data, &key))
+    {
+        LOG_err << "Failed to CBC encrypt data"; // continue with unencrypted data intentionally
+    }
+
+    return true;
+}
+
+bool DbTable::putEncoded(uint32_t type, Cacheable* record, string* data)
+{
     if (!record->dbid)
     {
         uint32_t previousNextid = nextid;
@@ -57,7 +77,7 @@ bool DbTable::put(uint32_t type, Cacheable* record, SymmCipher* key)
         }
     }
 
-    if (!record->serialize(&data))
+    if (!data)
     {
         // Don't return false if there are errors in the serialization
         // to let the SDK continue and save the rest of records
@@ -65,30 +85,30 @@ bool DbTable::put(uint32_t type, Cacheable* record, SymmCipher* key)
         return true;
     }
 
-    if (!PaddedCBC::encrypt(rng, &data, key))
+    return put(record->dbid, data);
+}
+
+// get next record, decrypt and unpad
+bool DbTable::next(uint32_t* type, string* data, SymmCipher* key)
+{
+    if (nextEncrypted(type, data))
     {
-        LOG_err << "Failed to CBC encrypt data"; // continue with unencrypted data intentionally
+        return !*type || PaddedCBC::decrypt(data, key);
     }
 
-    return put(record->dbid, &data);
+    return false;
 }
 
-// get next record, decrypt and unpad
-bool DbTable::next(uint32_t* type, string* data, SymmCipher* key)
+bool DbTable::nextEncrypted(uint32_t* type, string* data)
 {
     if (next(type, data))
     {
-        if (!*type)
-        {
-            return true;
-        }
-
         if (*type > nextid)
         {
             nextid = *type & ~(static_cast<unsigned>(IDSPACING) - 1);
         }
 
-        return PaddedCBC::decrypt(data, key);
+        return true;
     }
 
     return false;
@@ -132,11 +152,12 @@ void DbTable::checkCommitter(DBTableTransactionCommitter*)
     assert(mTransactionCommitter);
 }
 
-const int DbAccess::LEGACY_DB_VERSION = 14;
+const int DbAccess::LEGACY_DB_VERSION = 15;
 const int DbAccess::DB_VERSION = DbAccess::LEGACY_DB_VERSION + 1;
 const int DbAccess::LAST_DB_VERSION_WITHOUT_NOD = 12;
 const int DbAccess::LAST_DB_VERSION_WITHOUT_SRW = 13;
 const int DbAccess::LAST_DB_VERSION_WITHOUT_VFINGERPRINT = 14;
+const int DbAccess::LAST_DB_VERSION_WITHOUT_NODE_RECORD = 15;
 
 DbAccess::DbAccess()
 {
@@ -76,12 +76,13 @@ bool SqliteDbAccess::checkDbFileAndAdjustLegacy(FileSystemAccess& fsAccess, cons
             LOG_debug << "Found legacy database at: " << legacyPath;
 
             // if current version is legacy, use that one... unless migration to NoD, DB with
-            // virtual fingerprint column in Nodes table, or renaming to adapt the version to SRW
-            // are required
+            // virtual fingerprint column in Nodes table, nodes stored as NodeRecords, or renaming
+            // to adapt the version to SRW are required
             if (currentDbVersion == LEGACY_DB_VERSION &&
                 LEGACY_DB_VERSION != LAST_DB_VERSION_WITHOUT_NOD &&
                 LEGACY_DB_VERSION != LAST_DB_VERSION_WITHOUT_SRW &&
-                LEGACY_DB_VERSION != LAST_DB_VERSION_WITHOUT_VFINGERPRINT)
+                LEGACY_DB_VERSION != LAST_DB_VERSION_WITHOUT_VFINGERPRINT &&
+                LEGACY_DB_VERSION != LAST_DB_VERSION_WITHOUT_NODE_RECORD)
             {
                 LOG_debug << "Using a legacy database.";
                 dbPath = std::move(legacyPath);
@@ -163,51 +164,8 @@ DbTable *SqliteDbAccess::openTableWithNodes(PrnGen &rng, FileSystemAccess &fsAcc
         return nullptr;
     }
 
-    if (sqlite3_create_function(db, u8"getmimetype", 1, SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0, &SqliteAccountState::userGetMimetype, 0, 0) != SQLITE_OK)
-    {
-        LOG_err << "Data base error(sqlite3_create_function userGetMimetype): " << sqlite3_errmsg(db);
-        sqlite3_close(db);
-        return nullptr;
-    }
-
-    if (sqlite3_create_function(db,
-                                u8"getFingerprintExcludingMtime",
-                                1,
-                                SQLITE_UTF8 | SQLITE_DETERMINISTIC,
-                                0,
-                                &SqliteAccountState::getFingerprintExcludingMtime,
-                                0,
-                                0) != SQLITE_OK)
-    {
-        LOG_err << "Data base error(sqlite3_create_function getFingerprintExcludingMtime): "
-                << sqlite3_errmsg(db);
-        sqlite3_close(db);
-        return nullptr;
-    }
-
-    if (sqlite3_create_function(db,
-                                u8"getSizeFromNodeCounter",
-                                1,
-                                SQLITE_UTF8 | SQLITE_DETERMINISTIC,
-                                0,
-                                &SqliteAccountState::getSizeFromNodeCounter,
-                                0,
-                                0) != SQLITE_OK)
-    {
-        LOG_err << "Data base error(sqlite3_create_function getSizeFromNodeCounter): "
-                << sqlite3_errmsg(db);
-        sqlite3_close(db);
-        return nullptr;
-    }
-
-    if (sqlite3_create_collation(db,
-                                 "NATURALNOCASE",
-                                 SQLITE_UTF8,
-                                 nullptr,
-                                 sqlite_naturalsorting_compare))
+    if (!SqliteAccountState::registerNodeFunctions(db))
     {
-        LOG_err << "Data base error(sqlite3_create_collation NATURALNOCASE): "
-                << sqlite3_errmsg(db);
         sqlite3_close(db);
         return nullptr;
     }
@@ -219,6 +177,8 @@ DbTable *SqliteDbAccess::openTableWithNodes(PrnGen &rng, FileSystemAccess &fsAcc
         "type tinyint, mimetypeVirtual tinyint AS (getmimetype(name)) VIRTUAL, "
         "fingerprintVirtual BLOB AS (getFingerprintExcludingMtime(fingerprint)) VIRTUAL, "
         "sizeVirtual int64 AS (getSizeFromNodeCounter(counter)) VIRTUAL,"
+        "ownerVirtual int64 AS (getOwnerFromNode(node)) VIRTUAL, "
+        "mediaVirtual tinyint AS (ismedia(name)) VIRTUAL, "
         "share tinyint, fav tinyint, ctime int64, mtime int64 DEFAULT 0, "
         "flags int64, counter BLOB NOT NULL, "
         "node BLOB NOT NULL, label tinyint DEFAULT 0, description text, tags text)";
@@ -259,6 +219,11 @@ DbTable *SqliteDbAccess::openTableWithNodes(PrnGen &rng, FileSystemAccess &fsAcc
          "int64 AS (getSizeFromNodeCounter(counter)) VIRTUAL",
          NodeData::COMPONENT_NONE,
          nullptr},
+        {"ownerVirtual",
+         "int64 AS (getOwnerFromNode(node)) VIRTUAL",
+         NodeData::COMPONENT_NONE,
+         nullptr},
+        {"mediaVirtual", "tinyint AS (ismedia(name)) VIRTUAL", NodeData::COMPONENT_NONE, nullptr},
     };
 
     if (!addAndPopulateColumns(db, std::move(newCols)))
@@ -267,6 +232,12 @@ DbTable *SqliteDbAccess::openTableWithNodes(PrnGen &rng, FileSystemAccess &fsAcc
         return nullptr;
     }
 
+    if (!migrateNodesToRecords(db))
+    {
+        sqlite3_close(db);
+        return nullptr;
+    }
+
 #if __ANDROID__
     // Android doesn't provide a temporal directory -> change default policy for temp
     // store (FILE=1) to avoid failures on large queries, so it relies on MEMORY=2
@@ -279,29 +250,6 @@ DbTable *SqliteDbAccess::openTableWithNodes(PrnGen &rng, FileSystemAccess &fsAcc
     }
 #endif
 
-    result = sqlite3_create_function(db, "regexp", 2, SQLITE_ANY,0, &SqliteAccountState::userRegexp, 0, 0);
-    if (result)
-    {
-        LOG_err << "Data base error(sqlite3_create_function userRegexp): " << sqlite3_errmsg(db);
-        sqlite3_close(db);
-        return nullptr;
-    }
-
-    result = sqlite3_create_function(db,
-                                     "matchFilter",
-                                     10,
-                                     SQLITE_ANY,
-                                     0,
-                                     &SqliteAccountState::userMatchFilter,
-                                     0,
-                                     0);
-    if (result)
-    {
-        LOG_err << "Data base error(sqlite3_create_function userMatchFilter): "
-                << sqlite3_errmsg(db);
-        sqlite3_close(db);
-        return nullptr;
-    }
     return new SqliteAccountState(rng,
                                 db,
                                 fsAccess,
@@ -666,6 +614,80 @@ bool SqliteDbAccess::migrateDataToColumns(sqlite3* db, vector<NewColumn>&& cols)
     return true;
 }
 
+// Converts a node in the legacy format to a NodeRecord, leaving it as it is otherwise
+static void toNodeRecord(sqlite3_context* context, int argc, sqlite3_value** argv)
+{
+    assert(argc == 1);
+
+    const auto blob = static_cast<const char*>(sqlite3_value_blob(argv[0]));
+    const auto blobSize = static_cast<size_t>(sqlite3_value_bytes(argv[0]));
+
+    string record;
+    if (blob && NodeData(blob, blobSize, NodeData::COMPONENT_ALL).toRecord(record))
+    {
+        sqlite3_result_blob(context, record.data(), static_cast<int>(record.size()), SQLITE_TRANSIENT);
+    }
+    else
+    {
+        LOG_err << "Unable to convert node to a NodeRecord, keeping it as it is";
+        sqlite3_result_value(context, argv[0]);
+    }
+}
+
+bool SqliteDbAccess::migrateNodesToRecords(sqlite3* db)
+{
+    sqlite3_stmt* stmt = nullptr;
+    int userVersion = 0;
+
+    if (sqlite3_prepare_v2(db, "PRAGMA user_version", -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        LOG_err << "Db error while reading user_version: " << sqlite3_errmsg(db);
+        return false;
+    }
+
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        userVersion = sqlite3_column_int(stmt, 0);
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (userVersion >= NodeRecord::FORMAT_VERSION)
+    {
+        return true;
+    }
+
+    if (sqlite3_create_function(db,
+                                u8"toNodeRecord",
+                                1,
+                                SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                0,
+                                &toNodeRecord,
+                                0,
+                                0) != SQLITE_OK)
+    {
+        LOG_err << "Data base error(sqlite3_create_function toNodeRecord): " << sqlite3_errmsg(db);
+        return false;
+    }
+
+    LOG_info << "Migrating Data base - rewriting nodes as NodeRecords";
+
+    // new DBs get here too, with an empty nodes table
+    string query = "BEGIN; UPDATE nodes SET node = toNodeRecord(node); PRAGMA user_version = " +
+                   std::to_string(NodeRecord::FORMAT_VERSION) + "; COMMIT;";
+
+    if (sqlite3_exec(db, query.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        LOG_err << "Db error during migration to NodeRecords: " << sqlite3_errmsg(db);
+        sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    LOG_info << "Migrating Data base - rewrote " << sqlite3_changes(db) << " nodes";
+
+    return true;
+}
+
 
 SqliteDbTable::SqliteDbTable(PrnGen &rng, sqlite3* db, FileSystemAccess &fsAccess, const LocalPath &path, const bool checkAlwaysTransacted, DBErrorCallback dBErrorCallBack)
   : DbTable(rng, checkAlwaysTransacted, dBErrorCallBack)
@@ -802,6 +824,7 @@ bool SqliteDbTable::put(uint32_t index, char* data, unsigned len)
     assert((index & (DbTable::IDSPACING - 1)) != MegaClient::CACHEDNODE); // nodes must be stored in DbTableNodes ('nodes' table, not 'statecache' table)
 
     checkTransaction();
+    ++mChanges;
 
     int sqlResult = SQLITE_OK;
     if (!mPutStmt)
@@ -839,6 +862,7 @@ bool SqliteDbTable::del(uint32_t index)
     }
 
     checkTransaction();
+    ++mChanges;
 
     int sqlResult = SQLITE_OK;
     if (!mDelStmt)
@@ -871,6 +895,7 @@ void SqliteDbTable::truncate()
     }
 
     checkTransaction();
+    ++mChanges;
     assert(inTransaction());
 
     int rc = sqlite3_exec(db, "DELETE FROM statecache", 0, 0, NULL);
@@ -886,11 +911,32 @@ void SqliteDbTable::begin()
     }
 
     assert(!inTransaction());
+
+    // anything written outside a transaction was committed as it was written
+    mCommittedChanges = mChanges.load();
+
     LOG_debug << "DB transaction BEGIN " << dbfile;
     int rc = sqlite3_exec(db, "BEGIN", 0, 0, NULL);
     errorHandler(rc, "Begin transaction", false);
 }
 
+std::mutex SqliteDbTable::commitTimeMutex;
+CodeCounter::ScopeStats SqliteDbTable::commitTime = {"sqlite_commit"};
+
+CodeCounter::ScopeStats SqliteDbTable::commitTimeSnapshot([[maybe_unused]] bool reset)
+{
+    std::lock_guard<std::mutex> guard(commitTimeMutex);
+
+    auto snapshot = commitTime;
+#ifdef MEGA_MEASURE_CODE
+    if (reset)
+    {
+        commitTime.report(true);
+    }
+#endif
+    return snapshot;
+}
+
 // commit transaction
 void SqliteDbTable::commit()
 {
@@ -899,9 +945,26 @@ void SqliteDbTable::commit()
         return;
     }
 
+    // timed without the lock, which is only taken to record it
+    trace::Span span(commitTime.traceName);
+    auto started = std::chrono::high_resolution_clock::now();
+
     LOG_debug << "DB transaction COMMIT " << dbfile;
 
+    auto changes = mChanges.load();
     int rc = sqlite3_exec(db, "COMMIT", 0, 0, NULL);
+
+    if (rc == SQLITE_OK)
+    {
+        mCommittedChanges = changes;
+    }
+
+    span.complete();
+    {
+        std::lock_guard<std::mutex> guard(commitTimeMutex);
+        commitTime.add(std::chrono::high_resolution_clock::now() - started);
+    }
+
     errorHandler(rc, "Commit transaction", false);
 }
 
@@ -916,6 +979,13 @@ void SqliteDbTable::abort()
     LOG_debug << "DB transaction ROLLBACK " << dbfile;
 
     int rc = sqlite3_exec(db, "ROLLBACK", 0, 0, NULL);
+
+    if (rc == SQLITE_OK)
+    {
+        // the table is back to what was committed, which is a change for queries in progress
+        mCommittedChanges = ++mChanges;
+    }
+
     errorHandler(rc, "Rollback", false);
 }
 
@@ -1055,16 +1125,279 @@ void SqliteDbTable::errorHandler(int sqliteError, const string& operation, bool
     }
 }
 
+const unsigned SqliteAccountState::MAX_READERS = 4;
+const sqlite3_int64 SqliteAccountState::READER_MMAP_SIZE = 256 * 1024 * 1024; // 256 MB
+
 SqliteAccountState::SqliteAccountState(PrnGen &rng, sqlite3 *pdb, FileSystemAccess &fsAccess, const LocalPath &path, const bool checkAlwaysTransacted, DBErrorCallback dBErrorCallBack)
     : SqliteDbTable(rng, pdb, fsAccess, path, checkAlwaysTransacted, dBErrorCallBack)
+    , mReaders(std::make_shared<Readers>())
 {
 }
 
 SqliteAccountState::~SqliteAccountState()
 {
+    closeReaders();
     finalise();
 }
 
+bool SqliteAccountState::registerNodeFunctions(sqlite3* db)
+{
+    if (sqlite3_create_function(db, u8"getmimetype", 1, SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0, &SqliteAccountState::userGetMimetype, 0, 0) != SQLITE_OK)
+    {
+        LOG_err << "Data base error(sqlite3_create_function userGetMimetype): " << sqlite3_errmsg(db);
+        return false;
+    }
+
+    if (sqlite3_create_function(db,
+                                u8"getFingerprintExcludingMtime",
+                                1,
+                                SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                0,
+                                &SqliteAccountState::getFingerprintExcludingMtime,
+                                0,
+                                0) != SQLITE_OK)
+    {
+        LOG_err << "Data base error(sqlite3_create_function getFingerprintExcludingMtime): "
+                << sqlite3_errmsg(db);
+        return false;
+    }
+
+    if (sqlite3_create_function(db,
+                                u8"getSizeFromNodeCounter",
+                                1,
+                                SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                0,
+                                &SqliteAccountState::getSizeFromNodeCounter,
+                                0,
+                                0) != SQLITE_OK)
+    {
+        LOG_err << "Data base error(sqlite3_create_function getSizeFromNodeCounter): "
+                << sqlite3_errmsg(db);
+        return false;
+    }
+
+    if (sqlite3_create_function(db,
+                                u8"getOwnerFromNode",
+                                1,
+                                SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                0,
+                                &SqliteAccountState::getOwnerFromNode,
+                                0,
+                                0) != SQLITE_OK)
+    {
+        LOG_err << "Data base error(sqlite3_create_function getOwnerFromNode): "
+                << sqlite3_errmsg(db);
+        return false;
+    }
+
+    if (sqlite3_create_function(db,
+                                u8"ismedia",
+                                1,
+                                SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                0,
+                                &SqliteAccountState::userIsMedia,
+                                0,
+                                0) != SQLITE_OK)
+    {
+        LOG_err << "Data base error(sqlite3_create_function userIsMedia): " << sqlite3_errmsg(db);
+        return false;
+    }
+
+    if (sqlite3_create_collation(db,
+                                 "NATURALNOCASE",
+                                 SQLITE_UTF8,
+                                 nullptr,
+                                 sqlite_naturalsorting_compare))
+    {
+        LOG_err << "Data base error(sqlite3_create_collation NATURALNOCASE): "
+                << sqlite3_errmsg(db);
+        return false;
+    }
+
+    if (sqlite3_create_function(db, "regexp", 2, SQLITE_ANY, 0, &SqliteAccountState::userRegexp, 0, 0))
+    {
+        LOG_err << "Data base error(sqlite3_create_function userRegexp): " << sqlite3_errmsg(db);
+        return false;
+    }
+
+    if (sqlite3_create_function(db,
+                                "matchFilter",
+                                10,
+                                SQLITE_ANY,
+                                0,
+                                &SqliteAccountState::userMatchFilter,
+                                0,
+                                0))
+    {
+        LOG_err << "Data base error(sqlite3_create_function userMatchFilter): "
+                << sqlite3_errmsg(db);
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<DBTableNodes> SqliteAccountState::readOnlyView()
+{
+#if TARGET_OS_IPHONE
+    // Without WAL, readers would block the commits of this connection
+    return nullptr;
+#else
+    // Readers only see what has been committed, NodeManager checks whether that's current
+    if (!db || !mReaders)
+    {
+        return nullptr;
+    }
+
+    std::unique_ptr<SqliteAccountState> reader;
+
+    {
+        std::lock_guard<std::mutex> g(mReaders->mMutex);
+
+        if (!mReaders->mIdle.empty())
+        {
+            reader = std::move(mReaders->mIdle.back());
+            mReaders->mIdle.pop_back();
+        }
+        else if (mReaders->mOpen >= MAX_READERS)
+        {
+            return nullptr;
+        }
+        else
+        {
+            // Open it below, without holding the lock
+            ++mReaders->mOpen;
+        }
+    }
+
+    if (!reader)
+    {
+        reader.reset(openReader());
+    }
+
+    std::lock_guard<std::mutex> g(mReaders->mMutex);
+
+    if (!reader)
+    {
+        --mReaders->mOpen;
+        return nullptr;
+    }
+
+    mReaders->mLeased.insert(reader->db);
+
+    auto readers = mReaders;
+
+    return std::shared_ptr<DBTableNodes>(
+        reader.release(),
+        [readers](DBTableNodes* view)
+        {
+            std::unique_ptr<SqliteAccountState> reader(static_cast<SqliteAccountState*>(view));
+            std::lock_guard<std::mutex> g(readers->mMutex);
+
+            readers->mLeased.erase(reader->db);
+
+            if (readers->mClosed)
+            {
+                --readers->mOpen;
+                reader.reset();
+            }
+            else
+            {
+                readers->mIdle.emplace_back(std::move(reader));
+            }
+
+            readers->mReturned.notify_all();
+        });
+#endif
+}
+
+uint64_t SqliteAccountState::changeCount() const
+{
+    return mChanges;
+}
+
+uint64_t SqliteAccountState::committedChangeCount() const
+{
+    // outside a transaction, changes are committed as they are written
+    return inTransaction() ? mCommittedChanges.load() : mChanges.load();
+}
+
+SqliteAccountState* SqliteAccountState::openReader()
+{
+    sqlite3* reader = nullptr;
+
+    // Each reader is used by one thread at a time
+    int result = sqlite3_open_v2(dbfile.toPath(false).c_str(),
+                                 &reader,
+                                 SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+                                 nullptr);
+
+    if (result == SQLITE_OK && !registerNodeFunctions(reader))
+    {
+        result = SQLITE_ERROR;
+    }
+
+    if (result == SQLITE_OK)
+    {
+        auto pragma = "PRAGMA mmap_size=" + std::to_string(READER_MMAP_SIZE) + ";";
+        result = sqlite3_exec(reader, pragma.c_str(), nullptr, nullptr, nullptr);
+    }
+
+#if __ANDROID__
+    if (result == SQLITE_OK)
+    {
+        result = sqlite3_exec(reader, "PRAGMA temp_store=2;", nullptr, nullptr, nullptr);
+    }
+#endif
+
+    if (result != SQLITE_OK)
+    {
+        LOG_warn << "Unable to open a read-only connection to " << dbfile << ": "
+                 << (reader ? sqlite3_errmsg(reader) : std::to_string(result));
+        sqlite3_close(reader);
+        return nullptr;
+    }
+
+    LOG_debug << "Read-only connection opened to " << dbfile;
+
+    auto state = new SqliteAccountState(rng, reader, *fsaccess, dbfile, false, nullptr);
+
+    // Readers don't hand out readers of their own
+    state->mReaders.reset();
+
+    return state;
+}
+
+void SqliteAccountState::closeReaders()
+{
+    if (!mReaders)
+    {
+        return;
+    }
+
+    std::vector<std::unique_ptr<SqliteAccountState>> idle;
+    std::unique_lock<std::mutex> g(mReaders->mMutex);
+
+    mReaders->mClosed = true;
+    mReaders->mOpen -= static_cast<unsigned>(mReaders->mIdle.size());
+    idle.swap(mReaders->mIdle);
+
+    // Make the queries in progress end early
+    for (auto* reader: mReaders->mLeased)
+    {
+        sqlite3_interrupt(reader);
+    }
+
+    mReaders->mReturned.wait(g,
+                             [this]()
+                             {
+                                 return mReaders->mLeased.empty();
+                             });
+
+    g.unlock();
+    idle.clear();
+}
+
 int SqliteAccountState::progressHandler(void *param)
 {
     CancelToken* cancelFlag = static_cast<CancelToken*>(param);
@@ -1114,6 +1447,7 @@ bool SqliteAccountState::remove(NodeHandle nodehandle)
     }
 
     checkTransaction();
+    ++mChanges;
 
     char buf[64];
 
@@ -1133,6 +1467,7 @@ bool SqliteAccountState::removeNodes()
     }
 
     checkTransaction();
+    ++mChanges;
 
     int sqlResult = sqlite3_exec(db, "DELETE FROM nodes", 0, 0, NULL);
     errorHandler(sqlResult, "Delete nodes", false);
@@ -1148,6 +1483,7 @@ void SqliteAccountState::updateCounter(NodeHandle nodeHandle, const std::string&
     }
 
     checkTransaction();
+    ++mChanges;
 
     int sqlResult = SQLITE_OK;
     if (!mStmtUpdateNode)
@@ -1183,6 +1519,7 @@ void SqliteAccountState::updateCounterAndFlags(NodeHandle nodeHandle, uint64_t f
     }
 
     checkTransaction();
+    ++mChanges;
 
     int sqlResult = SQLITE_OK;
     if (!mStmtUpdateNodeAndFlags)
@@ -1231,6 +1568,17 @@ void SqliteAccountState::createIndexes(bool enableIndexesForSearching,
         LOG_err << "Data base error while creating index (parenthandleindex): " << sqlite3_errmsg(db);
     }
 
+    // Covers getRecentFiles(), so recent actions are bucketed without reading any node.
+    // SQLite keeps it up to date as nodes are put and removed.
+    sql = "CREATE INDEX IF NOT EXISTS recentsindex on nodes (ctime DESC, flags, nodehandle, "
+          "parenthandle, ownerVirtual, mediaVirtual) WHERE type = " +
+          std::to_string(FILENODE);
+    result = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
+    if (result)
+    {
+        LOG_err << "Data base error while creating index (recentsindex): " << sqlite3_errmsg(db);
+    }
+
     sql = "CREATE INDEX IF NOT EXISTS fingerprintindex on nodes (fingerprint)";
     result = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
     if (result)
@@ -1346,6 +1694,7 @@ void SqliteAccountState::dropDBIndexes(const std::vector<std::string>& indicesTo
 
 void SqliteAccountState::remove()
 {
+    closeReaders();
     finalise();
 
     SqliteDbTable::remove();
@@ -1440,6 +1789,7 @@ bool SqliteAccountState::put(Node *node)
     }
 
     checkTransaction();
+    ++mChanges;
 
     int sqlResult = SQLITE_OK;
     if (!mStmtPutNode)
@@ -2457,25 +2807,29 @@ bool SqliteAccountState::getNodeByFingerprint(const std::string &fingerprint, me
     return result;
 }
 
-bool SqliteAccountState::getRecentNodes(const NodeSearchPage& page,
+bool SqliteAccountState::getRecentFiles(const NodeSearchPage& page,
                                         m_time_t since,
-                                        std::vector<std::pair<NodeHandle, NodeSerialized>>& nodes)
+                                        std::vector<RecentFile>& files)
 {
     if (!db)
     {
         return false;
     }
 
+    // The type must be compared with the same literal as recentsindex for it to be used.
+    // Files with previous versions are found through parenthandleindex.
     constexpr uint64_t excludeFlags =
         (1 << Node::FLAGS_IS_VERSION | 1 << Node::FLAGS_IS_IN_RUBBISH);
     static const std::string filenode = std::to_string(FILENODE);
-    static const std::string sqlQuery = "SELECT n1.nodehandle, n1.counter, n1.node "
-                                        "FROM nodes n1 "
-                                        "WHERE n1.flags & " +
-                                        std::to_string(excludeFlags) +
-                                        " = 0 AND n1.ctime >= ?1 AND n1.type = " + filenode +
-                                        " "
-                                        "ORDER BY n1.ctime DESC LIMIT ?2 OFFSET ?3";
+    static const std::string sqlQuery =
+        "SELECT n1.nodehandle, n1.parenthandle, n1.ownerVirtual, n1.ctime, n1.flags, "
+        "n1.mediaVirtual, "
+        "EXISTS (SELECT 1 FROM nodes n2 WHERE n2.parenthandle = n1.nodehandle) "
+        "FROM nodes n1 "
+        "WHERE n1.type = " +
+        filenode + " AND n1.flags & " + std::to_string(excludeFlags) +
+        " = 0 AND n1.ctime >= ?1 "
+        "ORDER BY n1.ctime DESC LIMIT ?2 OFFSET ?3";
 
     int sqlResult = SQLITE_OK;
     if (!mStmtRecents)
@@ -2490,12 +2844,28 @@ bool SqliteAccountState::getRecentNodes(const NodeSearchPage& page,
         sqlResult == sqlite3_bind_int64(mStmtRecents, 2, nodeCount) &&
         sqlResult == sqlite3_bind_int64(mStmtRecents, 3, offset))
     {
-        stepResult = processSqlQueryNodes(mStmtRecents, nodes);
+        int result = SQLITE_ERROR;
+        while ((result = sqlite3_step(mStmtRecents)) == SQLITE_ROW)
+        {
+            RecentFile file;
+            file.nodeHandle.set6byte(static_cast<uint64_t>(sqlite3_column_int64(mStmtRecents, 0)));
+            file.parentHandle.set6byte(
+                static_cast<uint64_t>(sqlite3_column_int64(mStmtRecents, 1)));
+            file.owner = static_cast<handle>(sqlite3_column_int64(mStmtRecents, 2));
+            file.ctime = sqlite3_column_int64(mStmtRecents, 3);
+            file.flags = static_cast<uint64_t>(sqlite3_column_int64(mStmtRecents, 4));
+            file.media = sqlite3_column_int(mStmtRecents, 5) != 0;
+            file.updated = sqlite3_column_int(mStmtRecents, 6) != 0;
+            files.push_back(file);
+        }
+
+        errorHandler(result, "Get recent files", true);
+        stepResult = result == SQLITE_DONE;
     }
 
     if (sqlResult != SQLITE_OK)
     {
-        errorHandler(sqlResult, "Get recent nodes", false);
+        errorHandler(sqlResult, "Get recent files", false);
     }
 
     sqlite3_reset(mStmtRecents);
@@ -2813,6 +3183,67 @@ void SqliteAccountState::getSizeFromNodeCounter(sqlite3_context* context,
     sqlite3_result_int64(context, nc.storage);
 }
 
+void SqliteAccountState::getOwnerFromNode(sqlite3_context* context, int argc, sqlite3_value** argv)
+{
+    if (argc != 1)
+    {
+        LOG_err << "getOwnerFromNode: Invalid parameters for getOwnerFromNode";
+        assert(argc == 1);
+        sqlite3_result_null(context);
+        return;
+    }
+
+    // in the legacy format, the owner follows the size, the node handle and the parent handle
+    constexpr size_t ownerOffset = sizeof(m_off_t) + 2 * MegaClient::NODEHANDLE;
+
+    const auto blob = static_cast<const char*>(sqlite3_value_blob(argv[0]));
+    const auto blobSize = static_cast<size_t>(sqlite3_value_bytes(argv[0]));
+
+    if (blob && NodeRecord::isRecord(blob, blobSize))
+    {
+        NodeRecord record(blob, blobSize);
+
+        if (record.valid())
+        {
+            sqlite3_result_int64(context, static_cast<sqlite3_int64>(record.owner()));
+        }
+        else
+        {
+            sqlite3_result_null(context);
+        }
+        return;
+    }
+
+    if (!blob || blobSize < ownerOffset + MegaClient::USERHANDLE)
+    {
+        LOG_err << "getOwnerFromNode: invalid node blob";
+        sqlite3_result_null(context);
+        return;
+    }
+
+    handle owner = 0;
+    memcpy(&owner, blob + ownerOffset, MegaClient::USERHANDLE);
+    sqlite3_result_int64(context, static_cast<sqlite3_int64>(owner));
+}
+
+void SqliteAccountState::userIsMedia(sqlite3_context* context, int argc, sqlite3_value** argv)
+{
+    if (argc != 1)
+    {
+        LOG_err << "Invalid parameters for userIsMedia";
+        assert(argc == 1);
+        sqlite3_result_int(context, 0);
+        return;
+    }
+
+    // same as MegaClient::nodeIsMedia(), which only looks at the extension
+    const char* fileName = reinterpret_cast<const char*>(sqlite3_value_text(argv[0]));
+    string ext;
+    bool result = fileName && *fileName && Node::getExtension(ext, fileName) &&
+                  (Node::isPhoto(ext) || Node::isVideo(ext));
+    sqlite3_result_int(context, result);
+}
+
 void SqliteAccountState::userGetMimetype(sqlite3_context* context, int argc, sqlite3_value** argv)
 {
     if (argc != 1)
@@ -511,6 +511,20 @@ void File::sendPutnodesOfUpload(MegaClient* client,
             pitag->target = inIncomingShare ? PitagTarget::IncomingShare : PitagTarget::CloudDrive;
         }
 
+        if (client->mBatchSmallUploads && size <= MegaClient::MAX_BATCHED_UPLOAD_SIZE)
+        {
+            // sent along with other small uploads completing at about the same time
+            client->putnodesOfSmallUpload(th,
+                                          mVersioningOption,
+                                          std::move(newnodes.front()),
+                                          tag,
+                                          source,
+                                          std::move(completion),
+                                          canChangeVault,
+                                          pitag);
+            return;
+        }
+
         client->queueCommand(new CommandPutNodes(client,
                                                  th,
                                                  NULL,
@@ -390,6 +390,82 @@ int compareUtf(const LocalPath& s1, bool unescaping1, const LocalPath& s2, bool
                               caseInsensitive ? Utils::toUpper : detail::identity);
 }
 
+UtfCollationKey::UtfCollationKey(const string& name, bool unescaping, bool caseInsensitive)
+  : mName(&name)
+  , mUnescaping(unescaping)
+  , mCaseInsensitive(caseInsensitive)
+  , mKeyed(!unescaping || name.find(static_cast<char>(detail::escapeChar)) == string::npos)
+{
+#ifdef _WIN32
+    // compareUtf skips path prefixes
+    mKeyed = mKeyed && name.compare(0, 2, "\\\\") != 0;
+#endif // _WIN32
+
+    if (!mKeyed)
+    {
+        return;
+    }
+
+    // ASCII names (most of them) need no decoding
+    auto ascii = std::all_of(name.begin(), name.end(), [](char c) { return !(c & 0x80); });
+
+    if (ascii)
+    {
+        if (!caseInsensitive)
+        {
+            mKey = name;
+            return;
+        }
+
+        mKey.resize(name.size());
+        std::transform(name.begin(), name.end(), mKey.begin(), [](char c)
+        {
+            return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+        });
+        return;
+    }
+
+    mKey.reserve(name.size());
+
+    auto data = reinterpret_cast<const utf8proc_uint8_t*>(name.data());
+    auto remaining = static_cast<utf8proc_ssize_t>(name.size());
+
+    while (remaining > 0)
+    {
+        utf8proc_int32_t c;
+        auto consumed = utf8proc_iterate(data, remaining, &c);
+
+        if (consumed <= 0)
+        {
+            mKeyed = false;
+            mKey.clear();
+            return;
+        }
+
+        data += consumed;
+        remaining -= consumed;
+
+        if (caseInsensitive)
+        {
+            c = Utils::toUpper(c);
+        }
+
+        utf8proc_uint8_t buffer[4];
+        auto length = utf8proc_encode_char(c, buffer);
+        mKey.append(reinterpret_cast<const char*>(buffer), static_cast<size_t>(length));
+    }
+}
+
+int UtfCollationKey::compare(const UtfCollationKey& other) const
+{
+    if (mKeyed && other.mKeyed)
+    {
+        return mKey.compare(other.mKey);
+    }
+
+    return compareUtf(*mName, mUnescaping, *other.mName, other.mUnescaping, mCaseInsensitive);
+}
+
 RemotePath::RemotePath(const string& path)
   : mPath(path)
 {
@@ -78,6 +78,16 @@ InodeRefVector DirectoryInode::children() const
     return mInodeDB.children(*this);
 }
 
+InodeRefVector DirectoryInode::children(const DirectorySnapshot& snapshot,
+                                        std::size_t begin,
+                                        std::size_t end) const
+{
+    InodeLock guard(*this);
+
+    // Ask the Inode DB to instantiate the requested children.
+    return mInodeDB.children(*this, snapshot, begin, end);
+}
+
 DirectoryInodeRef DirectoryInode::directory()
 {
     return DirectoryInodeRef(this);
@@ -323,6 +333,14 @@ Error DirectoryInode::replace(InodeBadge,
                             std::move(otherParent));
 }
 
+DirectorySnapshotPtr DirectoryInode::snapshot() const
+{
+    InodeLock guard(*this);
+
+    // Ask the Inode DB what children we contain.
+    return mInodeDB.snapshot(*this);
+}
+
 Error DirectoryInode::unlink(const std::string& name, std::function<Error(InodeRef)> predicate)
 {
     // Invalid name.
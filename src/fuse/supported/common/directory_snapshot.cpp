@@ -0,0 +1,151 @@
+#include <mega/fuse/common/directory_snapshot.h>
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace mega
+{
+namespace fuse
+{
+
+using namespace common;
+
+// Order the specified children by name.
+static std::vector<std::size_t> byName(const NodeInfoVector& children);
+
+DirectorySnapshot::CloudChildren::CloudChildren(NodeInfoVector children):
+    mByName(byName(children)),
+    mChildren(),
+    mDuplicates()
+{
+    // Determine which names are shared by more than one child.
+    for (auto i = 1u; i < mByName.size(); ++i)
+    {
+        // Convenience.
+        auto& name = children[mByName[i]].mName;
+
+        // Name isn't shared with the previous child.
+        if (name != children[mByName[i - 1]].mName)
+            continue;
+
+        // Remember that this name is shared.
+        mDuplicates.emplace(name);
+    }
+
+    // No names are shared.
+    if (mDuplicates.empty())
+    {
+        mChildren = std::move(children);
+        return;
+    }
+
+    // Drop children whose name is shared.
+    children.erase(std::remove_if(children.begin(),
+                                  children.end(),
+                                  [&](const NodeInfo& info)
+                                  {
+                                      return mDuplicates.count(info.mName) > 0;
+                                  }),
+                   children.end());
+
+    // Recompute our index.
+    mByName = byName(children);
+
+    // Latch the remaining children.
+    mChildren = std::move(children);
+}
+
+const NodeInfo& DirectorySnapshot::CloudChildren::at(std::size_t index) const
+{
+    assert(index < mChildren.size());
+
+    return mChildren[index];
+}
+
+bool DirectorySnapshot::CloudChildren::contains(const std::string& name) const
+{
+    // Is the name shared by more than one child?
+    if (duplicate(name))
+        return true;
+
+    // Locate the first child whose name isn't less than name.
+    auto i = std::lower_bound(mByName.begin(),
+                              mByName.end(),
+                              name,
+                              [&](std::size_t index, const std::string& name)
+                              {
+                                  return mChildren[index].mName < name;
+                              });
+
+    // Is the name used by a single child?
+    return i != mByName.end() && mChildren[*i].mName == name;
+}
+
+bool DirectorySnapshot::CloudChildren::duplicate(const std::string& name) const
+{
+    return mDuplicates.count(name) > 0;
+}
+
+std::size_t DirectorySnapshot::CloudChildren::size() const
+{
+    return mChildren.size();
+}
+
+DirectorySnapshot::LocalChild::LocalChild(FileExtension extension, std::string name, InodeID id):
+    mExtension(std::move(extension)),
+    mName(std::move(name)),
+    mID(id)
+{}
+
+DirectorySnapshot::DirectorySnapshot(CloudChildrenPtr cloud,
+                                     LocalChildVector local,
+                                     NodeHandle parentHandle):
+    mCloud(std::move(cloud)),
+    mLocal(std::move(local)),
+    mParentHandle(parentHandle)
+{
+    // Sanity.
+    assert(mCloud);
+}
+
+auto DirectorySnapshot::cloud() const -> const CloudChildren&
+{
+    return *mCloud;
+}
+
+auto DirectorySnapshot::local() const -> const LocalChildVector&
+{
+    return mLocal;
+}
+
+NodeHandle DirectorySnapshot::parentHandle() const
+{
+    return mParentHandle;
+}
+
+std::size_t DirectorySnapshot::size() const
+{
+    return mCloud->size() + mLocal.size();
+}
+
+std::vector<std::size_t> byName(const NodeInfoVector& children)
+{
+    std::vector<std::size_t> indices(children.size());
+
+    // Every child is initially in enumeration order.
+    std::iota(indices.begin(), indices.end(), 0u);
+
+    // Order children by name.
+    std::sort(indices.begin(),
+              indices.end(),
+              [&](std::size_t lhs, std::size_t rhs)
+              {
+                  return children[lhs].mName < children[rhs].mName;
+              });
+
+    return indices;
+}
+
+} // fuse
+} // mega
@@ -10,7 +10,9 @@
 #include <mega/fuse/common/any_lock.h>
 #include <mega/fuse/common/any_lock_set.h>
 #include <mega/fuse/common/client.h>
+#include <mega/fuse/common/constants.h>
 #include <mega/fuse/common/directory_inode.h>
+#include <mega/fuse/common/directory_snapshot.h>
 #include <mega/fuse/common/file_cache.h>
 #include <mega/fuse/common/file_info.h>
 #include <mega/fuse/common/file_inode.h>
@@ -24,9 +26,11 @@
 #include <mega/fuse/platform/service_context.h>
 #include <mega/utils.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <map>
+#include <optional>
 #include <tuple>
 
 namespace mega
@@ -332,160 +336,117 @@ void InodeDB::childRemoved([[maybe_unused]] const Inode& inode,
 
 InodeRefVector InodeDB::children(const DirectoryInode& parent) const
 {
-    // Convenience.
-    using StringToNodeInfoPtrMap = std::map<std::string, NodeInfoList::iterator>;
-
-    // Stores the description of each of this node's children.
-    NodeInfoList storage;
-
-    // Maps a child's name to its description.
-    StringToNodeInfoPtrMap descriptions;
-
-    // Insert dummy for purposes of duplicate detection.
-    storage.emplace_back();
-
-    // What children are present in the cloud?
-    client().each(
-        [&](NodeInfo description)
-        {
-            // Have we seen a child with this name before?
-            auto i = descriptions.find(description.mName);
-
-            // Haven't seen a child with this name before.
-            if (i == descriptions.end())
-            {
-                auto j = storage.end();
-
-                // Latch the child's description.
-                j = storage.emplace(j, std::move(description));
-
-                // Add child to index.
-                descriptions[j->mName] = j;
-
-                // Process the next child.
-                return;
-            }
-
-            // We've already detected a duplicate with this name.
-            if (i->second == storage.begin())
-                return;
+    // What children does the directory contain?
+    auto snapshot = this->snapshot(parent);
 
-            // Remove existing child's description.
-            storage.erase(i->second);
+    // Instantiate all of the directory's children.
+    auto children = this->children(parent, *snapshot, 0, snapshot->size());
 
-            // Mark name as a duplicate.
-            i->second = storage.begin();
-        },
-        parent.handle());
-
-    auto guard = lockAll(mContext.mDatabase, *this);
-
-    auto transaction = mContext.mDatabase.transaction();
-    auto query = transaction.query(mQueries.mGetChildrenByParentHandle);
-
-    // What children are present on disk?
-    query.param(":parent_handle").set(parent.handle());
-    query.execute();
+    // Prune children that no longer exist.
+    children.erase(std::remove_if(children.begin(),
+                                  children.end(),
+                                  [](const InodeRef& child)
+                                  {
+                                      return !child;
+                                  }),
+                   children.end());
 
-    // What children need to be loaded?
-    struct PendingChild
-    {
-        PendingChild(FileExtension extension, std::string name, InodeID id):
-            mExtension(std::move(extension)),
-            mName(std::move(name)),
-            mID(id)
-        {}
+    // Return children to caller.
+    return children;
+}
 
-        // The child's extension.
-        FileExtension mExtension;
+InodeRefVector InodeDB::children(const DirectoryInode& parent,
+                                 const DirectorySnapshot& snapshot,
+                                 std::size_t begin,
+                                 std::size_t end) const
+{
+    // Convenience.
+    auto& cloud = snapshot.cloud();
+    auto& local = snapshot.local();
 
-        // The child's name.
-        std::string mName;
+    // Clamp range.
+    end = std::min(end, snapshot.size());
+    begin = std::min(begin, end);
 
-        // The child's ID.
-        InodeID mID;
-    }; // PendingChild
+    // Which cloud children have been requested?
+    auto cloudBegin = std::min(begin, cloud.size());
+    auto cloudEnd = std::min(end, cloud.size());
 
-    using PendingChildVector = std::vector<PendingChild>;
+    // Latch the description of each requested cloud child.
+    std::vector<std::optional<NodeInfo>> infos;
 
-    // Children waiting to be loaded.
-    PendingChildVector pending;
+    infos.reserve(cloudEnd - cloudBegin);
 
-    // What children have been removed or replaced?
-    InodeIDVector removed;
+    for (auto i = cloudBegin; i < cloudEnd; ++i)
+        infos.emplace_back(cloud.at(i));
 
-    for (; query; ++query)
+    // The directory's cloud children have changed since the snapshot was taken.
+    if (!current(snapshot))
     {
-        auto id = query.field("id").get<InodeID>();
-        auto name = query.field("name").get<std::string>();
-
-        // Have we already seen a cloud child with this name?
-        auto i = descriptions.find(name);
-
-        // A child with this name is present in the cloud.
-        if (i != descriptions.end())
+        for (auto& info: infos)
         {
-            // Child was a duplicate.
-            if (i->second == storage.begin())
-                continue;
+            // What does the client know about this child now?
+            auto result = client().get(info->mHandle);
 
-            // Cloud child has replaced this local child.
-            removed.emplace_back(id);
+            // Child no longer exists or is no longer below this directory.
+            if (!result || result->mParentHandle != snapshot.parentHandle())
+            {
+                info.reset();
+                continue;
+            }
 
-            // Process next local child.
-            continue;
+            // Latch the child's current description.
+            info = std::move(*result);
         }
-
-        // Child exists only locally.
-        pending.emplace_back(fileExtensionDB().get(query.field("extension").get<std::string>()),
-                             std::move(name),
-                             id);
     }
 
+    auto guard = lockAll(mContext.mDatabase, *this);
+
+    auto transaction = mContext.mDatabase.transaction();
+    auto query = transaction.query(mQueries.mGetExtensionAndInodeIDByHandle);
+
     InodeRefVector children;
 
     // Convenience.
     auto& self = const_cast<InodeDB&>(*this);
 
-    // Pop dummy marker.
-    storage.pop_front();
-
-    // Prepare query.
-    query = transaction.query(mQueries.mGetExtensionAndInodeIDByHandle);
+    // What children have been removed?
+    InodeIDVector removed;
 
     // Instantiate cloud children.
-    while (!storage.empty())
+    for (auto& info: infos)
     {
-        // Latch child's description.
-        auto info = std::move(storage.front());
-
-        // Pop description.
-        storage.pop_front();
+        // Child no longer exists.
+        if (!info)
+        {
+            children.emplace_back();
+            continue;
+        }
 
         // Instantiate child.
         children.emplace_back((
             [&]()
             {
                 // Is the child already in memory?
-                auto h = mByHandle.find(info.mHandle);
+                auto h = mByHandle.find(info->mHandle);
 
                 // Child's already in memory.
                 if (h != mByHandle.end())
                     return InodeRef(h->second->accessed());
 
                 // Child's a directory.
-                if (info.mIsDirectory)
-                    return self.add(&InodeDB::buildDirectory, info);
+                if (info->mIsDirectory)
+                    return self.add(&InodeDB::buildDirectory, *info);
 
                 query.reset();
 
                 // Check if child's in the file cache.
-                query.param(":handle").set(info.mHandle);
+                query.param(":handle").set(info->mHandle);
                 query.execute();
 
                 // Child's not in the file cache.
                 if (!query)
-                    return self.add(&InodeDB::buildFile, info);
+                    return self.add(&InodeDB::buildFile, *info);
 
                 // Convenience.
                 auto extension = fileExtensionDB().get(query.field("extension").get<std::string>());
@@ -501,11 +462,11 @@ InodeRefVector InodeDB::children(const DirectoryInode& parent) const
                     removed.emplace_back(id);
 
                     // Return new child instance.
-                    return self.add(&InodeDB::buildFile, info);
+                    return self.add(&InodeDB::buildFile, *info);
                 }
 
                 // Instantiate child.
-                auto ptr = std::make_unique<FileInode>(id, info, self);
+                auto ptr = std::make_unique<FileInode>(id, *info, self);
 
                 // Inject file info.
                 ptr->fileInfo(std::move(fileInfo));
@@ -514,7 +475,7 @@ InodeRefVector InodeDB::children(const DirectoryInode& parent) const
                 auto ref = InodeRef(ptr->accessed());
 
                 // Add child to index.
-                mByHandle.emplace(info.mHandle, ptr.get());
+                mByHandle.emplace(info->mHandle, ptr.get());
                 mByID.emplace(id, std::move(ptr));
 
                 // Return new child instance.
@@ -522,40 +483,55 @@ InodeRefVector InodeDB::children(const DirectoryInode& parent) const
             })());
     }
 
+    // Which local children have been requested?
+    auto localBegin = std::max(begin, cloud.size()) - cloud.size();
+    auto localEnd = std::max(end, cloud.size()) - cloud.size();
+
+    query = transaction.query(mQueries.mGetHandleByID);
+
     // Instantiate local children.
-    while (!pending.empty())
+    for (auto i = localBegin; i < localEnd; ++i)
     {
         // Convenience.
-        auto& child = pending.back();
-
-        // Pop child's name and ID.
-        auto extension = std::move(child.mExtension);
-        auto name = std::move(child.mName);
-        auto id = child.mID;
-
-        pending.pop_back();
+        auto& child = local[i];
 
         // Is the child already in memory?
-        auto i = mByID.find(id);
+        auto j = mByID.find(child.mID);
 
         // Child's already in memory.
-        if (i != mByID.end())
+        if (j != mByID.end())
         {
             // Add child to vector.
-            children.emplace_back(i->second->accessed());
+            children.emplace_back(j->second->accessed());
 
             // Process next child.
             continue;
         }
 
+        query.reset();
+
+        // Make sure the child hasn't been removed since the snapshot was taken.
+        query.param(":id").set(child.mID);
+        query.execute();
+
+        // Child's been removed.
+        if (!query)
+        {
+            children.emplace_back();
+            continue;
+        }
+
         // Try and get our hands on the file's info.
-        auto fileInfo = fileCache().info(extension, id);
+        auto fileInfo = fileCache().info(child.mExtension, child.mID);
 
         // File's been removed from the cache.
         if (!fileInfo)
         {
             // Remember to purge stale record.
-            removed.emplace_back(id);
+            removed.emplace_back(child.mID);
+
+            // Let the caller know the child no longer exists.
+            children.emplace_back();
 
             // Process next child.
             continue;
@@ -564,11 +540,11 @@ InodeRefVector InodeDB::children(const DirectoryInode& parent) const
         NodeInfo info;
 
         // Populate dummy description.
-        info.mName = std::move(name);
+        info.mName = child.mName;
         info.mParentHandle = parent.handle();
 
         // Instantiate child.
-        auto ptr = std::make_unique<FileInode>(id, info, self);
+        auto ptr = std::make_unique<FileInode>(child.mID, info, self);
 
         // Inject file info.
         ptr->fileInfo(std::move(fileInfo));
@@ -577,7 +553,7 @@ InodeRefVector InodeDB::children(const DirectoryInode& parent) const
         children.emplace_back(ptr.get());
 
         // Add child to index.
-        mByID.emplace(id, std::move(ptr));
+        mByID.emplace(child.mID, std::move(ptr));
     }
 
     query = transaction.query(mQueries.mRemoveInodeByID);
@@ -597,11 +573,88 @@ InodeRefVector InodeDB::children(const DirectoryInode& parent) const
     return children;
 }
 
+auto InodeDB::cloudChildren(NodeHandle parentHandle) const -> DirectorySnapshot::CloudChildrenPtr
+{
+    std::uint64_t generation;
+
+    // Have we already enumerated this directory's cloud children?
+    {
+        InodeDBLock guard(*this);
+
+        auto i = mCloudChildren.find(parentHandle);
+
+        // Directory's children are already known.
+        if (i != mCloudChildren.end())
+        {
+            // Directory's now the most recently used.
+            mCloudChildrenLRU.splice(mCloudChildrenLRU.begin(),
+                                     mCloudChildrenLRU,
+                                     i->second.second);
+
+            return i->second.first;
+        }
+
+        // Latch generation so we can tell if the cloud changes under us.
+        generation = mCloudChildrenGeneration;
+    }
+
+    NodeInfoVector children;
+
+    // What children are present in the cloud?
+    client().each(
+        [&](NodeInfo description)
+        {
+            children.emplace_back(std::move(description));
+        },
+        parentHandle);
+
+    // Index the children by name.
+    auto cloud = std::make_shared<const DirectorySnapshot::CloudChildren>(std::move(children));
+
+    InodeDBLock guard(*this);
+
+    // The cloud has changed since we enumerated the directory's children.
+    if (generation != mCloudChildrenGeneration)
+        return cloud;
+
+    // Another enumeration has already described this directory.
+    if (auto i = mCloudChildren.find(parentHandle); i != mCloudChildren.end())
+        return i->second.first;
+
+    // Make room for this directory if necessary.
+    if (mCloudChildren.size() >= MaxCachedDirectories)
+    {
+        // Evict the least recently used directory.
+        mCloudChildren.erase(mCloudChildrenLRU.back());
+        mCloudChildrenLRU.pop_back();
+    }
+
+    // Remember what children the directory contains.
+    mCloudChildrenLRU.emplace_front(parentHandle);
+
+    mCloudChildren.emplace(parentHandle,
+                           CloudChildrenEntry(cloud, mCloudChildrenLRU.begin()));
+
+    // Return children to caller.
+    return cloud;
+}
+
 void InodeDB::current()
 {
     // No-op for now but left in case we need it later.
 }
 
+bool InodeDB::current(const DirectorySnapshot& snapshot) const
+{
+    InodeDBLock guard(*this);
+
+    // Do we still know what children this directory contains?
+    auto i = mCloudChildren.find(snapshot.parentHandle());
+
+    // Snapshot's current if it shares our description of the directory.
+    return i != mCloudChildren.end() && i->second.first == snapshot.mCloud;
+}
+
 bool InodeDB::discard() const
 {
     InodeDBLock guard(*this);
@@ -609,6 +662,33 @@ bool InodeDB::discard() const
     return mDiscard;
 }
 
+void InodeDB::forget() const
+{
+    InodeDBLock guard(*this);
+
+    // Forget what we know about every directory's cloud children.
+    mCloudChildren.clear();
+    mCloudChildrenLRU.clear();
+
+    // Let in-progress enumerations know they're stale.
+    ++mCloudChildrenGeneration;
+}
+
+void InodeDB::forget(NodeHandle parentHandle) const
+{
+    InodeDBLock guard(*this);
+
+    // Forget what we know about this directory's cloud children.
+    if (auto i = mCloudChildren.find(parentHandle); i != mCloudChildren.end())
+    {
+        mCloudChildrenLRU.erase(i->second.second);
+        mCloudChildren.erase(i);
+    }
+
+    // Let in-progress enumerations know they're stale.
+    ++mCloudChildrenGeneration;
+}
+
 InodeRef InodeDB::get(Client& client, NodeHandle handle) const
 {
     // Sanity.
@@ -1021,6 +1101,9 @@ ErrorOr<MakeInodeResult> InodeDB::makeDirectory(const platform::Mount&,
     // Lock the database.
     InodeDBLock guard(*this);
 
+    // The parent's gained a child.
+    forget(info.mParentHandle);
+
     // Has another thread instantiated an inode for this directory?
     auto ref = get(info.mHandle, true);
 
@@ -1146,8 +1229,22 @@ Error InodeDB::move(InodeRef source, const std::string& targetName, DirectoryIno
     assert(!targetName.empty());
     assert(targetParent);
 
+    // Convenience.
+    auto sourceParentHandle = source->parentHandle();
+
     // Ask the client to move the child.
-    return client().move(targetName, source->handle(), targetParent->handle());
+    auto result = client().move(targetName, source->handle(), targetParent->handle());
+
+    // Couldn't move the child.
+    if (result != API_OK)
+        return result;
+
+    // The child's old and new parents have changed.
+    forget(sourceParentHandle);
+    forget(targetParent->handle());
+
+    // Child's been moved.
+    return result;
 }
 
 Error InodeDB::move(FileInodeRef source,
@@ -1332,6 +1429,12 @@ Error InodeDB::replace(FileInodeRef source,
     // Lock database.
     auto lock = lockAll(mContext.mDatabase, *this);
 
+    // The source's and target's parents may have changed.
+    if (sourceParent)
+        forget(sourceParent->handle());
+
+    forget(targetParentHandle);
+
     auto transaction = mContext.mDatabase.transaction();
     auto query = transaction.query(mQueries.mRemoveInodeByID);
 
@@ -1387,8 +1490,85 @@ Error InodeDB::replace(DirectoryInodeRef source,
     assert(source);
     assert(target);
 
+    // Convenience.
+    auto sourceParentHandle = source->parentHandle();
+    auto targetParentHandle = target->parentHandle();
+
     // Ask the client to replace target with source.
-    return client().replace(source->handle(), target->handle());
+    auto result = client().replace(source->handle(), target->handle());
+
+    // Couldn't replace the target.
+    if (result != API_OK)
+        return result;
+
+    // The source's and target's parents have changed.
+    forget(sourceParentHandle);
+    forget(targetParentHandle);
+
+    // Target's been replaced.
+    return result;
+}
+
+DirectorySnapshotPtr InodeDB::snapshot(const DirectoryInode& parent) const
+{
+    // Convenience.
+    auto parentHandle = parent.handle();
+
+    // What children are present in the cloud?
+    auto cloud = cloudChildren(parentHandle);
+
+    auto guard = lockAll(mContext.mDatabase, *this);
+
+    auto transaction = mContext.mDatabase.transaction();
+    auto query = transaction.query(mQueries.mGetChildrenByParentHandle);
+
+    // What children are present on disk?
+    query.param(":parent_handle").set(parentHandle);
+    query.execute();
+
+    // Children that exist only on disk.
+    DirectorySnapshot::LocalChildVector local;
+
+    // What children have been replaced?
+    InodeIDVector removed;
+
+    for (; query; ++query)
+    {
+        auto id = query.field("id").get<InodeID>();
+        auto name = query.field("name").get<std::string>();
+
+        // A child with this name is present in the cloud.
+        if (cloud->contains(name))
+        {
+            // Cloud child has replaced this local child.
+            if (!cloud->duplicate(name))
+                removed.emplace_back(id);
+
+            // Process next local child.
+            continue;
+        }
+
+        // Child exists only locally.
+        local.emplace_back(fileExtensionDB().get(query.field("extension").get<std::string>()),
+                           std::move(name),
+                           id);
+    }
+
+    query = transaction.query(mQueries.mRemoveInodeByID);
+
+    // Prune stale database records.
+    for (auto id: removed)
+    {
+        query.param(":id").set(id);
+        query.execute();
+        query.reset();
+    }
+
+    // Commit transaction.
+    transaction.commit();
+
+    // Return snapshot to caller.
+    return std::make_shared<DirectorySnapshot>(std::move(cloud), std::move(local), parentHandle);
 }
 
 Error InodeDB::unlink(InodeRef inode)
@@ -1403,6 +1583,9 @@ Error InodeDB::unlink(InodeRef inode)
     if (result != API_OK)
         return result;
 
+    // The inode's parent has lost a child.
+    forget(inode->parentHandle());
+
     // Mark inode as removed.
     inode->removed(true);
 
@@ -1429,6 +1612,9 @@ Error InodeDB::unlink(FileInodeRef file)
         // Couldn't remove the file.
         if (result != API_OK)
             return result;
+
+        // The file's parent has lost a child.
+        forget(parent->handle());
     }
 
     // Remove the file from the database.
@@ -1465,6 +1651,9 @@ InodeDB::InodeDB(platform::ServiceContext& context):
     mByHandle(),
     mByID(),
     mByParentHandleAndName(),
+    mCloudChildren(),
+    mCloudChildrenLRU(),
+    mCloudChildrenGeneration(0u),
     mCV(),
     mContext(context),
     mDiscard(false),
@@ -1560,6 +1749,10 @@ void InodeDB::discard(bool discard)
 {
     InodeDBLock guard(*this);
 
+    // Events discarded so far may have changed any directory.
+    if (mDiscard != discard)
+        forget();
+
     mDiscard = discard;
 }
 
@@ -1807,6 +2000,9 @@ void InodeDB::updated(NodeEventQueue& events)
 
     // Discarding node events.
     FUSEDebugF("Discarding %zu node event(s)", events.size());
+
+    // We can't tell which directories the events changed.
+    forget();
 }
 
 void InodeDB::EventObserver::added(const NodeEvent& event)
@@ -1821,6 +2017,9 @@ void InodeDB::EventObserver::added(const NodeEvent& event)
                toNodeHandle(handle).c_str(),
                toNodeHandle(parentHandle).c_str());
 
+    // The parent's cloud children have changed.
+    mInodeDB.forget(parentHandle);
+
     // Node replaces an in-memory inode.
     if (auto ref = mInodeDB.child(name, parentHandle, MemoryOnly))
     {
@@ -1911,6 +2110,9 @@ void InodeDB::EventObserver::modified(const NodeEvent& event)
                toNodeHandle(handle).c_str(),
                toNodeHandle(parentHandle).c_str());
 
+    // The parent's cloud children may have been renamed.
+    mInodeDB.forget(parentHandle);
+
     // Has an inode in memory been updated in the cloud?
     auto ref = mInodeDB.get(handle, true);
 
@@ -1938,6 +2140,17 @@ void InodeDB::EventObserver::moved(const NodeEvent& event)
                toNodeHandle(handle).c_str(),
                toNodeHandle(parentHandle).c_str());
 
+    // The node's new parent has gained a child.
+    mInodeDB.forget(parentHandle);
+
+    // The node's old parent is known so forget only about its children.
+    if (auto ref = mInodeDB.get(handle, true))
+        mInodeDB.forget(ref->parentHandle(CachedOnly));
+
+    // Otherwise, any directory may have lost a child.
+    else
+        mInodeDB.forget();
+
     // Node replaces an in-memory inode at this location.
     if (auto ref = mInodeDB.child(name, parentHandle, MemoryOnly))
     {
@@ -2046,6 +2259,9 @@ void InodeDB::EventObserver::removed(const NodeEvent& event)
                toNodeHandle(handle).c_str(),
                toNodeHandle(parentHandle).c_str());
 
+    // The parent's cloud children have changed.
+    mInodeDB.forget(parentHandle);
+
     // Disable any mounts that might be associated with this node.
     if (event.isDirectory())
         mountDB().disable(event.handle());
@@ -7,6 +7,8 @@ namespace fuse
 
 constexpr auto FilesystemID = 0x4d454741ul;
 constexpr auto BlockSize = 4096u;
+constexpr auto DirectoryPageSize = 1024u;
+constexpr auto MaxCachedDirectories = 64u;
 constexpr auto MaxNameLength = 255u;
 
 } // fuse
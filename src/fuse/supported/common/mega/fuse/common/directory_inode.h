@@ -3,11 +3,13 @@
 #include <mega/common/error_or_forward.h>
 #include <mega/fuse/common/directory_inode_forward.h>
 #include <mega/fuse/common/directory_inode_results.h>
+#include <mega/fuse/common/directory_snapshot_forward.h>
 #include <mega/fuse/common/file_move_flag_forward.h>
 #include <mega/fuse/common/inode.h>
 #include <mega/fuse/platform/mount_forward.h>
 #include <mega/types.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <string>
@@ -37,6 +39,11 @@ public:
     // Retrieve a list of this directory's children.
     InodeRefVector children() const;
 
+    // Retrieve some of the children in a snapshot.
+    InodeRefVector children(const DirectorySnapshot& snapshot,
+                            std::size_t begin,
+                            std::size_t end) const;
+
     // Return a specialized reference to this directory.
     DirectoryInodeRef directory() override;
 
@@ -81,6 +88,9 @@ public:
                   const std::string& otherName,
                   DirectoryInodeRef otherParent) override;
 
+    // Take a snapshot of this directory's children.
+    DirectorySnapshotPtr snapshot() const;
+
     // Unlink a child.
     Error unlink(const std::string& name, std::function<Error(InodeRef)> predicate);
 
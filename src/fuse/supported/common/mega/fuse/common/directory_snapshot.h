@@ -0,0 +1,106 @@
+#pragma once
+
+#include <mega/common/node_info.h>
+#include <mega/fuse/common/directory_snapshot_forward.h>
+#include <mega/fuse/common/file_extension_db.h>
+#include <mega/fuse/common/inode_id.h>
+#include <mega/types.h>
+
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace mega
+{
+namespace fuse
+{
+
+// Describes a directory's children at some point in time.
+//
+// Enumerating a directory's children in the cloud is expensive for large
+// directories so the inode database keeps what it learns about them
+// until one of them changes. A snapshot pairs those cloud children with
+// the directory's local children, giving each an index so that they can
+// be listed a page at a time.
+//
+// Cloud children come first, followed by local children.
+class DirectorySnapshot
+{
+public:
+    // What children does a directory contain in the cloud?
+    class CloudChildren
+    {
+        // Indices of mChildren, ordered by name.
+        std::vector<std::size_t> mByName;
+
+        // The directory's children, without those whose name is shared.
+        common::NodeInfoVector mChildren;
+
+        // Names shared by more than one child.
+        std::set<std::string> mDuplicates;
+
+    public:
+        explicit CloudChildren(common::NodeInfoVector children);
+
+        // Retrieve a description of the specified child.
+        const common::NodeInfo& at(std::size_t index) const;
+
+        // Does the directory contain a child with this name?
+        bool contains(const std::string& name) const;
+
+        // Is this name shared by more than one child?
+        bool duplicate(const std::string& name) const;
+
+        // How many children does the directory contain?
+        std::size_t size() const;
+    }; // CloudChildren
+
+    using CloudChildrenPtr = std::shared_ptr<const CloudChildren>;
+
+    // A child that exists only on disk.
+    struct LocalChild
+    {
+        LocalChild(FileExtension extension, std::string name, InodeID id);
+
+        // The child's extension.
+        FileExtension mExtension;
+
+        // The child's name.
+        std::string mName;
+
+        // The child's ID.
+        InodeID mID;
+    }; // LocalChild
+
+    using LocalChildVector = std::vector<LocalChild>;
+
+    DirectorySnapshot(CloudChildrenPtr cloud, LocalChildVector local, NodeHandle parentHandle);
+
+    // What children does the directory contain in the cloud?
+    const CloudChildren& cloud() const;
+
+    // What children does the directory contain only on disk?
+    const LocalChildVector& local() const;
+
+    // Which directory does this snapshot describe?
+    NodeHandle parentHandle() const;
+
+    // How many children does the directory contain?
+    std::size_t size() const;
+
+private:
+    // Shared with the inode database while it remains current.
+    CloudChildrenPtr mCloud;
+
+    LocalChildVector mLocal;
+
+    NodeHandle mParentHandle;
+
+    // So the inode database can tell whether this snapshot is current.
+    friend class InodeDB;
+}; // DirectorySnapshot
+
+} // fuse
+} // mega
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <memory>
+
+namespace mega
+{
+namespace fuse
+{
+
+class DirectorySnapshot;
+
+using DirectorySnapshotPtr = std::shared_ptr<const DirectorySnapshot>;
+
+} // fuse
+} // mega
@@ -15,6 +15,7 @@
 #include <mega/fuse/common/any_lock_set_forward.h>
 #include <mega/fuse/common/directory_inode_forward.h>
 #include <mega/fuse/common/directory_inode_results.h>
+#include <mega/fuse/common/directory_snapshot.h>
 #include <mega/fuse/common/file_cache_forward.h>
 #include <mega/fuse/common/file_extension_db_forward.h>
 #include <mega/fuse/common/file_inode_forward.h>
@@ -28,6 +29,9 @@
 #include <mega/types.h>
 
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <list>
 #include <map>
 #include <mutex>
 #include <string>
@@ -115,6 +119,13 @@ class InodeDB final: public common::Lockable<InodeDB>, public common::NodeEventO
         }
     }; // NodeHandleStringPtrPairLess
 
+    // Directories whose cloud children we know, most recently used first.
+    using NodeHandleList = std::list<NodeHandle>;
+
+    // What children a directory contains and where it is in the list above.
+    using CloudChildrenEntry =
+      std::pair<DirectorySnapshot::CloudChildrenPtr, NodeHandleList::iterator>;
+
     // For convenience.
     template<typename T>
     using FromNodeHandleStringPtrPairMap =
@@ -210,9 +221,29 @@ class InodeDB final: public common::Lockable<InodeDB>, public common::NodeEventO
     // Retrieve a reference to a directory's children.
     InodeRefVector children(const DirectoryInode& parent) const;
 
+    // Retrieve a reference to some of the children in a snapshot.
+    //
+    // Children that no longer exist are represented by a null reference.
+    InodeRefVector children(const DirectoryInode& parent,
+                            const DirectorySnapshot& snapshot,
+                            std::size_t begin,
+                            std::size_t end) const;
+
+    // Retrieve a description of a directory's cloud children.
+    DirectorySnapshot::CloudChildrenPtr cloudChildren(NodeHandle parentHandle) const;
+
+    // Is the snapshot's description of the cloud still current?
+    bool current(const DirectorySnapshot& snapshot) const;
+
     // Are we discarding node events?
     bool discard() const;
 
+    // Forget what we know about every directory's cloud children.
+    void forget() const;
+
+    // Forget what we know about a directory's cloud children.
+    void forget(NodeHandle parentHandle) const;
+
     // Load an inode from the client.
     InodeRef get(common::Client& client, NodeHandle handle) const;
 
@@ -277,6 +308,9 @@ class InodeDB final: public common::Lockable<InodeDB>, public common::NodeEventO
                   const std::string& targetName,
                   DirectoryInodeRef targetParent);
 
+    // Take a snapshot of a directory's children.
+    DirectorySnapshotPtr snapshot(const DirectoryInode& parent) const;
+
     // Unlink an inode.
     Error unlink(InodeRef inode);
 
@@ -292,6 +326,15 @@ class InodeDB final: public common::Lockable<InodeDB>, public common::NodeEventO
     // Tracks which inode is visible under what parent with what name.
     mutable FromNodeHandleStringPtrPairMap<InodeRawPtr> mByParentHandleAndName;
 
+    // Tracks what children a directory contains in the cloud.
+    mutable std::map<NodeHandle, CloudChildrenEntry> mCloudChildren;
+
+    // Which directory's cloud children were used least recently.
+    mutable NodeHandleList mCloudChildrenLRU;
+
+    // Incremented whenever we forget about a directory's cloud children.
+    mutable std::uint64_t mCloudChildrenGeneration;
+
     // Signalled when an inode is purged from memory.
     std::condition_variable_any mCV;
 
@@ -513,6 +513,69 @@ TEST_F(FUSECommonTests, reload)
     EXPECT_EQ(fsidOf(client->storagePath() / "s" / "sdx" / "sf0"), sf0i);
 }
 
+TEST_F(FUSECommonTests, readdir_current_after_discard)
+{
+    // Create a new client so not to interfere with future tests.
+    auto client = CreateClient("readdir_discard_" + randomName());
+
+    // Log the client in.
+    ASSERT_EQ(client->login(1), API_OK);
+
+    auto handle = client->handle("/x/s");
+    ASSERT_EQ(handle.errorOr(API_OK), API_OK);
+
+    // Add a new mount.
+    MountInfo mount;
+
+    mount.mHandle = *handle;
+    mount.name("s");
+    mount.mPath = client->storagePath() / "s";
+
+    UNIX_ONLY(ASSERT_TRUE(fs::create_directories(Path(mount.mPath))));
+
+    ASSERT_EQ(client->addMount(mount), MOUNT_SUCCESS);
+
+    // Enable the mount.
+    ASSERT_EQ(client->enableMount(mount.name(), false), MOUNT_SUCCESS);
+
+    // Is name listed in the mount's root?
+    auto listed = [&](const std::string& name)
+    {
+        std::error_code error;
+
+        auto path = (client->storagePath() / "s").path();
+
+        for (fs::directory_iterator i(path, error), j; !error && i != j; i.increment(error))
+        {
+            if (i->path().filename() == fs::path(name))
+                return true;
+        }
+
+        return false;
+    };
+
+    // Enumerate the root so its cloud children are remembered.
+    ASSERT_TRUE(listed("sd0"));
+    ASSERT_FALSE(listed("sdy"));
+
+    // Tell FUSE to ignore node events.
+    ASSERT_EQ(client->discard(true), MOUNT_SUCCESS);
+
+    // Add sdy while events are being discarded.
+    ASSERT_EQ(client->makeDirectory("sdy", "/x/s").errorOr(API_OK), API_OK);
+
+    // Tell FUSE to process node events again.
+    ASSERT_EQ(client->discard(false), MOUNT_SUCCESS);
+
+    // The root's listing shouldn't be stale.
+    EXPECT_TRUE(waitFor(
+        [&]()
+        {
+            return listed("sdy");
+        },
+        mDefaultTimeout));
+}
+
 TEST_F(FUSECommonTests, share_changes_permissions)
 {
     // Convenience.
@@ -1,4 +1,6 @@
+#include <mega/fuse/common/constants.h>
 #include <mega/fuse/common/directory_inode.h>
+#include <mega/fuse/common/directory_snapshot.h>
 #include <mega/fuse/common/inode.h>
 #include <mega/fuse/common/inode_info.h>
 #include <mega/fuse/common/logging.h>
@@ -11,25 +13,43 @@ namespace fuse
 namespace platform
 {
 
+const InodeRef& DirectoryContext::child(std::size_t index) const
+{
+    // Child's on the page we've already instantiated.
+    if (index >= mChildrenBegin && index - mChildrenBegin < mChildren.size())
+        return mChildren[index - mChildrenBegin];
+
+    // Which page contains this child?
+    mChildrenBegin = index - index % DirectoryPageSize;
+
+    // Instantiate the children on that page.
+    mChildren =
+        mDirectory->children(*mSnapshot, mChildrenBegin, mChildrenBegin + DirectoryPageSize);
+
+    // Sanity.
+    assert(index - mChildrenBegin < mChildren.size());
+
+    // Return child to caller.
+    return mChildren[index - mChildrenBegin];
+}
+
 void DirectoryContext::populate() const
 {
     std::lock_guard<std::mutex> guard(mLock);
 
-    // Retrieve children if necessary.
-    if (!mPopulated)
-        mChildren = mDirectory->children();
-
-    // Remember that we've retrieved this directory's children.
-    mPopulated = true;
+    // Take a snapshot of the directory's children if necessary.
+    if (!mSnapshot)
+        mSnapshot = mDirectory->snapshot();
 }
 
 DirectoryContext::DirectoryContext(DirectoryInodeRef directory, fuse::Mount& mount):
     Context(mount),
     mChildren(),
+    mChildrenBegin(0u),
     mDirectory(std::move(directory)),
     mLock(),
     mParent(mDirectory->parent()),
-    mPopulated(false)
+    mSnapshot()
 {
     FUSEDebugF("Directory Context %s created", toString(mDirectory->id()).c_str());
 
@@ -59,7 +79,11 @@ InodeInfo DirectoryContext::get(std::size_t index) const
     InodeRef child = mDirectory;
 
     if (index >= 2)
-        child = mChildren[index - 2];
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+
+        child = this->child(index - 2);
+    }
     else if (index)
         child = mParent;
 
@@ -93,7 +117,7 @@ std::size_t DirectoryContext::size() const
     populate();
 
     // Two extra for . and ..
-    return mChildren.size() + 2;
+    return mSnapshot->size() + 2;
 }
 
 } // platform
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mega/fuse/common/directory_inode_forward.h>
+#include <mega/fuse/common/directory_snapshot_forward.h>
 #include <mega/fuse/common/ref.h>
 #include <mega/fuse/platform/context.h>
 #include <mega/fuse/platform/directory_context_forward.h>
@@ -14,12 +15,18 @@ namespace platform
 
 class DirectoryContext: public Context
 {
+    // Retrieve the page of children containing the specified index.
+    const InodeRef& child(std::size_t index) const;
+
     // Retrieve this directory's children.
     void populate() const;
 
-    // The directory's (last known) children.
+    // The page of children we've most recently instantiated.
     mutable InodeRefVector mChildren;
 
+    // The index of the first child in mChildren.
+    mutable std::size_t mChildrenBegin;
+
     // The directory we're iterating.
     DirectoryInodeRef mDirectory;
 
@@ -29,8 +36,8 @@ class DirectoryContext: public Context
     // The parent of the directory we're iterating.
     DirectoryInodeRef mParent;
 
-    // Have we retrieved all of this directory's children?
-    mutable bool mPopulated;
+    // What children did the directory contain when it was opened?
+    mutable DirectorySnapshotPtr mSnapshot;
 
 public:
     DirectoryContext(DirectoryInodeRef directory, fuse::Mount& mount);
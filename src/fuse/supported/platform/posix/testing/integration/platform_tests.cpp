@@ -1,6 +1,7 @@
 #include <mega/common/error_or.h>
 #include <mega/common/node_info.h>
 #include <mega/common/testing/cloud_path.h>
+#include <mega/common/testing/directory.h>
 #include <mega/fuse/common/testing/client.h>
 #include <mega/fuse/common/testing/utility.h>
 #include <mega/fuse/platform/constants.h>
@@ -15,6 +16,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <iostream>
 #include <map>
 #include <thread>
 
@@ -877,6 +879,61 @@ TEST_P(FUSEPlatformTests, read_write_succeeds)
     ASSERT_FALSE(terminate);
 }
 
+// Measures how long it takes to list a large directory repeatedly.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST_P(FUSEPlatformTests, DISABLED_readdir_benchmark_large_directory)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    using std::chrono::steady_clock;
+
+    constexpr auto NumEntries = 200000u;
+    constexpr auto NumPasses = 5u;
+
+    // Populate a large directory locally.
+    Directory sl("sl", mScratchPath);
+
+    for (auto i = 0u; i < NumEntries; ++i)
+        ASSERT_TRUE(fs::create_directory(sl.path() / ("d" + std::to_string(i))));
+
+    // Upload the directory to the cloud.
+    ASSERT_EQ(ClientW()->upload("/x/s", sl.path()).errorOr(API_OK), API_OK);
+
+    // Wait for the directory to become visible.
+    ASSERT_TRUE(waitFor(
+        [&]()
+        {
+            return !access(MountPathW() / "sl", F_OK);
+        },
+        mDefaultTimeout));
+
+    for (auto pass = 0u; pass < NumPasses; ++pass)
+    {
+        auto began = steady_clock::now();
+
+        auto iterator = opendir(MountPathW() / "sl");
+        ASSERT_TRUE(iterator);
+
+        auto count = 0u;
+
+        errno = 0;
+
+        while (readdir(iterator.get()))
+            ++count;
+
+        ASSERT_EQ(errno, 0);
+
+        auto elapsed = duration_cast<milliseconds>(steady_clock::now() - began);
+
+        // Two extra for . and ..
+        EXPECT_EQ(count, NumEntries + 2);
+
+        std::cout << "pass " << pass << ": " << count << " entries in " << elapsed.count()
+                  << "ms" << std::endl;
+    }
+}
+
 TEST_P(FUSEPlatformTests, readdir_succeeds_when_changing)
 {
     auto iterator = opendir(MountPathW());
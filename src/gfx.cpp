@@ -38,6 +38,8 @@ const std::vector<GfxDimension> GfxProc::DIMENSIONS_AVATAR = {
     { 250, 0 }      // AVATAR250X250: square thumbnail, cropped from near center
 };
 
+const size_t GfxProc::MAX_BATCH_JOBS = 8;
+
 std::unique_ptr<IGfxProvider> IGfxProvider::createInternalGfxProvider()
 {
 #if USE_FREEIMAGE
@@ -145,6 +147,7 @@ void GfxProc::loop()
     {
         waiter.init(NEVER);
         waiter.wait();
+        std::vector<GfxJob*> jobs;
         while ((job = requests.pop()) != nullptr)
         {
             if (finished)
@@ -155,14 +158,23 @@ void GfxProc::loop()
 
             LOG_debug << "Processing media file: " << job->h;
 
-            auto images = generateImages(job->localfilename, getJobDimensions(job));
-            for (auto& image : images)
+            jobs.push_back(job);
+            if (jobs.size() == MAX_BATCH_JOBS)
             {
-                job->images.push_back(image.empty() ? nullptr : new string(std::move(image)));
+                processJobs(jobs);
             }
+        }
 
-            responses.push(job);
-            client->waiter->notify();
+        if (finished)
+        {
+            for (auto pendingJob : jobs)
+            {
+                delete pendingJob;
+            }
+        }
+        else if (!jobs.empty())
+        {
+            processJobs(jobs);
         }
     }
 
@@ -181,6 +193,35 @@ void GfxProc::loop()
     }
 }
 
+void GfxProc::processJobs(std::vector<GfxJob*>& jobs)
+{
+    std::vector<IGfxProvider::ImagesRequest> batch;
+    for (auto job : jobs)
+    {
+        batch.push_back({job->localfilename, getJobDimensions(job)});
+    }
+
+    std::vector<std::vector<std::string>> images;
+    {
+        std::lock_guard<std::mutex> g(mutex);
+        images = mGfxProvider->generateImagesBatch(batch);
+    }
+    assert(images.size() == jobs.size());
+
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        for (auto& image : images[i])
+        {
+            jobs[i]->images.push_back(image.empty() ? nullptr : new string(std::move(image)));
+        }
+
+        responses.push(jobs[i]);
+    }
+
+    jobs.clear();
+    client->waiter->notify();
+}
+
 int GfxProc::checkevents(Waiter *)
 {
     if (!client)
@@ -245,6 +286,17 @@ int GfxProc::checkevents(Waiter *)
     return needexec ? Waiter::NEEDEXEC : 0;
 }
 
+std::vector<std::vector<std::string>>
+    IGfxProvider::generateImagesBatch(const std::vector<ImagesRequest>& requests)
+{
+    std::vector<std::vector<std::string>> images;
+    for (const auto& request : requests)
+    {
+        images.push_back(generateImages(request.localfilepath, request.dimensions));
+    }
+    return images;
+}
+
 std::vector<std::string> IGfxLocalProvider::generateImages(const LocalPath& localfilepath,
                                                            const std::vector<GfxDimension>& dimensions)
 {
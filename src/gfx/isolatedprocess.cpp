@@ -1,6 +1,7 @@
 #include "mega/gfx/isolatedprocess.h"
 #include "mega/filesystem.h"
 #include "mega/gfx/worker/client.h"
+#include "mega/gfx/worker/commands.h"
 #include "mega/logging.h"
 #include "mega/process.h"
 
@@ -15,6 +16,9 @@
 #include <chrono>
 
 using mega::gfx::GfxClient;
+using mega::gfx::CommandNewGfxBatch;
+using mega::gfx::GfxTask;
+using mega::gfx::GfxTaskResult;
 using std::chrono::milliseconds;
 using std::chrono::seconds;
 using std::chrono::duration_cast;
@@ -125,6 +129,37 @@ std::vector<std::string> GfxProviderIsolatedProcess::generateImages(
     return images;
 }
 
+std::vector<std::vector<std::string>>
+    GfxProviderIsolatedProcess::generateImagesBatch(const std::vector<ImagesRequest>& requests)
+{
+    std::vector<GfxTask> tasks;
+    for (const auto& request : requests)
+    {
+        tasks.push_back(GfxTask{request.localfilepath.toPath(false), request.dimensions});
+    }
+
+    std::vector<std::vector<std::string>> images;
+
+    std::vector<GfxTaskResult> results;
+    auto gfxclient = GfxClient::create(mEndpointName);
+    if (!tasks.empty() && tasks.size() <= CommandNewGfxBatch::MAX_TASKS &&
+        gfxclient.runGfxBatch(tasks, results))
+    {
+        for (auto& result : results)
+        {
+            images.push_back(std::move(result.OutputImages));
+        }
+        return images;
+    }
+
+    // The worker may have crashed on one of the files, don't fail the others
+    for (const auto& request : requests)
+    {
+        images.push_back(generateImages(request.localfilepath, request.dimensions));
+    }
+    return images;
+}
+
 const char* GfxProviderIsolatedProcess::supportedformats()
 {
     return getformats(&Formats::formats);
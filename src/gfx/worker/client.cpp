@@ -2,9 +2,11 @@
 #include "mega/gfx/worker/command_serializer.h"
 #include "mega/gfx/worker/commands.h"
 #include "mega/gfx/worker/comms.h"
+#include "mega/gfx/worker/shared_memory.h"
 #include "mega/logging.h"
 #include "mega/filesystem.h"
 #include "mega/types.h"
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -71,7 +73,7 @@ bool GfxClient::runGfxTask(const std::string& localpath,
                            const std::vector<GfxDimension>& dimensions,
                            std::vector<std::string>& images)
 {
-     // 3 seconds at most
+    // 3 seconds at most
     auto endpoint = connectWithRetry(milliseconds(100), 30);
     if (!endpoint)
     {
@@ -105,6 +107,87 @@ bool GfxClient::runGfxTask(const std::string& localpath,
     }
 }
 
+bool GfxClient::runGfxBatch(const std::vector<GfxTask>& tasks, std::vector<GfxTaskResult>& results)
+{
+    assert(!tasks.empty() && tasks.size() <= CommandNewGfxBatch::MAX_TASKS);
+
+    // 3 seconds at most
+    auto endpoint = connectWithRetry(milliseconds(100), 30);
+    if (!endpoint)
+    {
+        LOG_err << "runGfxBatch Couldn't connect";
+        return false;
+    }
+
+    CommandNewGfxBatch command;
+    size_t numImages = 0;
+    for (const auto& task : tasks)
+    {
+        command.Tasks.push_back(
+            GfxTask{LocalPath::fromAbsolutePath(task.Path).platformEncoded(), task.Dimensions});
+        numImages += task.Dimensions.size();
+    }
+
+    // Without shared memory, images come back inline
+    auto sharedMemory =
+        SharedMemory::create(std::min(numImages * SHARED_BYTES_PER_IMAGE, MAX_SHARED_BYTES));
+    if (sharedMemory)
+    {
+        command.SharedMemoryName = sharedMemory->name();
+        command.SharedMemorySize = static_cast<uint32_t>(sharedMemory->size());
+    }
+
+    // The worker processes the tasks concurrently, allow as long as processing them one by one
+    const auto receiveTimeout = milliseconds(5000) * static_cast<int>(tasks.size());
+    auto response = sendAndReceive<CommandNewGfxBatchResponse>(endpoint.get(),
+                                                               command,
+                                                               milliseconds(5000),
+                                                               receiveTimeout);
+    if (!response || response->Results.size() != tasks.size())
+    {
+        LOG_err << "GfxClient couldn't get gfxBatch response, " << tasks.size() << " tasks";
+        return false;
+    }
+
+    results.clear();
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        auto& result = response->Results[i];
+
+        // One image per dimension, empty on error
+        std::vector<std::string> images(tasks[i].Dimensions.size());
+        if (result.ProcessStatus == GfxTaskProcessStatus::SUCCESS && result.Images.size() == images.size())
+        {
+            for (size_t j = 0; j < images.size(); ++j)
+            {
+                auto& image = result.Images[j];
+                if (!image.isShared())
+                {
+                    images[j] = std::move(image.Data);
+                }
+                else if (sharedMemory && image.Offset <= sharedMemory->size() &&
+                         image.Length <= sharedMemory->size() - image.Offset)
+                {
+                    images[j].assign(sharedMemory->data() + image.Offset, image.Length);
+                }
+                else
+                {
+                    LOG_err << "GfxClient gets gfxBatch image out of shared memory, " << tasks[i].Path;
+                }
+            }
+        }
+        else
+        {
+            LOG_info << "GfxClient gets gfxBatch response with error, " << tasks[i].Path;
+        }
+
+        results.emplace_back(std::move(images), result.ProcessStatus);
+    }
+
+    LOG_verbose << "GfxClient gets gfxBatch response successfully, " << tasks.size() << " tasks";
+    return true;
+}
+
 bool GfxClient::runSupportFormats(std::string& formats, std::string& videoformats)
 {
     auto endpoint = connectWithRetry(milliseconds(100), 30); // 3 seconds at most
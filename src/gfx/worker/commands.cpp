@@ -22,6 +22,22 @@ public:
     {
         writer.serializestring_u32(source);
     }
+    static void serialize(CacheableWriter& writer, const mega::gfx::GfxTask& source)
+    {
+        writer.serializestring_u32(source.Path);
+        serialize(writer, source.Dimensions);
+    }
+    static void serialize(CacheableWriter& writer, const mega::gfx::GfxBatchImage& source)
+    {
+        writer.serializestring_u32(source.Data);
+        writer.serializeu32(source.Offset);
+        writer.serializeu32(source.Length);
+    }
+    static void serialize(CacheableWriter& writer, const mega::gfx::GfxBatchResult& source)
+    {
+        writer.serializeu32(static_cast<uint32_t>(source.ProcessStatus));
+        serialize(writer, source.Images);
+    }
     template<typename T>
     static void serialize(CacheableWriter& writer, const std::vector<T>& target)
     {
@@ -53,6 +69,32 @@ public:
     {
         return reader.unserializestring_u32(target);
     }
+    static bool unserialize(CacheableReader& reader, mega::gfx::GfxTask& target)
+    {
+        // empty dimensions considered an invalid task
+        return reader.unserializestring_u32(target.Path) &&
+               unserialize(reader, target.Dimensions) &&
+               !target.Dimensions.empty();
+    }
+    static bool unserialize(CacheableReader& reader, mega::gfx::GfxBatchImage& target)
+    {
+        // an image is either inline or in the shared memory
+        return reader.unserializestring_u32(target.Data) &&
+               reader.unserializeu32(target.Offset) &&
+               reader.unserializeu32(target.Length) &&
+               (target.Data.empty() || !target.isShared());
+    }
+    static bool unserialize(CacheableReader& reader, mega::gfx::GfxBatchResult& target)
+    {
+        uint32_t status = 0;
+        if (!reader.unserializeu32(status) ||
+            status > static_cast<uint32_t>(mega::gfx::GfxTaskProcessStatus::ERR))
+        {
+            return false;
+        }
+        target.ProcessStatus = static_cast<mega::gfx::GfxTaskProcessStatus>(status);
+        return unserialize(reader, target.Images);
+    }
     template<typename T>
     static bool unserialize(CacheableReader& reader, std::vector<T>& target, const size_t maxVectSize = MAX_VECT_SIZE)
     {
@@ -94,6 +136,10 @@ std::unique_ptr<ICommand> ICommand::factory(CommandType type)
         return std::make_unique<CommandShutDown>();
     case CommandType::SHUTDOWN_RESPONSE:
         return std::make_unique<CommandShutDownResponse>();
+    case CommandType::NEW_GFX_BATCH:
+        return std::make_unique<CommandNewGfxBatch>();
+    case CommandType::NEW_GFX_BATCH_RESPONSE:
+        return std::make_unique<CommandNewGfxBatchResponse>();
     case CommandType::HELLO:
         return std::make_unique<CommandHello>();
     case CommandType::HELLO_RESPONSE:
@@ -189,6 +235,55 @@ bool CommandNewGfxResponse::unserialize(const std::string& data)
     return true;
 }
 
+std::string CommandNewGfxBatch::serialize() const
+{
+    std::string toret;
+    CacheableWriter writer(toret);
+    GfxSerializationHelper::serialize(writer, Tasks);
+    writer.serializestring_u32(SharedMemoryName);
+    writer.serializeu32(SharedMemorySize);
+    return toret;
+}
+
+bool CommandNewGfxBatch::unserialize(const std::string& data)
+{
+    CacheableReader reader(data);
+    // tasks, an empty batch is invalid
+    if (!GfxSerializationHelper::unserialize(reader, Tasks, MAX_TASKS) || Tasks.empty())
+    {
+        return false;
+    }
+    // shared memory
+    if (!reader.unserializestring_u32(SharedMemoryName))
+    {
+        return false;
+    }
+    if (!reader.unserializeu32(SharedMemorySize))
+    {
+        return false;
+    }
+    return true;
+}
+
+std::string CommandNewGfxBatchResponse::serialize() const
+{
+    std::string toret;
+    CacheableWriter writer(toret);
+    GfxSerializationHelper::serialize(writer, Results);
+    return toret;
+}
+
+bool CommandNewGfxBatchResponse::unserialize(const std::string& data)
+{
+    CacheableReader reader(data);
+    // results
+    if (!GfxSerializationHelper::unserialize(reader, Results, CommandNewGfxBatch::MAX_TASKS))
+    {
+        return false;
+    }
+    return true;
+}
+
 std::string CommandHello::serialize() const
 {
     std::string toret;
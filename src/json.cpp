@@ -37,8 +37,324 @@
 #include <locale.h>
 #endif
 
+#if (defined(__x86_64__) || defined(_M_X64)) && \
+    (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#define MEGA_JSON_SIMD 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
 namespace mega {
 
+namespace {
+
+#ifdef MEGA_JSON_SIMD
+
+// Arrays and objects are skipped 64 bytes at a time, in the manner of the
+// first stage of simdjson: each block is reduced to bitmasks of quotes,
+// backslashes and structural characters, from which the string contents and
+// the brackets outside strings follow without looking at single characters.
+//
+// Blocks are read at 64 byte aligned addresses, so they never cross a page
+// and reading past the terminator of the buffer can't fault. The bytes out
+// of the buffer are masked away before they are looked at.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MEGA_TARGET_SSE2 __attribute__((target("sse2"), no_sanitize_address))
+#define MEGA_TARGET_AVX2 __attribute__((target("avx2"), no_sanitize_address))
+#else
+#define MEGA_TARGET_SSE2 __declspec(no_sanitize_address)
+#define MEGA_TARGET_AVX2 __declspec(no_sanitize_address)
+#endif
+
+struct JSONBlock
+{
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t nul;
+
+    // indexed like the counters of JSON::storeobject(): 0 for {}, 1 for []
+    uint64_t open[2];
+    uint64_t close[2];
+
+    // other characters storeobject() accepts out of strings (but 'e' and 'E')
+    uint64_t other;
+};
+
+MEGA_TARGET_SSE2 inline __m128i equal128(__m128i v, char c)
+{
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+MEGA_TARGET_SSE2 inline uint64_t mask128(__m128i v)
+{
+    return static_cast<uint16_t>(_mm_movemask_epi8(v));
+}
+
+MEGA_TARGET_SSE2 void classify64Sse2(const char* block, JSONBlock& b)
+{
+    b = JSONBlock{};
+
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(block) + i);
+        auto shift = i * 16;
+
+        auto other = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                   _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+
+        other = _mm_or_si128(other, _mm_or_si128(equal128(v, '-'), equal128(v, '.')));
+        other = _mm_or_si128(other, _mm_or_si128(equal128(v, ':'), equal128(v, ',')));
+
+        b.quote |= mask128(equal128(v, '"')) << shift;
+        b.backslash |= mask128(equal128(v, '\\')) << shift;
+        b.nul |= mask128(equal128(v, '\0')) << shift;
+        b.open[0] |= mask128(equal128(v, '{')) << shift;
+        b.open[1] |= mask128(equal128(v, '[')) << shift;
+        b.close[0] |= mask128(equal128(v, '}')) << shift;
+        b.close[1] |= mask128(equal128(v, ']')) << shift;
+        b.other |= mask128(other) << shift;
+    }
+}
+
+MEGA_TARGET_AVX2 inline __m256i equal256(__m256i v, char c)
+{
+    return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+
+MEGA_TARGET_AVX2 inline uint64_t mask256(__m256i v)
+{
+    return static_cast<uint32_t>(_mm256_movemask_epi8(v));
+}
+
+MEGA_TARGET_AVX2 void classify64Avx2(const char* block, JSONBlock& b)
+{
+    b = JSONBlock{};
+
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        auto v = _mm256_load_si256(reinterpret_cast<const __m256i*>(block) + i);
+        auto shift = i * 32;
+
+        auto other = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                                      _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+
+        other = _mm256_or_si256(other, _mm256_or_si256(equal256(v, '-'), equal256(v, '.')));
+        other = _mm256_or_si256(other, _mm256_or_si256(equal256(v, ':'), equal256(v, ',')));
+
+        b.quote |= mask256(equal256(v, '"')) << shift;
+        b.backslash |= mask256(equal256(v, '\\')) << shift;
+        b.nul |= mask256(equal256(v, '\0')) << shift;
+        b.open[0] |= mask256(equal256(v, '{')) << shift;
+        b.open[1] |= mask256(equal256(v, '[')) << shift;
+        b.close[0] |= mask256(equal256(v, '}')) << shift;
+        b.close[1] |= mask256(equal256(v, ']')) << shift;
+        b.other |= mask256(other) << shift;
+    }
+}
+
+using Classifier = void (*)(const char*, JSONBlock&);
+
+Classifier detectClassifier()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+
+    __cpuid(info, 1);
+
+    bool osxsave = info[2] & (1 << 27);
+    bool avx = info[2] & (1 << 28);
+
+    __cpuidex(info, 7, 0);
+
+    bool avx2 = info[1] & (1 << 5);
+
+    if (osxsave && avx && avx2 && (_xgetbv(0) & 6) == 6)
+    {
+        return classify64Avx2;
+    }
+
+    return classify64Sse2;
+#else
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return classify64Avx2;
+    }
+
+    return __builtin_cpu_supports("sse2") ? classify64Sse2 : nullptr;
+#endif
+}
+
+const Classifier CLASSIFY = detectClassifier();
+
+unsigned trailingZeros(uint64_t x)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+// without relying on the popcnt instruction
+int countBits(uint64_t x)
+{
+    x -= (x >> 1) & 0x5555555555555555ULL;
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+}
+
+// bit i set if an odd number of bits up to and including i are set
+uint64_t prefixXor(uint64_t x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// The characters preceded by an odd number of backslashes. Whether the first
+// character of the next block is escaped is carried in escapedCarry.
+uint64_t findEscaped(uint64_t backslash, uint64_t& escapedCarry)
+{
+    constexpr uint64_t EVEN_BITS = 0x5555555555555555ULL;
+
+    backslash &= ~escapedCarry;
+
+    auto followsEscape = backslash << 1 | escapedCarry;
+    auto oddStarts = backslash & ~EVEN_BITS & ~followsEscape;
+    auto evenStartSequences = oddStarts + backslash;
+
+    escapedCarry = evenStartSequences < oddStarts;
+
+    return (EVEN_BITS ^ (evenStartSequences << 1)) & followsEscape;
+}
+
+// Just past the string, array or object starting at p, as JSON::storeobject()
+// would find it. nullptr when that's left to the character at a time scan:
+// a terminator is reached, a bracket doesn't match or there are characters
+// out of strings that storeobject() may reject (whitespace, exponents...).
+const char* skipValue(const char* p)
+{
+    if (!CLASSIFY)
+    {
+        return nullptr;
+    }
+
+    auto address = reinterpret_cast<uintptr_t>(p);
+    auto block = reinterpret_cast<const char*>(address & ~uintptr_t(63));
+    auto first = uint64_t(1) << (address & 63);
+
+    // the bytes before p
+    auto valid = ~(first - 1);
+
+    bool string = *p == '"';
+    int depth[2] = {0, 0};
+    uint64_t inString = 0;
+    uint64_t escapedCarry = 0;
+
+    for (;; block += 64, valid = ~uint64_t(0), first = 0)
+    {
+        JSONBlock b;
+        CLASSIFY(block, b);
+
+        auto quote = b.quote & valid & ~findEscaped(b.backslash & valid, escapedCarry);
+        auto strings = prefixXor(quote) ^ inString;
+        auto outside = valid & ~strings & ~quote;
+
+        inString = static_cast<uint64_t>(static_cast<int64_t>(strings) >> 63);
+
+        uint64_t end = 0;
+        auto invalid = b.nul & valid;
+
+        if (string)
+        {
+            // the first quote after the opening one
+            auto closing = quote & ~first;
+            end = closing & (0 - closing);
+        }
+        else
+        {
+            uint64_t open[2] = {b.open[0] & outside, b.open[1] & outside};
+            uint64_t close[2] = {b.close[0] & outside, b.close[1] & outside};
+
+            invalid |= outside & ~(open[0] | open[1] | close[0] | close[1] | b.other);
+
+            auto closes0 = countBits(close[0]);
+            auto closes1 = countBits(close[1]);
+
+            // Unless both counters can drop to zero, or one below zero, the
+            // brackets of this block only need counting.
+            if ((closes0 < depth[0] || closes1 < depth[1]) && closes0 <= depth[0] &&
+                closes1 <= depth[1])
+            {
+                depth[0] += countBits(open[0]) - closes0;
+                depth[1] += countBits(open[1]) - closes1;
+            }
+            else
+            {
+                auto brackets = open[0] | open[1] | close[0] | close[1];
+
+                for (; brackets; brackets &= brackets - 1)
+                {
+                    auto bit = brackets & (0 - brackets);
+                    auto index = (bit & (open[1] | close[1])) != 0;
+
+                    depth[index] += (bit & (open[0] | open[1])) ? 1 : -1;
+
+                    if (depth[index] < 0)
+                    {
+                        return nullptr;
+                    }
+
+                    if (!depth[0] && !depth[1])
+                    {
+                        end = bit;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (end)
+        {
+            // anything up to the end
+            if (invalid & ((end << 1) - 1))
+            {
+                return nullptr;
+            }
+
+            return block + trailingZeros(end) + 1;
+        }
+
+        if (invalid)
+        {
+            return nullptr;
+        }
+    }
+}
+
+#else
+
+const char* skipValue(const char*)
+{
+    return nullptr;
+}
+
+#endif // MEGA_JSON_SIMD
+
+} // namespace
+
 // store array or object in string s
 // reposition after object
 bool JSON::storeobject(string* s)
@@ -62,75 +378,88 @@ bool JSON::storeobject(string* s)
         pos++;
     }
 
-    ptr = pos;
+    // strings, arrays and objects are skipped a block at a time when possible
+    ptr = nullptr;
 
-    for (;;)
+    if (*pos == '[' || *pos == '{' || *pos == '"')
     {
-        if ((*ptr == '[') || (*ptr == '{'))
-        {
-            openobject[*ptr == '[']++;
-        }
-        else if ((*ptr == ']') || (*ptr == '}'))
+        ptr = skipValue(pos);
+    }
+
+    if (!ptr)
+    {
+        ptr = pos;
+
+        for (;;)
         {
-            openobject[*ptr == ']']--;
-            if(openobject[*ptr == ']'] < 0)
+            if ((*ptr == '[') || (*ptr == '{'))
             {
-                LOG_err << "Parse error (])";
+                openobject[*ptr == '[']++;
             }
-        }
-        else if (*ptr == '"')
-        {
-            ptr++;
-
-            while (*ptr && (escaped || *ptr != '"'))
+            else if ((*ptr == ']') || (*ptr == '}'))
+            {
+                openobject[*ptr == ']']--;
+                if(openobject[*ptr == ']'] < 0)
+                {
+                    LOG_err << "Parse error (])";
+                }
+            }
+            else if (*ptr == '"')
             {
-                escaped = *ptr == '\\' && !escaped;
                 ptr++;
+
+                while (*ptr && (escaped || *ptr != '"'))
+                {
+                    escaped = *ptr == '\\' && !escaped;
+                    ptr++;
+                }
+
+                if (!*ptr)
+                {
+                    LOG_err << "Parse error (\")";
+                    return false;
+                }
             }
+            else if ((*ptr >= '0' && *ptr <= '9') || *ptr == '-' || *ptr == '.')
+            {
+                ptr++;
 
-            if (!*ptr)
+                while ((*ptr >= '0' && *ptr <= '9') || *ptr == '.' || *ptr == 'e' || *ptr == 'E')
+                {
+                    ptr++;
+                }
+
+                ptr--;
+            }
+            else if (*ptr != ':' && *ptr != ',')
             {
-                LOG_err << "Parse error (\")";
+                LOG_err << "Parse error (unexpected " << *ptr << ")";
                 return false;
             }
-        }
-        else if ((*ptr >= '0' && *ptr <= '9') || *ptr == '-' || *ptr == '.')
-        {
+
             ptr++;
 
-            while ((*ptr >= '0' && *ptr <= '9') || *ptr == '.' || *ptr == 'e' || *ptr == 'E')
+            if (!openobject[0] && !openobject[1])
             {
-                ptr++;
+                break;
             }
-
-            ptr--;
         }
-        else if (*ptr != ':' && *ptr != ',')
+    }
+
+    if (s)
+    {
+        if (*pos == '"')
         {
-            LOG_err << "Parse error (unexpected " << *ptr << ")";
-            return false;
+            s->assign(pos + 1, static_cast<size_t>(ptr - pos - 2));
         }
-
-        ptr++;
-
-        if (!openobject[0] && !openobject[1])
+        else
         {
-            if (s)
-            {
-                if (*pos == '"')
-                {
-                    s->assign(pos + 1, static_cast<size_t>(ptr - pos - 2));
-                }
-                else
-                {
-                    s->assign(pos, static_cast<size_t>(ptr - pos));
-                }
-            }
-
-            pos = ptr;
-            return true;
+            s->assign(pos, static_cast<size_t>(ptr - pos));
         }
     }
+
+    pos = ptr;
+    return true;
 }
 
 bool JSON::storeKeyValueFromObject(string& key, string& value)
@@ -377,8 +706,10 @@ bool JSON::storebinary(string* dst)
         }
 
         dst->resize(static_cast<size_t>((ptr - pos - 1) / 4 * 3 + 3));
-        dst->resize(
-            static_cast<size_t>(Base64::atob(pos + 1, (byte*)dst->data(), int(dst->size()))));
+        dst->resize(static_cast<size_t>(Base64::atob(pos + 1,
+                                                     static_cast<size_t>(ptr - pos - 1),
+                                                     (byte*)dst->data(),
+                                                     int(dst->size()))));
 
         // skip string
         storeobject();
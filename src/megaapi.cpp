@@ -2313,6 +2313,16 @@ void MegaApi::setDnsServers(const char *dnsServers, MegaRequestListener *listene
     pImpl->setDnsServers(dnsServers, listener);
 }
 
+bool MegaApi::setTlsSessionPersistence(bool enable)
+{
+    return pImpl->setTlsSessionPersistence(enable);
+}
+
+bool MegaApi::setHttp2(bool enable)
+{
+    return pImpl->setHttp2(enable);
+}
+
 bool MegaApi::serverSideRubbishBinAutopurgeEnabled()
 {
     return pImpl->serverSideRubbishBinAutopurgeEnabled();
@@ -3612,6 +3622,31 @@ void MegaApi::setMaxConnections(int connections, MegaRequestListener *listener)
     pImpl->setMaxConnections(-1,  connections, listener);
 }
 
+void MegaApi::setAdaptiveTransfers(bool enable)
+{
+    pImpl->setAdaptiveTransfers(enable);
+}
+
+bool MegaApi::setTransferSchedulingPolicy(int policy)
+{
+    return pImpl->setTransferSchedulingPolicy(policy);
+}
+
+bool MegaApi::setTransferWeights(int appWeight, int syncWeight)
+{
+    return pImpl->setTransferWeights(appWeight, syncWeight);
+}
+
+void MegaApi::setAdaptiveTransferSlots(bool enable)
+{
+    pImpl->setAdaptiveTransferSlots(enable);
+}
+
+void MegaApi::setSmallUploadBatching(bool enable)
+{
+    pImpl->setSmallUploadBatching(enable);
+}
+
 void MegaApi::getMaxUploadConnections(MegaRequestListener* const listener)
 {
     pImpl->getMaxUploadConnections(listener);
@@ -4866,6 +4901,26 @@ bool MegaApi::isOnline()
     return pImpl->isOnline();
 }
 
+char* MegaApi::getMetrics()
+{
+    return pImpl->getMetrics();
+}
+
+void MegaApi::startTracing()
+{
+    pImpl->startTracing();
+}
+
+void MegaApi::stopTracing()
+{
+    pImpl->stopTracing();
+}
+
+bool MegaApi::exportTrace(const char* localPath)
+{
+    return pImpl->exportTrace(localPath);
+}
+
 void MegaApi::getAccountAchievements(MegaRequestListener *listener)
 {
     pImpl->getAccountAchievements(listener);
@@ -5134,6 +5189,21 @@ int MegaApi::ftpServerGetMaxOutputSize()
     return pImpl->ftpServerGetMaxOutputSize();
 }
 
+bool MegaApi::metricsServerStart(bool localOnly, int port, bool useIPv6)
+{
+    return pImpl->metricsServerStart(localOnly, port, useIPv6);
+}
+
+void MegaApi::metricsServerStop()
+{
+    pImpl->metricsServerStop();
+}
+
+int MegaApi::metricsServerIsRunning()
+{
+    return pImpl->metricsServerIsRunning();
+}
+
 #endif
 
 char *MegaApi::getMimeType(const char *extension)
@@ -30,6 +30,7 @@
 
 #include "mega/canceller.h"
 #include "mega/mediafileattribute.h"
+#include "mega/openmetrics.h"
 #include "mega/scoped_helpers.h"
 #include "mega/tlv.h"
 #include "mega/user_attribute.h"
@@ -3174,6 +3175,7 @@ MegaTransferPrivate::MegaTransferPrivate(int type, MegaTransferListener *listene
     this->streamingTransfer = false;
     this->temporarySourceFile = false;
     this->startFirst = false;
+    this->pipelinedFolderUpload = false;
     this->backupTransfer = false;
     this->foreignOverquota = false;
     this->folderTransferTag = 0;
@@ -3224,6 +3226,7 @@ MegaTransferPrivate::MegaTransferPrivate(const MegaTransferPrivate *transfer)
     this->setStreamingTransfer(transfer->isStreamingTransfer());
     this->setSourceFileTemporary(transfer->isSourceFileTemporary());
     this->setStartFirst(transfer->shouldStartFirst());
+    this->setPipelinedFolderUpload(transfer->isPipelinedFolderUpload());
     this->setBackupTransfer(transfer->isBackupTransfer());
     this->setForeignOverquota(transfer->isForeignOverquota());
     this->setForceNewUpload(transfer->isForceNewUpload());
@@ -3339,6 +3342,11 @@ bool MegaTransferPrivate::shouldStartFirst() const
     return startFirst;
 }
 
+bool MegaTransferPrivate::isPipelinedFolderUpload() const
+{
+    return pipelinedFolderUpload;
+}
+
 int MegaTransferPrivate::getType() const
 {
     return type;
@@ -3851,6 +3859,11 @@ void MegaTransferPrivate::setStartFirst(bool beFirst)
     startFirst = beFirst;
 }
 
+void MegaTransferPrivate::setPipelinedFolderUpload(bool pipelined)
+{
+    pipelinedFolderUpload = pipelined;
+}
+
 void MegaTransferPrivate::setBackupTransfer(bool isBackupTransfer)
 {
     backupTransfer = isBackupTransfer;
@@ -6957,6 +6970,8 @@ void *MegaApiImpl::threadEntryPoint(void *param)
     ::sigaction(SIGPIPE, &noaction, 0);
 #endif
 
+    trace::setThreadName("MegaApi");
+
     MegaApiImpl *megaApiImpl = (MegaApiImpl *)param;
     megaApiImpl->loop();
     return 0;
@@ -7583,6 +7598,18 @@ void MegaApiImpl::setDnsServers(const char *dnsServers, MegaRequestListener *lis
     waiter->notify();
 }
 
+bool MegaApiImpl::setTlsSessionPersistence(bool enable)
+{
+    SdkMutexGuard g(sdkMutex);
+    return client->setTlsSessionPersistence(enable);
+}
+
+bool MegaApiImpl::setHttp2(bool enable)
+{
+    SdkMutexGuard g(sdkMutex);
+    return client->httpio->setHttp2(enable);
+}
+
 void MegaApiImpl::addEntropy(char *data, unsigned int size)
 {
     if(client && client->rng.CanIncorporateEntropy())
@@ -10234,6 +10261,7 @@ MegaTransferPrivate* MegaApiImpl::createUploadTransfer(const LocalPath& localPat
     transfer->setAppData(options.mPublicOptions.appData);
     transfer->setSourceFileTemporary(options.mPublicOptions.isSourceTemporary);
     transfer->setStartFirst(options.mPublicOptions.startFirst);
+    transfer->setPipelinedFolderUpload(options.mPublicOptions.pipelineFolderUpload);
     transfer->setCancelToken(cancelToken);
     transfer->setBackupTransfer(options.mIsBackup);
 
@@ -11179,6 +11207,39 @@ bool MegaApiImpl::isOnline()
     return !client->httpio->noinetds;
 }
 
+char* MegaApiImpl::getMetrics()
+{
+    SdkMutexGuard g(sdkMutex);
+    return MegaApi::strdup(client->openMetrics().c_str());
+}
+
+void MegaApiImpl::startTracing()
+{
+    trace::start();
+}
+
+void MegaApiImpl::stopTracing()
+{
+    trace::stop();
+}
+
+bool MegaApiImpl::exportTrace(const char* localPath)
+{
+    if (!localPath)
+    {
+        return false;
+    }
+
+    auto json = trace::chromeJson();
+
+    auto path = LocalPath::fromAbsolutePath(localPath);
+    auto f = fsAccess->newfileaccess();
+    fsAccess->unlinklocal(path);
+
+    return f->fopen(path, OPEN_WRONLY, FSLogging::logOnError) &&
+           f->fwrite(reinterpret_cast<const byte*>(json.data()), static_cast<unsigned>(json.size()), 0);
+}
+
 #ifdef HAVE_LIBUV
 bool MegaApiImpl::httpServerStart(bool localOnly, int port, bool useTLS, const char *certificatepath, const char *keypath, bool useIPv6)
 {
@@ -11730,6 +11791,56 @@ int MegaApiImpl::ftpServerGetMaxOutputSize()
     }
 }
 
+bool MegaApiImpl::metricsServerStart(bool localOnly, int port, bool useIPv6)
+{
+    SdkMutexGuard g(sdkMutex);
+    if (metricsServer && metricsServer->getPort() == port &&
+        metricsServer->isLocalOnly() == localOnly)
+    {
+        return true;
+    }
+
+    g.unlock();
+    metricsServerStop();
+    g.lock();
+
+    metricsServer = new MegaMetricsServer(this, basePath, useIPv6);
+
+    bool result = metricsServer->start(port, localOnly);
+    if (!result)
+    {
+        MegaMetricsServer* server = metricsServer;
+        metricsServer = nullptr;
+        g.unlock();
+        delete server;
+    }
+    return result;
+}
+
+void MegaApiImpl::metricsServerStop()
+{
+    SdkMutexGuard g(sdkMutex);
+    if (metricsServer)
+    {
+        // The server's thread may be waiting for the lock to get the metrics.
+        MegaMetricsServer* server = metricsServer;
+        metricsServer = nullptr;
+        g.unlock();
+        server->stop();
+        delete server;
+    }
+}
+
+int MegaApiImpl::metricsServerIsRunning()
+{
+    SdkMutexGuard g(sdkMutex);
+    if (metricsServer)
+    {
+        return metricsServer->getPort();
+    }
+    return 0;
+}
+
 void MegaApiImpl::ftpServerSetRestrictedMode(int mode)
 {
     if (mode != MegaApi::TCP_SERVER_DENY_ALL
@@ -13213,23 +13324,20 @@ MegaNodeList* MegaApiImpl::search(const MegaSearchFilter* filter, int order, Can
 
     sharedNode_vector searchResults;
 
-    // search
+    // search, without sdkMutex: NodeManager is locked on its own, and released while the
+    // DB is queried, so that the SDK thread isn't held up meanwhile
+    switch (filter->byLocation())
     {
-        SdkMutexGuard g(sdkMutex);
-
-        switch (filter->byLocation())
-        {
-        case MegaApi::SEARCH_TARGET_ALL:
-        case MegaApi::SEARCH_TARGET_ROOTNODE: // Search on Cloud root and Vault, excluding Rubbish
-        case MegaApi::SEARCH_TARGET_INSHARE:
-        case MegaApi::SEARCH_TARGET_OUTSHARE:
-        case MegaApi::SEARCH_TARGET_PUBLICLINK:
-            searchResults = searchInNodeManager(filter, order, cancelToken, searchPage);
-            break;
-        default:
-            LOG_err << "Search not implemented for Location " << filter->byLocation();
-        }
-    } // end scope for mutex guard
+    case MegaApi::SEARCH_TARGET_ALL:
+    case MegaApi::SEARCH_TARGET_ROOTNODE: // Search on Cloud root and Vault, excluding Rubbish
+    case MegaApi::SEARCH_TARGET_INSHARE:
+    case MegaApi::SEARCH_TARGET_OUTSHARE:
+    case MegaApi::SEARCH_TARGET_PUBLICLINK:
+        searchResults = searchInNodeManager(filter, order, cancelToken, searchPage);
+        break;
+    default:
+        LOG_err << "Search not implemented for Location " << filter->byLocation();
+    }
 
     MegaNodeListPrivate* nodeList = new MegaNodeListPrivate(searchResults);
 
@@ -18693,8 +18801,7 @@ MegaNodeList *MegaApiImpl::getChildren(const MegaSearchFilter* filter, int order
         return new MegaNodeListPrivate();
     }
 
-    SdkMutexGuard guard(sdkMutex);
-
+    // no sdkMutex, as in search()
     NodeSearchFilter nf = searchToNodeFilter(*filter);
 
     const NodeSearchPage& np = searchPage ? NodeSearchPage(searchPage->startingOffset(), searchPage->size()) : NodeSearchPage(0u, 0u);
@@ -20396,6 +20503,7 @@ void MegaApiImpl::sendPendingRequests()
             g.unlock();
             httpServerStop();
             ftpServerStop();
+            metricsServerStop();
             g.lock();
 #endif
             abortPendingActions();
@@ -23651,6 +23759,70 @@ void MegaApiImpl::setMaxConnections(int direction, int connections, MegaRequestL
     waiter->notify();
 }
 
+void MegaApiImpl::setAdaptiveTransfers(bool enable)
+{
+    SdkMutexGuard g(sdkMutex);
+    client->mAdaptiveTransfers = enable;
+}
+
+bool MegaApiImpl::setTransferSchedulingPolicy(int policy)
+{
+    TransferScheduler::Policy schedulerPolicy;
+
+    switch (policy)
+    {
+        case MegaApi::TRANSFER_SCHEDULING_PRIORITY:
+            schedulerPolicy = TransferScheduler::POLICY_PRIORITY;
+            break;
+        case MegaApi::TRANSFER_SCHEDULING_SMALLEST_FIRST:
+            schedulerPolicy = TransferScheduler::POLICY_SMALLEST_FIRST;
+            break;
+        case MegaApi::TRANSFER_SCHEDULING_SHORTEST_REMAINING:
+            schedulerPolicy = TransferScheduler::POLICY_SHORTEST_REMAINING;
+            break;
+        default:
+            return false;
+    }
+
+    SdkMutexGuard g(sdkMutex);
+    client->mTransferScheduler.setPolicy(schedulerPolicy);
+    return true;
+}
+
+bool MegaApiImpl::setTransferWeights(int appWeight, int syncWeight)
+{
+    if (!appWeight && !syncWeight)
+    {
+        SdkMutexGuard g(sdkMutex);
+        client->mTransferScheduler.clearWeights();
+        return true;
+    }
+
+    if (appWeight < 1 || syncWeight < 1)
+    {
+        return false;
+    }
+
+    SdkMutexGuard g(sdkMutex);
+    client->mTransferScheduler.setWeight(TransferScheduler::FLOW_APP,
+                                         static_cast<unsigned>(appWeight));
+    client->mTransferScheduler.setWeight(TransferScheduler::FLOW_SYNC,
+                                         static_cast<unsigned>(syncWeight));
+    return true;
+}
+
+void MegaApiImpl::setAdaptiveTransferSlots(bool enable)
+{
+    SdkMutexGuard g(sdkMutex);
+    client->mTransferScheduler.setAdaptiveSlots(enable);
+}
+
+void MegaApiImpl::setSmallUploadBatching(bool enable)
+{
+    SdkMutexGuard g(sdkMutex);
+    client->mBatchSmallUploads = enable;
+}
+
 void MegaApiImpl::getMaxTransferConnections(const direction_t direction,
                                             MegaRequestListener* const listener)
 {
@@ -31305,15 +31477,71 @@ void MegaFolderUploadController::start(MegaNode*)
         megaapiThreadClient()->putnodes_prepareOneFolder(&newTreeNode->newnode, leaf, false);
         newTreeNode->newnode.nodehandle = nextUploadId();
         newTreeNode->newnode.parenthandle = UNDEF;
+        newTreeNode->uploadId = newTreeNode->newnode.nodehandle;
     }
     // else => if there's another node (TYPE_FOLDER) with the same name, in the destination path, the content of both folders will be merged
 
+    newTreeNode->parent = &mUploadTree;
+
     // add the tree above, to subtrees vector for root tree
     mUploadTree.subtrees.push_back(std::move(newTreeNode));
 
     // it's mandatory to notify stage change from MegaApiImpl's thread to avoid deadlocks and other issues
     notifyStage(MegaTransfer::STAGE_SCAN);
 
+    if (transfer->isPipelinedFolderUpload())
+    {
+        auto& root = *mUploadTree.subtrees.front();
+
+        mMoreSubtransfersToCome = true;
+        mFoldersKnown = 1;
+
+        if (root.megaNode)
+        {
+            ++mFoldersExisting;
+        }
+        else
+        {
+            mFoldersToCreate.push_back(&root);
+            advancePipeline();
+        }
+
+        mWorkerThread = std::thread([this, path]() {
+            scanFolder_result scanResult = scanInParallel(path);
+
+            weak_ptr<MegaFolderUploadController> weak_this = shared_from_this();
+
+            mCompletionForMegaApiThread.reset(new ExecuteOnce([this, scanResult, weak_this]() {
+
+                if (!weak_this.lock()) return;
+                assert(mMainThreadId == std::this_thread::get_id());
+
+                if (mWorkerThread.joinable())
+                {
+                    mWorkerThread.join();
+                }
+
+                // the last folders may not have been taken yet
+                takeScannedFolders();
+
+                mScanFinished = true;
+                mScanResult = scanResult;
+
+                if (scanResult == scanFolder_succeeded)
+                {
+                    notifyStage(MegaTransfer::STAGE_CREATE_TREE);
+                }
+
+                advancePipeline();
+                // no further code can be added here, this object may now be deleted
+            }));
+
+            megaApi->executeOnThread(mCompletionForMegaApiThread);
+        });
+
+        return;
+    }
+
     mWorkerThread = std::thread ([this, path]() {
         // recurse all subfolders on disk, building up tree structure to match
         // not yet existing folders get a temporary upload id instead of a handle
@@ -31376,11 +31604,11 @@ void MegaFolderUploadController::start(MegaNode*)
 }
 
 // this method provides a temporal handle useful to indicate putnodes()-local parent linkage
+// (it may be called from several scan threads at once)
 handle MegaFolderUploadController::nextUploadId()
 {
-    return mCurrUploadId = (mCurrUploadId + 1 <= 0xFFFFFFFFFFFF)
-        ? mCurrUploadId + 1
-        : 0;
+    handle id = ++mCurrUploadId;
+    return id <= 0xFFFFFFFFFFFF ? id : 0;
 }
 
 void MegaRecursiveOperation::onTransferStart(MegaApi *, MegaTransfer *t)
@@ -31390,6 +31618,7 @@ void MegaRecursiveOperation::onTransferStart(MegaApi *, MegaTransfer *t)
 
     ++transfersStartedCount;
     if (transfersStartedCount == transfersTotalCount &&
+        !mMoreSubtransfersToCome &&
         !transfer->accessCancelToken().isCancelled() &&
         !startedTransferring)
     {
@@ -31454,7 +31683,7 @@ void MegaRecursiveOperation::onTransferFinish(MegaApi *, MegaTransfer *t, MegaEr
 
         // Cancelled or not, there is always an onTransferFinish callback for the folder transfer.
         // If subtransfers were started, completion is always by the last subtransfer completing
-        complete(mIncompleteTransfers ? API_EINCOMPLETE : API_OK);
+        complete(mQueueingError ? mQueueingError : Error(mIncompleteTransfers ? API_EINCOMPLETE : API_OK));
     }
 }
 
@@ -31470,15 +31699,46 @@ MegaFolderUploadController::~MegaFolderUploadController()
 MegaFolderUploadController::scanFolder_result MegaFolderUploadController::scanFolder(Tree& tree, LocalPath& localPath, uint32_t& foldercount, uint32_t& filecount)
 {
     recursive++;
-    unique_ptr<DirAccess> da(fsaccess->newdiraccess());
-    if (!da->dopen(&localPath, nullptr, false))
+
+    vector<std::pair<Tree*, LocalPath>> subfolders;
+    scanFolder_result sr = scanOneFolder(tree, localPath, *fsaccess, rng, tmpnodecipher, subfolders, foldercount, filecount, true);
+
+    for (auto& subfolder : subfolders)
+    {
+        if (sr != scanFolder_succeeded)
+        {
+            break;
+        }
+
+        sr = scanFolder(*subfolder.first, subfolder.second, foldercount, filecount);
+    }
+
+    recursive--;
+    return sr;
+}
+
+MegaFolderUploadController::scanFolder_result MegaFolderUploadController::scanOneFolder(Tree& tree,
+                                                                                        const LocalPath& localPath,
+                                                                                        FileSystemAccess& fsa,
+                                                                                        PrnGen& rng,
+                                                                                        SymmCipher& cipher,
+                                                                                        vector<std::pair<Tree*, LocalPath>>& subfolders,
+                                                                                        uint32_t& foldercount,
+                                                                                        uint32_t& filecount,
+                                                                                        bool fireUpdates)
+{
+    unique_ptr<DirAccess> da(fsa.newdiraccess());
+    LocalPath path = localPath;
+    if (!da->dopen(&path, nullptr, false))
     {
         LOG_err << "Can't open local directory" << localPath;
-        recursive--;
         return scanFolder_failed;
     }
 
-    megaApi->fireOnFolderTransferUpdate(transfer, MegaTransfer::STAGE_SCAN, foldercount, 0, filecount, &localPath, nullptr);
+    if (fireUpdates)
+    {
+        megaApi->fireOnFolderTransferUpdate(transfer, MegaTransfer::STAGE_SCAN, foldercount, 0, filecount, &localPath, nullptr);
+    }
 
     LocalPath localname;
     nodetype_t dirEntryType;
@@ -31490,7 +31750,10 @@ MegaFolderUploadController::scanFolder_result MegaFolderUploadController::scanFo
             return scanFolder_cancelled;
         }
 
-        megaApi->fireOnFolderTransferUpdate(transfer, MegaTransfer::STAGE_SCAN, foldercount, 0, filecount, &localPath, &localname);
+        if (fireUpdates)
+        {
+            megaApi->fireOnFolderTransferUpdate(transfer, MegaTransfer::STAGE_SCAN, foldercount, 0, filecount, &localPath, &localname);
+        }
 
         if (!childPath.isURI())
         {
@@ -31501,7 +31764,7 @@ MegaFolderUploadController::scanFolder_result MegaFolderUploadController::scanFo
         {
             // Do the fingerprinting for uploads on the scan thread, so we don't lock the main mutex for so long
             FileFingerprint fp;
-            auto fa = fsaccess->newfileaccess();
+            auto fa = fsa.newfileaccess();
             if (fa->fopen(childPath, OPEN_RDONLY, FSLogging::logOnError))
             {
                 fp.genfingerprint(fa.get());
@@ -31516,22 +31779,19 @@ MegaFolderUploadController::scanFolder_result MegaFolderUploadController::scanFo
         {
             // generate new subtree
             unique_ptr<Tree> newTreeNode(new Tree);
-            newTreeNode->folderName = localname.toName(*fsaccess);
-            newTreeNode->fsType = fsaccess->getlocalfstype(childPath);
+            newTreeNode->folderName = localname.toName(fsa);
+            newTreeNode->fsType = fsa.getlocalfstype(childPath);
 
             // generate fresh random key and node attributes
-            MegaClient::putnodes_prepareOneFolder(&newTreeNode->newnode, newTreeNode->folderName, rng, tmpnodecipher, false);
+            MegaClient::putnodes_prepareOneFolder(&newTreeNode->newnode, newTreeNode->folderName, rng, cipher, false);
 
             // set nodeHandle
             newTreeNode->newnode.nodehandle = nextUploadId();
-            newTreeNode->newnode.parenthandle = tree.newnode.nodehandle;
+            newTreeNode->newnode.parenthandle = tree.uploadId;
+            newTreeNode->uploadId = newTreeNode->newnode.nodehandle;
+            newTreeNode->parent = &tree;
 
-            scanFolder_result sr = scanFolder(*newTreeNode, childPath, foldercount, filecount);
-            if (sr != scanFolder_succeeded)
-            {
-                recursive--;
-                return sr;
-            }
+            subfolders.emplace_back(newTreeNode.get(), childPath);
             tree.subtrees.push_back(std::move(newTreeNode));
 
             foldercount += 1;
@@ -31539,10 +31799,424 @@ MegaFolderUploadController::scanFolder_result MegaFolderUploadController::scanFo
 
         childPath = localPath;
     }
-    recursive--;
+
     return scanFolder_succeeded;
 }
 
+MegaFolderUploadController::scanFolder_result MegaFolderUploadController::scanInParallel(const LocalPath& path)
+{
+    // folders found but not scanned yet, taken breadth first so that the upper
+    // levels of the tree, which must be created first, are known early
+    std::deque<std::pair<Tree*, LocalPath>> pending;
+    pending.emplace_back(mUploadTree.subtrees.front().get(), path);
+
+    std::mutex m;
+    std::condition_variable cv;
+    unsigned busy = 0;
+    scanFolder_result result = scanFolder_succeeded;
+
+    auto scan = [&]()
+    {
+        // each thread has its own, as these are not thread safe
+        auto fsa = createFSA();
+        PrnGen threadRng;
+        SymmCipher threadCipher;
+
+        vector<std::pair<Tree*, LocalPath>> subfolders;
+        uint32_t foldercount = 0;
+        uint32_t filecount = 0;
+
+        std::unique_lock<std::mutex> lock(m);
+
+        for (;;)
+        {
+            // done when nothing is left, and no other thread can find more
+            cv.wait(lock, [&]() { return !pending.empty() || !busy || result != scanFolder_succeeded; });
+
+            if (pending.empty() || result != scanFolder_succeeded)
+            {
+                break;
+            }
+
+            auto folder = std::move(pending.front());
+            pending.pop_front();
+            ++busy;
+
+            lock.unlock();
+
+            subfolders.clear();
+            scanFolder_result sr = scanOneFolder(*folder.first, folder.second, *fsa, threadRng, threadCipher, subfolders, foldercount, filecount, false);
+
+            if (sr == scanFolder_succeeded)
+            {
+                // this thread is done with it
+                folderScanned(folder.first);
+            }
+
+            lock.lock();
+            --busy;
+
+            if (sr != scanFolder_succeeded)
+            {
+                result = sr;
+            }
+            else
+            {
+                for (auto& subfolder : subfolders)
+                {
+                    pending.push_back(std::move(subfolder));
+                }
+            }
+
+            cv.notify_all();
+        }
+    };
+
+    auto threads = std::clamp(std::thread::hardware_concurrency(), 2u, MAX_SCAN_THREADS);
+
+    vector<std::thread> helpers;
+    for (unsigned i = 1; i < threads; ++i)
+    {
+        helpers.emplace_back(scan);
+    }
+
+    scan();
+
+    for (auto& helper : helpers)
+    {
+        helper.join();
+    }
+
+    return result;
+}
+
+void MegaFolderUploadController::folderScanned(Tree* tree)
+{
+    bool queue = false;
+    {
+        std::lock_guard<std::mutex> g(mScannedMutex);
+        mScannedFolders.push_back(tree);
+        queue = !mScannedFoldersQueued;
+        mScannedFoldersQueued = true;
+    }
+
+    if (!queue)
+    {
+        // the MegaApiImpl's thread has yet to take the ones before
+        return;
+    }
+
+    weak_ptr<MegaFolderUploadController> weak_this = shared_from_this();
+
+    megaApi->executeOnThread(std::make_shared<ExecuteOnce>([this, weak_this]() {
+
+        if (!weak_this.lock()) return;
+        assert(mMainThreadId == std::this_thread::get_id());
+
+        takeScannedFolders();
+        advancePipeline();
+        // no further code can be added here, this object may now be deleted
+    }));
+}
+
+void MegaFolderUploadController::takeScannedFolders()
+{
+    assert(mMainThreadId == std::this_thread::get_id());
+
+    vector<Tree*> scanned;
+    {
+        std::lock_guard<std::mutex> g(mScannedMutex);
+        scanned.swap(mScannedFolders);
+        mScannedFoldersQueued = false;
+    }
+
+    if (scanned.empty())
+    {
+        return;
+    }
+
+    for (auto* tree : scanned)
+    {
+        tree->scanned = true;
+        mFoldersKnown += tree->subtrees.size();
+        mFilesScanned += static_cast<uint32_t>(tree->files.size());
+
+        if (tree->megaNode)
+        {
+            folderExists(*tree);
+        }
+    }
+
+    megaApi->fireOnFolderTransferUpdate(transfer, MegaTransfer::STAGE_SCAN, unsigned(mFoldersKnown), 0, mFilesScanned, nullptr, nullptr);
+}
+
+void MegaFolderUploadController::folderExists(Tree& tree)
+{
+    assert(mMainThreadId == std::this_thread::get_id());
+    assert(tree.megaNode);
+
+    // nothing can be done until its contents are known
+    if (!tree.scanned || tree.filesQueued)
+    {
+        return;
+    }
+
+    if (isCancelledByFolderTransferToken() || mPipelineError)
+    {
+        return;
+    }
+
+    // preload children (optimization to speed up searches by name/type)
+    if (!tree.childrenLoaded)
+    {
+        std::shared_ptr<Node> parent = megaApi->client->nodebyhandle(tree.megaNode->getHandle());
+        assert(parent);
+        megaApi->client->getChildren(parent.get());
+        tree.childrenLoaded = true;
+    }
+
+    for (auto& t : tree.subtrees)
+    {
+        // already on its way, as part of its parent's batch
+        if (t->creating)
+        {
+            continue;
+        }
+
+        t->megaNode.reset(megaApi->getChildNodeOfType(tree.megaNode.get(), t->folderName.c_str(), MegaNode::TYPE_FOLDER));
+
+        if (t->megaNode)
+        {
+            ++mFoldersExisting;
+            folderExists(*t);
+        }
+        else
+        {
+            mFoldersToCreate.push_back(t.get());
+        }
+    }
+
+    tree.filesQueued = true;
+    ++mFoldersQueued;
+
+    TransferQueue transferQueue;
+    if (!genUploadTransfersForFiles(tree, transferQueue, false))
+    {
+        // cancelled, noticed by advancePipeline()
+        transferQueue.clear();
+    }
+    else if (!transferQueue.empty())
+    {
+        transfersTotalCount += transferQueue.size();
+        megaApi->sendPendingTransfers(&transferQueue, this);
+    }
+}
+
+void MegaFolderUploadController::advancePipeline()
+{
+    assert(mMainThreadId == std::this_thread::get_id());
+
+    if (isCancelledByFolderTransferToken() || mPipelineError)
+    {
+        mFoldersToCreate.clear();
+    }
+
+    while (!mFoldersToCreate.empty() && mPendingPutnodes < MAX_PIPELINED_PUTNODES)
+    {
+        // a putnodes can only create folders in one target, so take those waiting
+        // for the same parent as the first one
+        Tree* parent = mFoldersToCreate.front()->parent;
+
+        auto siblings = std::stable_partition(mFoldersToCreate.begin(),
+                                              mFoldersToCreate.end(),
+                                              [parent](Tree* t)
+                                              {
+                                                  return t->parent != parent;
+                                              });
+
+        if (mFoldersToCreate.end() - siblings > MAXNODESUPLOAD)
+        {
+            siblings = mFoldersToCreate.end() - MAXNODESUPLOAD;
+        }
+
+        vector<Tree*> folders(siblings, mFoldersToCreate.end());
+        mFoldersToCreate.erase(siblings, mFoldersToCreate.end());
+
+        sendFolderBatch(*parent, std::move(folders));
+    }
+
+    checkPipelineFinished();
+    // no further code can be added here, this object may now be deleted
+}
+
+void MegaFolderUploadController::sendFolderBatch(Tree& parent, vector<Tree*> folders)
+{
+    assert(mMainThreadId == std::this_thread::get_id());
+    assert(parent.megaNode);
+
+    // Along with the folders themselves, send those of their subfolders already known,
+    // parents first, which putnodes links up by their upload ids.
+    vector<Tree*> batch;
+    vector<NewNode> newnodes;
+
+    std::function<void(Tree&)> add = [&](Tree& t)
+    {
+        t.creating = true;
+        batch.push_back(&t);
+        newnodes.push_back(std::move(t.newnode));
+
+        if (!t.scanned)
+        {
+            return;
+        }
+
+        for (auto& child : t.subtrees)
+        {
+            if (newnodes.size() >= MAXNODESUPLOAD)
+            {
+                return;
+            }
+
+            add(*child);
+        }
+    };
+
+    for (auto it = folders.begin(); it != folders.end(); ++it)
+    {
+        if (newnodes.size() >= MAXNODESUPLOAD)
+        {
+            // subfolders filled the batch, the rest wait for a later putnodes
+            mFoldersToCreate.insert(mFoldersToCreate.end(), it, folders.end());
+            break;
+        }
+
+        // the parent of the root newNode must already exist in remote
+        (*it)->newnode.parenthandle = UNDEF;
+        add(**it);
+    }
+
+    assert(newnodes.size() <= MAXNODESUPLOAD);
+
+    ++mPendingPutnodes;
+
+    weak_ptr<MegaFolderUploadController> weak_this = shared_from_this();
+    handle target = parent.megaNode->getHandle();
+
+    megaapiThreadClient()->putnodes(
+        NodeHandle().set6byte(target),
+        UseLocalVersioningFlag,
+        std::move(newnodes),
+        nullptr,
+        megaapiThreadClient()->nextreqtag(),
+        false,
+        {}, // customerIpPort
+        [this, weak_this, batch](const Error& e,
+                                 targettype_t,
+                                 vector<NewNode>& nn,
+                                 bool,
+                                 int /*tag*/,
+                                 const map<string, string>& /*fileHandles*/)
+        {
+            // double check our object still exists on request completion
+            if (!weak_this.lock())
+                return;
+            assert(weak_this.lock().get() == this);
+            assert(mMainThreadId == std::this_thread::get_id());
+
+            --mPendingPutnodes;
+
+            if (e && !mPipelineError)
+            {
+                LOG_err << "MegaFolderUploadController: failed to create folders: " << e;
+                mPipelineError = e;
+            }
+
+            // parents come before their subfolders, and nn keeps the order of batch
+            assert(mPipelineError || nn.size() == batch.size());
+            for (size_t i = 0; i < batch.size(); ++i)
+            {
+                Tree* t = batch[i];
+                t->creating = false;
+
+                if (mPipelineError)
+                {
+                    continue;
+                }
+
+                if (i < nn.size() && nn[i].added && nn[i].mAddedHandle != UNDEF)
+                {
+                    t->megaNode.reset(megaApi->getNodeByHandle(nn[i].mAddedHandle));
+                }
+
+                if (!t->megaNode)
+                {
+                    LOG_err << "MegaFolderUploadController: created folder not found: " << t->folderName;
+                    mPipelineError = API_ENOENT;
+                    continue;
+                }
+
+                ++mFoldersExisting;
+                folderExists(*t);
+            }
+
+            megaApi->fireOnFolderTransferUpdate(transfer,
+                                                mScanFinished ? MegaTransfer::STAGE_CREATE_TREE : MegaTransfer::STAGE_SCAN,
+                                                unsigned(mFoldersKnown),
+                                                unsigned(mFoldersExisting),
+                                                mFilesScanned,
+                                                nullptr,
+                                                nullptr);
+
+            advancePipeline();
+            // no further code can be added here, this object may now be deleted
+        },
+        folderPitag(target));
+}
+
+void MegaFolderUploadController::checkPipelineFinished()
+{
+    assert(mMainThreadId == std::this_thread::get_id());
+
+    bool cancelled = isCancelledByFolderTransferToken() || mScanResult == scanFolder_cancelled;
+    bool stopped = cancelled || mPipelineError || mScanResult == scanFolder_failed;
+
+    if (!mMoreSubtransfersToCome || !mScanFinished || mPendingPutnodes ||
+        (!stopped && mFoldersQueued < mFoldersKnown))
+    {
+        return;
+    }
+
+    Error e = API_OK;
+    if (cancelled)
+    {
+        e = API_EINCOMPLETE;
+    }
+    else if (mPipelineError)
+    {
+        e = mPipelineError;
+    }
+    else if (mScanResult == scanFolder_failed)
+    {
+        e = API_EACCESS;
+    }
+
+    allSubtransfersQueued(e, cancelled);
+    // no further code can be added here, this object may now be deleted
+}
+
+Pitag MegaFolderUploadController::folderPitag(handle target)
+{
+    auto parent = megaApi->client->mNodeManager.getNodeByHandle(NodeHandle().set6byte(target));
+    const bool inIncomingShare = parent && parent->matchesOrHasAncestorMatching(
+                                               [](const Node& node)
+                                               {
+                                                   return node.inshare != nullptr;
+                                               });
+    Pitag localPitag = transfer->getPitag();
+    localPitag.target = inIncomingShare ? PitagTarget::IncomingShare : PitagTarget::CloudDrive;
+    return localPitag;
+}
+
 MegaFolderUploadController::batchResult MegaFolderUploadController::createNextFolderBatch(Tree& tree, vector<NewNode>& newnodes, uint32_t filecount, bool isBatchRootLevel)
 {
     assert(mMainThreadId == std::this_thread::get_id());
@@ -31606,15 +32280,7 @@ MegaFolderUploadController::batchResult MegaFolderUploadController::createNextFo
         // anymore when the request completes
         weak_ptr<MegaFolderUploadController> weak_this = shared_from_this();
 
-        auto parent = megaApi->client->mNodeManager.getNodeByHandle(
-            NodeHandle().set6byte(tree.megaNode->getHandle()));
-        const bool inIncomingShare = parent && parent->matchesOrHasAncestorMatching(
-                                                   [](const Node& node)
-                                                   {
-                                                       return node.inshare != nullptr;
-                                                   });
-        Pitag localPitag = transfer->getPitag();
-        localPitag.target = inIncomingShare ? PitagTarget::IncomingShare : PitagTarget::CloudDrive;
+        Pitag localPitag = folderPitag(tree.megaNode->getHandle());
 
         megaapiThreadClient()->putnodes(
             NodeHandle().set6byte(tree.megaNode->getHandle()),
@@ -31696,7 +32362,7 @@ MegaFolderUploadController::batchResult MegaFolderUploadController::createNextFo
     return batchResult_stillRecursing;
 }
 
-bool MegaFolderUploadController::genUploadTransfersForFiles(Tree& tree, TransferQueue& transferQueue)
+bool MegaFolderUploadController::genUploadTransfersForFiles(Tree& tree, TransferQueue& transferQueue, bool includeSubtrees)
 {
     for (const auto& localpath : tree.files)
     {
@@ -31724,6 +32390,11 @@ bool MegaFolderUploadController::genUploadTransfersForFiles(Tree& tree, Transfer
         if (isCancelledByFolderTransferToken()) return false;
     }
 
+    if (!includeSubtrees)
+    {
+        return true;
+    }
+
     for (auto& t : tree.subtrees)
     {
         genUploadTransfersForFiles(*t, transferQueue);
@@ -31758,6 +32429,32 @@ void MegaRecursiveOperation::setRootNodeHandleInTransfer()
     }
 }
 
+void MegaRecursiveOperation::allSubtransfersQueued(Error e, bool cancelledByUser)
+{
+    assert(mMainThreadId == std::this_thread::get_id());
+    assert(mMoreSubtransfersToCome);
+
+    // every sub-transfer there will be has been queued
+    mMoreSubtransfersToCome = false;
+
+    if (!cancelledByUser && transfersTotalCount && transfersStartedCount == transfersTotalCount && !startedTransferring)
+    {
+        notifyStage(MegaTransfer::STAGE_TRANSFERRING_FILES);
+        megaApi->fireOnFolderTransferUpdate(transfer, MegaTransfer::STAGE_TRANSFERRING_FILES, 0, 0, unsigned(transfersTotalCount), nullptr, nullptr);
+        startedTransferring = true;
+    }
+
+    if (!allSubtransfersResolved())
+    {
+        // the last sub-transfer to finish completes the folder transfer, with this error
+        mQueueingError = e;
+        return;
+    }
+
+    complete(e ? e : Error(mIncompleteTransfers ? API_EINCOMPLETE : API_OK), cancelledByUser);
+    // no further code can be added here, this object may now be deleted
+}
+
 void MegaRecursiveOperation::complete(Error e, bool cancelledByUser)
 {
     assert(mMainThreadId == std::this_thread::get_id());
@@ -32919,6 +33616,7 @@ MegaFolderDownloadController::MegaFolderDownloadController(MegaApiImpl* api,
     recursive = 0;
     tag = t->getTag();
     mMainThreadId = std::this_thread::get_id();
+    mReadyDownloads = std::make_unique<TransferQueue>();
 }
 
 MegaFolderDownloadController::~MegaFolderDownloadController()
@@ -32926,6 +33624,9 @@ MegaFolderDownloadController::~MegaFolderDownloadController()
     assert(mMainThreadId == std::this_thread::get_id());
     LOG_debug << "MegaFolderDownloadController dtor is being called from main thread";
     ensureThreadStopped();
+
+    // downloads generated after the operation was stopped, that were never sent
+    mReadyDownloads->clear();
 }
 
 void MegaFolderDownloadController::start(MegaNode *node)
@@ -32977,6 +33678,46 @@ void MegaFolderDownloadController::start(MegaNode *node)
     }
 
     notifyStage(MegaTransfer::STAGE_SCAN);
+
+    if (!node->isForeign())
+    {
+        mMoreSubtransfersToCome = true;
+        mStreamPath = path;
+
+        mWorkerThread = std::thread([this, root = node->getHandle(), fsType, path]() {
+            Error e = streamFolders(root, path, fsType);
+
+            weak_ptr<MegaFolderDownloadController> weak_this = shared_from_this();
+
+            mCompletionForMegaApiThread.reset(new ExecuteOnce([this, e, weak_this]() {
+
+                if (!weak_this.lock()) return;
+                assert(mMainThreadId == std::this_thread::get_id());
+
+                if (mWorkerThread.joinable())
+                {
+                    mWorkerThread.join();
+                }
+
+                mStreamFinished = true;
+                mStreamResult = e;
+
+                if (!e)
+                {
+                    notifyStage(MegaTransfer::STAGE_CREATE_TREE);
+                }
+
+                // the last downloads may not have been sent yet
+                sendReadyDownloads();
+                // no further code can be added here, this object may now be deleted
+            }));
+
+            megaApi->executeOnThread(mCompletionForMegaApiThread);
+        });
+
+        return;
+    }
+
     // for download scan is just checking nodes, we can do this all in one quick pass
     unsigned fileAddedCount = 0;
     scanFolder_result sr = scanFolder(node, path, fsType, fileAddedCount);
@@ -33224,43 +33965,309 @@ bool MegaFolderDownloadController::genDownloadTransfersForFiles(
             return false;
         }
 
-        // get file local path
-        auto fileLocalPath = folder.localPath;
-        fileLocalPath.appendWithSeparator(LocalPath::fromRelativeName(fileNode->getName(), *fsaccess, fsType), true);
+        transferQueue->push(genDownloadTransfer(fileNode.get(), folder.localPath, fsType, folderExists, *fsaccess));
+    }
+
+    return true;
+}
+
+MegaTransferPrivate* MegaFolderDownloadController::genDownloadTransfer(MegaNode* fileNode,
+                                                                       const LocalPath& folderPath,
+                                                                       FileSystemType fsType,
+                                                                       bool folderExists,
+                                                                       FileSystemAccess& fsa)
+{
+    // get file local path
+    auto fileLocalPath = folderPath;
+    fileLocalPath.appendWithSeparator(LocalPath::fromRelativeName(fileNode->getName(), fsa, fsType), true);
+
+    auto decision = CollisionChecker::Result::Download;
+
+    // collision might exist only if the folder already exists
+    if (folderExists)
+    {
+        auto fa = fsa.newfileaccess();
+        if (fa && fa->fopen(fileLocalPath, OPEN_RDONLY, FSLogging::logExceptFileNotFound) &&
+            fa->type == FILENODE)
+        {
+            decision = CollisionChecker::check(&fsa, fileLocalPath, fileNode, transfer->getCollisionCheck());
+        }
+    }
+
+    MegaTransferPrivate* transferDownload =
+        megaApi->createDownloadTransfer(false,
+                                        fileNode,
+                                        fileLocalPath,
+                                        nullptr,
+                                        tag,
+                                        transfer->getAppData(),
+                                        transfer->accessCancelToken(),
+                                        static_cast<int>(transfer->getCollisionCheck()),
+                                        static_cast<int>(transfer->getCollisionResolution()),
+                                        transfer->getNodeToUndelete() != nullptr,
+                                        this,
+                                        fsType);
+
+    transferDownload->setCollisionCheckResult(decision);
+
+    return transferDownload;
+}
+
+Error MegaFolderDownloadController::streamFolders(MegaHandle root, const LocalPath& path, FileSystemType fsType)
+{
+    // folders listed but not created yet, most recently found taken first,
+    // which keeps this short for wide trees
+    vector<std::pair<MegaHandle, LocalPath>> pending;
+    pending.emplace_back(root, path);
+    mFoldersFound = 1;
+
+    std::mutex m;
+    std::condition_variable cv;
+    unsigned busy = 0;
+    Error result = API_OK;
+
+    auto stream = [&]()
+    {
+        // each thread has its own, as it is not thread safe
+        auto fsa = createFSA();
+        fsa->setdefaultfilepermissions(fsaccess->getdefaultfilepermissions());
+        fsa->setdefaultfolderpermissions(fsaccess->getdefaultfolderpermissions());
+
+        vector<std::pair<MegaHandle, LocalPath>> subfolders;
+
+        std::unique_lock<std::mutex> lock(m);
+
+        for (;;)
+        {
+            // done when nothing is left, and no other thread can find more
+            cv.wait(lock, [&]() { return !pending.empty() || !busy || result != API_OK; });
+
+            if (pending.empty() || result != API_OK)
+            {
+                break;
+            }
+
+            auto folder = std::move(pending.back());
+            pending.pop_back();
+            ++busy;
+
+            lock.unlock();
+
+            subfolders.clear();
+            Error e = streamOneFolder(folder.first, std::move(folder.second), fsType, *fsa, subfolders);
+
+            lock.lock();
+            --busy;
+
+            if (e)
+            {
+                result = e;
+            }
+            else
+            {
+                for (auto& subfolder : subfolders)
+                {
+                    pending.push_back(std::move(subfolder));
+                }
+            }
+
+            cv.notify_all();
+        }
+    };
+
+    auto threads = std::clamp(std::thread::hardware_concurrency(), 2u, MAX_STREAM_THREADS);
+
+    vector<std::thread> helpers;
+    for (unsigned i = 1; i < threads; ++i)
+    {
+        helpers.emplace_back(stream);
+    }
+
+    stream();
+
+    for (auto& helper : helpers)
+    {
+        helper.join();
+    }
+
+    return result;
+}
+
+Error MegaFolderDownloadController::streamOneFolder(MegaHandle folder,
+                                                    LocalPath path,
+                                                    FileSystemType fsType,
+                                                    FileSystemAccess& fsa,
+                                                    vector<std::pair<MegaHandle, LocalPath>>& subfolders)
+{
+    if (isStoppedOrCancelled("MegaFolderDownloadController::streamOneFolder"))
+    {
+        return API_EINCOMPLETE;
+    }
+
+    // the path may change, depending on the collision resolution
+    Error e = MegaApiImpl::createLocalFolder_unlocked(path, fsa, transfer->getCollisionResolution());
+
+    // errors besides the folder already exists is an error
+    if (e && e != API_EEXIST)
+    {
+        return e;
+    }
+
+    const bool folderExists = e == API_EEXIST;
+    ++mFoldersCreated;
 
-        auto decision = CollisionChecker::Result::Download;
+    std::optional<MegaSearchLexicographicalOffset> offset;
 
-        // collision might exist only if the folder already exists
-        if (folderExists)
+    for (;;)
+    {
+        // the SDK mutex can be held by whoever is stopping this thread, so don't wait on it for long
+        while (!megaApi->tryLockMutexFor(100))
         {
-            auto fa = fsaccess->newfileaccess();
-            if (fa && fa->fopen(fileLocalPath, OPEN_RDONLY, FSLogging::logExceptFileNotFound) &&
-                fa->type == FILENODE)
+            if (isStoppedOrCancelled("MegaFolderDownloadController::streamOneFolder"))
             {
-                decision = CollisionChecker::check(fsaccess.get(), fileLocalPath, fileNode.get(), transfer->getCollisionCheck());
+                return API_EINCOMPLETE;
             }
         }
 
-        MegaTransferPrivate* transferDownload =
-            megaApi->createDownloadTransfer(false,
-                                            fileNode.get(),
-                                            fileLocalPath,
-                                            nullptr,
-                                            tag,
-                                            transfer->getAppData(),
-                                            transfer->accessCancelToken(),
-                                            static_cast<int>(transfer->getCollisionCheck()),
-                                            static_cast<int>(transfer->getCollisionResolution()),
-                                            transfer->getNodeToUndelete() != nullptr,
-                                            this,
-                                            fsType);
+        unique_ptr<MegaNodeList> children(megaApi->listChildNodesLexicographically(folder,
+                                                                                   transfer->accessCancelToken(),
+                                                                                   CHILDREN_PAGE_SIZE,
+                                                                                   offset));
+        megaApi->unlockMutex();
+
+        TransferQueue downloads;
+        unsigned files = 0;
 
-        transferDownload->setCollisionCheckResult(decision);
+        for (int i = 0; i < children->size(); i++)
+        {
+            if (isStoppedOrCancelled("MegaFolderDownloadController::streamOneFolder"))
+            {
+                downloads.clear();
+                return API_EINCOMPLETE;
+            }
 
-        transferQueue->push(transferDownload);
+            MegaNode* child = children->get(i);
+            if (child->getType() == MegaNode::TYPE_FILE)
+            {
+                downloads.push(genDownloadTransfer(child, path, fsType, folderExists, fsa));
+                ++files;
+            }
+            else
+            {
+                LocalPath subfolderPath = path;
+                subfolderPath.appendWithSeparator(LocalPath::fromRelativeName(child->getName(), fsa, fsType), true);
+                subfolders.emplace_back(child->getHandle(), std::move(subfolderPath));
+                ++mFoldersFound;
+            }
+        }
+
+        mFilesFound += files;
+
+        if (!downloads.empty())
+        {
+            downloadsReady(downloads);
+        }
+
+        if (static_cast<size_t>(children->size()) < CHILDREN_PAGE_SIZE)
+        {
+            return API_OK;
+        }
+
+        // resume after the last one, even among others of the same name
+        MegaNode* last = children->get(children->size() - 1);
+        offset = MegaSearchLexicographicalOffset{last->getName() ? last->getName() : "",
+                                                 last->getType(),
+                                                 last->getHandle()};
     }
+}
 
-    return true;
+void MegaFolderDownloadController::downloadsReady(TransferQueue& downloads)
+{
+    bool queue = false;
+    {
+        std::lock_guard<std::mutex> g(mReadyMutex);
+
+        while (MegaTransferPrivate* t = downloads.pop())
+        {
+            mReadyDownloads->push(t);
+        }
+
+        queue = !mReadyDownloadsQueued;
+        mReadyDownloadsQueued = true;
+    }
+
+    if (!queue)
+    {
+        // the MegaApiImpl's thread has yet to send the ones before
+        return;
+    }
+
+    weak_ptr<MegaFolderDownloadController> weak_this = shared_from_this();
+
+    megaApi->executeOnThread(std::make_shared<ExecuteOnce>([this, weak_this]() {
+
+        if (!weak_this.lock()) return;
+        assert(mMainThreadId == std::this_thread::get_id());
+
+        sendReadyDownloads();
+        // no further code can be added here, this object may now be deleted
+    }));
+}
+
+void MegaFolderDownloadController::sendReadyDownloads()
+{
+    assert(mMainThreadId == std::this_thread::get_id());
+
+    if (!mMoreSubtransfersToCome)
+    {
+        // all were sent already
+        return;
+    }
+
+    TransferQueue downloads;
+    {
+        std::lock_guard<std::mutex> g(mReadyMutex);
+
+        while (MegaTransferPrivate* t = mReadyDownloads->pop())
+        {
+            downloads.push(t);
+        }
+
+        mReadyDownloadsQueued = false;
+    }
+
+    if (!downloads.empty())
+    {
+        // the folder transfer can't complete meanwhile, as more sub-transfers are to come
+        transfersTotalCount += downloads.size();
+        megaApi->sendPendingTransfers(&downloads, this, megaapiThreadClient()->fsaccess->availableDiskSpace(mStreamPath));
+    }
+
+    megaApi->fireOnFolderTransferUpdate(transfer,
+                                        mStreamFinished ? MegaTransfer::STAGE_CREATE_TREE : MegaTransfer::STAGE_SCAN,
+                                        mFoldersFound,
+                                        mFoldersCreated,
+                                        mFilesFound,
+                                        nullptr,
+                                        nullptr);
+
+    checkStreamingFinished();
+    // no further code can be added here, this object may now be deleted
+}
+
+void MegaFolderDownloadController::checkStreamingFinished()
+{
+    assert(mMainThreadId == std::this_thread::get_id());
+
+    if (!mMoreSubtransfersToCome || !mStreamFinished)
+    {
+        return;
+    }
+
+    bool cancelled = isCancelledByFolderTransferToken() || mStreamResult == API_EINCOMPLETE;
+
+    allSubtransfersQueued(cancelled ? Error(API_EINCOMPLETE) : mStreamResult, cancelled);
+    // no further code can be added here, this object may now be deleted
 }
 
 
@@ -36769,6 +37776,119 @@ void MegaFTPServer::getPermissionsString(int permissions, char *permsString)
     strncat(permsString, ps.c_str(), ps.size() + 1);
 }
 
+//////////////////////////////////
+//  MegaMetricsServer specifics //
+//////////////////////////////////
+
+MegaMetricsServer::MegaMetricsServer(MegaApiImpl* megaApi, string basePath, bool useIPv6):
+    MegaTCPServer(megaApi, basePath, false, string(), string(), useIPv6)
+{}
+
+MegaMetricsServer::~MegaMetricsServer()
+{
+    // if not stopped, the uv thread might call our overrides after they're gone
+    stop();
+}
+
+MegaTCPContext* MegaMetricsServer::initializeContext(uv_stream_t* server_handle)
+{
+    MegaMetricsContext* metricsctx = new MegaMetricsContext();
+
+    // Set connection data
+    MegaMetricsServer* metricsServer = (MegaMetricsServer*)(server_handle->data);
+    metricsctx->server = metricsServer;
+    metricsctx->megaApi = metricsServer->megaApi;
+    metricsctx->tcphandle.data = metricsctx;
+    metricsctx->asynchandle.data = metricsctx;
+
+    return metricsctx;
+}
+
+bool MegaMetricsServer::respondNewConnection(MegaTCPContext*)
+{
+    return true;
+}
+
+void MegaMetricsServer::processReceivedData(MegaTCPContext* tcpctx,
+                                            ssize_t nread,
+                                            const uv_buf_t* buf)
+{
+    MegaMetricsContext* metricsctx = static_cast<MegaMetricsContext*>(tcpctx);
+
+    if (nread < 0)
+    {
+        closeConnection(tcpctx);
+        return;
+    }
+
+    // Already answered.
+    if (!metricsctx->response.empty())
+        return;
+
+    metricsctx->request.append(buf->base, static_cast<size_t>(nread));
+
+    // Wait for the whole of the headers.
+    if (metricsctx->request.find("\r\n\r\n") == string::npos)
+    {
+        if (metricsctx->request.size() > MAX_REQUEST_SIZE)
+        {
+            LOG_warn << "Metrics server: request too long";
+            closeConnection(tcpctx);
+        }
+        return;
+    }
+
+    // Only the request line matters.
+    std::istringstream requestLine(metricsctx->request.substr(0, metricsctx->request.find("\r\n")));
+    string method, target;
+    requestLine >> method >> target;
+    target = target.substr(0, target.find('?'));
+
+    LOG_debug << "Metrics server: " << method << " " << target;
+
+    string status = "200 OK";
+    string contentType = stats::OpenMetricsWriter::CONTENT_TYPE;
+    string body;
+
+    if (method != "GET" && method != "HEAD")
+    {
+        status = "405 Method Not Allowed";
+        contentType = "text/plain";
+    }
+    else if (target != "/metrics" && target != "/")
+    {
+        status = "404 Not Found";
+        contentType = "text/plain";
+    }
+    else
+    {
+        std::unique_ptr<char[]> metrics(megaApi->getMetrics());
+        body = metrics.get();
+    }
+
+    metricsctx->response = "HTTP/1.1 " + status + "\r\n"
+                           "Content-Type: " + contentType + "\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n"
+                           "\r\n";
+
+    if (method != "HEAD")
+        metricsctx->response += body;
+
+    answer(tcpctx, metricsctx->response.data(), metricsctx->response.size());
+}
+
+void MegaMetricsServer::processWriteFinished(MegaTCPContext* tcpctx, int status)
+{
+    if (status < 0)
+    {
+        LOG_warn << "Metrics server: error sending the response: " << status << ": "
+                 << uv_err_name(status);
+    }
+
+    closeConnection(tcpctx);
+}
+
 //ftp_parser_settings MegaTCPServer::parsercfg;
 MegaFTPServer::MegaFTPServer(MegaApiImpl *megaApi, string basePath, int dataportBegin, int dataPortEnd, bool useTLS, string certificatepath, string keypath)
 : MegaTCPServer(megaApi, basePath, useTLS, certificatepath, keypath)
@@ -26,6 +26,7 @@
 #include "mega/logging.h"
 #include "mega/mediafileattribute.h"
 #include "mega/network_connectivity_test.h"
+#include "mega/openmetrics.h"
 #include "mega/recent_actions.h"
 #include "mega/scoped_helpers.h"
 #include "mega/testhooks.h"
@@ -107,6 +108,9 @@ const unsigned MegaClient::MAX_RAIDTRANSFERS_FOR_MOBILE = std::max<unsigned>(MAX
 // i.e., there must be at least this number of raid transfers to let us predict whether the next download transfer will be raided or non-raided
 const unsigned MegaClient::MEANINGFUL_PORTION_OF_MAXTRANSFERS_QUEUE_FOR_RAID_PREDICTIVE_SYSTEM = std::max<unsigned>(MAXTRANSFERS / 6, 1);
 
+// largest upload whose putnodes may be batched with others (as TransferCategory's small files)
+const m_off_t MegaClient::MAX_BATCHED_UPLOAD_SIZE = 131072;
+
 // maximum number of queued putfa before halting the upload queue
 const int MegaClient::MAXQUEUEDFA = 30;
 
@@ -881,6 +885,79 @@ bool MegaClient::setJourneyId(const string& jid)
 }
 // -- MegaClient JourneyID methods end --
 
+bool MegaClient::setTlsSessionPersistence(bool enable)
+{
+    if (!enable)
+    {
+        if (!mTlsSessionCachePath.empty())
+        {
+            fsaccess->unlinklocal(mTlsSessionCachePath);
+            mTlsSessionCachePath.clear();
+        }
+        return true;
+    }
+
+    if (!dbaccess)
+    {
+        LOG_warn << "[MegaClient::setTlsSessionPersistence] No local cache folder";
+        return false;
+    }
+
+    string probe;
+    if (!httpio->exportTlsSessions(probe))
+    {
+        LOG_warn << "[MegaClient::setTlsSessionPersistence] The network layer can't export TLS "
+                    "sessions";
+        return false;
+    }
+
+    mTlsSessionCachePath = dbaccess->rootPath();
+    mTlsSessionCachePath.appendWithSeparator(LocalPath::fromRelativePath("tlss"), true);
+
+    auto fileAccess = fsaccess->newfileaccess(false);
+    if (fileAccess->fopen(mTlsSessionCachePath, OPEN_RDONLY, FSLogging::logExceptFileNotFound))
+    {
+        string data;
+        if (!fileAccess->fread(&data,
+                               static_cast<unsigned long>(fileAccess->size),
+                               0,
+                               0,
+                               FSLogging::logOnError) ||
+            !httpio->importTlsSessions(data))
+        {
+            LOG_warn << "[MegaClient::setTlsSessionPersistence] Unable to load the TLS session "
+                        "cache";
+        }
+    }
+
+    return true;
+}
+
+bool MegaClient::storeTlsSessions()
+{
+    if (mTlsSessionCachePath.empty())
+    {
+        return false;
+    }
+
+    string data;
+    if (!httpio->exportTlsSessions(data))
+    {
+        return false;
+    }
+
+    auto fileAccess = fsaccess->newfileaccess(false);
+    if (!fileAccess->fopen(mTlsSessionCachePath, OPEN_WRONLY, FSLogging::logOnError) ||
+        !fileAccess->ftruncate() ||
+        !fileAccess->fwrite(data.data(), static_cast<unsigned long>(data.size()), 0))
+    {
+        LOG_err << "[MegaClient::storeTlsSessions] Unable to store the TLS session cache";
+        return false;
+    }
+
+    return true;
+}
+
 error MegaClient::setbackupfolder(const char* foldername, int tag, std::function<void(Error)> addua_completion)
 {
     if (!foldername)
@@ -2217,6 +2294,15 @@ void MegaClient::exec()
 
     WAIT_CLASS::bumpds();
 
+    mTimers.fire();
+
+    if (httpio->newtlssessions && Waiter::ds >= mNextTlsSessionStoreDs)
+    {
+        httpio->newtlssessions = false;
+        mNextTlsSessionStoreDs = Waiter::ds + TLS_SESSION_STORE_INTERVAL_DS;
+        storeTlsSessions();
+    }
+
     if (overquotauntil && overquotauntil < Waiter::ds)
     {
         overquotauntil = 0;
@@ -2285,6 +2371,9 @@ void MegaClient::exec()
         }
         first = false;
 
+        // uploads completed in the previous pass go out together
+        sendBatchedPutnodes();
+
         if (cachedug && btugexpiration.armed())
         {
             LOG_debug << "Cached user data expired";
@@ -2628,6 +2717,7 @@ void MegaClient::exec()
         }
 
         // handle API client-server requests
+        CodeCounter::ScopeTimer csTime(performanceStats.execCsRequests);
         for (;;)
         {
             // do we have an API request outstanding?
@@ -2990,6 +3080,8 @@ void MegaClient::exec()
             break;
         }
 
+        csTime.complete();
+
         // handle API lockless client-server requests
         for (;;)
         {
@@ -3234,7 +3326,9 @@ void MegaClient::exec()
         }
 
         // handle API server-client requests
+        CodeCounter::ScopeTimer scTime(performanceStats.execScChannel);
         handleScChannel();
+        scTime.complete();
 
         if (!pendingsc && !pendingscUserAlerts && scsn.ready() && btsc.armed() && !mBlocked)
         {
@@ -3420,6 +3514,12 @@ void MegaClient::exec()
             nextDispatchTransfersDs = transferCount ? Waiter::ds + 1 : 0;
         }
 
+        // cached transfers not resumed yet, once the first ones had the chance to start
+        if (resumingTransfers() && tctable)
+        {
+            resumeTransferFromDB();
+        }
+
 #ifndef EMSCRIPTEN
         assert(!asyncfopens);
 #endif
@@ -3429,6 +3529,7 @@ void MegaClient::exec()
 
         if (!mBlocked) // handle active unpaused transfers
         {
+            CodeCounter::ScopeTimer slotsTime(performanceStats.execTransferSlots);
             TransferDbCommitter committer(tctable);
 
             while (slotit != tslots.end())
@@ -3570,7 +3671,8 @@ void MegaClient::exec()
 
         httpio->updatedownloadspeed();
         httpio->updateuploadspeed();
-    } while (httpio->doio() || execdirectreads() || (!pendingcs && reqs.readyToSend() && btcs.armed()));
+    } while (httpio->doio() || execdirectreads() || !mPutnodesBatches.empty() ||
+             (!pendingcs && reqs.readyToSend() && btcs.armed()));
 
 
     if (!fetchingnodes)
@@ -3662,6 +3764,14 @@ int MegaClient::preparewait()
         if (nextDispatchTransfersDs)
             nds = std::max(nextDispatchTransfersDs, Waiter::ds.load());
 
+        // cached transfers still to resume
+        if (resumingTransfers())
+            nds = Waiter::ds;
+
+        // high-resolution timers already due (the others set the waiter's ceiling below)
+        if (auto next = mTimers.timeUntilNext(); next && *next == TimerQueue::Clock::duration::zero())
+            nds = 0;
+
         for (pendinghttp_map::iterator it = pendinghttp.begin(); it != pendinghttp.end(); it++)
         {
             if (it->second->isbtactive)
@@ -3732,22 +3842,6 @@ int MegaClient::preparewait()
             }
         }
 
-        // next pending pread event
-        if (!dsdrns.empty())
-        {
-            if (dsdrns.begin()->first < nds)
-            {
-                if (dsdrns.begin()->first <= Waiter::ds)
-                {
-                    nds = Waiter::ds;
-                }
-                else
-                {
-                    nds = dsdrns.begin()->first;
-                }
-            }
-        }
-
         if (cachedug)
         {
             btugexpiration.update(&nds);
@@ -3874,11 +3968,16 @@ int MegaClient::preparewait()
 
     waiter->init(nds);
 
+    if (auto next = mTimers.timeUntilNext())
+    {
+        waiter->wakeupwithin(std::chrono::ceil<std::chrono::milliseconds>(*next));
+    }
+
     // set subsystem wakeup criteria (WinWaiter assumes httpio to be set first!)
     waiter->wakeupby(httpio, Waiter::NEEDEXEC);
 
 #ifdef MEGA_MEASURE_CODE
-    if (waiter->maxds == 0 && !reasonGiven)
+    if (waiter->timeoutms() == 0 && !reasonGiven)
     {
         ++performanceStats.prepwaitHttpio;
         reasonGiven = true;
@@ -3888,7 +3987,7 @@ int MegaClient::preparewait()
     waiter->wakeupby(fsaccess.get(), Waiter::NEEDEXEC);
 
 #ifdef MEGA_MEASURE_CODE
-    if (waiter->maxds == 0 && !reasonGiven)
+    if (waiter->timeoutms() == 0 && !reasonGiven)
     {
         ++performanceStats.prepwaitFsaccess;
         reasonGiven = true;
@@ -4039,6 +4138,11 @@ void MegaClient::dispatchTransfers()
         }
     }
 
+    // let the scheduler learn how the slots in use perform
+    mTransferScheduler.sample(static_cast<unsigned>(tslots.size()),
+                              httpio->downloadSpeed + httpio->uploadSpeed,
+                              Waiter::ds);
+
     // do we have any transfer slots available?
     if (!slotavail())
     {
@@ -4241,7 +4345,12 @@ void MegaClient::dispatchTransfers()
 
     TransferDbCommitter committer(tctable);
 
-    std::array<vector<Transfer*>, 6> nextInCategory = transferlist.nexttransfers(testAddTransferFunction, continueDirection, committer);
+    // the scheduler orders every ready transfer before the budget picks from them
+    std::array<vector<Transfer*>, 6> nextInCategory =
+        transferlist.nexttransfers(testAddTransferFunction,
+                                   continueDirection,
+                                   committer,
+                                   &mTransferScheduler);
 
     // Iterate the 4 combinations in this order:
     static const TransferCategory categoryOrder[] = {
@@ -4251,7 +4360,18 @@ void MegaClient::dispatchTransfers()
         TransferCategory(GET, SMALLFILE),
     };
 
-    for (auto category : categoryOrder)
+    // ...unless the scheduler favors small files
+    static const TransferCategory smallFirstCategoryOrder[] = {
+        TransferCategory(PUT, SMALLFILE),
+        TransferCategory(GET, SMALLFILE),
+        TransferCategory(PUT, LARGEFILE),
+        TransferCategory(GET, LARGEFILE),
+    };
+
+    const auto& order =
+        mTransferScheduler.smallFilesFirst() ? smallFirstCategoryOrder : categoryOrder;
+
+    for (auto category : order)
     {
         for (Transfer *nexttransfer : nextInCategory[category.index()])
         {
@@ -4362,6 +4482,7 @@ void MegaClient::dispatchTransfers()
                 {
                     // allocate transfer slot
                     ts = new TransferSlot(nexttransfer);
+                    mTransferScheduler.started(TransferScheduler::job(*nexttransfer));
                 }
                 else
                 {
@@ -4895,6 +5016,9 @@ void MegaClient::locallogout(bool removecaches, [[maybe_unused]] bool keepSyncsC
     LOG_debug << clientname << "executing locallogout processing";  // track possible lack of logout callbacks
     executingLocalLogout = true;
 
+    // keep the sessions of this run's connections for the next one
+    storeTlsSessions();
+
     mAsyncQueue.clearDiscardable();
 
     mV1PswdVault.reset();
@@ -4964,8 +5088,8 @@ void MegaClient::locallogout(bool removecaches, [[maybe_unused]] bool keepSyncsC
     // Clear cached request progress.
     mRequestProgress.reset();
 
-    sctable.reset();
     mNodeManager.setTable(nullptr);
+    sctable.reset();
 
     statusTable.reset();
 
@@ -5050,6 +5174,7 @@ void MegaClient::locallogout(bool removecaches, [[maybe_unused]] bool keepSyncsC
 
     reqs.clear();
     mReqsLockless.clear();
+    mPutnodesBatches.clear();
 
     delete pendingcs;
     pendingcs = NULL;
@@ -5438,11 +5563,16 @@ void MegaClient::sc_procEoo(std::unique_lock<recursive_mutex>& nodeTreeIsChangin
         {
             resumeTransferFromDB();
         }
-        WAIT_CLASS::bumpds();
-        fnstats.timeToTransfersResumed = Waiter::ds - fnstats.startTime;
-        string report;
-        fnstats.toJsonArray(&report);
-        sendevent(99426, report.c_str(), 0); // Treeproc performance log
+
+        // the stats are sent once the last round of resumption is done
+        if (resumingTransfers())
+        {
+            mFnStatsReportPending = true;
+        }
+        else
+        {
+            sendFetchNodesStats();
+        }
         // NULL vector: "notify all elements"
         app->nodes_updated(NULL, int(numNodes));
         app->users_updated(NULL, int(users.size()));
@@ -5974,6 +6104,56 @@ void MegaClient::updatesc()
             return;
         }
 
+        // Serialize and encrypt what will be written below on the worker
+        // threads, leaving only the writes themselves, in order, to this one
+        vector<std::pair<uint32_t, Cacheable*>> records;
+
+        if (!mScDbStateRecord.seqTag.empty())
+        {
+            records.emplace_back(CACHEDDBSTATE, &mScDbStateRecord);
+        }
+
+        for (User* u : usernotify)
+        {
+            if (u->show != INACTIVE || u->userhandle == me)
+            {
+                records.emplace_back(CACHEDUSER, u);
+            }
+        }
+
+        for (PendingContactRequest* pcr : pcrnotify)
+        {
+            if (!pcr->removed())
+            {
+                records.emplace_back(CACHEDPCR, pcr);
+            }
+        }
+
+        for (Set* s : setnotify)
+        {
+            if (s->changes() && !s->hasChanged(Set::CH_REMOVED))
+            {
+                records.emplace_back(CACHEDSET, s);
+            }
+        }
+
+        for (SetElement* e : setelementnotify)
+        {
+            if (e->changes() && !e->hasChanged(SetElement::CH_EL_REMOVED) && mSets.count(e->set()))
+            {
+                records.emplace_back(CACHEDSETELEMENT, e);
+            }
+        }
+
+#ifdef ENABLE_CHAT
+        for (auto& it : chatnotify)
+        {
+            records.emplace_back(CACHEDCHAT, it.second);
+        }
+#endif
+
+        encodesc(records);
+
         bool complete;
 
         // 1. update associated scsn
@@ -5983,7 +6163,7 @@ void MegaClient::updatesc()
 
         if (complete && !mScDbStateRecord.seqTag.empty())
         {
-            complete = sctable->put(CACHEDDBSTATE, &mScDbStateRecord, &key);
+            complete = putsc(CACHEDDBSTATE, &mScDbStateRecord);
             LOG_debug << "saving seqtag in db: " << mScDbStateRecord.seqTag;
         }
 
@@ -6008,7 +6188,7 @@ void MegaClient::updatesc()
                 else
                 {
                     LOG_verbose << clientname << "Adding/updating user to database: " << (Base64::btoa((byte*)&((*it)->userhandle),MegaClient::USERHANDLE,base64) ? base64 : "");
-                    complete = sctable->put(CACHEDUSER, *it, &key);
+                    complete = putsc(CACHEDUSER, *it);
                     if (!complete)
                     {
                         break;
@@ -6041,7 +6221,7 @@ void MegaClient::updatesc()
                 else if (!(*it)->removed())
                 {
                     LOG_verbose << "Adding pcr to database: " << (Base64::btoa((byte*)&((*it)->id),MegaClient::PCRHANDLE,base64) ? base64 : "");
-                    complete = sctable->put(CACHEDPCR, *it, &key);
+                    complete = putsc(CACHEDPCR, *it);
                     if (!complete)
                     {
                         break;
@@ -6069,7 +6249,7 @@ void MegaClient::updatesc()
             for (textchat_map::iterator it = chatnotify.begin(); it != chatnotify.end(); it++)
             {
                 LOG_verbose << "Adding chat to database: " << Base64Str<sizeof(handle)>(it->second->getChatId());
-                complete = sctable->put(CACHEDCHAT, it->second, &key);
+                complete = putsc(CACHEDCHAT, it->second);
                 if (!complete)
                 {
                     break;
@@ -6084,6 +6264,9 @@ void MegaClient::updatesc()
             << mNodeManager.nodeNotifySize() << " modified nodes, " << usernotify.size() << " users, " << pcrnotify.size() << " pcrs, "
             << setnotify.size() << " sets, " << setelementnotify.size() << " elements to local cache (" << complete << ")";
 #endif
+        // records left over if a write failed
+        mEncodedScRecords.clear();
+
         finalizesc(complete);
     }
 }
@@ -6102,6 +6285,109 @@ void MegaClient::finalizesc(bool complete)
     }
 }
 
+void MegaClient::encodesc(const vector<std::pair<uint32_t, Cacheable*>>& records)
+{
+    if (!sctable || records.empty())
+    {
+        return;
+    }
+
+    struct Batch
+    {
+        vector<std::pair<uint32_t, Cacheable*>> records;
+        vector<std::optional<string>> encoded;
+        vector<std::chrono::high_resolution_clock::duration> spent;
+        byte key[SymmCipher::KEYLENGTH];
+        const DbTable* table = nullptr;
+        size_t chunks = 0;
+        std::atomic<size_t> next{0};
+        size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    auto batch = std::make_shared<Batch>();
+    batch->records = records;
+    batch->encoded.resize(records.size());
+    batch->spent.resize(records.size());
+    memcpy(batch->key, key.key, sizeof(batch->key));
+    batch->table = sctable.get();
+
+    // Encode in chunks claimed by the worker threads and by this thread, which
+    // takes over any chunk the workers haven't started. The records aren't
+    // touched by this thread until every chunk is done.
+    batch->chunks = (records.size() + SC_RECORDS_PER_CHUNK - 1) / SC_RECORDS_PER_CHUNK;
+
+    auto work = [](Batch& batch, SymmCipher& cipher)
+    {
+        cipher.setkey(batch.key);
+
+        for (size_t chunk; (chunk = batch.next++) < batch.chunks;)
+        {
+            auto begin = chunk * SC_RECORDS_PER_CHUNK;
+            auto end = std::min(begin + SC_RECORDS_PER_CHUNK, batch.records.size());
+
+            for (auto i = begin; i < end; ++i)
+            {
+                auto started = std::chrono::high_resolution_clock::now();
+
+                string data;
+                if (batch.table->encode(*batch.records[i].second, cipher, data))
+                {
+                    batch.encoded[i] = std::move(data);
+                }
+
+                batch.spent[i] = std::chrono::high_resolution_clock::now() - started;
+            }
+
+            {
+                std::lock_guard<std::mutex> g(batch.mutex);
+                ++batch.done;
+            }
+            batch.cv.notify_one();
+        }
+    };
+
+    for (size_t i = 1; i < batch->chunks; ++i)
+    {
+        mAsyncQueue.push([batch, work](SymmCipher& cipher)
+                         {
+                             work(*batch, cipher);
+                         },
+                         true);
+    }
+
+    SymmCipher cipher;
+    work(*batch, cipher);
+
+    {
+        std::unique_lock<std::mutex> g(batch->mutex);
+        batch->cv.wait(g, [&batch]() { return batch->done == batch->chunks; });
+    }
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        performanceStats.scRecords(records[i].first).encode.add(batch->spent[i]);
+        mEncodedScRecords[records[i].second] = std::move(batch->encoded[i]);
+    }
+}
+
+bool MegaClient::putsc(uint32_t type, Cacheable* record)
+{
+    CodeCounter::ScopeTimer ccst(performanceStats.scRecords(type).write);
+
+    auto it = mEncodedScRecords.find(record);
+    if (it == mEncodedScRecords.end())
+    {
+        return sctable->put(type, record, &key);
+    }
+
+    auto encoded = std::move(it->second);
+    mEncodedScRecords.erase(it);
+
+    return sctable->putEncoded(type, record, encoded ? &*encoded : nullptr);
+}
+
 // queue node file attribute for retrieval or cancel retrieval
 error MegaClient::getfa(handle h, string *fileattrstring, const string &nodekey, fatype t, int cancel)
 {
@@ -6290,7 +6576,7 @@ void MegaClient::activatefa()
 // has the limit of concurrent transfer tslots been reached?
 bool MegaClient::slotavail() const
 {
-    return !mBlocked && tslots.size() < MAXTOTALTRANSFERS;
+    return !mBlocked && tslots.size() < mTransferScheduler.slotLimit();
 }
 
 bool MegaClient::processStorageStatusFromCmd(const storagestatus_t status)
@@ -8895,7 +9181,7 @@ void MegaClient::persistAlert(UserAlert::Base* a)
     }
     else // insert or replace
     {
-        if (sctable->put(CACHEDALERT, a, &key))
+        if (putsc(CACHEDALERT, a))
         {
             LOG_verbose << "UserAlert of type " << a->type << " inserted or replaced in db.";
         }
@@ -9791,6 +10077,143 @@ void MegaClient::putnodes(const char* user,
     queuepubkeyreq(user, std::make_unique<PubKeyActionPutNodes>(std::move(newnodes), tag, std::move(completion)));
 }
 
+void MegaClient::putnodesOfSmallUpload(NodeHandle parent,
+                                       VersioningOption vo,
+                                       NewNode&& newnode,
+                                       int tag,
+                                       putsource_t source,
+                                       CommandPutNodes::Completion&& completion,
+                                       bool canChangeVault,
+                                       std::optional<Pitag> pitag)
+{
+    auto samePitag = [&pitag](const std::optional<Pitag>& other)
+    {
+        if (!pitag || !other)
+            return !pitag == !other;
+
+        return pitagToString(*pitag) == pitagToString(*other);
+    };
+
+    auto batch = std::find_if(mPutnodesBatches.begin(),
+                              mPutnodesBatches.end(),
+                              [&](const PutnodesBatch& b)
+                              {
+                                  return b.target == parent && b.versioning == vo &&
+                                         b.source == source &&
+                                         b.canChangeVault == canChangeVault && samePitag(b.pitag);
+                              });
+
+    if (batch == mPutnodesBatches.end())
+    {
+        mPutnodesBatches.emplace_back();
+        batch = std::prev(mPutnodesBatches.end());
+
+        batch->target = parent;
+        batch->versioning = vo;
+        batch->source = source;
+        batch->canChangeVault = canChangeVault;
+        batch->pitag = pitag;
+    }
+
+    batch->nodes.emplace_back(std::move(newnode));
+    batch->tags.emplace_back(tag);
+    batch->completions.emplace_back(std::move(completion));
+
+    if (batch->nodes.size() >= MAXNODESUPLOAD)
+    {
+        auto full = std::move(*batch);
+
+        mPutnodesBatches.erase(batch);
+        sendPutnodesBatch(std::move(full));
+    }
+}
+
+void MegaClient::sendBatchedPutnodes()
+{
+    auto batches = std::move(mPutnodesBatches);
+
+    mPutnodesBatches.clear();
+
+    for (auto& batch: batches)
+        sendPutnodesBatch(std::move(batch));
+}
+
+void MegaClient::sendPutnodesBatch(PutnodesBatch&& batch)
+{
+    // A batch of one goes as usual.
+    if (batch.nodes.size() == 1)
+    {
+        queueCommand(new CommandPutNodes(this,
+                                         batch.target,
+                                         NULL,
+                                         batch.versioning,
+                                         std::move(batch.nodes),
+                                         batch.tags.front(),
+                                         batch.source,
+                                         nullptr,
+                                         std::move(batch.completions.front()),
+                                         batch.canChangeVault,
+                                         {}, // customerIpPort
+                                         batch.pitag));
+        return;
+    }
+
+    LOG_debug << "Sending the putnodes of " << batch.nodes.size() << " uploads together";
+
+    auto target = batch.target;
+    auto tags = batch.tags;
+
+    // Each upload learns the outcome of its own node, as if it had been sent alone.
+    auto completion = [this, target, tags, completions = std::move(batch.completions)](
+                          const Error& e,
+                          targettype_t type,
+                          vector<NewNode>& nn,
+                          bool,
+                          int,
+                          const map<string, string>& fileHandles) mutable
+    {
+        for (size_t i = 0; i < nn.size() && i < tags.size(); ++i)
+        {
+            vector<NewNode> own;
+            own.emplace_back(std::move(nn[i]));
+
+            auto& node = own.front();
+            Error result = e;
+
+            if (node.mError != API_OK)
+                result = node.mError;
+            else if (e == API_OK && !node.added)
+                result = API_ENOENT;
+
+            // when the target has been removed, the API adds the node into the rubbish bin
+            auto added = result == API_OK ? nodebyhandle(node.mAddedHandle) : nullptr;
+            auto targetOverride = added && NodeHandle().set6byte(added->parenthandle) != target;
+
+            if (completions[i])
+                completions[i](result, type, own, targetOverride, tags[i], fileHandles);
+            else
+                app->putnodes_result(result, type, own, targetOverride, tags[i], fileHandles);
+        }
+    };
+
+    auto command = new CommandPutNodes(this,
+                                       batch.target,
+                                       NULL,
+                                       batch.versioning,
+                                       std::move(batch.nodes),
+                                       tags.front(),
+                                       batch.source,
+                                       nullptr,
+                                       std::move(completion),
+                                       batch.canChangeVault,
+                                       {}, // customerIpPort
+                                       batch.pitag);
+
+    command->mBatchedTags.assign(tags.begin() + 1, tags.end());
+
+    queueCommand(command);
+}
+
 void MegaClient::putFileAttributes(handle h, fatype t, const string& encryptedAttributes, int tag)
 {
     std::shared_ptr<Node> node = mNodeManager.getNodeByHandle(NodeHandle().set6byte(h));
@@ -12263,10 +12686,12 @@ void MegaClient::opensctable()
             // new DB scheme. Similarly, for SRW, we just need to rename the existing legacy DB, and
             // only delete the DB if there is a downgrade (SRW to NO SRW), hence why we need to
             // increase the DB version, but without affecting the upgrade from NO SRW to SRW.
+            // The same goes for NODE_RECORD, where nodes are rewritten as NodeRecords in place.
             int recycleDBVersion =
                 (DbAccess::LEGACY_DB_VERSION == DbAccess::LAST_DB_VERSION_WITHOUT_NOD ||
                  DbAccess::LEGACY_DB_VERSION == DbAccess::LAST_DB_VERSION_WITHOUT_SRW ||
-                 DbAccess::LEGACY_DB_VERSION == DbAccess::LAST_DB_VERSION_WITHOUT_VFINGERPRINT) ?
+                 DbAccess::LEGACY_DB_VERSION == DbAccess::LAST_DB_VERSION_WITHOUT_VFINGERPRINT ||
+                 DbAccess::LEGACY_DB_VERSION == DbAccess::LAST_DB_VERSION_WITHOUT_NODE_RECORD) ?
                     DB_OPEN_FLAG_RECYCLE :
                     0;
             sctable.reset(dbaccess->openTableWithNodes(rng, *fsaccess, dbname, recycleDBVersion, [this](DBError error)
@@ -15375,6 +15800,8 @@ void MegaClient::closetc(bool remove)
     pendingtcids.clear();
     cachedfiles.clear();
     cachedfilesdbids.clear();
+    cachedfilesresumed = 0;
+    mFnStatsReportPending = false;
 
     if (remove && tctable)
     {
@@ -15423,17 +15850,14 @@ void MegaClient::enabletransferresumption()
     // If we want to resume those transfers after logging in on the main instance,
     // we should read them from the default cache and resume them.
 
-    uint32_t id;
-    string data;
     Transfer* t;
     size_t cachedTransfersLoaded = 0;
     size_t cachedFilesLoaded = 0;
 
     LOG_info << "Loading transfers from local cache";
-    tctable->rewind();
     {
         TransferDbCommitter committer(tctable); // needed in case of tctable->del()
-        while (tctable->next(&id, &data, &tckey))
+        for (auto& [id, data]: readTransferCache())
         {
             switch (id & 15)
             {
@@ -15455,7 +15879,7 @@ void MegaClient::enabletransferresumption()
                     }
                     break;
                 case CACHEDFILE:
-                    cachedfiles.push_back(data);
+                    cachedfiles.push_back(std::move(data));
                     cachedfilesdbids.push_back(id);
                     cachedFilesLoaded += 1;
                     break;
@@ -15474,6 +15898,116 @@ void MegaClient::enabletransferresumption()
     {
         resumeTransferFromDB();
     }
+    else
+    {
+        prewarmCachedTransfers();
+    }
+}
+
+vector<std::pair<uint32_t, string>> MegaClient::readTransferCache()
+{
+    struct Batch
+    {
+        vector<std::pair<uint32_t, string>> records;
+        vector<char> decrypted;
+        byte key[SymmCipher::KEYLENGTH];
+        size_t chunks = 0;
+        std::atomic<size_t> next{0};
+        size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    auto batch = std::make_shared<Batch>();
+    memcpy(batch->key, tckey.key, sizeof(batch->key));
+
+    uint32_t id;
+    string data;
+
+    tctable->rewind();
+    while (tctable->nextEncrypted(&id, &data))
+    {
+        batch->records.emplace_back(id, std::move(data));
+    }
+
+    batch->decrypted.resize(batch->records.size());
+
+    // Decrypt in chunks claimed by the worker threads and by this thread, which
+    // takes over any chunk the workers haven't started
+    batch->chunks = (batch->records.size() + TRANSFER_RECORDS_PER_CHUNK - 1) / TRANSFER_RECORDS_PER_CHUNK;
+
+    auto work = [](Batch& batch, SymmCipher& cipher)
+    {
+        cipher.setkey(batch.key);
+
+        for (size_t chunk; (chunk = batch.next++) < batch.chunks;)
+        {
+            auto begin = chunk * TRANSFER_RECORDS_PER_CHUNK;
+            auto end = std::min(begin + TRANSFER_RECORDS_PER_CHUNK, batch.records.size());
+
+            for (auto i = begin; i < end; ++i)
+            {
+                auto& record = batch.records[i];
+                batch.decrypted[i] = !record.first || PaddedCBC::decrypt(&record.second, &cipher);
+            }
+
+            {
+                std::lock_guard<std::mutex> g(batch.mutex);
+                ++batch.done;
+            }
+            batch.cv.notify_one();
+        }
+    };
+
+    for (size_t i = 1; i < batch->chunks; ++i)
+    {
+        mAsyncQueue.push([batch, work](SymmCipher& cipher)
+                         {
+                             work(*batch, cipher);
+                         },
+                         true);
+    }
+
+    SymmCipher cipher;
+    work(*batch, cipher);
+
+    {
+        std::unique_lock<std::mutex> g(batch->mutex);
+        batch->cv.wait(g, [&batch]() { return batch->done == batch->chunks; });
+    }
+
+    auto failed = std::find(batch->decrypted.begin(), batch->decrypted.end(), false);
+    if (failed != batch->decrypted.end())
+    {
+        LOG_err << "Failed to decrypt transfer cache record, "
+                << batch->decrypted.end() - failed << " records skipped";
+        batch->records.resize(static_cast<size_t>(failed - batch->decrypted.begin()));
+    }
+
+    return std::move(batch->records);
+}
+
+void MegaClient::prewarmCachedTransfers()
+{
+    // enough for a couple of raided downloads plus some uploads, without flooding
+    // the storage servers with connections for transfers that won't start soon
+    static constexpr size_t MAX_PREWARMED_URLS = 16;
+
+    size_t prewarmed = 0;
+    for (direction_t d: {GET, PUT})
+    {
+        for (auto& it: multi_cachedtransfers[d])
+        {
+            for (auto& url: it.second->tempurls)
+            {
+                if (prewarmed++ == MAX_PREWARMED_URLS)
+                {
+                    return;
+                }
+                httpio->prewarm(url, d);
+            }
+        }
+    }
 }
 
 void MegaClient::disabletransferresumption()
@@ -15553,7 +16087,8 @@ string MegaClient::getTransferDBName()
 void MegaClient::resumeTransferFromDB()
 {
     TransferDbCommitter committer(tctable);
-    for (unsigned int i = 0; i < cachedfiles.size(); i++)
+    auto end = std::min(cachedfilesresumed + RESUMED_FILES_PER_ROUND, cachedfiles.size());
+    for (auto i = cachedfilesresumed; i < end; i++)
     {
         direction_t type = NONE;
         MegaApp::FileResumeData data;
@@ -15647,10 +16182,41 @@ void MegaClient::resumeTransferFromDB()
         }
     }
 
+    cachedfilesresumed = end;
+
+    if (resumingTransfers())
+    {
+        LOG_debug << "Resumed " << cachedfilesresumed << " of " << cachedfiles.size()
+                  << " cached files";
+        return;
+    }
+
     purgeOrphanTransfers(true);
 
     cachedfiles.clear();
     cachedfilesdbids.clear();
+    cachedfilesresumed = 0;
+
+    if (mFnStatsReportPending)
+    {
+        sendFetchNodesStats();
+    }
+}
+
+void MegaClient::sendFetchNodesStats()
+{
+    mFnStatsReportPending = false;
+
+    WAIT_CLASS::bumpds();
+    fnstats.timeToTransfersResumed = Waiter::ds - fnstats.startTime;
+    string report;
+    fnstats.toJsonArray(&report);
+    sendevent(99426, report.c_str(), 0); // Treeproc performance log
+}
+
+bool MegaClient::resumingTransfers() const
+{
+    return cachedfilesresumed && cachedfilesresumed < cachedfiles.size();
 }
 
 void MegaClient::handleDbError(DBError error)
@@ -15876,6 +16442,7 @@ void MegaClient::fetchnodes(bool nocache, bool loadSyncs, bool forceLoadFromServ
 
     WAIT_CLASS::bumpds();
     fnstats.init();
+    mFnStatsReportPending = false;
     if (sid.size() >= SIDLEN)
     {
         fnstats.type = FetchNodesStats::TYPE_ACCOUNT;
@@ -17606,20 +18173,6 @@ bool MegaClient::execdirectreads()
         }
     }
 
-    while (!dsdrns.empty() && dsdrns.begin()->first <= Waiter::ds)
-    {
-        if (dsdrns.begin()->second->reads.size() && (dsdrns.begin()->second->tempurls.size() || dsdrns.begin()->second->pendingcmd))
-        {
-            LOG_warn << "DirectRead scheduled retry";
-            dsdrns.begin()->second->retry(API_EAGAIN);
-        }
-        else
-        {
-            LOG_debug << "Dispatching scheduled streaming";
-            dsdrns.begin()->second->dispatch();
-        }
-    }
-
     return r;
 }
 
@@ -17629,6 +18182,17 @@ error MegaClient::addtimer(TimerWithBackoff *twb)
     return API_OK;
 }
 
+TimerQueue::TimerId MegaClient::scheduleTimer(std::chrono::milliseconds delay,
+                                              TimerQueue::Callback callback)
+{
+    return mTimers.schedule(delay, std::move(callback));
+}
+
+bool MegaClient::cancelTimer(TimerQueue::TimerId id)
+{
+    return mTimers.cancel(id);
+}
+
 #ifdef ENABLE_SYNC
 
 std::pair<error, SyncError> MegaClient::isnodesyncable(std::shared_ptr<Node> remotenode,
@@ -20356,6 +20920,20 @@ const char* MegaClient::cancelLinkPrefix()
     return prefix;
 }
 
+MegaClient::PerformanceStats::CacheRecordStats& MegaClient::PerformanceStats::scRecords(uint32_t type)
+{
+    switch (type)
+    {
+        case CACHEDUSER:        return scUsers;
+        case CACHEDPCR:         return scPcrs;
+        case CACHEDSET:         return scSets;
+        case CACHEDSETELEMENT:  return scSetElements;
+        case CACHEDCHAT:        return scChats;
+        case CACHEDALERT:       return scAlerts;
+        default:                return scOther;
+    }
+}
+
 #ifdef MEGA_MEASURE_CODE
 
 extern CodeCounter::ScopeStats computeSyncSequencesStats;
@@ -20367,6 +20945,9 @@ std::string MegaClient::PerformanceStats::report(bool reset, HttpIO* httpio, Wai
         << doWait.report(reset) << "\n"
         << checkEvents.report(reset) << "\n"
         << execFunction.report(reset) << "\n"
+        << execCsRequests.report(reset) << "\n"
+        << execScChannel.report(reset) << "\n"
+        << execTransferSlots.report(reset) << "\n"
         << megaapiSendPendingTransfers.report(reset) << "\n"
         << transferslotDoio.report(reset) << "\n"
         << execdirectreads.report(reset) << "\n"
@@ -20376,6 +20957,16 @@ std::string MegaClient::PerformanceStats::report(bool reset, HttpIO* httpio, Wai
         << scProcessingTime.report(reset) << "\n"
         << csResponseProcessingTime.report(reset) << "\n"
         << csSuccessProcessingTime.report(reset) << "\n"
+        << scUsers.encode.report(reset) << scUsers.write.report(reset) << "\n"
+        << scPcrs.encode.report(reset) << scPcrs.write.report(reset) << "\n"
+        << scSets.encode.report(reset) << scSets.write.report(reset) << "\n"
+        << scSetElements.encode.report(reset) << scSetElements.write.report(reset) << "\n"
+        << scChats.encode.report(reset) << scChats.write.report(reset) << "\n"
+        << scAlerts.encode.report(reset) << scAlerts.write.report(reset) << "\n"
+        << scOther.encode.report(reset) << scOther.write.report(reset) << "\n"
+#ifdef USE_SQLITE
+        << SqliteDbTable::commitTimeSnapshot(reset).report() << "\n"
+#endif
 #ifdef ENABLE_SYNC
         << recursiveSyncTime.report(reset) << "\n"
         << computeSyncTripletsTime.report(reset) << "\n"
@@ -20420,8 +21011,304 @@ std::string MegaClient::PerformanceStats::report(bool reset, HttpIO* httpio, Wai
     }
     return s.str();
 }
+
+std::vector<CodeCounter::ScopeStats*> MegaClient::PerformanceStats::scopes(HttpIO* httpio)
+{
+    std::vector<CodeCounter::ScopeStats*> result = {
+        &prepareWait, &doWait, &checkEvents, &execFunction, &megaapiSendPendingTransfers,
+        &transferslotDoio, &execdirectreads, &transferComplete, &dispatchTransfers, &applyKeys,
+        &scProcessingTime, &csResponseProcessingTime, &csSuccessProcessingTime,
+        &execCsRequests, &execScChannel, &execTransferSlots};
+
+    for (auto* records: {&scUsers, &scPcrs, &scSets, &scSetElements, &scChats, &scAlerts, &scOther})
+    {
+        result.push_back(&records->encode);
+        result.push_back(&records->write);
+    }
+
+#ifdef USE_SQLITE
+    sqliteCommitTime = SqliteDbTable::commitTimeSnapshot();
+    result.push_back(&sqliteCommitTime);
+#endif
+
+#ifdef ENABLE_SYNC
+    result.insert(result.end(),
+                  {&recursiveSyncTime, &computeSyncTripletsTime, &computeSyncSequencesStats,
+                   &ScanService::syncScanTime, &inferSyncTripletsTime, &g_compareUtfTimings,
+                   &syncItem, &syncItemCheckMove, &syncItemXXX, &syncItemXXF, &syncItemXSX,
+                   &syncItemXSF, &syncItemCXX, &syncItemCXF, &syncItemCSX, &syncItemCSF,
+                   &clientThreadActions});
 #endif
 
+    if (auto curlhttpio = dynamic_cast<CurlHttpIO*>(httpio))
+    {
+        result.insert(result.end(),
+                      {&curlhttpio->countCurlHttpIOAddevents, &curlhttpio->countAddCurlEventsCode,
+                       &curlhttpio->countProcessCurlEventsCode});
+    }
+
+    return result;
+}
+#endif
+
+std::string MegaClient::openMetrics()
+{
+    using stats::OpenMetricsWriter;
+    using Type = OpenMetricsWriter::Type;
+
+    OpenMetricsWriter writer;
+
+#ifdef MEGA_MEASURE_CODE
+    using Seconds = std::chrono::duration<double>;
+
+    auto scopes = performanceStats.scopes(httpio);
+
+    std::vector<double> bounds;
+    for (auto bound: CodeCounter::ScopeStats::BUCKET_BOUNDS)
+        bounds.push_back(Seconds(bound).count());
+
+    writer.family("scope_duration_seconds",
+                  Type::HISTOGRAM,
+                  "Time spent in instrumented blocks of code.",
+                  "seconds");
+
+    for (auto* scope: scopes)
+        writer.histogram({{"scope", scope->name}},
+                         bounds,
+                         {scope->buckets.begin(), scope->buckets.end()},
+                         Seconds(scope->timeSpent).count());
+
+    writer.family("scope_longest_seconds",
+                  Type::GAUGE,
+                  "Longest time spent in an instrumented block of code.",
+                  "seconds");
+
+    for (auto* scope: scopes)
+        writer.sample({{"scope", scope->name}}, Seconds(scope->longest).count());
+
+    writer.family("scope_in_progress",
+                  Type::GAUGE,
+                  "Instrumented blocks of code started but not finished.");
+
+    for (auto* scope: scopes)
+        writer.sample({{"scope", scope->name}},
+                      static_cast<double>(scope->starts - scope->finishes));
+
+    auto counter = [&writer](const char* name, const char* help, uint64_t value)
+    {
+        writer.family(name, Type::COUNTER, help);
+        writer.sample({}, static_cast<double>(value));
+    };
+
+    counter("transfers_started", "Transfers started.", performanceStats.transferStarts);
+    counter("transfers_finished", "Transfers finished.", performanceStats.transferFinishes);
+    counter("transfer_temporary_errors",
+            "Temporary errors during transfers.",
+            performanceStats.transferTempErrors);
+    counter("transfers_failed", "Transfers failed.", performanceStats.transferFails);
+#endif
+
+    // Statistics of the latest transfers, in each direction.
+    const std::pair<direction_t, const char*> directions[] = {{PUT, "upload"}, {GET, "download"}};
+
+    stats::TransferStats::Metrics transferMetrics[2];
+    for (size_t i = 0; i < 2; ++i)
+        transferMetrics[i] = mTransferStatsManager.collectMetrics(directions[i].first);
+
+    auto transferFamily = [&](const char* name,
+                              const char* help,
+                              const char* unit,
+                              std::function<double(const stats::TransferStats::Metrics&)> value)
+    {
+        writer.family(name, Type::GAUGE, help, unit);
+
+        for (size_t i = 0; i < 2; ++i)
+            writer.sample({{"direction", directions[i].second}}, value(transferMetrics[i]));
+    };
+
+    transferFamily("transfer_stats_transfers",
+                   "Latest transfers the transfer statistics are computed from.",
+                   "",
+                   [](const stats::TransferStats::Metrics& m)
+                   {
+                       return static_cast<double>(m.mNumTransfers);
+                   });
+    transferFamily("transfer_median_size_bytes",
+                   "Median size of the latest transfers.",
+                   "bytes",
+                   [](const stats::TransferStats::Metrics& m)
+                   {
+                       return static_cast<double>(m.mMedianSize);
+                   });
+    transferFamily("transfer_contraharmonic_mean_size_bytes",
+                   "Mean size of the latest transfers, weighted by size.",
+                   "bytes",
+                   [](const stats::TransferStats::Metrics& m)
+                   {
+                       return static_cast<double>(m.mContraharmonicMeanSize);
+                   });
+    transferFamily("transfer_median_speed_bytes_per_second",
+                   "Median speed of the latest transfers.",
+                   "bytes_per_second",
+                   [](const stats::TransferStats::Metrics& m)
+                   {
+                       return static_cast<double>(m.mMedianSpeed);
+                   });
+    transferFamily("transfer_weighted_average_speed_bytes_per_second",
+                   "Average speed of the latest transfers, weighted by size.",
+                   "bytes_per_second",
+                   [](const stats::TransferStats::Metrics& m)
+                   {
+                       return static_cast<double>(m.mWeightedAverageSpeed);
+                   });
+    transferFamily("transfer_max_speed_bytes_per_second",
+                   "Highest speed of the latest transfers.",
+                   "bytes_per_second",
+                   [](const stats::TransferStats::Metrics& m)
+                   {
+                       return static_cast<double>(m.mMaxSpeed);
+                   });
+    transferFamily("transfer_average_latency_seconds",
+                   "Average time the latest transfers took to start.",
+                   "seconds",
+                   [](const stats::TransferStats::Metrics& m)
+                   {
+                       return static_cast<double>(m.mAvgLatency) / 1000;
+                   });
+    transferFamily("transfer_failed_request_ratio",
+                   "Ratio of failed requests during the latest transfers.",
+                   "ratio",
+                   [](const stats::TransferStats::Metrics& m)
+                   {
+                       return m.mFailedRequestRatio;
+                   });
+    transferFamily("transfer_raided_ratio",
+                   "Ratio of the latest transfers that were raided.",
+                   "ratio",
+                   [](const stats::TransferStats::Metrics& m)
+                   {
+                       return m.mRaidedTransferRatio;
+                   });
+    transferFamily("transfer_average_connections",
+                   "Average connections used by the latest transfers.",
+                   "",
+                   [](const stats::TransferStats::Metrics& m)
+                   {
+                       return m.mAvgConnections;
+                   });
+
+#ifdef ENABLE_SYNC
+    // The state of each running sync.
+    struct SyncState
+    {
+        std::string id;
+        int32_t files = 0;
+        int32_t folders = 0;
+        unsigned neverScannedFolders = 0;
+        SyncTransferCounts transfers;
+    };
+
+    std::vector<SyncState> syncStates;
+
+    syncs.selectedSyncConfigs(
+        [&syncStates](SyncConfig& config, Sync* sync)
+        {
+            if (!sync)
+                return false;
+
+            auto& state = *sync->threadSafeState;
+
+            syncStates.emplace_back();
+            syncStates.back().id = toHandle(config.mBackupId);
+            state.getSyncNodeCounts(syncStates.back().files, syncStates.back().folders);
+            syncStates.back().neverScannedFolders = state.neverScannedFolderCount;
+            syncStates.back().transfers = state.transferCounts();
+
+            return false;
+        });
+
+    auto syncFamily = [&](const char* name,
+                          const char* help,
+                          const char* unit,
+                          std::function<double(const SyncState&)> value)
+    {
+        writer.family(name, Type::GAUGE, help, unit);
+
+        for (auto& state: syncStates)
+            writer.sample({{"sync", state.id}}, value(state));
+    };
+
+    syncFamily("sync_files",
+               "Files in the sync.",
+               "",
+               [](const SyncState& s)
+               {
+                   return s.files;
+               });
+    syncFamily("sync_folders",
+               "Folders in the sync.",
+               "",
+               [](const SyncState& s)
+               {
+                   return s.folders;
+               });
+    syncFamily("sync_never_scanned_folders",
+               "Folders of the sync that haven't been scanned yet.",
+               "",
+               [](const SyncState& s)
+               {
+                   return s.neverScannedFolders;
+               });
+
+    auto syncTransferFamily = [&](const char* name,
+                                  const char* help,
+                                  const char* unit,
+                                  std::function<double(const SyncTransferCount&)> value)
+    {
+        writer.family(name, Type::GAUGE, help, unit);
+
+        for (auto& state: syncStates)
+        {
+            writer.sample({{"sync", state.id}, {"direction", "upload"}},
+                          value(state.transfers.mUploads));
+            writer.sample({{"sync", state.id}, {"direction", "download"}},
+                          value(state.transfers.mDownloads));
+        }
+    };
+
+    syncTransferFamily("sync_transfers_pending",
+                       "Transfers of the sync in progress.",
+                       "",
+                       [](const SyncTransferCount& c)
+                       {
+                           return c.mPending;
+                       });
+    syncTransferFamily("sync_transfers_completed",
+                       "Transfers of the sync completed.",
+                       "",
+                       [](const SyncTransferCount& c)
+                       {
+                           return c.mCompleted;
+                       });
+    syncTransferFamily("sync_transfer_pending_bytes",
+                       "Size of the transfers of the sync in progress.",
+                       "bytes",
+                       [](const SyncTransferCount& c)
+                       {
+                           return static_cast<double>(c.mPendingBytes);
+                       });
+    syncTransferFamily("sync_transfer_completed_bytes",
+                       "Size of the transfers of the sync completed.",
+                       "bytes",
+                       [](const SyncTransferCount& c)
+                       {
+                           return static_cast<double>(c.mCompletedBytes);
+                       });
+#endif // ENABLE_SYNC
+
+    return writer.finish();
+}
+
 m_time_t MegaClient::MyAccountData::getTimeLeft()
 {
     auto timeleft = mProUntil - static_cast<m_time_t>(std::time(nullptr));
@@ -22095,7 +22982,7 @@ bool MegaClient::updatescsets()
         if (!s->hasChanged(Set::CH_REMOVED)) // add / replace / exported / exported disabled
         {
             LOG_verbose << "Adding Set to database: " << (Base64::btoa((byte*)&(s->id()), MegaClient::SETHANDLE, base64) ? base64 : "");
-            if (!sctable->put(CACHEDSET, s, &key))
+            if (!putsc(CACHEDSET, s))
             {
                 return false;
             }
@@ -22149,7 +23036,7 @@ bool MegaClient::updatescsetelements()
             }
 
             LOG_verbose << (e->hasChanged(SetElement::CH_EL_NEW) ? "Adding" : "Updating") << " SetElement to database: " << (Base64::btoa((byte*)&(e->id()), MegaClient::SETELEMENTHANDLE, base64) ? base64 : "");
-            if (!sctable->put(CACHEDSETELEMENT, e, &key))
+            if (!putsc(CACHEDSETELEMENT, e))
             {
                 return false;
             }
@@ -22481,12 +23368,13 @@ void MegaClient::preparePasswordManagerNodeData(attr_map& attrs, const AttrMap&
     auto auxDataAttrMap = data;
     if (auxDataAttrMap.map.contains(AttrMap::string2nameid(PWM_ATTR_PASSWORD_TOTP)))
     {
-        const auto totp =
-            auxDataAttrMap.map.extract(AttrMap::string2nameid(PWM_ATTR_PASSWORD_TOTP));
+        const auto totpId = AttrMap::string2nameid(PWM_ATTR_PASSWORD_TOTP);
+        const auto totp = std::move(auxDataAttrMap.map.at(totpId));
+        auxDataAttrMap.map.erase(totpId);
         auxstr = auxDataAttrMap.getjson();
         if (!auxDataAttrMap.map.empty())
         {
-            auxstr += ",\"" + AttrMap::nameid2string(totp.key()) + "\":" + totp.mapped();
+            auxstr += ",\"" + AttrMap::nameid2string(totpId) + "\":" + totp;
         }
     }
 
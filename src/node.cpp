@@ -546,7 +546,7 @@ std::shared_ptr<Node> Node::unserialize(MegaClient& client, const std::string* d
     return nd.createNode(client, fromOldCache, ownNewshares);
 }
 
-// serialize node - nodes with pending or RSA keys are unsupported
+// serialize node as a NodeRecord - nodes with pending or RSA keys are unsupported
 bool Node::serialize(string* d) const
 {
     switch (type)
@@ -572,168 +572,82 @@ bool Node::serialize(string* d) const
             }
     }
 
-    unsigned short ll;
-    short numshares;
-    m_off_t s;
+    NodeRecord::Fields fields;
 
-    s = type ? -type : size;
+    fields.type = type;
+    fields.size = type ? -type : size;
+    fields.nodeHandle = nodehandle;
+    fields.parentHandle = parenthandle;
+    fields.owner = owner;
+    fields.ctime = ctime;
 
-    d->append((char*)&s, sizeof s);
+    fields.sections[NodeRecord::NODE_KEY] = nodekeydata;
 
-    d->append((char*)&nodehandle, MegaClient::NODEHANDLE);
-
-    if (parenthandle != UNDEF)
-    {
-        d->append((char*)&parenthandle, MegaClient::NODEHANDLE);
-    }
-    else
+    if (type == FILENODE)
     {
-        d->append("\0\0\0\0\0", MegaClient::NODEHANDLE);
+        fields.sections[NodeRecord::FILE_ATTRIBUTES] = fileattrstring;
     }
 
-    d->append((char*)&owner, MegaClient::USERHANDLE);
-
-    // FIXME: use Serialize64
-    time_t ts = 0;  // we don't want to break backward compatibility by changing the size (where m_time_t differs)
-    d->append((char*)&ts, sizeof(ts));
-
-    ts = (time_t)ctime;
-    d->append((char*)&ts, sizeof(ts));
-
-    if (attrstring)
+    if (plink)
     {
-        auto length = 0u;
+        fields.flags |= NodeRecord::EXPORTED;
 
-        if (type == FOLDERNODE)
-        {
-            length = FOLDERNODEKEYLENGTH;
-        }
-        else if (type == FILENODE)
+        if (plink->takendown)
         {
-            length = FILENODEKEYLENGTH;
+            fields.flags |= NodeRecord::LINK_TAKEN_DOWN;
         }
 
-        d->append(length, '\0');
+        fields.linkHandle = plink->ph;
+        fields.linkExpiry = plink->ets;
+        fields.linkCreation = plink->cts;
+        fields.sections[NodeRecord::AUTH_KEY] = plink->mAuthKey;
     }
-    else
-    {
-        d->append(nodekeydata);
-    }
-
-    if (type == FILENODE)
-    {
-        ll = static_cast<unsigned short>(fileattrstring.size() + 1);
-        d->append((char*)&ll, sizeof ll);
-        d->append(fileattrstring.c_str(), ll);
-    }
-
-    char isExported = plink ? 1 : 0;
-    d->append((char*)&isExported, 1);
 
-    char hasLinkCreationTs = plink ? 1 : 0;
-    d->append((char*)&hasLinkCreationTs, 1);
-
-    if (isExported && plink && plink->mAuthKey.size())
-    {
-        auto authKeySize = (char)plink->mAuthKey.size();
-        d->append((char*)&authKeySize, sizeof(authKeySize));
-        d->append(plink->mAuthKey.data(), static_cast<size_t>(authKeySize));
-    }
-    else
-    {
-        d->append("", 1);
-    }
-
-    d->append(1, static_cast<char>(!!attrstring));
-
-    if (attrstring)
-    {
-        d->append(1, '\1');
-    }
-
-    // Use these bytes for extensions.
-    d->append(4, '\0');
+    string shares;
 
     if (inshare)
     {
-        numshares = -1;
+        fields.numShares = -1;
+        inshare->serialize(&shares);
     }
     else
     {
-        numshares = 0;
-        if (outshares)
-        {
-            numshares += static_cast<short int>(outshares->size());
-        }
-        if (pendingshares)
-        {
-            numshares += static_cast<short int>(pendingshares->size());
-        }
-    }
-
-    d->append((char*)&numshares, sizeof numshares);
-
-    if (numshares)
-    {
-        if (sharekey)
-        {
-            d->append((char*)sharekey->key, SymmCipher::KEYLENGTH);
-        }
-        else // with ^!keys, shares may not receive the sharekey along with the share's data
-        {
-            d->append(SymmCipher::KEYLENGTH, '\0');
-        }
-
-        if (inshare)
-        {
-            inshare->serialize(d);
-        }
-        else
+        for (auto* map: {outshares.get(), pendingshares.get()})
         {
-            if (outshares)
-            {
-                for (share_map::iterator it = outshares->begin(); it != outshares->end(); it++)
-                {
-                    it->second->serialize(d);
-                }
-            }
-            if (pendingshares)
+            if (map)
             {
-                for (share_map::iterator it = pendingshares->begin(); it != pendingshares->end(); it++)
+                fields.numShares = static_cast<int16_t>(fields.numShares + map->size());
+
+                for (auto& it: *map)
                 {
-                    it->second->serialize(d);
+                    it.second->serialize(&shares);
                 }
             }
         }
     }
 
-    attrs.serialize(d);
+    static const string noShareKey(SymmCipher::KEYLENGTH, '\0');
 
-    if (isExported)
+    if (fields.numShares)
     {
-        d->append((char*) &plink->ph, MegaClient::NODEHANDLE);
-        d->append((char*) &plink->ets, sizeof(plink->ets));
-        d->append((char*) &plink->takendown, sizeof(plink->takendown));
-        if (hasLinkCreationTs)
-        {
-            d->append((char*) &plink->cts, sizeof(plink->cts));
-        }
+        // with ^!keys, shares may not receive the sharekey along with the share's data
+        fields.sections[NodeRecord::SHARE_KEY] =
+            sharekey ? std::string_view(reinterpret_cast<const char*>(sharekey->key),
+                                        SymmCipher::KEYLENGTH) :
+                       std::string_view(noShareKey);
+        fields.sections[NodeRecord::SHARES] = shares;
     }
 
-    // Write data necessary to thaw encrypted nodes.
+    fields.attributes = &attrs.map;
+
     if (attrstring)
     {
-        // Write node key data.
-        uint32_t length = static_cast<uint32_t>(nodekeydata.size());
-        d->append((char*)&length, sizeof(length));
-        d->append(nodekeydata, 0, length);
-
-        // Write attribute string data.
-        length = static_cast<uint32_t>(attrstring->size());
-        d->append((char*)&length, sizeof(length));
-        d->append(*attrstring, 0, length);
+        fields.flags |= NodeRecord::ENCRYPTED;
+        fields.sections[NodeRecord::ATTRIBUTE_STRING] = *attrstring;
     }
 
+    NodeRecord::write(fields, *d);
+
     return true;
 }
 
@@ -819,9 +733,17 @@ void Node::setattr()
         return;
     }
 
+    setattr(buf);
+
+    delete[] buf;
+}
+
+// build attribute hash from the decrypted attribute string
+void Node::setattr(const byte* buf)
+{
     AttrMap oldAttrs(attrs);
     attrs.map.clear();
-    attrs.fromjson(reinterpret_cast<char*>(buf) + 5);
+    attrs.fromjson(reinterpret_cast<const char*>(buf) + 5);
 
     auto it = attrs.map.find('n');
     if (it != std::end(attrs.map))
@@ -842,8 +764,6 @@ void Node::setattr()
 
     setfingerprint();
 
-    delete[] buf;
-
     attrstring.reset();
 }
 
@@ -1147,6 +1067,27 @@ int Node::hasfileattribute(const string *fileattrstring, fatype t)
 
 // attempt to apply node key - sets nodekey to a raw key if successful
 bool Node::applykey()
+{
+    const char* k = nullptr;
+    SymmCipher* sc = nullptr;
+
+    if (!locatekey(k, sc))
+    {
+        return false;
+    }
+
+    byte key[FILENODEKEYLENGTH];
+
+    if (!client->decryptkey(k, key, static_cast<int>(nodekeylength()), sc, 0, nodehandle))
+    {
+        return applyunwrappedkey(nullptr, nullptr);
+    }
+
+    return applyunwrappedkey(key, nullptr);
+}
+
+// locate the encrypted key and the key to decrypt it with
+bool Node::locatekey(const char*& k, SymmCipher*& sc)
 {
     if (type > FOLDERNODE)
     {
@@ -1162,8 +1103,8 @@ bool Node::applykey()
     int l = -1;
     size_t t = 0;
     handle h;
-    const char* k = NULL;
-    SymmCipher* sc = &client->key;
+    k = NULL;
+    sc = &client->key;
     handle me = client->loggedIntoFolder() ? client->mNodeManager.getRootNodeFiles().as8byte() : client->me;
 
     while ((t = nodekeydata.find_first_of(':', t)) != string::npos)
@@ -1242,16 +1183,27 @@ bool Node::applykey()
         }
     }
 
-    byte key[FILENODEKEYLENGTH];
-    unsigned keylength = (type == FILENODE) ? FILENODEKEYLENGTH : FOLDERNODEKEYLENGTH;
+    return true;
+}
 
-    if (client->decryptkey(k, key, static_cast<int>(keylength), sc, 0, nodehandle))
+// install the decrypted node key (nullptr if it couldn't be decrypted) and the attributes,
+// which are decrypted here unless decryptedAttrs is given
+bool Node::applyunwrappedkey(const byte* key, const byte* decryptedAttrs)
+{
+    if (key)
     {
         std::string undecryptedKey = nodekeydata;
         client->mNodeManager.increaseNumNodesAppliedKey();
-        nodekeydata.assign((const char*)key, keylength);
+        nodekeydata.assign((const char*)key, nodekeylength());
         bool keyApplied{true};
-        setattr();
+        if (decryptedAttrs)
+        {
+            setattr(decryptedAttrs);
+        }
+        else
+        {
+            setattr();
+        }
         if (attrstring)
         {
             if (foreignkey)
@@ -1494,6 +1446,17 @@ bool Node::isPasswordManagerNodeFolder() const
            !isPasswordManagerNode();
 }
 
+NodeData::NodeData(const char* ptr, size_t size, int component):
+    mStart(ptr),
+    mEnd(ptr + size),
+    mComp(component)
+{
+    if (NodeRecord::isRecord(ptr, size))
+    {
+        mRecord.emplace(ptr, size);
+    }
+}
+
 bool NodeData::readComponents()
 {
     mReadAttempted = true;
@@ -1768,18 +1731,35 @@ bool NodeData::readComponents()
     return mReadSucceeded;
 }
 
+std::optional<std::string_view> NodeData::attribute(nameid name) const
+{
+    if (mRecord)
+    {
+        return mRecord->attribute(name);
+    }
+
+    auto attrIt = mAttrs.map.find(name);
+
+    if (attrIt == mAttrs.map.end())
+    {
+        return std::nullopt;
+    }
+
+    return attrIt->second;
+}
+
 m_time_t NodeData::getMtime()
 {
-    if (readFailed() || mType != FILENODE)
+    if (readFailed() || type() != FILENODE)
     {
         return 0;
     }
 
-    auto attrIt = mAttrs.map.find('c');
-    if (attrIt != mAttrs.map.end())
+    if (auto value = attribute('c'))
     {
+        string fingerprint(*value);
         FileFingerprint fp;
-        if (fp.unserializefingerprint(&attrIt->second) && fp.isvalid)
+        if (fp.unserializefingerprint(&fingerprint) && fp.isvalid)
         {
             return fp.mtime;
         }
@@ -1796,9 +1776,9 @@ int NodeData::getLabel()
     }
 
     static const nameid labelId = AttrMap::string2nameid("lbl");
-    auto attrIt = mAttrs.map.find(labelId);
+    auto value = attribute(labelId);
 
-    return attrIt == mAttrs.map.end() ? LBL_UNKNOWN : std::atoi(attrIt->second.c_str());
+    return value ? std::atoi(string(*value).c_str()) : LBL_UNKNOWN;
 }
 
 std::string NodeData::getDescription()
@@ -1810,9 +1790,9 @@ std::string NodeData::getDescription()
 
     static const nameid descriptionId =
         AttrMap::string2nameid(MegaClient::NODE_ATTRIBUTE_DESCRIPTION);
-    auto attrIt = mAttrs.map.find(descriptionId);
+    auto value = attribute(descriptionId);
 
-    return attrIt == mAttrs.map.end() ? std::string() : attrIt->second.c_str();
+    return value ? string(value->data(), strnlen(value->data(), value->size())) : std::string();
 }
 
 std::string NodeData::getTags()
@@ -1823,9 +1803,9 @@ std::string NodeData::getTags()
     }
 
     static const nameid tagId = AttrMap::string2nameid(MegaClient::NODE_ATTRIBUTE_TAGS);
-    auto attrIt = mAttrs.map.find(tagId);
+    auto value = attribute(tagId);
 
-    return attrIt == mAttrs.map.end() ? std::string() : attrIt->second.c_str();
+    return value ? string(value->data(), strnlen(value->data(), value->size())) : std::string();
 }
 
 handle NodeData::getHandle()
@@ -1835,7 +1815,7 @@ handle NodeData::getHandle()
         return UNDEF;
     }
 
-    return mHandle;
+    return mRecord ? mRecord->nodeHandle() : mHandle;
 }
 
 std::shared_ptr<Node> NodeData::createNode(MegaClient& client,
@@ -1848,6 +1828,11 @@ std::shared_ptr<Node> NodeData::createNode(MegaClient& client,
         return nullptr;
     }
 
+    if (mRecord)
+    {
+        return createNodeFromRecord(client, fromOldCache, ownNewshares);
+    }
+
     std::shared_ptr<Node> n = std::make_shared<Node>(client,
                                                      NodeHandle().set6byte(mHandle),
                                                      NodeHandle().set6byte(mParentHandle),
@@ -1910,19 +1895,181 @@ std::shared_ptr<Node> NodeData::createNode(MegaClient& client,
 
     n->setKey(mNodeKey); // it can be decrypted or encrypted
 
+    applyKey(client, n, mIsEncrypted);
+
+    return n;
+}
+
+std::shared_ptr<Node>
+    NodeData::createNodeFromRecord(MegaClient& client,
+                                   bool fromOldCache,
+                                   std::list<std::unique_ptr<NewShare>>& ownNewshares)
+{
+    auto& record = *mRecord;
+    auto nodeHandle = record.nodeHandle();
+
+    std::shared_ptr<Node> n = std::make_shared<Node>(client,
+                                                     NodeHandle().set6byte(nodeHandle),
+                                                     NodeHandle().set6byte(record.parentHandle()),
+                                                     record.type(),
+                                                     record.size(),
+                                                     record.owner(),
+                                                     nullptr,
+                                                     record.ctime());
+
+    n->fileattrstring = record.section(NodeRecord::FILE_ATTRIBUTES);
+
+    // read inshare, outshares, or pending shares
+    if (auto numShares = record.numShares())
+    {
+        auto shares = record.section(NodeRecord::SHARES);
+        auto shareKey = reinterpret_cast<const byte*>(record.section(NodeRecord::SHARE_KEY).data());
+        const char* ptr = shares.data();
+        const char* end = ptr + shares.size();
+
+        for (; numShares && ptr < end; numShares = numShares > 0 ? numShares - 1 : 0)
+        {
+            NewShare* newShare =
+                Share::unserialize(numShares > 0 ? -1 : 0, nodeHandle, shareKey, &ptr, end);
+
+            if (!newShare)
+            {
+                LOG_err << "Failed to unserialize Share";
+                break;
+            }
+
+            if (fromOldCache)
+            {
+                client.newshares.push_back(newShare);
+            }
+            else
+            {
+                ownNewshares.emplace_back(newShare);
+            }
+        }
+    }
+
+    record.attributes(n->attrs.map);
+
+    if (fromOldCache)
+    {
+        attr_map::iterator it = n->attrs.map.find('n');
+        if (it != n->attrs.map.end())
+        {
+            LocalPath::utf8_normalize(&(it->second));
+        }
+    }
+
+    auto flags = record.flags();
+
+    if (flags & NodeRecord::EXPORTED)
+    {
+        n->plink.reset(new PublicLink(record.linkHandle(),
+                                      record.linkCreation(),
+                                      record.linkExpiry(),
+                                      flags & NodeRecord::LINK_TAKEN_DOWN,
+                                      string(record.section(NodeRecord::AUTH_KEY)).c_str()));
+    }
+
+    bool encrypted = flags & NodeRecord::ENCRYPTED;
+
+    if (encrypted)
+    {
+        n->attrstring.reset(new string(record.section(NodeRecord::ATTRIBUTE_STRING)));
+    }
+
+    n->setKey(string(record.section(NodeRecord::NODE_KEY))); // it can be decrypted or encrypted
+
+    applyKey(client, n, encrypted);
+
+    return n;
+}
+
+void NodeData::applyKey(MegaClient& client, const std::shared_ptr<Node>& n, bool encrypted) const
+{
     if (!n->keyApplied())
     {
         client.mNodeManager.addNodePendingApplykey(n);
     }
 
-    if (!mIsEncrypted)
+    if (!encrypted)
     {
         // only if the node is not encrypted, we can generate a valid
         // fingerprint, based on the node's attribute 'c'
         n->setfingerprint();
     }
+}
 
-    return n;
+bool NodeData::toRecord(std::string& record)
+{
+    assert(mComp == COMPONENT_ALL);
+    if (readFailed())
+    {
+        return false;
+    }
+
+    if (mRecord)
+    {
+        record.assign(mStart, mEnd);
+        return true;
+    }
+
+    NodeRecord::Fields fields;
+
+    fields.type = mType;
+    fields.size = mSize;
+    fields.nodeHandle = mHandle;
+    fields.parentHandle = mParentHandle;
+    fields.owner = mUserHandle;
+    fields.ctime = mCtime;
+
+    fields.sections[NodeRecord::NODE_KEY] = mNodeKey;
+
+    // the legacy format keeps the terminating null
+    fields.sections[NodeRecord::FILE_ATTRIBUTES] = mFileAttributes.c_str();
+
+    if (mIsExported)
+    {
+        fields.flags |= NodeRecord::EXPORTED;
+
+        if (mPubLinkTakenDown)
+        {
+            fields.flags |= NodeRecord::LINK_TAKEN_DOWN;
+        }
+
+        fields.linkHandle = mPubLinkHandle;
+        fields.linkExpiry = mPubLinkEts;
+        fields.linkCreation = mPubLinkCts;
+        fields.sections[NodeRecord::AUTH_KEY] = mAuthKey;
+    }
+
+    string shares;
+
+    for (auto& share: mShares)
+    {
+        shares.append(share.data(), share.size());
+    }
+
+    if (!mShares.empty())
+    {
+        fields.numShares = static_cast<int16_t>(mShareDirection ? mShares.size() : -1);
+        fields.sections[NodeRecord::SHARE_KEY] =
+            std::string_view(reinterpret_cast<const char*>(mShareKey.get()), SymmCipher::KEYLENGTH);
+        fields.sections[NodeRecord::SHARES] = shares;
+    }
+
+    fields.attributes = &mAttrs.map;
+
+    if (mIsEncrypted)
+    {
+        fields.flags |= NodeRecord::ENCRYPTED;
+        fields.sections[NodeRecord::ATTRIBUTE_STRING] = mAttrString;
+    }
+
+    record.clear();
+    NodeRecord::write(fields, record);
+
+    return true;
 }
 
 bool NewNode::hasZeroKey() const
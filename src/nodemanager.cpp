@@ -163,6 +163,7 @@ void NodeManager::setTable_internal(DBTableNodes *table)
 {
     assert(mMutex.owns_lock());
     mTable = table;
+    ++mTableGeneration;
 }
 
 void NodeManager::reset()
@@ -608,7 +609,12 @@ sharedNode_vector NodeManager::getChildren_internal(const NodeSearchFilter& filt
 
     // db look-up
     vector<pair<NodeHandle, NodeSerialized>> nodesFromTable;
-    if (!mTable->getChildren(filter, order, nodesFromTable, cancelFlag, page))
+    auto query = [&](DBTableNodes& table, vector<pair<NodeHandle, NodeSerialized>>& nodes)
+    {
+        return table.getChildren(filter, order, nodes, cancelFlag, page);
+    };
+
+    if (!queryNodes(query, nodesFromTable))
     {
         return sharedNode_vector();
     }
@@ -618,21 +624,34 @@ sharedNode_vector NodeManager::getChildren_internal(const NodeSearchFilter& filt
     return nodes;
 }
 
-sharedNode_vector NodeManager::getRecentNodes(unsigned maxcount,
-                                              m_time_t since,
-                                              bool excludeSensitives)
+std::vector<RecentFile> NodeManager::getRecentFiles(unsigned maxcount,
+                                                    m_time_t since,
+                                                    bool excludeSensitives)
 {
     LockGuard g(mMutex);
 
-    sharedNode_vector result = getRecentNodes_internal(NodeSearchPage{0, maxcount}, since);
+    std::vector<RecentFile> result = getRecentFiles_internal(NodeSearchPage{0, maxcount}, since);
     if (!excludeSensitives)
         return result;
 
-    const auto isSensitive = [](const std::shared_ptr<Node>& node) -> bool
+    // Sensitivity is inherited, so it's that of the file or of its folder, whose nodes are
+    // loaded once each.
+    std::map<NodeHandle, bool> sensitiveParents;
+    const auto isSensitive = [this, &sensitiveParents](const RecentFile& file) -> bool
     {
-        return node && node->isSensitiveInherited();
+        if (std::bitset<Node::FLAGS_SIZE>(file.flags).test(Node::FLAGS_IS_MARKED_SENSTIVE))
+            return true;
+
+        auto [it, inserted] = sensitiveParents.emplace(file.parentHandle, false);
+        if (inserted)
+        {
+            auto parent = getNodeByHandle_internal(file.parentHandle);
+            it->second = parent && parent->isSensitiveInherited();
+        }
+
+        return it->second;
     };
-    const auto filterSensitives = [&isSensitive](sharedNode_vector& v) -> void
+    const auto filterSensitives = [&isSensitive](std::vector<RecentFile>& v) -> void
     {
         auto it = std::remove_if(std::begin(v), std::end(v), isSensitive);
         v.erase(it, std::end(v));
@@ -642,12 +661,12 @@ sharedNode_vector NodeManager::getRecentNodes(unsigned maxcount,
     if (result.size() == maxcount)
         return result;
 
-    // Keep asking for more no sensitive nodes to the db
+    // Keep asking for more no sensitive files to the db
     unsigned start = maxcount;
     unsigned querySize = maxcount;
     while (true)
     {
-        auto moreResults = getRecentNodes_internal(NodeSearchPage{start, querySize}, since);
+        auto moreResults = getRecentFiles_internal(NodeSearchPage{start, querySize}, since);
         if (moreResults.empty()) // No more potential results
             return result;
         filterSensitives(moreResults);
@@ -667,19 +686,40 @@ sharedNode_vector NodeManager::getRecentNodes(unsigned maxcount,
     }
 }
 
-sharedNode_vector NodeManager::getRecentNodes_internal(const NodeSearchPage& page, m_time_t since)
+std::vector<RecentFile> NodeManager::getRecentFiles_internal(const NodeSearchPage& page,
+                                                             m_time_t since)
 {
     assert(mMutex.owns_lock());
 
     if (!mTable || mNodes.empty())
     {
-        return sharedNode_vector();
+        return std::vector<RecentFile>();
     }
 
-    std::vector<std::pair<NodeHandle, NodeSerialized>> nodesFromTable;
-    mTable->getRecentNodes(page, since, nodesFromTable);
+    std::vector<RecentFile> files;
+    auto changed = false;
+    auto query = [&](DBTableNodes& table)
+    {
+        return table.getRecentFiles(page, since, files);
+    };
 
-    return processUnserializedNodes(nodesFromTable);
+    auto result = queryReadOnlyView(query, changed);
+
+    if (result && !changed)
+    {
+        if (!*result)
+            files.clear();
+
+        return files;
+    }
+
+    // Files may have been added, removed or modified since the view was queried.
+    files.clear();
+
+    if (mTable)
+        query(*mTable);
+
+    return files;
 }
 
 uint64_t NodeManager::getNodeCount()
@@ -778,8 +818,24 @@ auto NodeManager::getNodeTagsBelow(CancelToken cancelToken,
     // Try and retrieve the tags below the specified nodes.
     for (const auto& handle: handles)
     {
-        // Try and retrieve tags below this node.
-        auto tags = mTable->getNodeTagsBelow(cancelToken, handle, pattern);
+        // The database may have been closed while we weren't holding the lock.
+        if (!mTable)
+            break;
+
+        auto query = [&](DBTableNodes& table)
+        {
+            return table.getNodeTagsBelow(cancelToken, handle, pattern);
+        };
+
+        // Try and retrieve tags below this node, without blocking the SDK thread if possible.
+        auto changed = false;
+        auto viewTags = queryReadOnlyView(query, changed);
+
+        // The database may have been closed or changed while we weren't holding the lock.
+        if (!mTable)
+            break;
+
+        auto tags = viewTags && !changed ? std::move(*viewTags) : query(*mTable);
 
         // Couldn't get tags.
         if (!tags)
@@ -830,7 +886,12 @@ sharedNode_vector NodeManager::searchNodes_internal(const NodeSearchFilter& filt
 
     // db look-up
     vector<pair<NodeHandle, NodeSerialized>> nodesFromTable;
-    if (!mTable->searchNodes(filter, order, nodesFromTable, cancelFlag, page))
+    auto query = [&](DBTableNodes& table, vector<pair<NodeHandle, NodeSerialized>>& nodes)
+    {
+        return table.searchNodes(filter, order, nodes, cancelFlag, page);
+    };
+
+    if (!queryNodes(query, nodesFromTable))
     {
         return sharedNode_vector();
     }
@@ -840,6 +901,78 @@ sharedNode_vector NodeManager::searchNodes_internal(const NodeSearchFilter& filt
     return nodes;
 }
 
+template<typename Query>
+auto NodeManager::queryReadOnlyView(Query&& query, bool& changed)
+    -> std::optional<std::invoke_result_t<Query, DBTableNodes&>>
+{
+    assert(mMutex.owns_lock());
+
+    changed = false;
+
+    // The view sees the table as of the last commit, so it's no use with changes pending
+    if (!mTable || mTable->changeCount() != mTable->committedChangeCount())
+    {
+        return std::nullopt;
+    }
+
+    auto view = mTable->readOnlyView();
+    if (!view)
+    {
+        return std::nullopt;
+    }
+
+    auto changes = mTable->committedChangeCount();
+    auto generation = mTableGeneration;
+
+    mMutex.unlock();
+
+    auto result = query(*view);
+
+    // Hand the connection back before waiting for the lock, as the table may be waiting
+    // for it to be returned while it's destroyed.
+    view.reset();
+
+    mMutex.lock();
+
+    if (generation != mTableGeneration)
+    {
+        changed = true;
+        return std::invoke_result_t<Query, DBTableNodes&>();
+    }
+
+    changed = mTable->changeCount() != changes;
+
+    return result;
+}
+
+template<typename Query>
+bool NodeManager::queryNodes(Query&& query, vector<pair<NodeHandle, NodeSerialized>>& nodes)
+{
+    assert(mMutex.owns_lock());
+
+    auto changed = false;
+    auto result = queryReadOnlyView(
+        [&query, &nodes](DBTableNodes& table)
+        {
+            return query(table, nodes);
+        },
+        changed);
+
+    if (result && !changed)
+    {
+        if (!*result)
+            nodes.clear();
+
+        return *result;
+    }
+
+    // The view showed the table as it was last committed: nodes may have been
+    // added, removed or modified since, so the query is run again.
+    nodes.clear();
+
+    return mTable && query(*mTable, nodes);
+}
+
 sharedNode_vector NodeManager::getNodesWithInShares()
 {
     LockGuard g(mMutex);
@@ -1585,6 +1718,8 @@ void NodeManager::applyKeys_internal()
 {
     assert(mMutex.owns_lock());
 
+    sharedNode_vector nodes;
+
     for (auto it = mNodePendingApplyKeys.begin(); it != mNodePendingApplyKeys.end();)
     {
         auto& [_, pendingNode] = *it;
@@ -1598,9 +1733,7 @@ void NodeManager::applyKeys_internal()
                 continue;
             }
 
-            // Node::applykey already remove element from mNodePendingApplyKeys if key has been
-            // applied
-            sharedNode->applykey();
+            nodes.push_back(std::move(sharedNode));
         }
         else
         {
@@ -1608,6 +1741,20 @@ void NodeManager::applyKeys_internal()
         }
     }
 
+    // Node::applykey already remove element from mNodePendingApplyKeys if key has been
+    // applied
+    if (nodes.size() >= MIN_NODES_TO_APPLY_KEYS_IN_PARALLEL)
+    {
+        applyKeysInParallel(nodes);
+    }
+    else
+    {
+        for (auto& node : nodes)
+        {
+            node->applykey();
+        }
+    }
+
 #ifdef DEBUG
     // In case of folder links, root node is not from type rootnode and it is decryptable
     unsigned rootNodeUndecrypted =
@@ -1632,6 +1779,142 @@ void NodeManager::applyKeys_internal()
 #endif
 }
 
+void NodeManager::applyKeysInParallel(const sharedNode_vector& nodes)
+{
+    assert(mMutex.owns_lock());
+
+    struct Job
+    {
+        std::shared_ptr<Node> node;
+
+        // encrypted key, the key to decrypt it with and the attributes, all of them
+        // left untouched by the client thread until the batch is done
+        const char* encryptedKey = nullptr;
+        byte wrappingKey[SymmCipher::KEYLENGTH];
+        const string* attrstring = nullptr;
+        int keylength = 0;
+
+        // results
+        bool unwrapped = false;
+        byte key[FILENODEKEYLENGTH];
+        std::unique_ptr<byte[]> attrs;
+    };
+
+    struct Batch
+    {
+        std::vector<Job> jobs;
+        size_t chunks = 0;
+        std::atomic<size_t> next{0};
+        size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    auto batch = std::make_shared<Batch>();
+    batch->jobs.reserve(nodes.size());
+
+    // Locating the keys depends on the client's state, so it's done here
+    for (auto& node : nodes)
+    {
+        const char* k = nullptr;
+        SymmCipher* sc = nullptr;
+
+        if (!node->locatekey(k, sc))
+        {
+            continue;
+        }
+
+        // RSA-encrypted keys need the client's private key, see MegaClient::decryptkey
+        if (strcspn(k, "\"/") > 4 * FILENODEKEYLENGTH / 3 + 1)
+        {
+            byte key[FILENODEKEYLENGTH];
+            auto unwrapped = mClient.decryptkey(k,
+                                                key,
+                                                static_cast<int>(node->nodekeylength()),
+                                                sc,
+                                                0,
+                                                node->nodehandle);
+            node->applyunwrappedkey(unwrapped ? key : nullptr, nullptr);
+            continue;
+        }
+
+        auto& job = batch->jobs.emplace_back();
+        job.node = node;
+        job.encryptedKey = k;
+        memcpy(job.wrappingKey, sc->key, sizeof(job.wrappingKey));
+        job.attrstring = node->attrstring.get();
+        job.keylength = static_cast<int>(node->nodekeylength());
+    }
+
+    // Decrypt in chunks claimed by the worker threads and by this thread, which
+    // takes over any chunk the workers haven't started
+    batch->chunks = (batch->jobs.size() + NODES_PER_APPLY_KEYS_CHUNK - 1) / NODES_PER_APPLY_KEYS_CHUNK;
+
+    auto work = [](Batch& batch, SymmCipher& cipher)
+    {
+        for (size_t chunk; (chunk = batch.next++) < batch.chunks;)
+        {
+            auto begin = chunk * NODES_PER_APPLY_KEYS_CHUNK;
+            auto end = std::min(begin + NODES_PER_APPLY_KEYS_CHUNK, batch.jobs.size());
+
+            for (auto i = begin; i < end; ++i)
+            {
+                auto& job = batch.jobs[i];
+
+                cipher.setkey(job.wrappingKey);
+                if (Base64::atob(job.encryptedKey, job.key, job.keylength) != job.keylength)
+                {
+                    continue;
+                }
+                cipher.ecb_decrypt(job.key, static_cast<size_t>(job.keylength));
+                job.unwrapped = true;
+
+                string key(reinterpret_cast<const char*>(job.key), static_cast<size_t>(job.keylength));
+                if (job.attrstring && cipher.setkey(&key))
+                {
+                    job.attrs.reset(Node::decryptattr(&cipher, job.attrstring->c_str(), job.attrstring->size()));
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> g(batch.mutex);
+                ++batch.done;
+            }
+            batch.cv.notify_one();
+        }
+    };
+
+    for (size_t i = 1; i < batch->chunks; ++i)
+    {
+        mClient.mAsyncQueue.push([batch, work](SymmCipher& cipher)
+                                 {
+                                     work(*batch, cipher);
+                                 },
+                                 true);
+    }
+
+    SymmCipher cipher;
+    work(*batch, cipher);
+
+    {
+        std::unique_lock<std::mutex> g(batch->mutex);
+        batch->cv.wait(g, [&batch]() { return batch->done == batch->chunks; });
+    }
+
+    // Merge the results, in the same way Node::applykey does
+    for (auto& job : batch->jobs)
+    {
+        if (!job.unwrapped)
+        {
+            LOG_warn << "Corrupt or invalid symmetric node key";
+        }
+
+        job.node->applyunwrappedkey(job.unwrapped ? job.key : nullptr, job.attrs.get());
+    }
+
+    LOG_debug << "Keys applied in parallel to " << batch->jobs.size() << " nodes";
+}
+
 void NodeManager::notifyPurge()
 {
     mClient.applykeys();
@@ -0,0 +1,368 @@
+/**
+ * @file noderecord.cpp
+ * @brief Binary record of a node, as stored in the nodes table
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/noderecord.h"
+
+#include "mega/logging.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace mega
+{
+
+namespace
+{
+
+constexpr size_t TAG_OFFSET = 0;
+constexpr size_t VERSION_OFFSET = 8;
+constexpr size_t TYPE_OFFSET = 9;
+constexpr size_t FLAGS_OFFSET = 10;
+constexpr size_t NUM_SHARES_OFFSET = 12;
+constexpr size_t SIZE_OFFSET = 16;
+constexpr size_t HANDLE_OFFSET = 24;
+constexpr size_t PARENT_OFFSET = 32;
+constexpr size_t OWNER_OFFSET = 40;
+constexpr size_t CTIME_OFFSET = 48;
+constexpr size_t SECTION_END_OFFSET = 56;
+
+template<typename T>
+void put(std::string& out, size_t offset, T value)
+{
+    memcpy(&out[offset], &value, sizeof(value));
+}
+
+template<typename T>
+void append(std::string& out, T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // anonymous
+
+void NodeRecord::write(const Fields& fields, std::string& out)
+{
+    auto start = out.size();
+    out.resize(start + HEADER_SIZE);
+
+    put(out, start + TAG_OFFSET, RECORD_TAG);
+    put(out, start + VERSION_OFFSET, FORMAT_VERSION);
+    put(out, start + TYPE_OFFSET, static_cast<int8_t>(fields.type));
+    put(out, start + FLAGS_OFFSET, fields.flags);
+    put(out, start + NUM_SHARES_OFFSET, fields.numShares);
+    put(out, start + SIZE_OFFSET, fields.size);
+    put(out, start + HANDLE_OFFSET, fields.nodeHandle);
+    put(out, start + PARENT_OFFSET, fields.parentHandle);
+    put(out, start + OWNER_OFFSET, fields.owner);
+    put(out, start + CTIME_OFFSET, fields.ctime);
+
+    for (int i = 0; i < NUM_SECTIONS; ++i)
+    {
+        switch (i)
+        {
+            case LINK:
+                if (fields.flags & EXPORTED)
+                {
+                    append(out, fields.linkHandle);
+                    append(out, fields.linkExpiry);
+                    append(out, fields.linkCreation);
+                }
+                break;
+
+            case ATTRIBUTES:
+            {
+                if (!fields.attributes || fields.attributes->empty())
+                {
+                    break;
+                }
+
+                auto& attrs = *fields.attributes;
+                auto count = static_cast<uint32_t>(attrs.size());
+                uint32_t valueEnd = static_cast<uint32_t>(sizeof(count) + count * ATTRIBUTE_ENTRY_SIZE);
+
+                append(out, count);
+
+                for (auto& attr: attrs)
+                {
+                    valueEnd += static_cast<uint32_t>(attr.second.size());
+                    append(out, attr.first);
+                    append(out, valueEnd);
+                }
+
+                for (auto& attr: attrs)
+                {
+                    out.append(attr.second);
+                }
+                break;
+            }
+
+            default:
+                out.append(fields.sections[i]);
+        }
+
+        put(out,
+            start + SECTION_END_OFFSET + i * sizeof(uint32_t),
+            static_cast<uint32_t>(out.size() - start));
+    }
+}
+
+bool NodeRecord::isRecord(const char* data, size_t size)
+{
+    if (size < sizeof(RECORD_TAG))
+    {
+        return false;
+    }
+
+    int64_t tag;
+    memcpy(&tag, data + TAG_OFFSET, sizeof(tag));
+    return tag == RECORD_TAG;
+}
+
+NodeRecord::NodeRecord(const char* data, size_t size):
+    mData(data),
+    mSize(size),
+    mValid(validate())
+{
+    if (!mValid)
+    {
+        LOG_err << "Invalid node record of " << size << " bytes";
+    }
+}
+
+bool NodeRecord::validate() const
+{
+    if (mSize < HEADER_SIZE || !isRecord(mData, mSize) || get<uint8_t>(VERSION_OFFSET) > FORMAT_VERSION)
+    {
+        return false;
+    }
+
+    size_t begin = HEADER_SIZE;
+
+    for (int i = 0; i < NUM_SECTIONS; ++i)
+    {
+        size_t end = get<uint32_t>(SECTION_END_OFFSET + i * sizeof(uint32_t));
+
+        if (end < begin || end > mSize)
+        {
+            return false;
+        }
+
+        begin = end;
+    }
+
+    auto link = section(LINK);
+
+    if (!link.empty() && link.size() != LINK_SIZE)
+    {
+        return false;
+    }
+
+    auto attrs = section(ATTRIBUTES);
+
+    if (attrs.empty())
+    {
+        return true;
+    }
+
+    uint32_t count;
+
+    if (attrs.size() < sizeof(count))
+    {
+        return false;
+    }
+
+    memcpy(&count, attrs.data(), sizeof(count));
+
+    size_t valueBegin = sizeof(count) + size_t(count) * ATTRIBUTE_ENTRY_SIZE;
+
+    if (valueBegin > attrs.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t valueEnd;
+        memcpy(&valueEnd,
+               attrs.data() + sizeof(count) + i * ATTRIBUTE_ENTRY_SIZE + sizeof(nameid),
+               sizeof(valueEnd));
+
+        if (valueEnd < valueBegin || valueEnd > attrs.size()
+            || (i && attributeName(i - 1) >= attributeName(i)))
+        {
+            return false;
+        }
+
+        valueBegin = valueEnd;
+    }
+
+    return true;
+}
+
+template<typename T>
+T NodeRecord::get(size_t offset) const
+{
+    assert(offset + sizeof(T) <= mSize);
+
+    T value;
+    memcpy(&value, mData + offset, sizeof(value));
+    return value;
+}
+
+nodetype_t NodeRecord::type() const
+{
+    return static_cast<nodetype_t>(get<int8_t>(TYPE_OFFSET));
+}
+
+uint8_t NodeRecord::flags() const
+{
+    return get<uint8_t>(FLAGS_OFFSET);
+}
+
+int16_t NodeRecord::numShares() const
+{
+    return get<int16_t>(NUM_SHARES_OFFSET);
+}
+
+m_off_t NodeRecord::size() const
+{
+    return get<m_off_t>(SIZE_OFFSET);
+}
+
+handle NodeRecord::nodeHandle() const
+{
+    return get<handle>(HANDLE_OFFSET);
+}
+
+handle NodeRecord::parentHandle() const
+{
+    return get<handle>(PARENT_OFFSET);
+}
+
+handle NodeRecord::owner() const
+{
+    return get<handle>(OWNER_OFFSET);
+}
+
+m_time_t NodeRecord::ctime() const
+{
+    return get<m_time_t>(CTIME_OFFSET);
+}
+
+handle NodeRecord::linkHandle() const
+{
+    auto link = section(LINK);
+    return link.empty() ? UNDEF : get<handle>(static_cast<size_t>(link.data() - mData));
+}
+
+m_time_t NodeRecord::linkExpiry() const
+{
+    auto link = section(LINK);
+    return link.empty() ? 0 :
+                          get<m_time_t>(static_cast<size_t>(link.data() - mData) + sizeof(handle));
+}
+
+m_time_t NodeRecord::linkCreation() const
+{
+    auto link = section(LINK);
+    return link.empty() ? 0 :
+                          get<m_time_t>(static_cast<size_t>(link.data() - mData) + sizeof(handle) +
+                                        sizeof(m_time_t));
+}
+
+std::string_view NodeRecord::section(Section section) const
+{
+    size_t begin =
+        section ? get<uint32_t>(SECTION_END_OFFSET + (section - 1) * sizeof(uint32_t)) : HEADER_SIZE;
+    size_t end = get<uint32_t>(SECTION_END_OFFSET + section * sizeof(uint32_t));
+
+    return std::string_view(mData + begin, end - begin);
+}
+
+size_t NodeRecord::numAttributes() const
+{
+    auto attrs = section(ATTRIBUTES);
+
+    if (attrs.empty())
+    {
+        return 0;
+    }
+
+    return get<uint32_t>(static_cast<size_t>(attrs.data() - mData));
+}
+
+nameid NodeRecord::attributeName(size_t i) const
+{
+    auto entry = static_cast<size_t>(section(ATTRIBUTES).data() - mData) + sizeof(uint32_t) +
+                 i * ATTRIBUTE_ENTRY_SIZE;
+
+    return get<nameid>(entry);
+}
+
+std::string_view NodeRecord::attributeValue(size_t i) const
+{
+    auto attrs = section(ATTRIBUTES);
+    auto offset = static_cast<size_t>(attrs.data() - mData) + sizeof(uint32_t);
+
+    size_t begin = i ? get<uint32_t>(offset + (i - 1) * ATTRIBUTE_ENTRY_SIZE + sizeof(nameid)) :
+                       sizeof(uint32_t) + numAttributes() * ATTRIBUTE_ENTRY_SIZE;
+    size_t end = get<uint32_t>(offset + i * ATTRIBUTE_ENTRY_SIZE + sizeof(nameid));
+
+    return attrs.substr(begin, end - begin);
+}
+
+std::optional<std::string_view> NodeRecord::attribute(nameid name) const
+{
+    size_t low = 0;
+    size_t high = numAttributes();
+
+    while (low < high)
+    {
+        auto middle = low + (high - low) / 2;
+        auto found = attributeName(middle);
+
+        if (found == name)
+        {
+            return attributeValue(middle);
+        }
+
+        if (found < name)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void NodeRecord::attributes(attr_map& attrs) const
+{
+    for (size_t i = 0, count = numAttributes(); i < count; ++i)
+    {
+        attrs.emplace(attributeName(i), std::string(attributeValue(i)));
+    }
+}
+
+} // namespace mega
@@ -0,0 +1,162 @@
+/**
+ * @file openmetrics.cpp
+ * @brief Write metrics in the OpenMetrics text format
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/openmetrics.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace mega::stats
+{
+
+namespace
+{
+
+std::string number(double value)
+{
+    if (std::isnan(value))
+        return "NaN";
+
+    if (std::isinf(value))
+        return value > 0 ? "+Inf" : "-Inf";
+
+    // Short, but reading back as the same value.
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.15g", value);
+
+    if (std::strtod(buffer, nullptr) != value)
+        snprintf(buffer, sizeof(buffer), "%.17g", value);
+
+    return buffer;
+}
+
+} // anonymous
+
+void OpenMetricsWriter::family(const std::string& name,
+                               Type type,
+                               const std::string& help,
+                               const std::string& unit)
+{
+    mName = "mega_" + name;
+    mType = type;
+
+    static const char* types[] = {"counter", "gauge", "histogram"};
+
+    mOut += "# TYPE " + mName + " " + types[static_cast<int>(type)] + "\n";
+
+    if (!unit.empty())
+        mOut += "# UNIT " + mName + " " + unit + "\n";
+
+    mOut += "# HELP " + mName + " " + escape(help) + "\n";
+}
+
+void OpenMetricsWriter::sample(const Labels& labels, double value)
+{
+    assert(mType != Type::HISTOGRAM);
+
+    line(mType == Type::COUNTER ? "_total" : "", labels, value);
+}
+
+void OpenMetricsWriter::histogram(const Labels& labels,
+                                  const std::vector<double>& bounds,
+                                  const std::vector<uint64_t>& counts,
+                                  double sum)
+{
+    assert(mType == Type::HISTOGRAM);
+    assert(counts.size() == bounds.size() + 1);
+
+    auto bucketLabels = labels;
+    bucketLabels.emplace_back("le", std::string());
+
+    uint64_t cumulative = 0;
+
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        cumulative += counts[i];
+
+        bucketLabels.back().second = number(i < bounds.size() ? bounds[i] : INFINITY);
+        line("_bucket", bucketLabels, static_cast<double>(cumulative));
+    }
+
+    line("_count", labels, static_cast<double>(cumulative));
+    line("_sum", labels, sum);
+}
+
+std::string OpenMetricsWriter::finish()
+{
+    mOut += "# EOF\n";
+    return std::move(mOut);
+}
+
+std::string OpenMetricsWriter::escape(const std::string& value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+
+    for (auto c: value)
+    {
+        switch (c)
+        {
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            default:
+                escaped += c;
+        }
+    }
+
+    return escaped;
+}
+
+void OpenMetricsWriter::line(const std::string& suffix, const Labels& labels, double value)
+{
+    mOut += mName;
+    mOut += suffix;
+
+    if (!labels.empty())
+    {
+        mOut += '{';
+
+        for (size_t i = 0; i < labels.size(); ++i)
+        {
+            if (i)
+                mOut += ',';
+
+            mOut += labels[i].first + "=\"" + escape(labels[i].second) + "\"";
+        }
+
+        mOut += '}';
+    }
+
+    mOut += ' ';
+    mOut += number(value);
+    mOut += '\n';
+}
+
+} // namespace mega::stats
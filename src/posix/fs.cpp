@@ -574,6 +574,23 @@ bool PosixFileAccess::sysread(void* buffer, unsigned long length, m_off_t offset
     return true;
 }
 
+void PosixFileAccess::readAhead(m_off_t offset, m_off_t length)
+{
+    if (fd < 0 || offset < 0 || length <= 0)
+        return;
+
+#if defined(__APPLE__)
+    radvisory advice{};
+    advice.ra_offset = static_cast<off_t>(offset);
+    advice.ra_count = static_cast<int>(std::min<m_off_t>(length, std::numeric_limits<int>::max()));
+
+    // Only a hint: failure just means the read won't be prefetched.
+    fcntl(fd, F_RDADVISE, &advice);
+#elif defined(POSIX_FADV_WILLNEED)
+    posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+#endif
+}
+
 void PosixFileAccess::fclose()
 {
 #ifndef HAVE_FDOPENDIR
@@ -931,6 +948,24 @@ PosixFileSystemAccess::PosixFileSystemAccess()
 
 bool LinuxFileSystemAccess::initFilesystemNotificationSystem()
 {
+#ifdef USE_FANOTIFY
+    if (mUseFanotify)
+    {
+        mFanotifyFd = fanotify_init(FAN_CLASS_NOTIF | FAN_REPORT_DFID_NAME | FAN_CLOEXEC |
+                                        FAN_NONBLOCK,
+                                    O_RDONLY | O_LARGEFILE);
+
+        if (mFanotifyFd < 0)
+        {
+            mFanotifyFd = -errno;
+
+            LOG_warn << "Unable to initialize fanotify, syncs will be monitored with inotify: "
+                     << -mFanotifyFd;
+        }
+    }
+#endif // USE_FANOTIFY
+
+    // Inotify is still needed for filesystems that can't be marked.
     mNotifyFd = inotify_init1(IN_NONBLOCK);
 
     if (mNotifyFd < 0)
@@ -938,6 +973,52 @@ bool LinuxFileSystemAccess::initFilesystemNotificationSystem()
 
     return true;
 }
+
+#ifdef USE_FANOTIFY
+
+std::atomic<bool> LinuxFileSystemAccess::mUseFanotify{false};
+
+void LinuxFileSystemAccess::setUseFanotify(bool useFanotify)
+{
+    mUseFanotify = useFanotify;
+}
+
+bool LinuxFileSystemAccess::fanotifyFsid(const LocalPath& path, string& fsid)
+{
+    struct statfs info;
+
+    if (statfs(path.toPath(false).c_str(), &info))
+        return false;
+
+    fsid.assign(reinterpret_cast<const char*>(&info.f_fsid), sizeof(info.f_fsid));
+
+    return true;
+}
+
+bool LinuxFileSystemAccess::fanotifyKey(const LocalPath& path, const string& fsid, string& key)
+{
+    union
+    {
+        file_handle handle;
+        char storage[sizeof(file_handle) + MAX_HANDLE_SZ];
+    } u;
+
+    u.handle.handle_bytes = MAX_HANDLE_SZ;
+
+    int mountId;
+
+    if (name_to_handle_at(AT_FDCWD, path.toPath(false).c_str(), &u.handle, &mountId, 0))
+        return false;
+
+    key = fsid;
+    key.append(reinterpret_cast<const char*>(&u.handle.handle_type), sizeof(u.handle.handle_type));
+    key.append(reinterpret_cast<const char*>(u.handle.f_handle), u.handle.handle_bytes);
+
+    return true;
+}
+
+#endif // USE_FANOTIFY
+
 #endif // ENABLE_SYNC
 
 LinuxFileSystemAccess::~LinuxFileSystemAccess()
@@ -951,6 +1032,12 @@ LinuxFileSystemAccess::~LinuxFileSystemAccess()
     if (mNotifyFd >= 0)
         close(mNotifyFd);
 
+#ifdef USE_FANOTIFY
+    // Release fanotify descriptor, and with it any marks.
+    if (mFanotifyFd >= 0)
+        close(mFanotifyFd);
+#endif // USE_FANOTIFY
+
 #endif // ENABLE_SYNC
 }
 
@@ -991,19 +1078,170 @@ void LinuxFileSystemAccess::addevents([[maybe_unused]] Waiter* waiter, int /*fla
 {
 #ifdef ENABLE_SYNC
 
-    if (mNotifyFd < 0)
-        return;
-
     auto w = static_cast<PosixWaiter*>(waiter);
 
-    MEGA_FD_SET(mNotifyFd, &w->rfds);
-    MEGA_FD_SET(mNotifyFd, &w->ignorefds);
+    auto add = [w](int fd)
+    {
+        if (fd < 0)
+            return;
+
+        MEGA_FD_SET(fd, &w->rfds);
+        MEGA_FD_SET(fd, &w->ignorefds);
 
-    w->bumpmaxfd(mNotifyFd);
+        w->bumpmaxfd(fd);
+    };
+
+    add(mNotifyFd);
+
+#ifdef USE_FANOTIFY
+    add(mFanotifyFd);
+#endif // USE_FANOTIFY
 
 #endif // ENABLE_SYNC
 }
 
+#ifdef ENABLE_SYNC
+
+void LinuxFileSystemAccess::readInotifyEvents(int fd,
+                                              vector<char>& buffer,
+                                              std::function<void(const inotify_event&)> handler)
+{
+    // Large enough for many events, and at least one with the longest name.
+    buffer.resize(std::max(EVENT_BUFFER_SIZE, sizeof(inotify_event) + NAME_MAX + 1));
+
+    ssize_t l;
+
+    while ((l = read(fd, buffer.data(), buffer.size())) > 0)
+    {
+        const inotify_event* in;
+
+        for (ssize_t p = 0; p < l; p += static_cast<ssize_t>(offsetof(inotify_event, name) + in->len))
+        {
+            in = reinterpret_cast<const inotify_event*>(buffer.data() + p);
+            handler(*in);
+        }
+    }
+}
+
+#ifdef USE_FANOTIFY
+
+void LinuxFileSystemAccess::readFanotifyEvents(
+    int fd,
+    vector<char>& buffer,
+    std::function<void(const fanotify_event_metadata&, const string&, const char*)> handler)
+{
+    buffer.resize(EVENT_BUFFER_SIZE);
+
+    string key;
+    ssize_t l;
+
+    while ((l = read(fd, buffer.data(), buffer.size())) > 0)
+    {
+        auto* metadata = reinterpret_cast<const fanotify_event_metadata*>(buffer.data());
+
+        for (; FAN_EVENT_OK(metadata, l); metadata = FAN_EVENT_NEXT(metadata, l))
+        {
+            key.clear();
+
+            const char* name = "";
+
+            // The directory the event happened in, and the entry's name.
+            if (metadata->event_len > metadata->metadata_len)
+            {
+                auto* info = reinterpret_cast<const fanotify_event_info_fid*>(
+                    reinterpret_cast<const char*>(metadata) + metadata->metadata_len);
+
+                if (info->hdr.info_type == FAN_EVENT_INFO_TYPE_DFID_NAME ||
+                    info->hdr.info_type == FAN_EVENT_INFO_TYPE_DFID)
+                {
+                    auto* handle = reinterpret_cast<const file_handle*>(info->handle);
+
+                    key.assign(reinterpret_cast<const char*>(&info->fsid), sizeof(info->fsid));
+                    key.append(reinterpret_cast<const char*>(&handle->handle_type),
+                               sizeof(handle->handle_type));
+                    key.append(reinterpret_cast<const char*>(handle->f_handle),
+                               handle->handle_bytes);
+
+                    if (info->hdr.info_type == FAN_EVENT_INFO_TYPE_DFID_NAME)
+                        name = reinterpret_cast<const char*>(handle->f_handle) +
+                               handle->handle_bytes;
+
+                    // Events on the directory itself.
+                    if (!strcmp(name, "."))
+                        name = "";
+                }
+            }
+
+            handler(*metadata, key, name);
+        }
+    }
+}
+
+#endif // USE_FANOTIFY
+
+int LinuxFileSystemAccess::notifyAll(WatchMap& watches,
+                                     int handle,
+                                     const char* name,
+                                     bool deletedSelf,
+                                     bool attribDir)
+{
+    int result = 0;
+
+    // Loop over and notify all associated nodes.
+    auto associated = watches.equal_range(handle);
+
+    for (auto i = associated.first; i != associated.second;)
+    {
+        // Convenience.
+        using std::move;
+        auto& node = *i->second.first;
+        auto& sync = *node.sync;
+        auto& notifier = *sync.dirnotify;
+
+        LOG_debug << "Filesystem notification:"
+            << " Root: "
+            << node.localname
+            << " Path: "
+            << name;
+
+        if (deletedSelf)
+        {
+            // The FS directory watched is gone
+            node.mWatchHandle.invalidate();
+            // Remove it from the container (C++11 and up)
+            i = watches.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+
+        auto localName = LocalPath::fromPlatformEncodedRelative(name);
+        notifier.notify(notifier.fsEventq,
+                        &node,
+                        Notification::NEEDS_PARENT_SCAN,
+                        std::move(localName));
+
+        // We need to rescan the directory if it's changed permissions.
+        //
+        // The reason for this is that we may not have been able to list
+        // the directory's contents before. If we didn't rescan, we
+        // wouldn't notice these files until some other event is
+        // triggered in or below this directory.
+        if (attribDir)
+            notifier.notify(notifier.fsEventq,
+                            &node,
+                            Notification::FOLDER_NEEDS_SELF_SCAN,
+                            LocalPath::fromPlatformEncodedRelative(name));
+
+        result |= Waiter::NEEDEXEC;
+    }
+
+    return result;
+}
+
+#endif // ENABLE_SYNC
+
 // read all pending inotify events and queue them for processing
 int LinuxFileSystemAccess::checkevents([[maybe_unused]] Waiter* waiter)
 {
@@ -1011,9 +1249,6 @@ int LinuxFileSystemAccess::checkevents([[maybe_unused]] Waiter* waiter)
 
 #ifdef ENABLE_SYNC
 
-    if (mNotifyFd < 0)
-        return result;
-
     // Called so that related syncs perform a rescan.
     auto notifyTransientFailure = [&]() {
         for (auto* notifier : mNotifiers)
@@ -1022,101 +1257,81 @@ int LinuxFileSystemAccess::checkevents([[maybe_unused]] Waiter* waiter)
 
     auto* w = static_cast<PosixWaiter*>(waiter);
 
-    if (!MEGA_FD_ISSET(mNotifyFd, &w->rfds))
-        return result;
+#ifdef USE_FANOTIFY
+    if (mFanotifyFd >= 0 && MEGA_FD_ISSET(mFanotifyFd, &w->rfds))
+    {
+        readFanotifyEvents(
+            mFanotifyFd,
+            mEventBuffer,
+            [&](const fanotify_event_metadata& metadata, const string& key, const char* name)
+            {
+                if ((metadata.mask & FAN_Q_OVERFLOW))
+                {
+                    LOG_err << "fanotify FAN_Q_OVERFLOW";
 
-    char buf[sizeof(struct inotify_event) + NAME_MAX + 1];
-    ssize_t p, l;
-    inotify_event* in;
-    WatchMapIterator it;
-    string localpath;
+                    notifyTransientFailure();
+                    return;
+                }
 
-    auto notifyAll = [&](int handle, const string& name)
-    {
-        // Loop over and notify all associated nodes.
-        auto associated = mWatches.equal_range(handle);
+                // Events anywhere on a marked filesystem are reported
+                // but we only care about those in our syncs.
+                auto it = mFanotifyHandles.find(key);
 
-        for (auto i = associated.first; i != associated.second;)
-        {
-            // Convenience.
-            using std::move;
-            auto& node = *i->second.first;
-            auto& sync = *node.sync;
-            auto& notifier = *sync.dirnotify;
+                if (it == mFanotifyHandles.end())
+                    return;
 
-            LOG_debug << "Filesystem notification:"
-                << " Root: "
-                << node.localname
-                << " Path: "
-                << name;
+                LOG_verbose << "Filesystem notification:"
+                    << " event " << name << ": " << std::hex << metadata.mask;
 
-            if ((in->mask & IN_DELETE_SELF))
-            {
-                // The FS directory watched is gone
-                node.mWatchHandle.invalidate();
-                // Remove it from the container (C++11 and up)
-                i = mWatches.erase(i);
-            }
-            else
-            {
-                ++i;
-            }
+                auto handle = it->second;
+                auto deletedSelf = (metadata.mask & FAN_DELETE_SELF) != 0;
 
-            auto localName = LocalPath::fromPlatformEncodedRelative(name);
-            notifier.notify(notifier.fsEventq,
-                            &node,
-                            Notification::NEEDS_PARENT_SCAN,
-                            std::move(localName));
-
-            // We need to rescan the directory if it's changed permissions.
-            //
-            // The reason for this is that we may not have been able to list
-            // the directory's contents before. If we didn't rescan, we
-            // wouldn't notice these files until some other event is
-            // triggered in or below this directory.
-            if (in->mask == (IN_ATTRIB | IN_ISDIR))
-                notifier.notify(notifier.fsEventq,
-                                &node,
-                                Notification::FOLDER_NEEDS_SELF_SCAN,
-                                LocalPath::fromPlatformEncodedRelative(name));
-
-            result |= Waiter::NEEDEXEC;
-        }
-    };
+                result |= notifyAll(mFanotifyWatches,
+                                    handle,
+                                    name,
+                                    deletedSelf,
+                                    metadata.mask == (FAN_ATTRIB | FAN_ONDIR));
 
-    while ((l = read(mNotifyFd, buf, sizeof buf)) > 0)
-    {
-        for (p = 0; p < l; p += offsetof(inotify_event, name) + in->len)
-        {
-            in = (inotify_event*)(buf + p);
+                // The directory's gone so we can forget it.
+                if (deletedSelf)
+                {
+                    mFanotifyHandles.erase(it);
+                    mFanotifyKeys.erase(handle);
+                }
+            });
+    }
+#endif // USE_FANOTIFY
+
+    if (mNotifyFd < 0 || !MEGA_FD_ISSET(mNotifyFd, &w->rfds))
+        return result;
 
-            if ((in->mask & (IN_Q_OVERFLOW | IN_UNMOUNT)))
+    readInotifyEvents(
+        mNotifyFd,
+        mEventBuffer,
+        [&](const inotify_event& in)
+        {
+            if ((in.mask & (IN_Q_OVERFLOW | IN_UNMOUNT)))
             {
                 LOG_err << "inotify "
-                    << (in->mask & IN_Q_OVERFLOW ? "IN_Q_OVERFLOW" : "IN_UNMOUNT");
+                    << (in.mask & IN_Q_OVERFLOW ? "IN_Q_OVERFLOW" : "IN_UNMOUNT");
 
                 notifyTransientFailure();
             }
 
-            // this flag was introduced in glibc 2.13 and Linux 2.6.36 (released October 20, 2010)
-#ifndef IN_EXCL_UNLINK
-#define IN_EXCL_UNLINK 0x04000000
-#endif
-            if ((in->mask & (IN_ATTRIB | IN_CREATE | IN_DELETE_SELF | IN_DELETE | IN_MOVED_FROM
+            if ((in.mask & (IN_ATTRIB | IN_CREATE | IN_DELETE_SELF | IN_DELETE | IN_MOVED_FROM
                 | IN_MOVED_TO | IN_CLOSE_WRITE | IN_EXCL_UNLINK)))
             {
                 LOG_verbose << "Filesystem notification:"
-                    << " event " << in->name << ": " << std::hex << in->mask;
-                it = mWatches.find(in->wd);
-
-                if (it != mWatches.end())
-                {
-                    // What nodes are associated with this handle?
-                    notifyAll(it->first, in->len? in->name : "");
-                }
+                    << " event " << in.name << ": " << std::hex << in.mask;
+
+                // What nodes are associated with this handle?
+                result |= notifyAll(mWatches,
+                                    in.wd,
+                                    in.len ? in.name : "",
+                                    (in.mask & IN_DELETE_SELF) != 0,
+                                    in.mask == (IN_ATTRIB | IN_ISDIR));
             }
-        }
-    }
+        });
 
 #endif // ENABLE_SYNC
 
@@ -1764,14 +1979,106 @@ LinuxDirNotify::LinuxDirNotify(LinuxFileSystemAccess& owner,
     // Did our owner initialize correctly?
     if (owner.mNotifyFd >= 0)
         setFailed(0, "");
+
+#ifdef USE_FANOTIFY
+    if (owner.mFanotifyFd < 0)
+        return;
+
+    string fsid;
+
+    if (!LinuxFileSystemAccess::fanotifyFsid(rootPath, fsid) || !markFilesystem(fsid, rootPath))
+        return;
+
+    mFanotifyFsid = std::move(fsid);
+
+    setFailed(0, "");
+#endif // USE_FANOTIFY
 }
 
 LinuxDirNotify::~LinuxDirNotify()
 {
+#ifdef USE_FANOTIFY
+    // Unmark our filesystems if no other notifier relies on them.
+    if (!mFanotifyFsid.empty())
+        unmarkFilesystem(mFanotifyFsid, localbasepath);
+
+    for (auto& mark : mOtherFanotifyMarks)
+        unmarkFilesystem(mark.first, mark.second);
+#endif // USE_FANOTIFY
+
     // Remove ourselves from our owner's list of notiifers.
     mOwner.mNotifiers.erase(mNotifiersIt);
 }
 
+#ifdef USE_FANOTIFY
+
+bool LinuxDirNotify::markFilesystem(const string& fsid, const LocalPath& path)
+{
+    // Is the filesystem already marked?
+    auto& marks = mOwner.mFanotifyMarks[fsid];
+
+    if (!marks && fanotify_mark(mOwner.mFanotifyFd,
+                                FAN_MARK_ADD | FAN_MARK_FILESYSTEM,
+                                LinuxFileSystemAccess::FANOTIFY_EVENTS,
+                                AT_FDCWD,
+                                path.toPath(false).c_str()))
+    {
+        LOG_warn << "Unable to mark filesystem for fanotify events, monitoring "
+                 << path << " with inotify: " << errno;
+
+        mOwner.mFanotifyMarks.erase(fsid);
+        return false;
+    }
+
+    ++marks;
+
+    return true;
+}
+
+void LinuxDirNotify::unmarkFilesystem(const string& fsid, const LocalPath& path)
+{
+    auto mark = mOwner.mFanotifyMarks.find(fsid);
+
+    if (mark == mOwner.mFanotifyMarks.end() || --mark->second)
+        return;
+
+    if (fanotify_mark(mOwner.mFanotifyFd,
+                      FAN_MARK_REMOVE | FAN_MARK_FILESYSTEM,
+                      LinuxFileSystemAccess::FANOTIFY_EVENTS,
+                      AT_FDCWD,
+                      path.toPath(false).c_str()))
+    {
+        LOG_verbose << "Unable to remove fanotify mark for " << path << ": " << errno;
+    }
+
+    mOwner.mFanotifyMarks.erase(mark);
+}
+
+bool LinuxDirNotify::fanotifyFilesystem(const LocalPath& path, string& fsid)
+{
+    if (mFanotifyFsid.empty() || !LinuxFileSystemAccess::fanotifyFsid(path, fsid))
+        return false;
+
+    if (fsid == mFanotifyFsid || mOtherFanotifyMarks.count(fsid))
+        return true;
+
+    // Another filesystem is mounted within our sync.
+    if (mUnmarkedFilesystems.count(fsid))
+        return false;
+
+    if (!markFilesystem(fsid, path))
+    {
+        mUnmarkedFilesystems.emplace(fsid);
+        return false;
+    }
+
+    mOtherFanotifyMarks.emplace(fsid, path);
+
+    return true;
+}
+
+#endif // USE_FANOTIFY
+
 #if defined(USE_INOTIFY)
 
 AddWatchResult LinuxDirNotify::addWatch(LocalNode& node,
@@ -1783,15 +2090,46 @@ AddWatchResult LinuxDirNotify::addWatch(LocalNode& node,
 
     assert(node.type == FOLDERNODE);
 
+#ifdef USE_FANOTIFY
+    // The directory's filesystem is marked so all we need is a way to
+    // recognize the directory in the events reported.
+    if (string filesystem; fanotifyFilesystem(path, filesystem))
+    {
+        auto& watches = mOwner.mFanotifyWatches;
+
+        string key;
+
+        if (!LinuxFileSystemAccess::fanotifyKey(path, filesystem, key))
+        {
+            LOG_warn << "Unable to identify path for filesystem notifications: "
+                     << path.toPath(false).c_str() << ": Error: " << errno;
+
+            return make_pair(watches.end(), WR_FAILURE);
+        }
+
+        auto handle = mOwner.mFanotifyHandles.emplace(std::move(key), 0);
+
+        if (handle.second)
+        {
+            handle.first->second = --mOwner.mNextFanotifyHandle;
+            mOwner.mFanotifyKeys.emplace(handle.first->second, handle.first->first);
+        }
+
+        auto entry =
+            watches.emplace(piecewise_construct,
+                forward_as_tuple(handle.first->second),
+                forward_as_tuple(&node, fsid));
+
+        return make_pair(entry, WR_SUCCESS);
+    }
+#endif // USE_FANOTIFY
+
     // Convenience.
     auto& watches = mOwner.mWatches;
 
-    auto handle =
-        inotify_add_watch(mOwner.mNotifyFd,
-                          path.toPath(false).c_str(),
-                          IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_DELETE_SELF |
-                              IN_EXCL_UNLINK | IN_MOVED_FROM // event->cookie set as IN_MOVED_TO
-                              | IN_MOVED_TO | IN_ONLYDIR);
+    auto handle = inotify_add_watch(mOwner.mNotifyFd,
+                                    path.toPath(false).c_str(),
+                                    LinuxFileSystemAccess::INOTIFY_EVENTS);
 
     if (handle >= 0)
     {
@@ -1816,6 +2154,29 @@ AddWatchResult LinuxDirNotify::addWatch(LocalNode& node,
 void LinuxDirNotify::removeWatch(WatchMapIterator entry)
 {
     LOG_verbose << "removeWatch for handle: " << entry->first;
+
+#ifdef USE_FANOTIFY
+    // Directories monitored through fanotify have negative handles.
+    if (entry->first < 0)
+    {
+        auto handle = entry->first;
+
+        mOwner.mFanotifyWatches.erase(entry);
+
+        // Forget the directory once no node is associated with it.
+        if (mOwner.mFanotifyWatches.count(handle))
+            return;
+
+        auto key = mOwner.mFanotifyKeys.find(handle);
+        assert(key != mOwner.mFanotifyKeys.end());
+
+        mOwner.mFanotifyHandles.erase(key->second);
+        mOwner.mFanotifyKeys.erase(key);
+
+        return;
+    }
+#endif // USE_FANOTIFY
+
     auto& watches = mOwner.mWatches;
 
     auto handle = entry->first;
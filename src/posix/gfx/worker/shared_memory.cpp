@@ -0,0 +1,122 @@
+#include "mega/posix/gfx/worker/shared_memory.h"
+
+#include "mega/logging.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+// Names are kept short as macOS limits them to 31 characters.
+const std::string NAME_PREFIX{"/mega_gfx_"};
+}
+
+namespace mega {
+namespace gfx {
+
+SharedMemory::SharedMemory(const std::string& name, void* data, size_t size, bool owner)
+    : mName(name)
+    , mData(static_cast<char*>(data))
+    , mSize(size)
+    , mOwner(owner)
+{
+}
+
+SharedMemory::~SharedMemory()
+{
+    munmap(mData, mSize);
+
+    if (mOwner)
+    {
+        shm_unlink(mName.c_str());
+    }
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::create(size_t size)
+{
+    const auto name = newName();
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+        LOG_err << "Couldn't create shared memory " << name << ": " << strerror(errno);
+        return nullptr;
+    }
+
+    // Pages are only backed once written, so the size can be generous.
+    void* data = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+    {
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+
+    const int error = errno;
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        LOG_err << "Couldn't map shared memory " << name << ": " << strerror(error);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    return std::unique_ptr<SharedMemory>(new SharedMemory(name, data, size, true));
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::open(const std::string& name, size_t size)
+{
+    // Only regions created by create()
+    if (!isValidName(name) || !size)
+    {
+        LOG_err << "Invalid shared memory " << name;
+        return nullptr;
+    }
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+    {
+        LOG_err << "Couldn't open shared memory " << name << ": " << strerror(errno);
+        return nullptr;
+    }
+
+    struct stat attributes;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &attributes) == 0 && static_cast<size_t>(attributes.st_size) >= size)
+    {
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        LOG_err << "Couldn't map shared memory " << name;
+        return nullptr;
+    }
+
+    return std::unique_ptr<SharedMemory>(new SharedMemory(name, data, size, false));
+}
+
+bool SharedMemory::isValidName(const std::string& name)
+{
+    return name.size() > NAME_PREFIX.size() && name.compare(0, NAME_PREFIX.size(), NAME_PREFIX) == 0 &&
+           name.find('/', 1) == std::string::npos;
+}
+
+std::string SharedMemory::newName()
+{
+    static std::atomic<unsigned> counter{0};
+
+    std::ostringstream oss;
+    oss << NAME_PREFIX << getpid() << "_" << counter++;
+    return oss.str();
+}
+
+} // namespace gfx
+} // namespace mega
@@ -362,6 +362,8 @@ CurlHttpIO::CurlHttpIO()
     curltimeoutreset[PUT] = -1;
     arerequestspaused[PUT] = false;
 
+    setmultiplexing();
+
     curlsh = curl_share_init();
     curl_share_setopt(curlsh, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
     curl_share_setopt(curlsh, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
@@ -498,7 +500,7 @@ void CurlHttpIO::processcurlevents(direction_t d)
 #endif
     }
 
-    if (curltimeoutreset[d] >= 0 && curltimeoutreset[d] <= Waiter::ds)
+    if (curltimeoutreset[d] >= 0 && curltimeoutreset[d] <= m_clock_getmonotonictimeMS())
     {
         curltimeoutreset[d] = -1;
         NET_debug << "Informing cURL of timeout reached for " << d << " at " << Waiter::ds;
@@ -522,6 +524,7 @@ void CurlHttpIO::processcurlevents(direction_t d)
 CurlHttpIO::~CurlHttpIO()
 {
     disconnecting = true;
+    cancelprewarm();
     curl_multi_cleanup(curlm[API]);
     curl_multi_cleanup(curlm[GET]);
     curl_multi_cleanup(curlm[PUT]);
@@ -576,6 +579,7 @@ void CurlHttpIO::disconnect()
     disconnecting = true;
     assert(!numconnections[API] && !numconnections[GET] && !numconnections[PUT]);
 
+    cancelprewarm();
     curl_multi_cleanup(curlm[API]);
     curl_multi_cleanup(curlm[GET]);
     curl_multi_cleanup(curlm[PUT]);
@@ -623,6 +627,8 @@ void CurlHttpIO::disconnect()
     curltimeoutreset[PUT] = -1;
     arerequestspaused[PUT] = false;
 
+    setmultiplexing();
+
     disconnecting = false;
     if (proxyurl.size() && !proxyip.size())
     {
@@ -710,6 +716,311 @@ int CurlHttpIO::cacheresolvedurls(const std::vector<string>& urls, const std::ve
     return result;
 }
 
+void CurlHttpIO::prewarm(const string& url, direction_t d)
+{
+    if (d != GET && d != PUT)
+    {
+        return;
+    }
+
+    if (proxyurl.size())
+    {
+        // the connection would have to be set up exactly as send_request() does for the proxy
+        LOG_verbose << "Skipping connection prewarming through a proxy";
+        return;
+    }
+
+    string scheme;
+    string host;
+    int port;
+
+    if (!crackURI(url, scheme, host, port) || host.empty())
+    {
+        return;
+    }
+
+    string target = scheme + "://" + host + ":" + std::to_string(port) + "/";
+
+    auto it = prewarmedhosts[d].find(target);
+    if (it != prewarmedhosts[d].end() && Waiter::ds - it->second < PREWARM_VALIDITY_DS)
+    {
+        return;
+    }
+
+    CURL* curl = curl_easy_init();
+    if (!curl)
+    {
+        return;
+    }
+
+    prewarmedhosts[d][target] = Waiter::ds;
+
+    // a HEAD request on the root of the host leaves an idle, TLS-established
+    // connection in the multi handle's pool that the first chunk request reuses.
+    // The SSL options must match the ones in send_request() for unprotected
+    // requests, otherwise cURL won't consider the connection (nor the session) reusable.
+    curl_easy_setopt(curl, CURLOPT_URL, target.c_str());
+    curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, useragent.c_str());
+    curl_easy_setopt(curl, CURLOPT_SHARE, curlsh);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, true);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, HttpIO::CONNECTTIMEOUT / 10);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, 90L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 60L);
+    curl_easy_setopt(curl, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2 | CURL_SSLVERSION_MAX_TLSv1_2);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0);
+    curl_easy_setopt(curl, CURLOPT_CAINFO, NULL);
+    curl_easy_setopt(curl, CURLOPT_CAPATH, NULL);
+    curl_easy_setopt(curl, CURLOPT_QUICK_EXIT, 1L);
+    sethttpversion(curl, host);
+
+    if (proxytype == Proxy::NONE)
+    {
+        curl_easy_setopt(curl, CURLOPT_PROXY, "");
+    }
+
+    if (!dnsservers.empty())
+    {
+        curl_easy_setopt(curl, CURLOPT_DNS_SERVERS, dnsservers.c_str());
+    }
+
+    PrewarmContext& context = prewarmrequests[curl];
+    context.d = d;
+
+    auto dnsEntry = dnscache.find(host);
+    if (dnsEntry != dnscache.end() && !dnsEntry->second.ipv4.empty())
+    {
+        addDnsResolution(curl, context.dnsList, host, dnsEntry->second.ipv4, port);
+    }
+
+    LOG_debug << "Prewarming connection to " << target << " for "
+              << (d == GET ? "downloads" : "uploads");
+
+    curl_multi_add_handle(curlm[d], curl);
+    statechange = true;
+}
+
+void CurlHttpIO::cancelprewarm()
+{
+    for (auto& request: prewarmrequests)
+    {
+        curl_multi_remove_handle(curlm[request.second.d], request.first);
+        curl_easy_cleanup(request.first);
+    }
+
+    prewarmrequests.clear();
+    prewarmedhosts[GET].clear();
+    prewarmedhosts[PUT].clear();
+}
+
+bool CurlHttpIO::setHttp2(bool enable)
+{
+    if (enable && !(curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2))
+    {
+        LOG_warn << "cURL built without HTTP/2 support";
+        return false;
+    }
+
+    LOG_debug << "HTTP/2 " << (enable ? "enabled" : "disabled");
+
+    http2 = enable;
+    http2errors.clear();
+    setmultiplexing();
+    return true;
+}
+
+void CurlHttpIO::setmultiplexing()
+{
+    long pipelining = http2 ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING;
+
+    curl_multi_setopt(curlm[API], CURLMOPT_PIPELINING, pipelining);
+    curl_multi_setopt(curlm[GET], CURLMOPT_PIPELINING, pipelining);
+    curl_multi_setopt(curlm[PUT], CURLMOPT_PIPELINING, pipelining);
+}
+
+void CurlHttpIO::sethttpversion(CURL* curl, const string& hostname)
+{
+    // HTTP/1.1 unless HTTP/2 was enabled, as connections aren't multiplexed then
+    // (cURL's own default would negotiate HTTP/2 with servers supporting it)
+    auto it = http2errors.find(hostname);
+
+    if (!http2 || (it != http2errors.end() && it->second >= MAX_HTTP2_ERRORS))
+    {
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+        return;
+    }
+
+    // ALPN selects HTTP/2 if the server supports it and HTTP/1.1 otherwise
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+
+    // rather than opening a connection for each concurrent request, wait for the
+    // one being established to the host to find out whether it can be multiplexed
+    curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+}
+
+void serializeTlsSessions(const std::vector<TlsSession>& sessions, std::string& data)
+{
+    CacheableWriter writer(data);
+
+    writer.serializeu8(1); // version
+    writer.serializeu32(static_cast<uint32_t>(sessions.size()));
+
+    for (auto& session: sessions)
+    {
+        writer.serializestring_u32(session.key);
+        writer.serializestring_u32(session.shmac);
+        writer.serializestring_u32(session.data);
+        writer.serializei64(session.validUntil);
+    }
+}
+
+bool unserializeTlsSessions(const std::string& data,
+                            m_time_t now,
+                            std::vector<TlsSession>& sessions)
+{
+    CacheableReader reader(data);
+
+    uint8_t version = 0;
+    uint32_t count = 0;
+
+    if (!reader.unserializeu8(version) || version != 1 || !reader.unserializeu32(count))
+    {
+        return false;
+    }
+
+    std::vector<TlsSession> result;
+
+    while (count--)
+    {
+        TlsSession session;
+
+        if (!reader.unserializestring_u32(session.key) ||
+            !reader.unserializestring_u32(session.shmac) ||
+            !reader.unserializestring_u32(session.data) ||
+            !reader.unserializei64(session.validUntil))
+        {
+            return false;
+        }
+
+        if (session.validUntil > now)
+        {
+            result.emplace_back(std::move(session));
+        }
+    }
+
+    sessions = std::move(result);
+    return true;
+}
+
+#ifdef CURL_VERSION_SSLS_EXPORT
+static bool canExportTlsSessions()
+{
+    return (curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_SSLS_EXPORT) != 0;
+}
+#endif
+
+bool CurlHttpIO::exportTlsSessions([[maybe_unused]] string& data)
+{
+#ifdef CURL_VERSION_SSLS_EXPORT
+    if (!canExportTlsSessions())
+    {
+        return false;
+    }
+
+    std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl(curl_easy_init(), curl_easy_cleanup);
+    if (!curl)
+    {
+        return false;
+    }
+
+    // the sessions live in the share object, any handle attached to it can export them
+    curl_easy_setopt(curl.get(), CURLOPT_SHARE, curlsh);
+
+    std::vector<TlsSession> sessions;
+
+    auto collect = [](CURL*,
+                      void* userptr,
+                      const char* sessionKey,
+                      const unsigned char* shmac,
+                      size_t shmacLen,
+                      const unsigned char* sdata,
+                      size_t sdataLen,
+                      curl_off_t validUntil,
+                      int,
+                      const char*,
+                      size_t) -> CURLcode
+    {
+        TlsSession session;
+        session.key = sessionKey ? sessionKey : "";
+        session.shmac.assign(reinterpret_cast<const char*>(shmac), shmacLen);
+        session.data.assign(reinterpret_cast<const char*>(sdata), sdataLen);
+        session.validUntil = static_cast<m_time_t>(validUntil);
+        static_cast<std::vector<TlsSession>*>(userptr)->emplace_back(std::move(session));
+        return CURLE_OK;
+    };
+
+    if (CURLcode e = curl_easy_ssls_export(curl.get(), collect, &sessions); e != CURLE_OK)
+    {
+        LOG_warn << "Unable to export TLS sessions: " << curl_easy_strerror(e);
+        return false;
+    }
+
+    data.clear();
+    serializeTlsSessions(sessions, data);
+
+    LOG_debug << "Exported " << sessions.size() << " TLS sessions";
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CurlHttpIO::importTlsSessions([[maybe_unused]] const string& data)
+{
+#ifdef CURL_VERSION_SSLS_EXPORT
+    if (!canExportTlsSessions())
+    {
+        return false;
+    }
+
+    std::vector<TlsSession> sessions;
+    if (!unserializeTlsSessions(data, m_time(), sessions))
+    {
+        LOG_warn << "Discarding malformed TLS session cache";
+        return false;
+    }
+
+    std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl(curl_easy_init(), curl_easy_cleanup);
+    if (!curl)
+    {
+        return false;
+    }
+
+    curl_easy_setopt(curl.get(), CURLOPT_SHARE, curlsh);
+
+    size_t imported = 0;
+    for (auto& session: sessions)
+    {
+        if (curl_easy_ssls_import(curl.get(),
+                                  session.key.empty() ? nullptr : session.key.c_str(),
+                                  reinterpret_cast<const unsigned char*>(session.shmac.data()),
+                                  session.shmac.size(),
+                                  reinterpret_cast<const unsigned char*>(session.data.data()),
+                                  session.data.size()) == CURLE_OK)
+        {
+            ++imported;
+        }
+    }
+
+    LOG_debug << "Imported " << imported << " of " << sessions.size() << " TLS sessions";
+    return true;
+#else
+    return false;
+#endif
+}
+
 // wake up from cURL I/O
 void CurlHttpIO::addevents(Waiter* w, int)
 {
@@ -719,6 +1030,7 @@ void CurlHttpIO::addevents(Waiter* w, int)
 
     waiter = (WAIT_CLASS*)w;
     long curltimeoutms = -1;
+    m_time_t nowms = m_clock_getmonotonictimeMS();
 
     addcurlevents(waiter, API);
 
@@ -728,16 +1040,16 @@ void CurlHttpIO::addevents(Waiter* w, int)
 
     if (curltimeoutreset[API] >= 0)
     {
-        m_time_t ds = curltimeoutreset[API] - Waiter::ds;
-        if (ds <= 0)
+        m_time_t ms = curltimeoutreset[API] - nowms;
+        if (ms <= 0)
         {
             curltimeoutms = 0;
         }
         else
         {
-            if (curltimeoutms < 0 || curltimeoutms > ds * 100)
+            if (curltimeoutms < 0 || curltimeoutms > ms)
             {
-                curltimeoutms = long(ds * 100);
+                curltimeoutms = long(ms);
             }
         }
     }
@@ -756,16 +1068,16 @@ void CurlHttpIO::addevents(Waiter* w, int)
             addcurlevents(waiter, (direction_t)d);
             if (curltimeoutreset[d] >= 0)
             {
-                m_time_t ds = curltimeoutreset[d] - Waiter::ds;
-                if (ds <= 0)
+                m_time_t ms = curltimeoutreset[d] - nowms;
+                if (ms <= 0)
                 {
                     curltimeoutms = 0;
                 }
                 else
                 {
-                    if (curltimeoutms < 0 || curltimeoutms > ds * 100)
+                    if (curltimeoutms < 0 || curltimeoutms > ms)
                     {
-                        curltimeoutms = long(ds * 100);
+                        curltimeoutms = long(ms);
                     }
                 }
             }
@@ -780,16 +1092,9 @@ void CurlHttpIO::addevents(Waiter* w, int)
 
     if (curltimeoutms >= 0)
     {
-        m_time_t timeoutds = curltimeoutms / 100;
-        if (curltimeoutms % 100)
-        {
-            timeoutds++;
-        }
-
-        if (timeoutds < waiter->maxds)
-        {
-            waiter->maxds = dstime(timeoutds);
-        }
+        // curl often asks to be called back within a few milliseconds (connecting,
+        // resolving, retransmitting): don't round that up to a whole decisecond
+        waiter->wakeupwithin(std::chrono::milliseconds(curltimeoutms));
     }
 }
 
@@ -920,6 +1225,8 @@ void CurlHttpIO::send_request(CurlHttpContext* httpctx)
         // Some networks (eg vodafone UK) seem to block TLS 1.3 ClientHello.  1.2 is secure, and works:
         curl_easy_setopt(curl, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2 | CURL_SSLVERSION_MAX_TLSv1_2);
 
+        httpio->sethttpversion(curl, httpctx->hostname);
+
         if (httpio->maxspeed[GET] && httpio->maxspeed[GET] <= 102400)
         {
             LOG_debug << "Low maxspeed, set curl buffer size to 4 KB";
@@ -1378,6 +1685,18 @@ bool CurlHttpIO::multidoio(CURLM *curlmhandle)
                     LOG_debug << req->getLogName() << "CURLMSG_DONE with error " << errorCode
                               << ": " << curl_easy_strerror(errorCode);
 
+                    if (http2 && req->httpiohandle &&
+                        (errorCode == CURLE_HTTP2 || errorCode == CURLE_HTTP2_STREAM))
+                    {
+                        const string& hostname = ((CurlHttpContext*)req->httpiohandle)->hostname;
+
+                        if (++http2errors[hostname] == MAX_HTTP2_ERRORS)
+                        {
+                            LOG_warn << req->getLogName() << "Too many HTTP/2 errors with "
+                                     << hostname << ". Falling back to HTTP/1.1";
+                        }
+                    }
+
 #if LIBCURL_VERSION_NUM >= 0x072c00 // At least cURL 7.44.0
                     if (errorCode == CURLE_SSL_PINNEDPUBKEYNOTMATCH)
                     {
@@ -1445,6 +1764,15 @@ bool CurlHttpIO::multidoio(CURLM *curlmhandle)
                 long httpstatus;
                 curl_easy_getinfo(msg->easy_handle, CURLINFO_RESPONSE_CODE, &httpstatus);
                 req->httpstatus = int(httpstatus);
+
+                long newConnections = 0;
+                if (curl_easy_getinfo(msg->easy_handle, CURLINFO_NUM_CONNECTS, &newConnections) ==
+                        CURLE_OK &&
+                    newConnections > 0)
+                {
+                    newtlssessions = true;
+                }
+
                 // Get the used ip address, if any.
                 char* resolvedIpAddress = nullptr;
                 curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIMARY_IP, &resolvedIpAddress);
@@ -1526,6 +1854,16 @@ bool CurlHttpIO::multidoio(CURLM *curlmhandle)
                     dnsok = true;
                     lastdata = Waiter::ds;
                     req->lastdata = Waiter::ds;
+
+                    if (http2 && req->httpiohandle)
+                    {
+                        // only consecutive errors count towards the fallback to HTTP/1.1
+                        auto it = http2errors.find(((CurlHttpContext*)req->httpiohandle)->hostname);
+                        if (it != http2errors.end() && it->second < MAX_HTTP2_ERRORS)
+                        {
+                            http2errors.erase(it);
+                        }
+                    }
                 }
                 else
                 {
@@ -1562,6 +1900,12 @@ bool CurlHttpIO::multidoio(CURLM *curlmhandle)
         curl_multi_remove_handle(curlmhandle, msg->easy_handle);
         curl_easy_cleanup(msg->easy_handle);
 
+        if (!req)
+        {
+            // prewarming requests have no HttpReq, the connection stays in the pool
+            prewarmrequests.erase(msg->easy_handle);
+        }
+
         if (req)
         {
             inetstatus(req->httpstatus != 0);
@@ -1769,6 +2113,22 @@ size_t CurlHttpIO::write_data(void* ptr, size_t size, size_t nmemb, void* target
     return static_cast<size_t>(len);
 }
 
+// header names are case-insensitive (and always lowercase over HTTP/2)
+// returns a pointer to the value if the header line has the given name
+static const char* headervalue(const char* line, const char* name)
+{
+    for (; *name; ++line, ++name)
+    {
+        if (std::tolower(static_cast<unsigned char>(*line)) !=
+            std::tolower(static_cast<unsigned char>(*name)))
+        {
+            return nullptr;
+        }
+    }
+
+    return line;
+}
+
 // set contentlength according to Original-Content-Length header
 size_t CurlHttpIO::check_header(const char* ptr, size_t size, size_t nmemb, void* target)
 {
@@ -1807,26 +2167,26 @@ size_t CurlHttpIO::check_header(const char* ptr, size_t size, size_t nmemb, void
 
         return size * nmemb;
     }
-    else if ((val = Utils::startswith(ptr, "Content-Length:")) != nullptr)
+    else if ((val = headervalue(ptr, "Content-Length:")) != nullptr)
     {
         if (req->contentlength < 0)
         {
             req->setcontentlength(atoll(val));
         }
     }
-    else if ((val = Utils::startswith(ptr, "Original-Content-Length:")) != nullptr)
+    else if ((val = headervalue(ptr, "Original-Content-Length:")) != nullptr)
     {
         req->setcontentlength(atoll(val));
     }
-    else if ((val = Utils::startswith(ptr, "X-MEGA-Time-Left:")) != nullptr)
+    else if ((val = headervalue(ptr, "X-MEGA-Time-Left:")) != nullptr)
     {
         req->timeleft = atol(val);
     }
-    else if ((val = Utils::startswith(ptr, "Content-Type:")) != nullptr)
+    else if ((val = headervalue(ptr, "Content-Type:")) != nullptr)
     {
         req->contenttype.assign(val, len - 15); // length of "Content-Type:" + 2
     }
-    else if ((val = Utils::startswith(ptr, "X-Hashcash:")) != nullptr)
+    else if ((val = headervalue(ptr, "X-Hashcash:")) != nullptr)
     {
         const char* end = ptr + len - 3; // point to the char before CRLF terminator
         if (end - val < 4) // minimum hashcash len is 5
@@ -2010,13 +2370,7 @@ int CurlHttpIO::timer_callback(CURLM *, long timeout_ms, void *userp, direction_
     }
     else
     {
-        m_time_t timeoutds = timeout_ms / 100;
-        if (timeout_ms % 100)
-        {
-            timeoutds++;
-        }
-
-        httpio->curltimeoutreset[d] = Waiter::ds + timeoutds;
+        httpio->curltimeoutreset[d] = m_clock_getmonotonictimeMS() + timeout_ms;
     }
 
     // Networking seems to be fine after performance improvments, no need for this logging anymore - but keep it in comments for a while to inform people debugging older logs
@@ -85,33 +85,32 @@ bool PosixWaiter::fd_filter(int nfds, mega_fd_set_t* fds, mega_fd_set_t* ignoref
 }
 
 // wait for supplied events (sockets, filesystem changes), plus timeout + application events
-// maxds specifies the maximum amount of time to wait in deciseconds (or
-// NEVER if no timeout scheduled) returns application-specific bitmask.
+// timeoutms() specifies the maximum amount of time to wait in milliseconds (or
+// -1 if no timeout scheduled) returns application-specific bitmask.
 // bit 0 set indicates that exec() needs to be called.
 int PosixWaiter::wait()
 {
     int numfd = 0;
     timeval tv;
+    int64_t timeoutMs = timeoutms();
 
     //Pipe added to rfds to be able to leave select() when needed
     MEGA_FD_SET(m_pipe[0], &rfds);
 
     bumpmaxfd(m_pipe[0]);
 
-    if (EVER(maxds))
+    if (timeoutMs >= 0)
     {
-        dstime us = 1000000 / 10 * maxds;
-
-        tv.tv_sec = us / 1000000;
-        tv.tv_usec = (suseconds_t)(us - tv.tv_sec * 1000000);
+        tv.tv_sec = static_cast<time_t>(timeoutMs / 1000);
+        tv.tv_usec = static_cast<suseconds_t>(timeoutMs % 1000 * 1000);
     }
 
 #ifdef USE_POLL
-    // wait infinite (-1) if maxds is max dstime OR it would overflow platform's int
+    // wait infinite (-1) if there is no timeout OR it would overflow platform's int
     int timeoutInMs = -1;
-    if (EVER(maxds) && maxds <= std::numeric_limits<int>::max() / 100)
+    if (timeoutMs >= 0 && timeoutMs <= std::numeric_limits<int>::max())
     {
-        timeoutInMs = static_cast<int>(maxds) * 100;
+        timeoutInMs = static_cast<int>(timeoutMs);
     }
     auto total = rfds.size() + wfds.size() + efds.size();
     struct pollfd fds[total];
@@ -139,7 +138,7 @@ int PosixWaiter::wait()
     }
     numfd = poll(fds, total, timeoutInMs);
 #else
-    numfd = select(maxfd + 1, &rfds, &wfds, &efds, EVER(maxds) ? &tv : NULL);
+    numfd = select(maxfd + 1, &rfds, &wfds, &efds, timeoutMs >= 0 ? &tv : NULL);
 #endif
 
     // empty pipe
@@ -913,7 +913,7 @@ m_off_t& TransferBufferManager::transferPos(unsigned connectionNum)
 {
     return isRaid() ? RaidBufferManager::transferPos(connectionNum) : transfer->pos;
 }
-std::pair<m_off_t, m_off_t> TransferBufferManager::nextNPosForConnection(unsigned connectionNum, m_off_t maxRequestSize, unsigned connectionCount, bool& newInputBufferSupplied, bool& pauseConnectionForRaid, m_off_t uploadSpeed)
+std::pair<m_off_t, m_off_t> TransferBufferManager::nextNPosForConnection(unsigned connectionNum, m_off_t maxRequestSize, unsigned connectionCount, bool& newInputBufferSupplied, bool& pauseConnectionForRaid, m_off_t uploadSpeed, m_off_t targetRequestSize)
 {
     // returning a pair for clarity - specifying the beginning and end position of the next data block, as the 'current pos' may be updated during this function
     newInputBufferSupplied = false;
@@ -949,6 +949,11 @@ std::pair<m_off_t, m_off_t> TransferBufferManager::nextNPosForConnection(unsigne
             m_off_t speedsize = std::min<m_off_t>(maxsize, uploadSpeed * 2 / 3);        // two seconds of data over 3 connections
             m_off_t sizesize = transfer->size > largeSize ? 8 * 1024 * 1024 : 0; // start with large-ish portions for large files.
             m_off_t targetsize = std::max<m_off_t>(sizesize, speedsize);
+            if (targetRequestSize)
+            {
+                // the size was chosen from the measured throughput
+                targetsize = std::min<m_off_t>(maxsize, targetRequestSize);
+            }
             maxReqSize = targetsize;
         }
         else if (transfer->type == GET)
@@ -990,6 +995,15 @@ std::pair<m_off_t, m_off_t> TransferBufferManager::nextNPosForConnection(unsigne
                 }
                 maxReqSize += 1; // Same as above, needed for expandUnProcessedPiece to return a chunk padded to raid-line
             }
+            else if (targetRequestSize)
+            {
+                // Non raid, with the size chosen from the measured throughput.
+                // Still split what remains so the last parts are delivered in parallel.
+                m_off_t share = (transfer->size - transfer->progresscompleted) / connectionCount;
+                maxReqSize = std::min<m_off_t>({targetRequestSize,
+                                                maxRequestSize,
+                                                std::max<m_off_t>(share, 1)});
+            }
             else
             {
                 // Non raid
@@ -322,54 +322,70 @@ recentactions_vector RecentActions::getRecentActions(unsigned maxcount,
                                                      m_time_t since,
                                                      bool excludeSensitives) const
 {
-    sharedNode_vector v = mClient->mNodeManager.getRecentNodes(maxcount, since, excludeSensitives);
-    return buildFromNodes(std::move(v), excludeSensitives);
+    std::vector<RecentFile> files =
+        mClient->mNodeManager.getRecentFiles(maxcount, since, excludeSensitives);
+    return buildFromFiles(files, excludeSensitives);
 }
 
-recentactions_vector RecentActions::buildFromNodes(sharedNode_vector&& v,
+recentactions_vector RecentActions::buildFromFiles(const std::vector<RecentFile>& files,
                                                    bool excludeSensitives) const
 {
     recentactions_vector rav;
     std::unordered_map<std::string, size_t> bucketIndex;
+    std::vector<std::vector<NodeHandle>> bucketFiles;
 
-    for (const auto& node: v)
+    for (const auto& file: files)
     {
-        if (!node)
-        {
-            continue;
-        }
-
-        const handle parentHandle = node->parent ? node->parent->nodehandle : UNDEF;
-        const bool updated = mClient->getNumberOfChildren(node->nodeHandle()) > 0;
-        const bool media = mClient->nodeIsMedia(node.get(), nullptr, nullptr);
+        const handle parentHandle = file.parentHandle.as8byte();
 
-        const std::string key = buildRecentActionId(node->ctime,
-                                                    node->owner,
-                                                    parentHandle,
-                                                    media,
-                                                    updated,
-                                                    excludeSensitives);
+        std::string key = buildRecentActionId(file.ctime,
+                                              file.owner,
+                                              parentHandle,
+                                              file.media,
+                                              file.updated,
+                                              excludeSensitives);
 
         auto it = bucketIndex.find(key);
         if (it == bucketIndex.end())
         {
-            const User* user = mClient->finduser(node->owner, 0);
+            const User* user = mClient->finduser(file.owner, 0);
             const std::string email = user ? user->email : std::string();
 
             recentaction ra;
-            ra.time = node->ctime;
-            ra.meta.user = node->owner;
+            ra.time = file.ctime;
+            ra.meta.user = file.owner;
             ra.meta.userEmail = email;
             ra.meta.parent = parentHandle;
-            ra.meta.updated = updated;
-            ra.meta.media = media;
+            ra.meta.updated = file.updated;
+            ra.meta.media = file.media;
             ra.id = key;
             rav.push_back(std::move(ra));
+            bucketFiles.emplace_back();
             it = bucketIndex.emplace(std::move(key), rav.size() - 1).first;
         }
 
-        rav[it->second].nodes.push_back(node);
+        bucketFiles[it->second].push_back(file.nodeHandle);
     }
+
+    // load the nodes of each bucket, dropping any removed since the DB was queried
+    for (size_t i = 0; i < rav.size(); ++i)
+    {
+        for (const NodeHandle& h: bucketFiles[i])
+        {
+            if (auto node = mClient->mNodeManager.getNodeByHandle(h))
+            {
+                rav[i].nodes.push_back(std::move(node));
+            }
+        }
+    }
+    rav.erase(std::remove_if(rav.begin(),
+                             rav.end(),
+                             [](const recentaction& ra)
+                             {
+                                 return ra.nodes.empty();
+                             }),
+              rav.end());
+
     // sort nodes inside each bucket
     for (recentactions_vector::iterator i = rav.begin(); i != rav.end(); ++i)
     {
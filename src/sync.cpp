@@ -1150,10 +1150,11 @@ void UnifiedSync::changeState(SyncError newSyncError, bool newEnableFlag, bool n
                 // the user downgraded from SRW to NO SRW and then upgraded again to SRW) we need
                 // to remove the SRW db files. The flag DB_OPEN_FLAG_RECYCLE is used for this
                 // purpose. A similar case happens if user is upgrading from No Fingerprint virtual
-                // column in Nodes table to a newer version with this column.
+                // column in Nodes table to a newer version with this column, or to NodeRecords.
                 int dbFlags = DB_OPEN_FLAG_TRANSACTED; // Unused
                 if (DbAccess::LEGACY_DB_VERSION == DbAccess::LAST_DB_VERSION_WITHOUT_SRW ||
-                    DbAccess::LEGACY_DB_VERSION == DbAccess::LAST_DB_VERSION_WITHOUT_VFINGERPRINT)
+                    DbAccess::LEGACY_DB_VERSION == DbAccess::LAST_DB_VERSION_WITHOUT_VFINGERPRINT ||
+                    DbAccess::LEGACY_DB_VERSION == DbAccess::LAST_DB_VERSION_WITHOUT_NODE_RECORD)
                 {
                     dbFlags |= DB_OPEN_FLAG_RECYCLE;
                 }
@@ -5691,11 +5692,13 @@ error Syncs::syncConfigStoreLoad(SyncConfigVector& configs)
                     // SRW) we need to remove the SRW db files. The flag DB_OPEN_FLAG_RECYCLE is
                     // used for this purpose. A similar case happens if user is upgrading from No
                     // Fingerprint virtual column in Nodes table to a newer version with this
-                    // column.
+                    // column, or to NodeRecords.
                     int dbFlags = DB_OPEN_FLAG_TRANSACTED; // Unused
                     if (DbAccess::LEGACY_DB_VERSION == DbAccess::LAST_DB_VERSION_WITHOUT_SRW ||
                         DbAccess::LEGACY_DB_VERSION ==
-                            DbAccess::LAST_DB_VERSION_WITHOUT_VFINGERPRINT)
+                            DbAccess::LAST_DB_VERSION_WITHOUT_VFINGERPRINT ||
+                        DbAccess::LEGACY_DB_VERSION ==
+                            DbAccess::LAST_DB_VERSION_WITHOUT_NODE_RECORD)
                     {
                         dbFlags |= DB_OPEN_FLAG_RECYCLE;
                     }
@@ -8052,85 +8055,64 @@ auto Sync::computeSyncTriplets(vector<CloudNode>& cloudNodes, const LocalNode& s
     for (auto& sn : syncParent.children) triplets.emplace_back(nullptr, sn.second, nullptr);
     for (auto& fsn : fsNodes)            triplets.emplace_back(nullptr, nullptr, &fsn);
 
-    auto tripletCompare = [this](const SyncRow& lhs, const SyncRow& rhs) -> int {
-        // Sanity.
-        assert(!lhs.fsNode || !lhs.fsNode->localname.empty());
-        assert(!rhs.fsNode || !rhs.fsNode->localname.empty());
-        assert(!lhs.syncNode || !lhs.syncNode->localname.empty());
-        assert(!rhs.syncNode || !rhs.syncNode->localname.empty());
+    // Although it would be great to efficiently compare cloud names in utf8 directly against filesystem names
+    // in utf16, without any conversions or copied and manipulated strings, unfortunately we have
+    // a few obstacles to that.  Mainly, that the utf8 encoding can differ - especially on Mac
+    // where they normalize the names that go to the filesystem, but with a different normalization
+    // than we chose for the Node names.  In order to compare these effectively and efficiently
+    // we pretty much have to first duplicate and convert both strings to a single utf8 normalization first.
+    //
+    // That's done once per row here, along with a collation key to sort by, rather than on every comparison.
+    vector<std::pair<UtfCollationKey, size_t>> keys;
+    keys.reserve(triplets.size());
 
-        // Although it would be great to efficiently compare cloud names in utf8 directly against filesystem names
-        // in utf16, without any conversions or copied and manipulated strings, unfortunately we have
-        // a few obstacles to that.  Mainly, that the utf8 encoding can differ - especially on Mac
-        // where they normalize the names that go to the filesystem, but with a different normalization
-        // than we chose for the Node names.  In order to compare these effectively and efficiently
-        // we pretty much have to first duplicate and convert both strings to a single utf8 normalization first.
+    for (size_t i = 0; i < triplets.size(); ++i)
+    {
+        auto& row = triplets[i];
 
-        if (lhs.cloudNode)
+        // Sanity.
+        assert(!row.fsNode || !row.fsNode->localname.empty());
+        assert(!row.syncNode || !row.syncNode->localname.empty());
+
+        if (row.cloudNode)
         {
-            if (rhs.cloudNode)
-            {
-                return compareUtf(lhs.cloudNode->name, true, rhs.cloudNode->name, true, mCaseInsensitive);
-            }
-            else if (rhs.syncNode)
-            {
-                return compareUtf(lhs.cloudNode->name, true, rhs.syncNode->toName_of_localname, false, mCaseInsensitive);
-            }
-            else // rhs.fsNode
-            {
-                return compareUtf(lhs.cloudNode->name, true, rhs.fsNode->toName_of_localname(*syncs.fsaccess), false, mCaseInsensitive);
-            }
+            keys.emplace_back(UtfCollationKey(row.cloudNode->name, true, mCaseInsensitive), i);
         }
-        else if (lhs.syncNode)
+        else if (row.syncNode)
         {
-            if (rhs.cloudNode)
-            {
-                return compareUtf(lhs.syncNode->toName_of_localname, false, rhs.cloudNode->name, true, mCaseInsensitive);
-            }
-            else if (rhs.syncNode)
-            {
-                return compareUtf(lhs.syncNode->toName_of_localname, false, rhs.syncNode->toName_of_localname, false, mCaseInsensitive);
-            }
-            else // rhs.fsNode
-            {
-                return compareUtf(lhs.syncNode->toName_of_localname, false, rhs.fsNode->toName_of_localname(*syncs.fsaccess), false, mCaseInsensitive);
-            }
+            keys.emplace_back(UtfCollationKey(row.syncNode->toName_of_localname, false, mCaseInsensitive), i);
         }
-        else // lhs.fsNode
+        else
         {
-            if (rhs.cloudNode)
-            {
-                return compareUtf(lhs.fsNode->toName_of_localname(*syncs.fsaccess), false, rhs.cloudNode->name, true, mCaseInsensitive);
-            }
-            else if (rhs.syncNode)
-            {
-                return compareUtf(lhs.fsNode->toName_of_localname(*syncs.fsaccess), false, rhs.syncNode->toName_of_localname, false, mCaseInsensitive);
-            }
-            else // rhs.fsNode
-            {
-                return compareUtf(lhs.fsNode->toName_of_localname(*syncs.fsaccess), false, rhs.fsNode->toName_of_localname(*syncs.fsaccess), false, mCaseInsensitive);
-            }
+            keys.emplace_back(UtfCollationKey(row.fsNode->toName_of_localname(*syncs.fsaccess), false, mCaseInsensitive), i);
         }
-    };
+    }
+
+    std::sort(keys.begin(), keys.end(),
+           [](const std::pair<UtfCollationKey, size_t>& lhs, const std::pair<UtfCollationKey, size_t>& rhs)
+           { return lhs.first.compare(rhs.first) < 0; });
 
-    std::sort(triplets.begin(), triplets.end(),
-           [=](const SyncRow& lhs, const SyncRow& rhs)
-           { return tripletCompare(lhs, rhs) < 0; });
+    vector<SyncRow> sorted;
+    sorted.reserve(triplets.size());
 
-    auto currSet = triplets.begin();
-    auto end  = triplets.end();
+    for (auto& key : keys)
+    {
+        sorted.emplace_back(std::move(triplets[key.second]));
+    }
 
-    while (currSet != end)
+    triplets.swap(sorted);
+
+    for (size_t currSet = 0; currSet < triplets.size(); )
     {
         // Determine the next set that are all comparator-equal
-        auto nextSet = currSet;
-        ++nextSet;
-        while (nextSet != end && 0 == tripletCompare(*currSet, *nextSet))
+        auto nextSet = currSet + 1;
+        while (nextSet < triplets.size() && 0 == keys[currSet].first.compare(keys[nextSet].first))
         {
             ++nextSet;
         }
 
-        combineTripletSet(currSet, nextSet);
+        combineTripletSet(triplets.begin() + static_cast<ptrdiff_t>(currSet),
+                          triplets.begin() + static_cast<ptrdiff_t>(nextSet));
 
         currSet = nextSet;
     }
@@ -13424,6 +13406,8 @@ void Syncs::syncLoop()
     syncThreadId = std::this_thread::get_id();
     assert(onSyncThread());
 
+    trace::setThreadName("Syncs");
+
     std::condition_variable cv;
     std::mutex dummy_mutex;
     std::unique_lock<std::mutex> dummy_lock(dummy_mutex);
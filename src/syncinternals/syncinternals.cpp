@@ -711,16 +711,65 @@ std::optional<FsCloudComparisonResult> quickFingerprintComparison(const CloudNod
     return std::nullopt;
 }
 
+namespace
+{
+
 /**
- * @brief Process one chunk of MAC computation on worker thread.
+ * @brief Releases a range's slot and read budget when its worker task is done with it.
+ *
+ * Owned by the queued task, so the budget also comes back if the task is discarded
+ * before it runs. A range that is released without being read fails the computation,
+ * as the file can't be completed without it.
+ */
+class MacRangeReservation
+{
+public:
+    MacRangeReservation(std::weak_ptr<MacComputationState> weakMac, const m_off_t bytes):
+        mWeakMac(std::move(weakMac)),
+        mBytes(bytes)
+    {}
+
+    MacRangeReservation(const MacRangeReservation&) = delete;
+    MacRangeReservation& operator=(const MacRangeReservation&) = delete;
+
+    ~MacRangeReservation()
+    {
+        // If the state is gone, its destructor gave back what its ranges reserved
+        if (auto macComp = mWeakMac.lock())
+        {
+            if (!mDone)
+            {
+                macComp->setFailed();
+            }
+
+            macComp->finishRange(mBytes);
+        }
+    }
+
+    void done()
+    {
+        mDone = true;
+    }
+
+private:
+    std::weak_ptr<MacComputationState> mWeakMac;
+    m_off_t mBytes;
+    bool mDone = false;
+};
+
+/**
+ * @brief Read one range of the file and compute its chunk MACs on a worker thread.
  *
  * Shared by CSF async MAC and clone candidate MAC computation.
- * Called from mAsyncQueue worker thread.
+ * Called from mAsyncQueue worker thread, with the file already opened by the sync thread.
+ * Several ranges of a file may be processed at once, on different workers, and finish
+ * in any order; whichever completes the file computes the local MAC.
  */
-void processChunkOnWorkerThread(std::weak_ptr<MacComputationState> weakMac,
-                                m_off_t chunkStart,
-                                m_off_t chunkEnd,
-                                std::shared_ptr<byte[]> chunkData,
+void processRangeOnWorkerThread(FileAccess& fa,
+                                std::weak_ptr<MacComputationState> weakMac,
+                                m_off_t rangeStart,
+                                m_off_t rangeEnd,
+                                MacRangeReservation& reservation,
                                 const std::string& logPrefix)
 {
     auto macComp = weakMac.lock();
@@ -730,6 +779,39 @@ void processChunkOnWorkerThread(std::weak_ptr<MacComputationState> weakMac,
         return;
     }
 
+    if (macComp->hasFailed() || macComp->isObsolete())
+    {
+        // Another range already gave up on this file
+        reservation.done();
+        return;
+    }
+
+    // Let the OS fetch the following range while we MAC this one
+    if (rangeEnd < macComp->totalSize)
+    {
+        fa.readAhead(rangeEnd,
+                      std::min(MacComputationState::BUFFER_SIZE, macComp->totalSize - rangeEnd));
+    }
+
+    const m_off_t rangeSize = rangeEnd - rangeStart;
+    std::unique_ptr<byte[]> rangeData(
+        new byte[static_cast<size_t>(rangeSize) + SymmCipher::BLOCKSIZE]);
+    memset(rangeData.get() + rangeSize, 0, SymmCipher::BLOCKSIZE);
+
+    bool readOk = fa.frawread(rangeData.get(),
+                              static_cast<unsigned>(rangeSize),
+                              rangeStart,
+                              true,
+                              FSLogging::logOnError);
+    fa.fclose();
+
+    if (!readOk)
+    {
+        LOG_debug << logPrefix << "Read failed at " << rangeStart << ": " << macComp->filePath;
+        macComp->setFailed();
+        return;
+    }
+
     // Create cipher and compute chunk MACs
     SymmCipher cipher;
     cipher.setkey(macComp->transferkey.data());
@@ -737,13 +819,13 @@ void processChunkOnWorkerThread(std::weak_ptr<MacComputationState> weakMac,
     chunkmac_map chunkMacs;
 
     // Process using the MEGA chunk boundaries (128KB-1MB chunks)
-    m_off_t pos = chunkStart;
-    byte* bufPtr = chunkData.get();
+    m_off_t pos = rangeStart;
+    byte* bufPtr = rangeData.get();
 
-    while (pos < chunkEnd)
+    while (pos < rangeEnd)
     {
         m_off_t chunkBoundary = ChunkedHash::chunkceil(pos, macComp->totalSize);
-        m_off_t thisChunkEnd = std::min(chunkBoundary, chunkEnd);
+        m_off_t thisChunkEnd = std::min(chunkBoundary, rangeEnd);
         unsigned chunkSize = static_cast<unsigned>(thisChunkEnd - pos);
 
         // Compute MAC for this chunk
@@ -758,15 +840,12 @@ void processChunkOnWorkerThread(std::weak_ptr<MacComputationState> weakMac,
         pos = thisChunkEnd;
     }
 
-    // Check if this was the last chunk
-    if (chunkEnd >= macComp->totalSize)
-    {
-        // Compute final local MAC
-        {
-            std::lock_guard<std::mutex> g(macComp->macsMutex);
-            chunkMacs.copyEntriesTo(macComp->partialMacs);
-        }
+    reservation.done();
 
+    if (macComp->addChunkMacs(std::move(chunkMacs), rangeSize))
+    {
+        // This range completed the file: compute final local MAC. No other range
+        // touches partialMacs any more.
         int64_t localMac = macComp->partialMacs.macsmac(&cipher);
 
         LOG_debug << logPrefix << "Local MAC computed: " << localMac;
@@ -775,39 +854,12 @@ void processChunkOnWorkerThread(std::weak_ptr<MacComputationState> weakMac,
     }
     else
     {
-        // More chunks to process
-        macComp->addChunkMacs(std::move(chunkMacs), chunkEnd);
-        macComp->chunkInProgress.store(false, std::memory_order_release);
-
-        LOG_verbose << logPrefix << "Chunk done, progress: " << chunkEnd << "/"
-                    << macComp->totalSize;
+        LOG_verbose << logPrefix << "Range [" << rangeStart << "-" << rangeEnd << "] done";
     }
 }
 
-/**
- * @brief Result of advanceMacComputation.
- */
-enum class MacAdvanceResult
-{
-    Pending, // Chunk queued or in progress
-    Ready, // Local MAC is computed (check state->localMac)
-    Obsolete, // Local file changed; discard state and rescan
-    Failed // Error occurred
-};
+} // anonymous namespace
 
-/**
- * @brief Advance local file MAC computation by one chunk.
- *
- * This is the shared core for both CSF and clone candidate MAC computation.
- * It handles reading the next chunk and queueing it to the worker thread.
- *
- * @param mc MegaClient for file access and async queue.
- * @param state The MAC computation state (must have cipher params initialized).
- *              Passed by value to ensure the state stays alive during the function,
- *              even if another thread resets the original shared_ptr.
- * @param logPrefix Prefix for log messages.
- * @return MacAdvanceResult indicating current state.
- */
 MacAdvanceResult advanceMacComputation(MegaClient& mc,
                                        std::shared_ptr<MacComputationState> state,
                                        const std::string& logPrefix)
@@ -823,17 +875,17 @@ MacAdvanceResult advanceMacComputation(MegaClient& mc,
         return MacAdvanceResult::Failed;
     }
 
-    if (state->isReady())
+    if (state->isObsolete())
     {
-        return MacAdvanceResult::Ready;
+        return MacAdvanceResult::Obsolete;
     }
 
-    if (state->isChunkInProgress())
+    if (state->isReady())
     {
-        return MacAdvanceResult::Pending;
+        return MacAdvanceResult::Ready;
     }
 
-    // Empty file: compute local MAC directly without reading or queueing chunks
+    // Empty file: compute local MAC directly without reading or queueing ranges
     if (state->totalSize == 0)
     {
         SymmCipher cipher;
@@ -846,88 +898,106 @@ MacAdvanceResult advanceMacComputation(MegaClient& mc,
         return MacAdvanceResult::Ready;
     }
 
-    // Ready for next chunk - read and queue
-    m_off_t readStart = state->currentPosition;
-    m_off_t tentativeEnd = std::min(readStart + MacComputationState::BUFFER_SIZE, state->totalSize);
+    std::weak_ptr<MacComputationState> weakMac = state;
+    const std::string workerLogPre = logPrefix + "(worker): ";
 
-    // Round down to nearest MEGA chunk boundary (unless it's the file end)
-    m_off_t readEnd;
-    if (tentativeEnd >= state->totalSize)
-    {
-        readEnd = state->totalSize;
-    }
-    else
+    // Queue as many of the following ranges as the file's slots and the read budget allow
+    while (state->nextReadPosition < state->totalSize)
     {
-        readEnd = ChunkedHash::chunkfloor(tentativeEnd);
-        if (readEnd <= readStart)
+        m_off_t readStart = state->nextReadPosition;
+        m_off_t tentativeEnd =
+            std::min(readStart + MacComputationState::BUFFER_SIZE, state->totalSize);
+
+        // Round down to nearest MEGA chunk boundary (unless it's the file end)
+        m_off_t readEnd;
+        if (tentativeEnd >= state->totalSize)
         {
-            readEnd = ChunkedHash::chunkceil(readStart, state->totalSize);
+            readEnd = state->totalSize;
+        }
+        else
+        {
+            readEnd = ChunkedHash::chunkfloor(tentativeEnd);
+            if (readEnd <= readStart)
+            {
+                readEnd = ChunkedHash::chunkceil(readStart, state->totalSize);
+            }
         }
-    }
 
-    m_off_t readSize = readEnd - readStart;
+        m_off_t readSize = readEnd - readStart;
 
-    if (readSize <= 0)
-    {
-        LOG_err << logPrefix << "Invalid read size: " << readSize;
-        state->setFailed();
-        return MacAdvanceResult::Failed;
-    }
+        if (readSize <= 0)
+        {
+            LOG_err << logPrefix << "Invalid read size: " << readSize;
+            state->setFailed();
+            return MacAdvanceResult::Failed;
+        }
 
-    // Open file briefly with FILE_SHARE_DELETE
-    auto fa = mc.fsaccess->newfileaccess();
-    if (!fa || !fa->fopenForMacRead(state->filePath, FSLogging::logOnError))
-    {
-        LOG_debug << logPrefix << "Cannot open file: " << state->filePath;
-        state->setFailed();
-        return MacAdvanceResult::Failed;
-    }
+        if (!state->tryStartRange(readSize))
+        {
+            break;
+        }
 
-    // Verify file size matches expected
-    if (fa->size != state->totalSize)
-    {
-        LOG_debug << logPrefix << "File size changed: expected " << state->totalSize << ", got "
-                  << fa->size;
-        fa->fclose();
-        return MacAdvanceResult::Obsolete;
-    }
+        state->nextReadPosition = readEnd;
 
-    // Read chunk into buffer
-    auto chunkData =
-        std::shared_ptr<byte[]>(new byte[static_cast<size_t>(readSize) + SymmCipher::BLOCKSIZE]);
-    memset(chunkData.get() + readSize, 0, SymmCipher::BLOCKSIZE);
+        auto reservation = std::make_shared<MacRangeReservation>(weakMac, readSize);
 
-    bool readOk = fa->frawread(chunkData.get(),
-                               static_cast<unsigned>(readSize),
-                               readStart,
-                               true,
-                               FSLogging::logOnError);
-    fa->fclose();
+        // Open the file here rather than on the worker, which may run after the client's
+        // FileSystemAccess is gone. Open it briefly, with FILE_SHARE_DELETE on Windows.
+        std::shared_ptr<FileAccess> fa = mc.fsaccess->newfileaccess();
+        if (!fa || !fa->fopenForMacRead(state->filePath, FSLogging::logOnError))
+        {
+            LOG_debug << logPrefix << "Cannot open file: " << state->filePath;
+            state->setFailed();
+            return MacAdvanceResult::Failed;
+        }
 
-    if (!readOk)
-    {
-        LOG_debug << logPrefix << "Read failed at " << readStart << ": " << state->filePath;
-        state->setFailed();
-        return MacAdvanceResult::Failed;
-    }
+        // Verify file size matches expected
+        if (fa->size != state->totalSize)
+        {
+            LOG_debug << logPrefix << "File size changed: expected " << state->totalSize
+                      << ", got " << fa->size;
+            state->setObsolete();
+            reservation->done();
+            return MacAdvanceResult::Obsolete;
+        }
 
-    // Mark chunk in progress and queue to worker thread
-    state->chunkInProgress.store(true, std::memory_order_release);
+        mc.mAsyncQueue.push(
+            [fa, weakMac, readStart, readEnd, reservation, workerLogPre](SymmCipher&)
+            {
+                processRangeOnWorkerThread(*fa,
+                                           weakMac,
+                                           readStart,
+                                           readEnd,
+                                           *reservation,
+                                           workerLogPre);
+            },
+            true);
+
+        LOG_verbose << logPrefix << "Queued range [" << readStart << "-" << readEnd
+                    << "]: " << state->filePath;
+    }
 
-    std::weak_ptr<MacComputationState> weakMac = state;
-    const std::string workerLogPre = logPrefix + "(worker): ";
+    return MacAdvanceResult::Pending;
+}
 
-    mc.mAsyncQueue.push(
-        [weakMac, readStart, readEnd, chunkData, workerLogPre](SymmCipher&)
-        {
-            processChunkOnWorkerThread(weakMac, readStart, readEnd, chunkData, workerLogPre);
-        },
-        true);
+bool MacComputationState::tryStartRange(const m_off_t bytes)
+{
+    if (rangesInFlight.load(std::memory_order_acquire) >= MAX_RANGES_IN_FLIGHT ||
+        !mThrottle.tryAcquireBytes(bytes))
+    {
+        return false;
+    }
 
-    LOG_verbose << logPrefix << "Queued chunk [" << readStart << "-" << readEnd
-                << "]: " << state->filePath;
+    mReservedBytes += bytes;
+    rangesInFlight.fetch_add(1, std::memory_order_acq_rel);
+    return true;
+}
 
-    return MacAdvanceResult::Pending;
+void MacComputationState::finishRange(const m_off_t bytes)
+{
+    mReservedBytes -= bytes;
+    mThrottle.releaseBytes(bytes);
+    rangesInFlight.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 MacComputationState::~MacComputationState()
@@ -938,6 +1008,12 @@ MacComputationState::~MacComputationState()
         throttleSlotAcquired = false;
         LOG_verbose << "MacComputationState: Released throttle slot for " << filePath;
     }
+
+    // Ranges still queued when the owner went away will find the state gone
+    if (const auto reserved = mReservedBytes.load())
+    {
+        mThrottle.releaseBytes(reserved);
+    }
 }
 
 namespace
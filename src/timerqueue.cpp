@@ -0,0 +1,98 @@
+/**
+ * @file timerqueue.cpp
+ * @brief High-resolution timers run from the client's event loop
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/timerqueue.h"
+
+#include <algorithm>
+
+namespace mega
+{
+
+auto TimerQueue::schedule(Clock::duration delay, Callback callback) -> TimerId
+{
+    auto id = mNextId++;
+
+    mHeap.push(Entry{Clock::now() + std::max(delay, Clock::duration::zero()), id});
+    mCallbacks.emplace(id, std::move(callback));
+
+    return id;
+}
+
+bool TimerQueue::cancel(TimerId id)
+{
+    return mCallbacks.erase(id) > 0;
+}
+
+size_t TimerQueue::fire(Clock::time_point now)
+{
+    // take what's due before running anything, so timers scheduled by the
+    // callbacks wait for the next call
+    std::vector<TimerId> due;
+
+    for (discardCancelled(); !mHeap.empty() && mHeap.top().due <= now; discardCancelled())
+    {
+        due.push_back(mHeap.top().id);
+        mHeap.pop();
+    }
+
+    size_t count = 0;
+
+    for (auto id: due)
+    {
+        // an earlier callback may have cancelled it
+        auto it = mCallbacks.find(id);
+
+        if (it == mCallbacks.end())
+        {
+            continue;
+        }
+
+        auto callback = std::move(it->second);
+        mCallbacks.erase(it);
+
+        callback();
+        ++count;
+    }
+
+    return count;
+}
+
+auto TimerQueue::timeUntilNext(Clock::time_point now) -> std::optional<Clock::duration>
+{
+    discardCancelled();
+
+    if (mHeap.empty())
+    {
+        return std::nullopt;
+    }
+
+    return std::max(mHeap.top().due - now, Clock::duration::zero());
+}
+
+void TimerQueue::discardCancelled()
+{
+    while (!mHeap.empty() && !mCallbacks.count(mHeap.top().id))
+    {
+        mHeap.pop();
+    }
+}
+
+} // namespace mega
@@ -0,0 +1,289 @@
+/**
+ * @file trace.cpp
+ * @brief Record spans of time spent in the SDK, for viewing as a trace
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/trace.h"
+
+#include "mega/logging.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace mega::trace
+{
+
+std::atomic<bool> g_tracing{false};
+
+namespace
+{
+
+struct Event
+{
+    const char* name;
+    Clock::time_point begin;
+    Clock::duration duration;
+};
+
+// Events are appended by the owning thread only. Each chunk publishes how
+// many of its events are complete, so they can be read while more are added.
+struct Chunk
+{
+    static constexpr size_t SIZE = 4096;
+
+    Event events[SIZE];
+    std::atomic<size_t> size{0};
+    std::atomic<Chunk*> next{nullptr};
+};
+
+struct ThreadBuffer
+{
+    uint64_t session;
+    size_t tid;
+    std::string threadName;
+
+    Chunk* head = new Chunk;
+    Chunk* tail = head; // owning thread only
+    size_t chunks = 1;  // owning thread only
+    std::atomic<size_t> dropped{0};
+
+    ThreadBuffer(uint64_t s, size_t t, std::string n):
+        session(s),
+        tid(t),
+        threadName(std::move(n))
+    {}
+
+    ~ThreadBuffer()
+    {
+        for (auto* chunk = head; chunk;)
+        {
+            auto* next = chunk->next.load(std::memory_order_relaxed);
+            delete chunk;
+            chunk = next;
+        }
+    }
+
+    void append(const Event& event)
+    {
+        auto size = tail->size.load(std::memory_order_relaxed);
+
+        if (size == Chunk::SIZE)
+        {
+            if (chunks * Chunk::SIZE >= MAX_EVENTS_PER_THREAD)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            auto* chunk = new Chunk;
+            tail->next.store(chunk, std::memory_order_release);
+            tail = chunk;
+            ++chunks;
+            size = 0;
+        }
+
+        tail->events[size] = event;
+        tail->size.store(size + 1, std::memory_order_release);
+    }
+};
+
+// Buffers of the current trace, kept after their threads exit.
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::atomic<uint64_t> session{0};
+    Clock::time_point started;
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+thread_local std::string t_threadName;
+
+ThreadBuffer& threadBuffer()
+{
+    auto& r = registry();
+    auto session = r.session.load(std::memory_order_acquire);
+
+    if (!t_buffer || t_buffer->session != session)
+    {
+        std::lock_guard<std::mutex> g(r.mutex);
+
+        t_buffer = std::make_shared<ThreadBuffer>(session, r.buffers.size() + 1, t_threadName);
+        r.buffers.push_back(t_buffer);
+    }
+
+    return *t_buffer;
+}
+
+void escape(const char* s, std::string& out)
+{
+    for (; *s; ++s)
+    {
+        auto c = static_cast<unsigned char>(*s);
+
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += static_cast<char>(c);
+        }
+        else if (c < 0x20)
+        {
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            out += buffer;
+        }
+        else
+        {
+            out += static_cast<char>(c);
+        }
+    }
+}
+
+void microseconds(Clock::duration d, std::string& out)
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%lld.%03lld", static_cast<long long>(ns / 1000),
+             static_cast<long long>(ns % 1000));
+    out += buffer;
+}
+
+} // anonymous
+
+void start()
+{
+    auto& r = registry();
+    std::lock_guard<std::mutex> g(r.mutex);
+
+    // threads notice the new session and start new buffers
+    r.buffers.clear();
+    r.started = Clock::now();
+    r.session.fetch_add(1, std::memory_order_release);
+
+    g_tracing.store(true, std::memory_order_relaxed);
+
+    LOG_info << "Tracing started";
+}
+
+void stop()
+{
+    g_tracing.store(false, std::memory_order_relaxed);
+
+    LOG_info << "Tracing stopped";
+}
+
+std::string chromeJson()
+{
+    auto& r = registry();
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    Clock::time_point started;
+    {
+        std::lock_guard<std::mutex> g(r.mutex);
+        buffers = r.buffers;
+        started = r.started;
+    }
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    auto open = [&](const char* phase, size_t tid)
+    {
+        out += first ? "\n" : ",\n";
+        first = false;
+
+        out += "{\"ph\":\"";
+        out += phase;
+        out += "\",\"pid\":1,\"tid\":" + std::to_string(tid);
+    };
+
+    for (auto& buffer: buffers)
+    {
+        auto name = buffer->threadName.empty() ? "thread " + std::to_string(buffer->tid) :
+                                                 buffer->threadName;
+
+        open("M", buffer->tid);
+        out += ",\"name\":\"thread_name\",\"args\":{\"name\":\"";
+        escape(name.c_str(), out);
+        out += "\"}}";
+
+        for (auto* chunk = buffer->head; chunk; chunk = chunk->next.load(std::memory_order_acquire))
+        {
+            auto size = chunk->size.load(std::memory_order_acquire);
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                auto& event = chunk->events[i];
+
+                // spans already underway when tracing started are cut short
+                auto begin = std::max(event.begin, started);
+                auto end = std::max(event.begin + event.duration, begin);
+
+                open("X", buffer->tid);
+                out += ",\"name\":\"";
+                escape(event.name, out);
+                out += "\",\"ts\":";
+                microseconds(begin - started, out);
+                out += ",\"dur\":";
+                microseconds(end - begin, out);
+                out += "}";
+            }
+        }
+
+        if (auto dropped = buffer->dropped.load(std::memory_order_relaxed))
+        {
+            LOG_warn << "Trace of " << name << " is missing " << dropped << " spans";
+        }
+    }
+
+    out += "\n]}\n";
+    return out;
+}
+
+void setThreadName(const std::string& name)
+{
+    t_threadName = name;
+}
+
+const char* intern(const std::string& name)
+{
+    static std::mutex mutex;
+    static std::unordered_set<std::string> names;
+
+    std::lock_guard<std::mutex> g(mutex);
+    return names.insert(name).first->c_str();
+}
+
+void record(const char* name, Clock::time_point begin, Clock::time_point end)
+{
+    threadBuffer().append({name, begin, end - begin});
+}
+
+} // namespace mega::trace
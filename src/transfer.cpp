@@ -1341,8 +1341,6 @@ DirectReadNode::DirectReadNode(MegaClient* client,
     size = 0;
 
     pendingcmd = NULL;
-
-    dsdrn_it = client->dsdrns.end();
 }
 
 DirectReadNode::~DirectReadNode()
@@ -1522,20 +1520,33 @@ void DirectReadNode::cmdresult(const Error &e, dstime timeleft)
 
 void DirectReadNode::schedule(dstime deltads)
 {
-    WAIT_CLASS::bumpds();
-    if (dsdrn_it != client->dsdrns.end())
+    if (mScheduledTimer)
     {
-        client->dsdrns.erase(dsdrn_it);
+        client->cancelTimer(mScheduledTimer);
+        mScheduledTimer = 0;
     }
 
-    if (EVER(deltads))
-    {
-        dsdrn_it = client->dsdrns.insert(pair<dstime, DirectReadNode*>(Waiter::ds + deltads, this));
-    }
-    else
+    if (!EVER(deltads))
     {
-        dsdrn_it = client->dsdrns.end();
+        return;
     }
+
+    mScheduledTimer = client->scheduleTimer(std::chrono::milliseconds(deltads * 100),
+                                            [this]()
+                                            {
+                                                mScheduledTimer = 0;
+
+                                                if (reads.size() && (tempurls.size() || pendingcmd))
+                                                {
+                                                    LOG_warn << "DirectRead scheduled retry";
+                                                    retry(API_EAGAIN);
+                                                }
+                                                else
+                                                {
+                                                    LOG_debug << "Dispatching scheduled streaming";
+                                                    dispatch();
+                                                }
+                                            });
 }
 
 DirectRead* DirectReadNode::enqueue(m_off_t offset,
@@ -3105,12 +3116,59 @@ bool TransferList::getIterator(Transfer *transfer, transfer_list::iterator& it,
 
 std::array<vector<Transfer*>, 6> TransferList::nexttransfers(std::function<bool(Transfer*)>& continuefunction,
                                                              std::function<bool(direction_t)>& directionContinuefunction,
-                                                             TransferDbCommitter& committer)
+                                                             TransferDbCommitter& committer,
+                                                             const TransferScheduler* scheduler)
 {
     std::array<vector<Transfer*>, 6> chosenTransfers;
 
     static direction_t putget[] = { PUT, GET };
 
+    if (scheduler && scheduler->reordersQueue())
+    {
+        for (direction_t direction : putget)
+        {
+            // the scheduler chooses among the first ready ones, so a transfer further down
+            // can start before the budget is spent on those ahead of it
+            vector<Transfer*> ready;
+
+            for (Transfer *transfer : transfers[direction])
+            {
+                if (ready.size() >= TransferScheduler::CANDIDATE_WINDOW) break;
+
+                if (!transfer->slot)
+                {
+                    transfer->removeCancelledTransferFiles(&committer);
+                    if (transfer->files.empty())
+                    {
+                        transfer->removeAndDeleteSelf(TRANSFERSTATE_CANCELLED);
+                        continue;
+                    }
+                }
+
+                if ((!transfer->slot && isReady(transfer))
+                    || (transfer->asyncopencontext
+                        && transfer->asyncopencontext->finished))
+                {
+                    ready.push_back(transfer);
+                }
+            }
+
+            scheduler->schedule(ready);
+
+            for (Transfer *transfer : ready)
+            {
+                if (!directionContinuefunction(direction)) break;
+
+                if (continuefunction(transfer))
+                {
+                    chosenTransfers[TransferCategory(transfer).index()].push_back(transfer);
+                }
+            }
+        }
+
+        return chosenTransfers;
+    }
+
     for (direction_t direction : putget)
     {
         for (Transfer *transfer : transfers[direction])
@@ -0,0 +1,323 @@
+/**
+ * @file transfercontroller.cpp
+ * @brief Adapt a transfer's connections and request size to the measured throughput
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/transfercontroller.h"
+
+#include "mega/logging.h"
+
+#include <algorithm>
+
+namespace mega
+{
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+// Connections used before anything has been measured.
+constexpr unsigned INITIAL_CONNECTIONS = 2;
+
+// Startup ends after this many rounds without the rate growing by a quarter.
+constexpr unsigned STARTUP_PLATEAU_ROUNDS = 3;
+
+// Rounds whose delivery rate is considered for the bandwidth estimate.
+constexpr std::size_t RATE_WINDOW_ROUNDS = 10;
+
+// Times to first byte considered for the minimum.
+constexpr std::size_t FIRST_BYTE_WINDOW = 32;
+
+// Rounds in steady state between probes with an extra connection.
+constexpr unsigned PROBE_INTERVAL_ROUNDS = 8;
+
+// The time to first byte is inflating when it exceeds both twice the minimum
+// and the minimum plus this margin, so that jitter on fast links is ignored.
+constexpr milliseconds FIRST_BYTE_INFLATION_MARGIN = 50ms;
+
+// How long a request should ideally take at the measured rate.
+constexpr milliseconds TARGET_REQUEST_DURATION = 2s;
+
+// Requests should last at least this many times the time to first byte.
+constexpr int FIRST_BYTES_PER_REQUEST = 8;
+
+} // anonymous
+
+AdaptiveTransferController::AdaptiveTransferController(const Limits& limits, Clock::time_point now):
+    mLimits(limits),
+    mRoundStart(now)
+{
+    mLimits.minConnections = std::max(mLimits.minConnections, 1u);
+    mLimits.maxConnections = std::max(mLimits.maxConnections, mLimits.minConnections);
+    mLimits.minRequestSize = std::max<m_off_t>(mLimits.minRequestSize, 1);
+    mLimits.maxRequestSize = std::max(mLimits.maxRequestSize, mLimits.minRequestSize);
+
+    mConnections =
+        std::clamp(INITIAL_CONNECTIONS, mLimits.minConnections, mLimits.maxConnections);
+    mFullRateConnections = mConnections;
+    mRoundLength = mConnections;
+    mRequestSizeCap = mLimits.maxRequestSize;
+
+    mStarted.resize(mLimits.maxConnections);
+}
+
+void AdaptiveTransferController::requestStarted(unsigned connection, Clock::time_point now)
+{
+    if (connection < mStarted.size())
+    {
+        mStarted[connection] = now;
+    }
+}
+
+void AdaptiveTransferController::requestCompleted(unsigned connection,
+                                                  m_off_t bytes,
+                                                  std::optional<milliseconds> firstByte,
+                                                  Clock::time_point now)
+{
+    if (connection >= mStarted.size() || !mStarted[connection])
+    {
+        return;
+    }
+
+    mRoundBytes += std::max<m_off_t>(bytes, 0);
+
+    if (firstByte && firstByte->count() >= 0)
+    {
+        mRoundFirstBytes.emplace_back(*firstByte);
+        mFirstBytes.emplace_back(*firstByte);
+
+        if (mFirstBytes.size() > FIRST_BYTE_WINDOW)
+        {
+            mFirstBytes.pop_front();
+        }
+    }
+
+    completed(connection, now);
+}
+
+void AdaptiveTransferController::requestFailed(unsigned connection, Clock::time_point now)
+{
+    if (connection >= mStarted.size() || !mStarted[connection])
+    {
+        return;
+    }
+
+    ++mRoundFailures;
+
+    completed(connection, now);
+}
+
+unsigned AdaptiveTransferController::connections() const
+{
+    return mConnections;
+}
+
+m_off_t AdaptiveTransferController::requestSize() const
+{
+    return mRequestSize;
+}
+
+m_off_t AdaptiveTransferController::bandwidth() const
+{
+    if (mRates.empty())
+    {
+        return 0;
+    }
+
+    return *std::max_element(mRates.begin(), mRates.end());
+}
+
+std::optional<milliseconds> AdaptiveTransferController::minFirstByte() const
+{
+    if (mFirstBytes.empty())
+    {
+        return std::nullopt;
+    }
+
+    return *std::min_element(mFirstBytes.begin(), mFirstBytes.end());
+}
+
+AdaptiveTransferController::Phase AdaptiveTransferController::phase() const
+{
+    return mPhase;
+}
+
+unsigned AdaptiveTransferController::rounds() const
+{
+    return mRounds;
+}
+
+void AdaptiveTransferController::completed(unsigned connection, Clock::time_point now)
+{
+    mStarted[connection].reset();
+
+    if (++mRoundCompletions >= mRoundLength)
+    {
+        endRound(now);
+    }
+}
+
+void AdaptiveTransferController::endRound(Clock::time_point now)
+{
+    ++mRounds;
+
+    auto elapsed = std::max<m_off_t>(duration_cast<milliseconds>(now - mRoundStart).count(), 1);
+    auto rate = mRoundBytes * 1000 / elapsed;
+
+    if (mRoundBytes)
+    {
+        mRates.emplace_back(rate);
+
+        if (mRates.size() > RATE_WINDOW_ROUNDS)
+        {
+            mRates.pop_front();
+        }
+    }
+
+    auto failed = mRoundFailures > 0;
+    auto inflating = false;
+
+    if (auto floor = minFirstByte(); floor && !mRoundFirstBytes.empty())
+    {
+        auto median = mRoundFirstBytes.begin() + mRoundFirstBytes.size() / 2;
+
+        std::nth_element(mRoundFirstBytes.begin(), median, mRoundFirstBytes.end());
+
+        inflating = *median > *floor * 2 && *median > *floor + FIRST_BYTE_INFLATION_MARGIN;
+    }
+
+    if (mPhase == STARTUP)
+    {
+        if (failed || inflating)
+        {
+            mPhase = STEADY;
+            setConnections(mFullRateConnections,
+                           failed ? "startup: requests failing" : "startup: first byte inflating");
+        }
+        else if (rate >= mFullRate + mFullRate / 4)
+        {
+            mFullRate = rate;
+            mFullRateConnections = mConnections;
+            mPlateauRounds = 0;
+            setConnections(mConnections * 2, "startup: rate growing");
+        }
+        else if (++mPlateauRounds >= STARTUP_PLATEAU_ROUNDS)
+        {
+            mPhase = STEADY;
+            setConnections(mFullRateConnections, "startup: rate plateaued");
+        }
+    }
+    else if (failed || inflating)
+    {
+        mProbing = false;
+        mRoundsSinceProbe = 0;
+        setConnections(mConnections - 1, failed ? "requests failing" : "first byte inflating");
+    }
+    else if (mProbing)
+    {
+        mProbing = false;
+        mRoundsSinceProbe = 0;
+
+        if (rate * 10 < mRateBeforeProbe * 11)
+        {
+            setConnections(mConnections - 1, "probe: no gain");
+        }
+    }
+    else if (++mRoundsSinceProbe >= PROBE_INTERVAL_ROUNDS &&
+             mConnections < mLimits.maxConnections)
+    {
+        mProbing = true;
+        mRateBeforeProbe = bandwidth();
+        setConnections(mConnections + 1, "probing");
+    }
+
+    updateRequestSize(failed);
+
+    mRoundStart = now;
+    mRoundLength = mConnections;
+    mRoundCompletions = 0;
+    mRoundFailures = 0;
+    mRoundBytes = 0;
+    mRoundFirstBytes.clear();
+}
+
+void AdaptiveTransferController::setConnections(unsigned connections, const char* reason)
+{
+    connections = std::clamp(connections, mLimits.minConnections, mLimits.maxConnections);
+
+    if (connections == mConnections)
+    {
+        return;
+    }
+
+    LOG_debug << "[AdaptiveTransferController] Connections " << mConnections << " -> "
+              << connections << " (" << reason << ", " << bandwidth() << " B/s)";
+
+    mConnections = connections;
+}
+
+void AdaptiveTransferController::updateRequestSize(bool failed)
+{
+    // Failures halve the largest size allowed, which then recovers gradually.
+    if (failed)
+    {
+        mRequestSizeCap = std::max((mRequestSize ? mRequestSize : mRequestSizeCap) / 2,
+                                   mLimits.minRequestSize);
+    }
+    else
+    {
+        mRequestSizeCap = std::min(mRequestSizeCap * 2, mLimits.maxRequestSize);
+    }
+
+    auto rate = bandwidth();
+    if (!rate)
+    {
+        if (mRequestSize)
+        {
+            mRequestSize = std::min(mRequestSize, mRequestSizeCap);
+        }
+
+        return;
+    }
+
+    auto duration = TARGET_REQUEST_DURATION;
+
+    if (auto firstByte = minFirstByte())
+    {
+        duration = std::max(duration, *firstByte * FIRST_BYTES_PER_REQUEST);
+    }
+
+    auto size = rate / mConnections * duration.count() / 1000;
+
+    size = std::clamp(std::min(size, mRequestSizeCap),
+                      mLimits.minRequestSize,
+                      mLimits.maxRequestSize);
+
+    if (size != mRequestSize)
+    {
+        LOG_verbose << "[AdaptiveTransferController] Request size " << mRequestSize << " -> "
+                    << size;
+    }
+
+    mRequestSize = size;
+}
+
+} // mega
@@ -0,0 +1,277 @@
+/**
+ * @file transferscheduler.cpp
+ * @brief Decide which queued transfers get a slot, and how many slots to use
+ *
+ * (c) 2026 by Mega Limited, Auckland, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega/transferscheduler.h"
+
+#include "mega/file.h"
+#include "mega/logging.h"
+#include "mega/transfer.h"
+
+#include <algorithm>
+
+namespace mega
+{
+
+const m_off_t TransferScheduler::TRANSFER_COST = 256 * 1024; // 256 KB
+const unsigned TransferScheduler::MIN_SLOTS = 8;
+const unsigned TransferScheduler::INITIAL_SLOTS = 16;
+const unsigned TransferScheduler::SLOT_STEP = 4;
+const dstime TransferScheduler::SAMPLE_INTERVAL = 50; // 5 seconds
+const unsigned TransferScheduler::PROBE_HOLDOFF = 6;
+const size_t TransferScheduler::CANDIDATE_WINDOW = 1024;
+
+TransferScheduler::TransferScheduler(unsigned maxSlots):
+    mMaxSlots(maxSlots),
+    mSlotLimit(maxSlots)
+{
+    mWeights.fill(1);
+}
+
+void TransferScheduler::setPolicy(Policy policy)
+{
+    mPolicy = policy;
+}
+
+TransferScheduler::Policy TransferScheduler::policy() const
+{
+    return mPolicy;
+}
+
+void TransferScheduler::setWeight(Flow flow, unsigned weight)
+{
+    assert(flow < NUM_FLOWS);
+    mWeights[flow] = std::max(weight, 1u);
+    mFairQueuing = true;
+}
+
+unsigned TransferScheduler::weight(Flow flow) const
+{
+    assert(flow < NUM_FLOWS);
+    return mWeights[flow];
+}
+
+void TransferScheduler::clearWeights()
+{
+    mWeights.fill(1);
+    mFairQueuing = false;
+    mService.fill(0);
+    mVirtualTime = 0;
+}
+
+void TransferScheduler::setAdaptiveSlots(bool enable)
+{
+    if (mAdaptiveSlots == enable)
+        return;
+
+    mAdaptiveSlots = enable;
+    mSlotLimit = enable ? std::clamp(INITIAL_SLOTS, std::min(MIN_SLOTS, mMaxSlots), mMaxSlots) :
+                          mMaxSlots;
+    mSampled = false;
+    mProbing = false;
+    mHoldoff = 0;
+}
+
+bool TransferScheduler::adaptiveSlots() const
+{
+    return mAdaptiveSlots;
+}
+
+std::vector<size_t> TransferScheduler::order(const std::vector<Job>& jobs) const
+{
+    std::array<std::vector<size_t>, NUM_FLOWS> queues;
+
+    // Until weights are set, every job is queued as one flow.
+    for (size_t i = 0; i < jobs.size(); ++i)
+        queues[mFairQueuing ? jobs[i].flow : FLOW_APP].emplace_back(i);
+
+    if (mPolicy != POLICY_PRIORITY)
+    {
+        auto key = [this, &jobs](size_t i)
+        {
+            return mPolicy == POLICY_SMALLEST_FIRST ? jobs[i].size : jobs[i].remaining;
+        };
+
+        for (auto& queue: queues)
+        {
+            std::stable_sort(queue.begin(),
+                             queue.end(),
+                             [&key](size_t lhs, size_t rhs)
+                             {
+                                 return key(lhs) < key(rhs);
+                             });
+        }
+    }
+
+    // Replay fair queuing without charging the flows yet, as not every job may get a slot.
+    auto service = mService;
+    std::array<size_t, NUM_FLOWS> next{};
+    std::vector<size_t> ordered;
+
+    ordered.reserve(jobs.size());
+
+    while (ordered.size() < jobs.size())
+    {
+        auto chosen = NUM_FLOWS;
+        auto chosenTag = 0.0;
+
+        for (unsigned flow = 0; flow < NUM_FLOWS; ++flow)
+        {
+            if (next[flow] == queues[flow].size())
+                continue;
+
+            auto tag = std::max(service[flow], mVirtualTime);
+
+            if (chosen == NUM_FLOWS || tag < chosenTag)
+            {
+                chosen = static_cast<Flow>(flow);
+                chosenTag = tag;
+            }
+        }
+
+        auto i = queues[chosen][next[chosen]++];
+
+        service[chosen] = chosenTag + cost(jobs[i]);
+        ordered.emplace_back(i);
+    }
+
+    return ordered;
+}
+
+void TransferScheduler::started(const Job& job)
+{
+    if (!mFairQueuing)
+        return;
+
+    auto start = std::max(mService[job.flow], mVirtualTime);
+
+    mService[job.flow] = start + cost(job);
+    mVirtualTime = start;
+}
+
+bool TransferScheduler::smallFilesFirst() const
+{
+    return mPolicy != POLICY_PRIORITY;
+}
+
+void TransferScheduler::sample(unsigned slots, m_off_t bytesPerSecond, dstime now)
+{
+    if (!mAdaptiveSlots)
+        return;
+
+    if (mSampled && now - mLastSample < SAMPLE_INTERVAL)
+        return;
+
+    mSampled = true;
+    mLastSample = now;
+
+    if (mProbing)
+    {
+        mProbing = false;
+
+        // Keep the extra slots only if they paid off.
+        if (bytesPerSecond * 10 < mSpeedBeforeProbe * 11)
+        {
+            mSlotLimit = std::max(mSlotLimit - SLOT_STEP, std::min(MIN_SLOTS, mMaxSlots));
+            mHoldoff = PROBE_HOLDOFF;
+
+            LOG_debug << "[TransferScheduler] More slots didn't increase throughput ("
+                      << bytesPerSecond << " B/s), limit back to " << mSlotLimit;
+        }
+
+        return;
+    }
+
+    if (mHoldoff)
+    {
+        --mHoldoff;
+        return;
+    }
+
+    // Only probe when the slots we have are in use and moving data.
+    if (slots < mSlotLimit || !bytesPerSecond || mSlotLimit >= mMaxSlots)
+        return;
+
+    mProbing = true;
+    mSpeedBeforeProbe = bytesPerSecond;
+    mSlotLimit = std::min(mSlotLimit + SLOT_STEP, mMaxSlots);
+
+    LOG_debug << "[TransferScheduler] Probing with " << mSlotLimit << " slots (" << bytesPerSecond
+              << " B/s)";
+}
+
+unsigned TransferScheduler::slotLimit() const
+{
+    return mSlotLimit;
+}
+
+TransferScheduler::Job TransferScheduler::job(const Transfer& transfer)
+{
+    Job job;
+
+    job.size = transfer.size;
+    job.remaining = std::max<m_off_t>(transfer.size - transfer.progresscompleted, 0);
+
+    auto sync = std::any_of(transfer.files.begin(),
+                            transfer.files.end(),
+                            [](const File* file)
+                            {
+                                return file->syncxfer;
+                            });
+
+    job.flow = sync ? FLOW_SYNC : FLOW_APP;
+
+    return job;
+}
+
+void TransferScheduler::schedule(std::vector<Transfer*>& transfers) const
+{
+    // Nothing to reorder.
+    if (!reordersQueue())
+        return;
+
+    std::vector<Job> jobs;
+
+    jobs.reserve(transfers.size());
+
+    for (auto* transfer: transfers)
+        jobs.emplace_back(job(*transfer));
+
+    std::vector<Transfer*> ordered;
+
+    ordered.reserve(transfers.size());
+
+    for (auto i: order(jobs))
+        ordered.emplace_back(transfers[i]);
+
+    transfers.swap(ordered);
+}
+
+bool TransferScheduler::reordersQueue() const
+{
+    return mPolicy != POLICY_PRIORITY || mFairQueuing;
+}
+
+double TransferScheduler::cost(const Job& job) const
+{
+    return static_cast<double>(job.remaining + TRANSFER_COST) / mWeights[job.flow];
+}
+
+} // mega
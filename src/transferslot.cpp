@@ -102,6 +102,7 @@ const m_off_t TransferSlot::MAX_REQ_SIZE_NEW_RAID = 2 * 1024 * 1024; // 2 MB for
 const m_off_t TransferSlot::UPPER_FILESIZE_LIMIT_FOR_SMALLER_CHUNKS = 25 * 1024 * 1024; // 25 MB
 const m_off_t TransferSlot::MIN_FILESIZE_FOR_MULTIPLE_CONNECTIONS = 131072 + 1; // 128 KB + 1 -> legacy value
 const m_off_t TransferSlot::MAX_GAP_SIZE = 256 * 1024 * 1024; // 256 MB
+const m_off_t TransferSlot::MIN_ADAPTIVE_REQ_SIZE = 1024 * 1024; // 1 MB
 
 TransferSlot::TransferSlot(Transfer* ctransfer)
     : fa(ctransfer->client->fsaccess->newfileaccess(), ctransfer)
@@ -188,6 +189,22 @@ bool TransferSlot::createconnectionsonce()
         mReqSpeeds.resize(static_cast<size_t>(connections));
         asyncIO = new AsyncIOContext*[static_cast<size_t>(connections)]();
 
+        if (transfer->client->mAdaptiveTransfers && connections > 1 && !transferbuf.isRaid() &&
+            !transferbuf.isNewRaid())
+        {
+            AdaptiveTransferController::Limits limits;
+            limits.maxConnections = static_cast<unsigned>(connections);
+            limits.minRequestSize = MIN_ADAPTIVE_REQ_SIZE;
+            limits.maxRequestSize = maxRequestSize;
+
+            mAdaptiveController =
+                std::make_unique<AdaptiveTransferController>(limits,
+                                                             std::chrono::steady_clock::now());
+
+            LOG_debug << "Adapting connections to the measured throughput, starting with "
+                      << mAdaptiveController->connections();
+        }
+
         if (transferbuf.isNewRaid())
         {
             transfer->slot->initCloudRaid(transfer->client);
@@ -727,6 +744,23 @@ void TransferSlot::doio(MegaClient* client, TransferDbCommitter& committer)
                     processRequestLatency(reqs[i]);
                     mReqSpeeds[i].requestProgressed(reqs[i]->size);
 
+                    if (mAdaptiveController)
+                    {
+                        std::optional<std::chrono::milliseconds> firstByte;
+
+                        if (reqs[i]->mStartTransferTime >= 0)
+                        {
+                            firstByte = std::chrono::milliseconds(
+                                static_cast<long long>(reqs[i]->mStartTransferTime));
+                        }
+
+                        // Postponed chunks come through here again, but are only accounted once.
+                        mAdaptiveController->requestCompleted(i,
+                                                              reqs[i]->size,
+                                                              firstByte,
+                                                              std::chrono::steady_clock::now());
+                    }
+
                     if (client->orderdownloadedchunks && transfer->type == GET && !transferbuf.isRaid() && transfer->progresscompleted != static_cast<HttpReqDL*>(reqs[i].get())->dlpos)
                     {
                         LOG_debug << "Conn " << i << " : POSTPONING UNSORTED CHUNK";
@@ -1175,17 +1209,22 @@ void TransferSlot::doio(MegaClient* client, TransferDbCommitter& committer)
 
         if (!failure)
         {
-            if (!reqs[i] || (reqs[i]->status == REQ_READY))
+            // Connections beyond those the controller wants busy are left idle.
+            if ((!reqs[i] || (reqs[i]->status == REQ_READY)) &&
+                (!mAdaptiveController || i < mAdaptiveController->connections()))
             {
                 bool newInputBufferSupplied = false;
                 bool pauseConnectionInputForRaid = false;
                 std::pair<m_off_t, m_off_t> posrange =
-                    transferbuf.nextNPosForConnection(i,
-                                                      maxRequestSize,
-                                                      static_cast<unsigned int>(connections),
-                                                      newInputBufferSupplied,
-                                                      pauseConnectionInputForRaid,
-                                                      client->httpio->uploadSpeed);
+                    transferbuf.nextNPosForConnection(
+                        i,
+                        maxRequestSize,
+                        mAdaptiveController ? mAdaptiveController->connections() :
+                                              static_cast<unsigned int>(connections),
+                        newInputBufferSupplied,
+                        pauseConnectionInputForRaid,
+                        client->httpio->uploadSpeed,
+                        mAdaptiveController ? mAdaptiveController->requestSize() : 0);
                 if (posrange == std::make_pair(m_off_t{-1}, m_off_t{-1}))
                 {
                     LOG_warn << "Conn " << i
@@ -1369,6 +1408,11 @@ void TransferSlot::doio(MegaClient* client, TransferDbCommitter& committer)
 
                     mReqSpeeds[i].requestStarted();
                     reqs[i]->minspeed = true;
+
+                    if (mAdaptiveController)
+                    {
+                        mAdaptiveController->requestStarted(i, std::chrono::steady_clock::now());
+                    }
                 }
                 if (transferbuf.isNewRaid())
                 {
@@ -1600,6 +1644,13 @@ void TransferSlot::processRequestPost(MegaClient* client,
 std::pair<error, dstime> TransferSlot::processRequestFailure(MegaClient* client, const std::shared_ptr<HttpReqXfer>& httpReq, dstime& backoff, int channel)
 {
     processRequestLatency(httpReq);
+
+    if (mAdaptiveController)
+    {
+        mAdaptiveController->requestFailed(static_cast<unsigned>(channel),
+                                           std::chrono::steady_clock::now());
+    }
+
     ++tsStats.mNumFailedRequests;
     LOG_warn << "Conn " << channel << " : Failed chunk. HTTP status: " << httpReq->httpstatus
              << " [httpReq = " << (void*)httpReq.get()
@@ -80,7 +80,9 @@ std::string TransferStats::Metrics::toString(const std::string& separator) const
     oss << "Max Speed: " << mMaxSpeed << separator;
     oss << "Avg Latency: " << mAvgLatency << separator;
     oss << "Failed Request Ratio: " << mFailedRequestRatio << separator;
-    oss << "Raided Transfer Ratio: " << mRaidedTransferRatio;
+    oss << "Raided Transfer Ratio: " << mRaidedTransferRatio << separator;
+    oss << "Avg Connections: " << mAvgConnections << separator;
+    oss << "Median Request Size: " << mMedianRequestSize;
 
     return oss.str();
 }
@@ -168,11 +170,13 @@ TransferStats::Metrics TransferStats::collectMetrics(const direction_t type) con
     // Declare sizes & speeds vectors and accumulated values.
     std::vector<m_off_t> sizes;
     std::vector<m_off_t> speeds;
+    std::vector<m_off_t> requestSizes;
     sizes.reserve(mTransfersData.size());
     speeds.reserve(mTransfersData.size());
     double totalLatency = 0.0;
     double totalFailedRequestRatios = 0.0;
     size_t totalRaidedTransfers = 0;
+    size_t totalConnections = 0;
 
     for (const auto& transferData: mTransfersData)
     {
@@ -183,11 +187,19 @@ TransferStats::Metrics TransferStats::collectMetrics(const direction_t type) con
         totalLatency += transferData.mLatency;
         totalFailedRequestRatios += transferData.mFailedRequestRatio;
         totalRaidedTransfers += transferData.mIsRaided ? 1 : 0;
+        totalConnections += transferData.mConnections;
+
+        // Only adaptive transfers choose their request size.
+        if (transferData.mRequestSize > 0)
+        {
+            requestSizes.push_back(transferData.mRequestSize);
+        }
     }
 
     // Sort the vectors in place.
     std::sort(sizes.begin(), sizes.end());
     std::sort(speeds.begin(), speeds.end());
+    std::sort(requestSizes.begin(), requestSizes.end());
 
     // Calculate median and weighted averages.
     metrics.mMedianSize = calculateMedian(sizes);
@@ -217,6 +229,14 @@ TransferStats::Metrics TransferStats::collectMetrics(const direction_t type) con
                                        100.0;
     }
 
+    // Calculate average connections (with precision to 2 decimals).
+    metrics.mAvgConnections = std::round((static_cast<double>(totalConnections) /
+                                          static_cast<double>(mTransfersData.size())) *
+                                         100.0) /
+                              100.0;
+
+    metrics.mMedianRequestSize = calculateMedian(requestSizes);
+
     return metrics;
 }
 
@@ -246,6 +266,16 @@ bool TransferStatsManager::addTransferStats(const Transfer* const transfer)
                                              transfer->slot->transferbuf.isRaid() ||
                                                  transfer->slot->transferbuf.isNewRaid()};
 
+    if (const auto& controller = transfer->slot->mAdaptiveController)
+    {
+        transferData.mConnections = controller->connections();
+        transferData.mRequestSize = controller->requestSize();
+    }
+    else
+    {
+        transferData.mConnections = static_cast<unsigned>(transfer->slot->connections);
+    }
+
     std::lock_guard<std::mutex> guard(mTransferStatsMutex);
     return transfer->type == PUT ? mUploadStatistics.addTransferData(std::move(transferData)) :
                                    mDownloadStatistics.addTransferData(std::move(transferData));
@@ -3009,8 +3009,26 @@ bool UserAlerts::unserializeAlert(string* d, uint32_t dbid)
     return false;
 }
 
+template<class AlertContainer>
+void UserAlerts::encodeAlerts(const AlertContainer& container)
+{
+    vector<std::pair<uint32_t, Cacheable*>> records;
+
+    for (auto a : container)
+    {
+        if (!a->removed())
+        {
+            records.emplace_back(MegaClient::CACHEDALERT, a);
+        }
+    }
+
+    mc.encodesc(records);
+}
+
 void UserAlerts::initscalerts() // called after sc50 response has been received
 {
+    encodeAlerts(alerts);
+
     // Alerts are not critical. There is no need to break execution if db ops failed for some (rare) reason
     for (auto& a : alerts)
     {
@@ -3032,6 +3050,8 @@ void UserAlerts::purgescalerts() // called from MegaClient::notifypurge()
     LOG_debug << "Notifying " << useralertnotify.size() << " user alerts";
     mc.app->useralerts_updated(&useralertnotify[0], (int)useralertnotify.size());
 
+    encodeAlerts(useralertnotify);
+
     for (auto a : useralertnotify)
     {
         mc.persistAlert(a); // persist to db (add/update/remove)
@@ -1960,6 +1960,14 @@ dstime m_clock_getmonotonictimeDS()
     return duration<dstime, std::milli>(timeMs).count() / 100;
 }
 
+m_time_t m_clock_getmonotonictimeMS()
+{
+    using namespace std::chrono;
+
+    return static_cast<m_time_t>(
+        duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
 m_time_t m_mktime_UTC(const struct tm *src)
 {
     struct tm dst = *src;
@@ -25,18 +25,46 @@
 namespace mega {
 
 std::atomic<dstime> Waiter::ds{0};
-std::mutex Waiter::dsMutex;
 
 // update monotonously increasing timestamp in deciseconds
 void Waiter::bumpds()
 {
-    std::lock_guard<std::mutex> lock(dsMutex);
-    ds = m_clock_getmonotonictimeDS();
+    dstime now = m_clock_getmonotonictimeDS();
+    dstime current = ds.load(std::memory_order_relaxed);
+
+    // a thread that read the clock earlier mustn't overwrite a later value
+    while (current < now && !ds.compare_exchange_weak(current, now, std::memory_order_relaxed))
+    {
+    }
 }
 
 void Waiter::init(dstime timeout)
 {
     maxds = timeout;
+    maxms = NEVER_MS;
+}
+
+void Waiter::wakeupwithin(std::chrono::milliseconds timeout)
+{
+    int64_t ms = std::max<int64_t>(timeout.count(), 0);
+    int64_t current = maxms.load(std::memory_order_relaxed);
+
+    while (ms < current && !maxms.compare_exchange_weak(current, ms, std::memory_order_relaxed))
+    {
+    }
+}
+
+int64_t Waiter::timeoutms() const
+{
+    int64_t ms = maxms;
+    dstime ceiling = maxds;
+
+    if (EVER(ceiling) && ceiling <= NEVER_MS / 100)
+    {
+        ms = std::min(ms, static_cast<int64_t>(ceiling) * 100);
+    }
+
+    return ms == NEVER_MS ? -1 : ms;
 }
 
 // add events to wakeup criteria
@@ -0,0 +1,109 @@
+#include "mega/win32/gfx/worker/shared_memory.h"
+
+#include "mega/logging.h"
+
+#include <atomic>
+#include <sstream>
+
+namespace
+{
+const std::string NAME_PREFIX{"Local\\mega_gfx_"};
+
+// Names only contain ASCII characters
+std::wstring toWideName(const std::string& name)
+{
+    return std::wstring(name.begin(), name.end());
+}
+}
+
+namespace mega {
+namespace gfx {
+
+SharedMemory::SharedMemory(const std::string& name, HANDLE mapping, void* data, size_t size)
+    : mName(name)
+    , mData(static_cast<char*>(data))
+    , mSize(size)
+    , mMapping(mapping)
+{
+}
+
+SharedMemory::~SharedMemory()
+{
+    UnmapViewOfFile(mData);
+    CloseHandle(mMapping);
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::create(size_t size)
+{
+    const auto name = newName();
+    const auto size64 = static_cast<unsigned long long>(size);
+
+    // The mapping is removed once the last handle to it is closed.
+    HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE,
+                                        nullptr,
+                                        PAGE_READWRITE,
+                                        static_cast<DWORD>(size64 >> 32),
+                                        static_cast<DWORD>(size64 & 0xFFFFFFFF),
+                                        toWideName(name).c_str());
+    if (!mapping || GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        LOG_err << "Couldn't create shared memory " << name << ": " << GetLastError();
+        if (mapping) CloseHandle(mapping);
+        return nullptr;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!data)
+    {
+        LOG_err << "Couldn't map shared memory " << name << ": " << GetLastError();
+        CloseHandle(mapping);
+        return nullptr;
+    }
+
+    return std::unique_ptr<SharedMemory>(new SharedMemory(name, mapping, data, size));
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::open(const std::string& name, size_t size)
+{
+    // Only regions created by create()
+    if (!isValidName(name) || !size)
+    {
+        LOG_err << "Invalid shared memory " << name;
+        return nullptr;
+    }
+
+    HANDLE mapping = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, toWideName(name).c_str());
+    if (!mapping)
+    {
+        LOG_err << "Couldn't open shared memory " << name << ": " << GetLastError();
+        return nullptr;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!data)
+    {
+        LOG_err << "Couldn't map shared memory " << name << ": " << GetLastError();
+        CloseHandle(mapping);
+        return nullptr;
+    }
+
+    return std::unique_ptr<SharedMemory>(new SharedMemory(name, mapping, data, size));
+}
+
+bool SharedMemory::isValidName(const std::string& name)
+{
+    return name.size() > NAME_PREFIX.size() && name.compare(0, NAME_PREFIX.size(), NAME_PREFIX) == 0 &&
+           name.find('\\', NAME_PREFIX.size()) == std::string::npos;
+}
+
+std::string SharedMemory::newName()
+{
+    static std::atomic<unsigned> counter{0};
+
+    std::ostringstream oss;
+    oss << NAME_PREFIX << GetCurrentProcessId() << "_" << counter++;
+    return oss.str();
+}
+
+} // namespace gfx
+} // namespace mega
@@ -35,12 +35,13 @@ WinWaiter::~WinWaiter()
 }
 
 // wait for events (socket, I/O completion, timeout + application events)
-// ds specifies the maximum amount of time to wait in deciseconds (or
-// NEVER if no timeout scheduled) (this assumes that the second call to
+// timeoutms() specifies the maximum amount of time to wait in milliseconds (or
+// -1 if no timeout scheduled) (this assumes that the second call to
 // addhandle() was coming from the network layer)
 int WinWaiter::wait()
 {
     int r = 0;
+    int64_t timeoutMs = timeoutms();
     addhandle(externalEvent, NEEDEXEC);
 
     if (index <= MAXIMUM_WAIT_OBJECTS)
@@ -50,21 +51,21 @@ int WinWaiter::wait()
             static_cast<DWORD>(index),
             &handles.front(),
             FALSE,
-            (maxds > static_cast<dstime>(std::numeric_limits<DWORD>::max() / 100)) ?
-                std::numeric_limits<DWORD>::max() :
-                static_cast<DWORD>(maxds * 100),
+            (timeoutMs < 0 || timeoutMs >= static_cast<int64_t>(INFINITE)) ?
+                INFINITE :
+                static_cast<DWORD>(timeoutMs),
             TRUE);
 
         assert(dwWaitResult != WAIT_FAILED);
 
 #ifdef MEGA_MEASURE_CODE
-        if (dwWaitResult == WAIT_TIMEOUT && maxds > 0) ++performanceStats.waitTimedoutNonzero;
-        else if (dwWaitResult == WAIT_TIMEOUT && maxds == 0) ++performanceStats.waitTimedoutZero;
+        if (dwWaitResult == WAIT_TIMEOUT && timeoutMs > 0) ++performanceStats.waitTimedoutNonzero;
+        else if (dwWaitResult == WAIT_TIMEOUT && timeoutMs == 0) ++performanceStats.waitTimedoutZero;
         else if (dwWaitResult == WAIT_IO_COMPLETION) ++performanceStats.waitIOCompleted;
         else if (dwWaitResult >= WAIT_OBJECT_0) ++performanceStats.waitSignalled;
 #endif
 
-        if ((dwWaitResult == WAIT_TIMEOUT) || (dwWaitResult == WAIT_IO_COMPLETION) || maxds == 0 || (dwWaitResult == WAIT_FAILED))
+        if ((dwWaitResult == WAIT_TIMEOUT) || (dwWaitResult == WAIT_IO_COMPLETION) || timeoutMs == 0 || (dwWaitResult == WAIT_FAILED))
         {
             r |= NEEDEXEC;
         }
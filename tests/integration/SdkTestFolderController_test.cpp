@@ -52,6 +52,25 @@ public:
         return rootNode;
     }
 
+    // Folders of fanout subfolders each, depth levels below the top one, all with the same files
+    void createSyntheticTree(const fs::path& folder, int fanout, int depth, int filesPerFolder)
+    {
+        fs::create_directories(folder);
+
+        for (int i = 0; i < filesPerFolder; ++i)
+        {
+            ASSERT_TRUE(createFile(path_u8string(folder / ("f" + std::to_string(i))), false));
+        }
+
+        for (int i = 0; depth > 0 && i < fanout; ++i)
+        {
+            ASSERT_NO_FATAL_FAILURE(createSyntheticTree(folder / ("d" + std::to_string(i)),
+                                                        fanout,
+                                                        depth - 1,
+                                                        filesPerFolder));
+        }
+    }
+
 private:
     const std::string localFolderName = getFilePrefix() + "baseDir";
     const std::string localFileName = "fileTest"; // One (any) file in the tree structure
@@ -161,3 +180,253 @@ TEST_F(SdkTestFolderController, AppData)
     ASSERT_EQ(testAppData, futureAppData.get())
         << "appData has not been correctly propagated to the download subtransfers";
 }
+
+/**
+ * Time to the first byte uploaded, and total time, of a folder upload of a synthetic tree,
+ * with and without pipelining (see MegaUploadOptions::pipelineFolderUpload).
+ *
+ * Meant to be pointed at a local stand-in server with --APIURL, as the times
+ * otherwise mostly measure the network.
+ *
+ * Run with --gtest_also_run_disabled_tests.
+ */
+TEST_F(SdkTestFolderController, DISABLED_PipelinedUploadBenchmark)
+{
+    static constexpr int FANOUT = 10;
+    static constexpr int DEPTH = 3;
+    static constexpr int FILES_PER_FOLDER = 2;
+
+    static const std::string logPre{getLogPrefix()};
+
+    const fs::path localTree = fs::current_path() / (getFilePrefix() + "benchmarkTree");
+    std::error_code ignoredEc;
+    fs::remove_all(localTree, ignoredEc);
+
+    ASSERT_NO_FATAL_FAILURE(createSyntheticTree(localTree, FANOUT, DEPTH, FILES_PER_FOLDER));
+
+    struct Timer: public ::mega::MegaTransferListener
+    {
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point started = Clock::now();
+        std::optional<Clock::duration> toFirstByte;
+        std::promise<int> finished;
+
+        void onTransferUpdate(MegaApi*, MegaTransfer* transfer) override
+        {
+            firstByte(transfer);
+        }
+
+        void onTransferFinish(MegaApi*, MegaTransfer* transfer, MegaError* error) override
+        {
+            firstByte(transfer);
+
+            if (transfer->isFolderTransfer())
+            {
+                finished.set_value(error->getErrorCode());
+            }
+        }
+
+        void firstByte(MegaTransfer* transfer)
+        {
+            if (!transfer->isFolderTransfer() && transfer->getTransferredBytes() > 0 &&
+                !toFirstByte)
+            {
+                toFirstByte = Clock::now() - started;
+            }
+        }
+    };
+
+    auto milliseconds = [](auto d)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+    };
+
+    for (bool pipelined: {false, true})
+    {
+        Timer timer;
+        megaApi[0]->addTransferListener(&timer);
+
+        std::unique_ptr<MegaUploadOptions> options{MegaUploadOptions::createInstance()};
+        options->fileName = getFilePrefix() + (pipelined ? "pipelined" : "sequential");
+        options->pipelineFolderUpload = pipelined;
+
+        megaApi[0]->startUpload(path_u8string(localTree), getRootNode().get(), nullptr, options.get());
+
+        auto result = timer.finished.get_future();
+        ASSERT_EQ(result.wait_for(std::chrono::minutes(30)), std::future_status::ready);
+        auto total = Timer::Clock::now() - timer.started;
+
+        megaApi[0]->removeTransferListener(&timer);
+
+        ASSERT_EQ(result.get(), API_OK);
+        ASSERT_TRUE(timer.toFirstByte);
+
+        LOG_info << logPre << (pipelined ? "pipelined" : "sequential")
+                 << ": first byte after " << milliseconds(*timer.toFirstByte) << "ms, total "
+                 << milliseconds(total) << "ms";
+        std::cout << (pipelined ? "pipelined" : "sequential") << ": first byte after "
+                  << milliseconds(*timer.toFirstByte) << "ms, total " << milliseconds(total)
+                  << "ms" << std::endl;
+    }
+
+    fs::remove_all(localTree, ignoredEc);
+}
+
+/**
+ * Time to the first byte downloaded, total time, and peak growth of the resident memory,
+ * of a folder download of a synthetic tree, which is streamed from the node database
+ * rather than first loaded whole.
+ *
+ * Meant to be pointed at a local stand-in server with --APIURL, as the times
+ * otherwise mostly measure the network. The memory is only measured on Linux.
+ *
+ * Run with --gtest_also_run_disabled_tests.
+ */
+TEST_F(SdkTestFolderController, DISABLED_StreamingDownloadBenchmark)
+{
+    static constexpr int FANOUT = 10;
+    static constexpr int DEPTH = 3;
+    static constexpr int FILES_PER_FOLDER = 2;
+
+    static const std::string logPre{getLogPrefix()};
+
+    const fs::path localTree = fs::current_path() / (getFilePrefix() + "benchmarkTree");
+    const fs::path downloaded = fs::current_path() / (getFilePrefix() + "benchmarkDownload");
+    std::error_code ignoredEc;
+    fs::remove_all(localTree, ignoredEc);
+    fs::remove_all(downloaded, ignoredEc);
+    fs::create_directories(downloaded);
+
+    ASSERT_NO_FATAL_FAILURE(createSyntheticTree(localTree, FANOUT, DEPTH, FILES_PER_FOLDER));
+
+    MegaHandle remoteTree = INVALID_HANDLE;
+    ASSERT_EQ(MegaError::API_OK,
+              doStartUpload(0,
+                            &remoteTree,
+                            path_u8string(localTree).c_str(),
+                            getRootNode().get(),
+                            nullptr /*fileName*/,
+                            ::mega::MegaApi::INVALID_CUSTOM_MOD_TIME,
+                            nullptr /*appData*/,
+                            false /*isSourceTemporary*/,
+                            false /*startFirst*/,
+                            nullptr /*cancelToken*/))
+        << "Failed to upload the tree";
+
+    unique_ptr<MegaNode> remoteTreeNode{megaApi[0]->getNodeByHandle(remoteTree)};
+    ASSERT_TRUE(remoteTreeNode);
+
+    // resident memory, in kB
+    auto residentMemory = []() -> std::optional<long long>
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+
+        while (std::getline(status, line))
+        {
+            if (line.rfind("VmRSS:", 0) == 0)
+            {
+                return std::stoll(line.substr(6));
+            }
+        }
+
+        return std::nullopt;
+    };
+
+    struct Timer: public ::mega::MegaTransferListener
+    {
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point started = Clock::now();
+        std::optional<Clock::duration> toFirstByte;
+        std::promise<int> finished;
+
+        void onTransferUpdate(MegaApi*, MegaTransfer* transfer) override
+        {
+            firstByte(transfer);
+        }
+
+        void onTransferFinish(MegaApi*, MegaTransfer* transfer, MegaError* error) override
+        {
+            firstByte(transfer);
+
+            if (transfer->isFolderTransfer())
+            {
+                finished.set_value(error->getErrorCode());
+            }
+        }
+
+        void firstByte(MegaTransfer* transfer)
+        {
+            if (!transfer->isFolderTransfer() && transfer->getTransferredBytes() > 0 &&
+                !toFirstByte)
+            {
+                toFirstByte = Clock::now() - started;
+            }
+        }
+    };
+
+    auto before = residentMemory();
+    std::atomic<long long> peak{before.value_or(0)};
+    std::atomic<bool> sampling{true};
+
+    std::thread sampler(
+        [&]()
+        {
+            while (sampling)
+            {
+                if (auto current = residentMemory(); current && *current > peak)
+                {
+                    peak = *current;
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        });
+
+    Timer timer;
+    megaApi[0]->addTransferListener(&timer);
+
+    megaApi[0]->startDownload(remoteTreeNode.get(),
+                              path_u8string(downloaded / "").c_str(),
+                              nullptr /*customName*/,
+                              nullptr /*appData*/,
+                              false /*startFirst*/,
+                              nullptr /*cancelToken*/,
+                              MegaTransfer::COLLISION_CHECK_FINGERPRINT,
+                              MegaTransfer::COLLISION_RESOLUTION_OVERWRITE,
+                              false /*undelete*/);
+
+    auto result = timer.finished.get_future();
+    auto ready = result.wait_for(std::chrono::minutes(30));
+    auto total = Timer::Clock::now() - timer.started;
+
+    sampling = false;
+    sampler.join();
+    megaApi[0]->removeTransferListener(&timer);
+
+    ASSERT_EQ(ready, std::future_status::ready);
+    ASSERT_EQ(result.get(), API_OK);
+    ASSERT_TRUE(timer.toFirstByte);
+
+    auto milliseconds = [](auto d)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+    };
+
+    std::ostringstream report;
+    report << "first byte after " << milliseconds(*timer.toFirstByte) << "ms, total "
+           << milliseconds(total) << "ms";
+
+    if (before)
+    {
+        report << ", resident memory grew by at most " << (peak - *before) << "kB";
+    }
+
+    LOG_info << logPre << report.str();
+    std::cout << report.str() << std::endl;
+
+    fs::remove_all(localTree, ignoredEc);
+    fs::remove_all(downloaded, ignoredEc);
+}
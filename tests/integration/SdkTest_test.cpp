@@ -42,6 +42,7 @@
 #include <cctype>
 #include <chrono>
 #include <cstdint>
+#include <future>
 #include <map>
 #include <mutex>
 #include <set>
@@ -14952,6 +14953,84 @@ TEST_F(SdkTest, SearchNodesByCreationTime)
 }
 
 
+/**
+ * @brief TEST_F SearchNodesWhileSdkThreadWrites
+ *
+ * Test that search() and getChildren() don't wait for the SDK thread while it writes nodes
+ *
+ */
+TEST_F(SdkTest, SearchNodesWhileSdkThreadWrites)
+{
+    LOG_info << "___TEST SearchNodesWhileSdkThreadWrites___";
+
+    ASSERT_NO_FATAL_FAILURE(getAccountsForTest(1));
+
+    unique_ptr<MegaNode> rootnode(megaApi[0]->getRootNode());
+    ASSERT_TRUE(rootnode);
+    const MegaHandle rootHandle = rootnode->getHandle();
+
+    const string folderName = "SearchWhileWriting_Folder";
+
+    // onNodesUpdate is called on the SDK thread, which holds sdkMutex, once the new folder
+    // has been written to the DB and before that transaction is committed
+    bool searchStarted = false;
+    std::future<std::pair<int, int>> search;
+    std::promise<bool> searchedWhileWriting;
+
+    mApi[0].mOnNodesUpdateCompletion = [&](size_t, MegaNodeList* nodes)
+    {
+        if (searchStarted || !nodes)
+        {
+            return;
+        }
+
+        bool added = false;
+        for (int i = 0; i < nodes->size() && !added; ++i)
+        {
+            added = nodes->get(i)->hasChanged(MegaNode::CHANGE_TYPE_NEW) &&
+                    folderName == nodes->get(i)->getName();
+        }
+
+        if (!added)
+        {
+            return;
+        }
+
+        searchStarted = true;
+        search = std::async(std::launch::async,
+                            [this, &folderName, rootHandle]()
+                            {
+                                unique_ptr<MegaSearchFilter> f(MegaSearchFilter::createInstance());
+                                f->byName(folderName.c_str());
+                                unique_ptr<MegaNodeList> found(megaApi[0]->search(f.get()));
+
+                                f->byLocationHandle(rootHandle);
+                                unique_ptr<MegaNodeList> children(megaApi[0]->getChildren(f.get()));
+
+                                return std::make_pair(found->size(), children->size());
+                            });
+
+        // the SDK thread stays here until the search returns, or gives up on it
+        searchedWhileWriting.set_value(search.wait_for(std::chrono::seconds(30)) ==
+                                       std::future_status::ready);
+    };
+
+    MegaHandle folderHandle = createFolder(0, folderName.c_str(), rootnode.get());
+
+    auto searched = searchedWhileWriting.get_future();
+    bool callbackCalled =
+        searched.wait_for(std::chrono::seconds(maxTimeout)) == std::future_status::ready;
+    mApi[0].mOnNodesUpdateCompletion = nullptr;
+
+    ASSERT_NE(folderHandle, INVALID_HANDLE);
+    ASSERT_TRUE(callbackCalled) << "New folder not reported by onNodesUpdate";
+    ASSERT_TRUE(searched.get()) << "search() waited for the SDK thread to finish writing";
+
+    auto [found, children] = search.get();
+    EXPECT_EQ(found, 1) << "search() didn't see the folder being written";
+    EXPECT_EQ(children, 1) << "getChildren() didn't see the folder being written";
+}
+
 /**
  * @brief TEST_F SearchNodesByModificationTime
  *
@@ -0,0 +1,462 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega/base64.h>
+#include <mega/db/sqlite.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+#include <mega/node.h>
+#include <stdfs.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+
+using namespace mega;
+
+namespace
+{
+
+// Counts what the app is told about, as listeners would receive it.
+struct ReplayApp: MegaApp
+{
+    size_t nodesNotified = 0;
+    size_t alertsNotified = 0;
+
+    void nodes_updated(sharedNode_vector* nodes, int count) override
+    {
+        if (nodes)
+            nodesNotified += static_cast<size_t>(count);
+    }
+
+    void useralerts_updated(UserAlert::Base**, int count) override
+    {
+        alertsNotified += static_cast<size_t>(count);
+    }
+};
+
+// A logged in client with a local cache, up to date with an empty account.
+std::shared_ptr<MegaClient> makeReplayClient(MegaApp& app, const LocalPath& folder, unsigned threads)
+{
+    auto client = mt::makeClient(app, new SqliteDbAccess(folder), threads);
+
+    byte masterKey[SymmCipher::KEYLENGTH];
+    client->rng.genblock(masterKey, sizeof(masterKey));
+    client->key.setkey(masterKey);
+
+    client->me = 0x0102030405060708;
+    client->uid = Base64Str<MegaClient::USERHANDLE>(client->me);
+    client->finduser(client->me, 1);
+
+    // outgoing shares are only processed for full accounts
+    CryptoPP::Integer publicKey[AsymmCipher::PUBKEY];
+    client->mPrivateRsaKey.genkeypair(client->rng, publicKey, 2048);
+
+    client->sid.assign(MegaClient::SIDLEN, 's');
+    client->opensctable();
+
+    client->scsn.setScsn(1);
+    client->initsc();
+
+    client->statecurrent = true;
+    client->actionpacketsCurrent = true;
+
+    return client;
+}
+
+// Generates sc responses, as the API would send them, changing the tree of
+// the account of a client made by makeReplayClient.
+class ActionPacketStream
+{
+public:
+    explicit ActionPacketStream(MegaClient& client, unsigned seed = 1):
+        mClient(client),
+        mRandom(seed)
+    {}
+
+    // A response creating the root and some folders under it.
+    std::string initialTree(size_t folders)
+    {
+        mRoot = mNextHandle++;
+
+        std::vector<std::string> packets;
+        packets.emplace_back("{\"a\":\"t\",\"t\":{\"f\":[{\"h\":\"" + nodeHandle(mRoot) +
+                             "\",\"t\":2,\"u\":\"" + mClient.uid + "\",\"ts\":1}]}}");
+
+        for (size_t i = 0; i < folders; ++i)
+            packets.emplace_back(create(FOLDERNODE, mRoot));
+
+        return response(packets);
+    }
+
+    // Responses of up to perResponse packets each, count packets in all,
+    // mixing creates, attribute updates, moves, deletes and share changes.
+    std::vector<std::string> changes(size_t count, size_t perResponse)
+    {
+        std::vector<std::string> responses;
+        std::vector<std::string> packets;
+
+        for (size_t sent = 0; sent < count;)
+        {
+            auto before = packets.size();
+
+            change(packets);
+            sent += packets.size() - before;
+
+            if (packets.size() >= perResponse)
+            {
+                responses.emplace_back(response(packets));
+                packets.clear();
+            }
+        }
+
+        if (!packets.empty())
+            responses.emplace_back(response(packets));
+
+        return responses;
+    }
+
+    // Nodes expected in the tree, root included.
+    size_t nodes() const
+    {
+        return mNodes.size() + 1;
+    }
+
+    // Expected name of each node but the root.
+    std::map<handle, std::string> names() const
+    {
+        std::map<handle, std::string> names;
+
+        for (auto& node: mNodes)
+            names[node.first] = node.second.name;
+
+        return names;
+    }
+
+private:
+    struct GeneratedNode
+    {
+        nodetype_t type;
+        handle parent;
+        std::string key;
+        std::string name;
+    };
+
+    void change(std::vector<std::string>& packets)
+    {
+        std::uniform_int_distribution<int> operation(0, 99);
+        auto o = operation(mRandom);
+
+        if (o < 40 || mFiles.size() < 2)
+            packets.emplace_back(create(FILENODE, folder()));
+        else if (o < 45)
+            packets.emplace_back(create(FOLDERNODE, folder()));
+        else if (o < 70)
+            packets.emplace_back(rename(file()));
+        else if (o < 80)
+            move(file(), folder(), packets);
+        else if (o < 90)
+            packets.emplace_back(remove(file()));
+        else
+            packets.emplace_back(share(folder()));
+    }
+
+    std::string create(nodetype_t type, handle parent)
+    {
+        auto h = mNextHandle++;
+        auto& node = mNodes[h];
+
+        node.type = type;
+        node.parent = parent;
+        node.key.resize(type == FILENODE ? FILENODEKEYLENGTH : FOLDERNODEKEYLENGTH);
+        mClient.rng.genblock(reinterpret_cast<byte*>(node.key.data()), node.key.size());
+        node.name = (type == FILENODE ? "file" : "folder") + std::to_string(h);
+
+        (type == FILENODE ? mFiles : mFolders).emplace_back(h);
+
+        return "{\"a\":\"t\",\"t\":{\"f\":[" + nodeJson(h) + "]},\"ou\":\"" + mClient.uid + "\"}";
+    }
+
+    std::string rename(handle h)
+    {
+        auto& node = mNodes[h];
+        node.name = "renamed" + std::to_string(mNextHandle++);
+
+        return "{\"a\":\"u\",\"n\":\"" + nodeHandle(h) + "\",\"u\":\"" + mClient.uid +
+               "\",\"at\":\"" + attributes(node) + "\",\"ts\":2}";
+    }
+
+    // As the API sends moves: a deletion followed by the node under its new parent.
+    void move(handle h, handle parent, std::vector<std::string>& packets)
+    {
+        mNodes[h].parent = parent;
+
+        packets.emplace_back("{\"a\":\"d\",\"n\":\"" + nodeHandle(h) + "\",\"m\":1}");
+        packets.emplace_back("{\"a\":\"t\",\"t\":{\"f\":[" + nodeJson(h) + "]}}");
+    }
+
+    std::string remove(handle h)
+    {
+        mNodes.erase(h);
+        mFiles.erase(std::find(mFiles.begin(), mFiles.end(), h));
+
+        return "{\"a\":\"d\",\"n\":\"" + nodeHandle(h) + "\"}";
+    }
+
+    // Shares a folder with a contact, or stops sharing it.
+    std::string share(handle h)
+    {
+        static constexpr handle PEER = 0x0807060504030201;
+
+        auto packet = "{\"a\":\"s2\",\"n\":\"" + nodeHandle(h) + "\",\"o\":\"" + mClient.uid +
+                      "\",\"u\":\"" + std::string(Base64Str<MegaClient::USERHANDLE>(PEER)) + "\"";
+
+        if (mShared.count(h))
+        {
+            mShared.erase(h);
+            return packet + "}";
+        }
+
+        mShared.insert(h);
+
+        byte shareKey[SymmCipher::KEYLENGTH];
+        mClient.rng.genblock(shareKey, sizeof(shareKey));
+        mClient.key.ecb_encrypt(shareKey);
+
+        byte auth[SymmCipher::KEYLENGTH];
+        mClient.handleauth(h, auth);
+
+        return packet + ",\"r\":1,\"ts\":2,\"ok\":\"" +
+               Base64::btoa(std::string(reinterpret_cast<char*>(shareKey), sizeof(shareKey))) +
+               "\",\"ha\":\"" +
+               Base64::btoa(std::string(reinterpret_cast<char*>(auth), sizeof(auth))) + "\"}";
+    }
+
+    std::string nodeJson(handle h)
+    {
+        auto& node = mNodes[h];
+
+        std::string key = node.key;
+        mClient.key.ecb_encrypt(reinterpret_cast<byte*>(key.data()),
+                                reinterpret_cast<byte*>(key.data()),
+                                key.size());
+
+        auto json = "{\"h\":\"" + nodeHandle(h) + "\",\"p\":\"" + nodeHandle(node.parent) +
+                    "\",\"u\":\"" + mClient.uid + "\",\"t\":" + std::to_string(node.type) +
+                    ",\"a\":\"" + attributes(node) + "\",\"k\":\"" + mClient.uid + ":" +
+                    Base64::btoa(key) + "\",\"ts\":1";
+
+        if (node.type == FILENODE)
+            json += ",\"s\":" + std::to_string(h % 100000);
+
+        return json + "}";
+    }
+
+    static std::string attributes(const GeneratedNode& node)
+    {
+        SymmCipher cipher;
+        cipher.setkey(&node.key);
+
+        std::string attrs;
+        MegaClient::makeattr(&cipher, &attrs, ("\"n\":\"" + node.name + "\"").c_str());
+
+        return Base64::btoa(attrs);
+    }
+
+    std::string response(const std::vector<std::string>& packets)
+    {
+        std::string response = "{\"a\":[";
+
+        for (size_t i = 0; i < packets.size(); ++i)
+            response += (i ? "," : "") + packets[i];
+
+        return response + "],\"sn\":\"" +
+               std::string(Base64Str<sizeof(handle)>(static_cast<handle>(++mScsn))) + "\"}";
+    }
+
+    static std::string nodeHandle(handle h)
+    {
+        return std::string(Base64Str<MegaClient::NODEHANDLE>(h));
+    }
+
+    handle folder()
+    {
+        return mFolders[std::uniform_int_distribution<size_t>(0, mFolders.size() - 1)(mRandom)];
+    }
+
+    handle file()
+    {
+        return mFiles[std::uniform_int_distribution<size_t>(0, mFiles.size() - 1)(mRandom)];
+    }
+
+    MegaClient& mClient;
+    std::mt19937 mRandom;
+    handle mNextHandle = 1;
+    handle mRoot = UNDEF;
+    uint64_t mScsn = 1;
+    std::map<handle, GeneratedNode> mNodes;
+    std::vector<handle> mFolders;
+    std::vector<handle> mFiles;
+    std::set<handle> mShared;
+};
+
+// Delivers a response as the sc channel does once it has been received.
+void deliver(MegaClient& client, const std::string& response)
+{
+    client.jsonsc.begin(response.c_str());
+    client.jsonsc.enterobject();
+    client.processScMessageNonStreaming();
+}
+
+// Bytes the process has passed to write(), which is what the DB costs us.
+uint64_t bytesWritten()
+{
+#ifdef __linux__
+    std::ifstream io("/proc/self/io");
+    std::string name;
+    uint64_t value;
+
+    while (io >> name >> value)
+    {
+        if (name == "wchar:")
+            return value;
+    }
+#endif
+
+    return 0;
+}
+
+} // anonymous
+
+TEST(ActionPacketReplay, appliesGeneratedStream)
+{
+    auto path = std::filesystem::current_path() / "action_packet_replay";
+    const MrProper cleanUp(
+        [path]()
+        {
+            std::filesystem::remove_all(path);
+        });
+
+    std::filesystem::create_directory(path);
+    auto folder = LocalPath::fromAbsolutePath(path_u8string(path));
+
+    ReplayApp app;
+    auto client = makeReplayClient(app, folder, 0);
+
+    ActionPacketStream stream(*client);
+
+    deliver(*client, stream.initialTree(10));
+
+    for (auto& response: stream.changes(500, 20))
+    {
+        deliver(*client, response);
+        ASSERT_FALSE(client->jsonsc.pos);
+    }
+
+    EXPECT_EQ(client->mNodeManager.getNodeCount(), stream.nodes());
+    EXPECT_GT(app.nodesNotified, 0u);
+
+    for (auto& expected: stream.names())
+    {
+        auto node = client->nodebyhandle(expected.first);
+
+        ASSERT_TRUE(node);
+        EXPECT_EQ(node->displayname(), expected.second);
+    }
+}
+
+// Applies generated action packets, in responses of several sizes, to a
+// client with a local cache. Reports packets per second, the time taken to
+// apply each response (p50/p99) and how many bytes are written per byte of
+// action packets received.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(ActionPacketReplay, DISABLED_benchmark)
+{
+    static constexpr size_t PACKETS = 50000;
+    static constexpr size_t FOLDERS = 1000;
+
+    auto path = std::filesystem::current_path() / "action_packet_replay";
+    const MrProper cleanUp(
+        [path]()
+        {
+            std::filesystem::remove_all(path);
+        });
+
+    for (size_t perResponse: {1u, 50u, 1000u})
+    {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directory(path);
+        auto folder = LocalPath::fromAbsolutePath(path_u8string(path));
+
+        ReplayApp app;
+        auto client = makeReplayClient(app, folder, std::thread::hardware_concurrency());
+
+        ActionPacketStream stream(*client);
+
+        deliver(*client, stream.initialTree(FOLDERS));
+
+        auto responses = stream.changes(PACKETS, perResponse);
+
+        size_t received = 0;
+        for (auto& response: responses)
+            received += response.size();
+
+        std::vector<std::chrono::steady_clock::duration> latencies;
+        latencies.reserve(responses.size());
+
+        auto written = bytesWritten();
+        auto started = std::chrono::steady_clock::now();
+
+        for (auto& response: responses)
+        {
+            auto applying = std::chrono::steady_clock::now();
+            deliver(*client, response);
+            latencies.emplace_back(std::chrono::steady_clock::now() - applying);
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - started;
+        written = bytesWritten() - written;
+
+        std::sort(latencies.begin(), latencies.end());
+
+        auto us = [](std::chrono::steady_clock::duration d)
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+        };
+
+        auto seconds = std::chrono::duration<double>(elapsed).count();
+
+        std::cout << PACKETS << " packets, " << perResponse << " per response: "
+                  << static_cast<size_t>(static_cast<double>(PACKETS) / seconds) << " packets/s, p50 "
+                  << us(latencies[latencies.size() / 2]) << "us p99 "
+                  << us(latencies[latencies.size() * 99 / 100]) << "us per response, "
+                  << static_cast<double>(written) / static_cast<double>(received)
+                  << " bytes written per byte received, " << app.nodesNotified
+                  << " node and " << app.alertsNotified << " alert notifications" << std::endl;
+    }
+}
@@ -16,9 +16,19 @@
  * program.
  */
 
+#include "utils.h"
+
 #include <gtest/gtest.h>
 #include <mega/attrmap.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+#include <mega/node.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
+#include <iostream>
 #include <map>
 #include <string>
 #include <string_view>
@@ -113,3 +123,111 @@ TEST(AttrMap, applyUpdatesWithNestedFields)
     expected = toAttrMap({{"b", "hello"}, {"c", "world"}});
     EXPECT_EQ(baseMap.map, expected.map);
 }
+
+TEST(AttrMap, behavesAsSortedMap)
+{
+    attr_map map;
+
+    EXPECT_TRUE(map.emplace('n', "name").second);
+    EXPECT_FALSE(map.emplace('n', "other").second);
+    map['c'] = "fingerprint";
+    map[AttrMap::string2nameid("lbl")] = "1";
+    map.insert({'a', "first"});
+
+    std::vector<nameid> names;
+    for (auto& [name, value]: map)
+        names.emplace_back(name);
+
+    EXPECT_EQ(names, (std::vector<nameid>{'a', 'c', 'n', AttrMap::string2nameid("lbl")}));
+    EXPECT_EQ(map.at('n'), "name");
+    EXPECT_THROW(map.at('x'), std::out_of_range);
+    EXPECT_EQ(map.find('x'), map.end());
+    EXPECT_EQ(map.count('c'), 1u);
+
+    EXPECT_EQ(map.erase('c'), 1u);
+    EXPECT_EQ(map.erase('c'), 0u);
+    EXPECT_FALSE(map.contains('c'));
+
+    auto it = map.erase(map.find('a'));
+    EXPECT_EQ(it->first, 'n');
+    EXPECT_EQ(map.size(), 2u);
+}
+
+// Reports the heap used per node for a tree of a million files, and how much
+// of it the attributes take compared to a std::map per node.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(AttrMap, DISABLED_benchmarkBytesPerNode)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    static constexpr size_t COUNT = 1000000;
+
+    auto heap = []()
+    {
+        return mallinfo2().uordblks;
+    };
+
+    // what a fetchnodes leaves in the attributes of files
+    auto attributes = [](size_t i)
+    {
+        std::string json = "\"n\":\"IMG_" + std::to_string(i) + ".jpg\",\"c\":\"" +
+                           std::string(31, 'A') + "\"";
+
+        if (!(i % 10))
+            json += ",\"lbl\":\"2\"";
+
+        if (!(i % 20))
+            json += ",\"fav\":\"1\"";
+
+        return json;
+    };
+
+    MegaApp app;
+    auto client = mt::makeClient(app);
+
+    sharedNode_vector nodes;
+    nodes.reserve(COUNT);
+
+    auto before = heap();
+
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        auto node = std::make_shared<Node>(*client,
+                                           NodeHandle().set6byte(i + 2),
+                                           NodeHandle().set6byte(1),
+                                           FILENODE,
+                                           1024,
+                                           UNDEF,
+                                           nullptr,
+                                           0);
+
+        node->attrs.fromjson(attributes(i).c_str());
+        nodes.emplace_back(std::move(node));
+    }
+
+    auto perNode = (heap() - before) / COUNT;
+
+    std::vector<AttrMap> attrMaps(COUNT);
+    before = heap();
+
+    for (size_t i = 0; i < COUNT; ++i)
+        attrMaps[i].fromjson(attributes(i).c_str());
+
+    auto perAttrMap = (heap() - before) / COUNT;
+
+    std::vector<std::map<nameid, std::string>> stdMaps(COUNT);
+    before = heap();
+
+    for (size_t i = 0; i < COUNT; ++i)
+        for (auto& [name, value]: attrMaps[i].map)
+            stdMaps[i][name] = value;
+
+    auto perStdMap = (heap() - before) / COUNT;
+
+    std::cout << COUNT << " nodes: " << perNode << " bytes per node, of which attributes "
+              << perAttrMap + sizeof(AttrMap) << " (with a std::map "
+              << perStdMap + sizeof(std::map<nameid, std::string>) << ")" << std::endl;
+#else
+    GTEST_SKIP() << "Heap usage is only reported with glibc";
+#endif
+}
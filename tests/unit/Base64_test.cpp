@@ -0,0 +1,237 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+#include <mega/base64.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace mega;
+
+namespace
+{
+
+// The byte at a time conversions, as the vectorized ones must produce the same.
+const std::string ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+std::string referenceEncode(const std::string& in)
+{
+    std::string out;
+    size_t i = 0;
+
+    for (; i + 3 <= in.size(); i += 3)
+    {
+        unsigned v = static_cast<unsigned>(static_cast<byte>(in[i])) << 16 |
+                     static_cast<unsigned>(static_cast<byte>(in[i + 1])) << 8 |
+                     static_cast<byte>(in[i + 2]);
+
+        for (int shift = 18; shift >= 0; shift -= 6)
+            out += ALPHABET[(v >> shift) & 63];
+    }
+
+    if (in.size() - i == 1)
+    {
+        unsigned v = static_cast<byte>(in[i]);
+        out += ALPHABET[v >> 2];
+        out += ALPHABET[(v << 4) & 63];
+    }
+    else if (in.size() - i == 2)
+    {
+        unsigned v = static_cast<unsigned>(static_cast<byte>(in[i])) << 8 | static_cast<byte>(in[i + 1]);
+        out += ALPHABET[v >> 10];
+        out += ALPHABET[(v >> 4) & 63];
+        out += ALPHABET[(v << 2) & 63];
+    }
+
+    return out;
+}
+
+int value(char c)
+{
+    if (c == '+')
+        return 62;
+
+    if (c == '/')
+        return 63;
+
+    auto i = ALPHABET.find(c);
+    return c && i != std::string::npos ? static_cast<int>(i) : 255;
+}
+
+std::string referenceDecode(const std::string& in, size_t limit)
+{
+    std::string out;
+    int c[4];
+
+    for (size_t pos = 0;;)
+    {
+        int i;
+
+        for (i = 0; i < 4; ++i)
+            if ((c[i] = value(pos < in.size() ? in[pos++] : 0)) == 255)
+                break;
+
+        if (out.size() >= limit || !i)
+            return out;
+
+        out += static_cast<char>((c[0] << 2) | ((c[1] & 0x30) >> 4));
+
+        if (out.size() >= limit || i < 3)
+            return out;
+
+        out += static_cast<char>((c[1] << 4) | ((c[2] & 0x3c) >> 2));
+
+        if (out.size() >= limit || i < 4)
+            return out;
+
+        out += static_cast<char>((c[2] << 6) | c[3]);
+    }
+}
+
+std::string randomBytes(std::mt19937& random, size_t size)
+{
+    std::string bytes(size, '\0');
+
+    for (auto& b: bytes)
+        b = static_cast<char>(random());
+
+    return bytes;
+}
+
+} // anonymous
+
+TEST(Base64, encodesAsByteAtATime)
+{
+    std::mt19937 random(1);
+
+    for (size_t size = 0; size < 300; ++size)
+    {
+        auto in = randomBytes(random, size);
+
+        ASSERT_EQ(Base64::btoa(in), referenceEncode(in)) << size;
+
+        // the C string API writes a terminator
+        std::string out(size * 4 / 3 + 4, 'x');
+        auto n = Base64::btoa(reinterpret_cast<const byte*>(in.data()), in.size(), out.data());
+
+        ASSERT_EQ(out.substr(0, n), referenceEncode(in));
+        ASSERT_EQ(out[n], '\0');
+    }
+}
+
+TEST(Base64, decodesAsByteAtATime)
+{
+    std::mt19937 random(2);
+
+    for (size_t size = 0; size < 300; ++size)
+    {
+        auto encoded = referenceEncode(randomBytes(random, size));
+
+        ASSERT_EQ(Base64::atob(encoded), referenceDecode(encoded, SIZE_MAX)) << size;
+
+        // the standard alphabet is accepted too
+        auto standard = encoded;
+        for (auto& c: standard)
+            c = c == '-' ? '+' : c == '_' ? '/' : c;
+
+        ASSERT_EQ(Base64::atob(standard), Base64::atob(encoded));
+
+        // the C string API, which stops at the first invalid character
+        std::string out(size + 3, '\0');
+        auto n = Base64::atob(encoded.c_str(), reinterpret_cast<byte*>(out.data()), static_cast<int>(out.size()));
+        out.resize(static_cast<size_t>(n));
+
+        ASSERT_EQ(out, referenceDecode(encoded, SIZE_MAX));
+    }
+}
+
+TEST(Base64, decodeStopsAtInvalidCharactersAndLimits)
+{
+    std::mt19937 random(3);
+
+    auto encoded = referenceEncode(randomBytes(random, 200));
+
+    for (size_t at = 0; at < encoded.size(); at += 7)
+    {
+        for (char invalid: {'"', '=', ':', '\0', '\x80'})
+        {
+            auto in = encoded;
+            in[at] = invalid;
+
+            ASSERT_EQ(Base64::atob(in), referenceDecode(in, SIZE_MAX)) << at;
+        }
+    }
+
+    for (size_t limit = 0; limit < 160; ++limit)
+    {
+        std::string out(limit, '\0');
+        auto n = Base64::atob(encoded.data(),
+                              encoded.size(),
+                              reinterpret_cast<byte*>(out.data()),
+                              static_cast<int>(limit));
+        out.resize(static_cast<size_t>(n));
+
+        ASSERT_EQ(out, referenceDecode(encoded, limit)) << limit;
+    }
+
+    // at most alen characters are decoded
+    EXPECT_EQ(Base64::atob(encoded.data(), 40, nullptr, 0), 0);
+
+    std::string out(200, '\0');
+    auto n = Base64::atob(encoded.data(), 40, reinterpret_cast<byte*>(out.data()), 200);
+    EXPECT_EQ(out.substr(0, static_cast<size_t>(n)), referenceDecode(encoded.substr(0, 40), SIZE_MAX));
+}
+
+// Compares the conversions with the byte at a time ones, for handles and for
+// attribute blobs. Run with --gtest_also_run_disabled_tests.
+TEST(Base64, DISABLED_benchmark)
+{
+    std::mt19937 random(4);
+
+    for (size_t size: {6u, 8u, 32u, 4096u})
+    {
+        auto in = randomBytes(random, size);
+        auto encoded = Base64::btoa(in);
+        auto iterations = 64 * 1024 * 1024 / size;
+
+        auto time = [iterations](auto&& f)
+        {
+            auto started = std::chrono::steady_clock::now();
+
+            for (size_t i = 0; i < iterations; ++i)
+                f();
+
+            auto elapsed = std::chrono::steady_clock::now() - started;
+            return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+        };
+
+        size_t sink = 0;
+
+        auto encode = time([&]() { sink += Base64::btoa(in).size(); });
+        auto referenceEncodeTime = time([&]() { sink += referenceEncode(in).size(); });
+        auto decode = time([&]() { sink += Base64::atob(encoded).size(); });
+        auto referenceDecodeTime = time([&]() { sink += referenceDecode(encoded, SIZE_MAX).size(); });
+
+        std::cout << size << " bytes x " << iterations << ": encode " << encode << "ms (byte at a time "
+                  << referenceEncodeTime << "ms), decode " << decode << "ms (byte at a time "
+                  << referenceDecodeTime << "ms)" << (sink ? "" : " ") << std::endl;
+    }
+}
@@ -28,6 +28,11 @@
 #include <mega/user.h>
 #include <mega/utils.h>
 
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
 class CacheLRU: public testing::Test
 {
 protected:
@@ -871,3 +876,189 @@ TEST_F(CacheLRU, reduceCacheLRUSize)
     // Root node + rubbish + vault + folder
     ASSERT_EQ(numNodesTotal(), numNodes + 4);
 }
+
+TEST_F(CacheLRU, searchNodesSeesUncommittedChanges)
+{
+    auto rootNode = init(8);
+    auto folder = addNode(mega::nodetype_t::FOLDERNODE, rootNode, false, true);
+    auto table = dynamic_cast<mega::DBTableNodes*>(mClient->sctable.get());
+    ASSERT_NE(table, nullptr);
+
+    auto addFile = [this, &folder](const std::string& name)
+    {
+        addNode(mega::nodetype_t::FILENODE,
+                folder,
+                true,
+                false,
+                [this, &name](mega::Node& file)
+                {
+                    file.size = static_cast<m_off_t>(mIndex);
+                    file.owner = 88;
+                    file.ctime = 44;
+                    file.attrs.map = std::map<mega::nameid, std::string>{{110, name}};
+                });
+    };
+
+    auto search = [this, &rootNode](const std::string& name)
+    {
+        mega::NodeSearchFilter searchFilter;
+        searchFilter.byAncestors({rootNode->nodehandle, mega::UNDEF, mega::UNDEF});
+        searchFilter.byName(name);
+
+        return mClient->mNodeManager
+            .searchNodes(searchFilter, 0 /*order None*/, mega::CancelToken(), {0, 0})
+            .size();
+    };
+
+    for (int i = 0; i < 16; ++i)
+        addFile("committed" + std::to_string(i));
+
+    // Everything is committed, so searches can be served by a read-only connection.
+    ASSERT_NE(table->readOnlyView(), nullptr);
+    EXPECT_EQ(search("committed1*"), 7u);
+
+    // Views are handed out while a transaction is open, as the SDK thread always has one.
+    mClient->sctable->begin();
+    ASSERT_NE(table->readOnlyView(), nullptr);
+    EXPECT_EQ(table->changeCount(), table->committedChangeCount());
+
+    // Changes that haven't been committed are only visible to the main connection.
+    addFile("pending");
+
+    EXPECT_NE(table->changeCount(), table->committedChangeCount());
+    EXPECT_EQ(search("pending"), 1u);
+    EXPECT_EQ(search("committed1*"), 7u);
+
+    mClient->sctable->commit();
+
+    EXPECT_EQ(table->changeCount(), table->committedChangeCount());
+    ASSERT_NE(table->readOnlyView(), nullptr);
+    EXPECT_EQ(search("pending"), 1u);
+
+    // The views handed out are limited.
+    std::vector<std::shared_ptr<mega::DBTableNodes>> views;
+
+    for (unsigned i = 0; i < mega::SqliteAccountState::MAX_READERS; ++i)
+    {
+        views.emplace_back(table->readOnlyView());
+        ASSERT_NE(views.back(), nullptr);
+    }
+
+    EXPECT_EQ(table->readOnlyView(), nullptr);
+    EXPECT_EQ(search("pending"), 1u);
+}
+
+// Measures how long batches of node changes take to be applied while other
+// threads keep searching, with searches served by read-only connections and
+// with every search on the main connection.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST_F(CacheLRU, DISABLED_benchmarkSearchWhileApplyingChanges)
+{
+    static constexpr int NUM_NODES = 50000;
+    static constexpr int NUM_BATCHES = 200;
+    static constexpr int BATCH_SIZE = 20;
+    static constexpr int NUM_SEARCHERS = 4;
+
+    auto rootNode = init(1000);
+    auto folder = addNode(mega::nodetype_t::FOLDERNODE, rootNode, false, true);
+    auto table = dynamic_cast<mega::DBTableNodes*>(mClient->sctable.get());
+    ASSERT_NE(table, nullptr);
+
+    auto addFile = [this, &folder]()
+    {
+        addNode(mega::nodetype_t::FILENODE,
+                folder,
+                true,
+                false,
+                [this](mega::Node& file)
+                {
+                    file.size = static_cast<m_off_t>(mIndex);
+                    file.owner = 88;
+                    file.ctime = 44;
+                    file.attrs.map = std::map<mega::nameid, std::string>{
+                        {110, "file" + std::to_string(mIndex) + ".jpg"}};
+                });
+    };
+
+    mClient->sctable->begin();
+
+    for (int i = 0; i < NUM_NODES; ++i)
+        addFile();
+
+    mClient->sctable->commit();
+
+    for (auto views: {false, true})
+    {
+        // Leasing every view makes searches fall back to the main connection.
+        std::vector<std::shared_ptr<mega::DBTableNodes>> leased;
+
+        while (!views)
+        {
+            auto view = table->readOnlyView();
+            if (!view)
+                break;
+
+            leased.emplace_back(std::move(view));
+        }
+
+        std::atomic<bool> done{false};
+        std::atomic<int> searches{0};
+        std::vector<std::thread> searchers;
+
+        for (int i = 0; i < NUM_SEARCHERS; ++i)
+        {
+            searchers.emplace_back(
+                [this, &done, &searches, &rootNode, i]()
+                {
+                    mega::NodeSearchFilter searchFilter;
+                    searchFilter.byAncestors({rootNode->nodehandle, mega::UNDEF, mega::UNDEF});
+                    searchFilter.byName("*" + std::to_string(i) + "7*");
+
+                    while (!done)
+                    {
+                        mClient->mNodeManager.searchNodes(searchFilter,
+                                                          0 /*order None*/,
+                                                          mega::CancelToken(),
+                                                          {0, 0});
+                        ++searches;
+                    }
+                });
+        }
+
+        using Clock = std::chrono::steady_clock;
+
+        Clock::duration total{}, worst{};
+
+        for (int i = 0; i < NUM_BATCHES; ++i)
+        {
+            auto started = Clock::now();
+
+            // A batch of action packets, as committed by sc_storeSn.
+            mClient->sctable->begin();
+
+            for (int j = 0; j < BATCH_SIZE; ++j)
+                addFile();
+
+            mClient->sctable->commit();
+
+            auto elapsed = Clock::now() - started;
+
+            total += elapsed;
+            worst = std::max(worst, elapsed);
+        }
+
+        done = true;
+
+        for (auto& searcher: searchers)
+            searcher.join();
+
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+
+        std::cout << (views ? "read-only connections: " : "main connection only:  ")
+                  << "batch mean " << duration_cast<microseconds>(total).count() / NUM_BATCHES
+                  << "us, worst " << duration_cast<microseconds>(worst).count() << "us, "
+                  << searches << " searches" << std::endl;
+    }
+}
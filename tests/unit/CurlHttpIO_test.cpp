@@ -0,0 +1,727 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "StandInHttpServer.h"
+
+#include <gtest/gtest.h>
+#include <mega.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace mega;
+using namespace std::chrono_literals;
+
+using mt::StandInHttpServer;
+
+namespace
+{
+
+StandInHttpServer::Response respond(const StandInHttpServer::Request&)
+{
+    return {200, std::string(1024, 'x')};
+}
+
+// Drives the network layer until done() holds or the timeout expires.
+bool pump(CurlHttpIO& io,
+          PosixWaiter& waiter,
+          std::function<bool()> done,
+          std::chrono::milliseconds timeout = 10s)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while (!done())
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+
+        Waiter::bumpds();
+
+        waiter.init(1);
+        io.addevents(&waiter, 0);
+        waiter.wait();
+        io.doio();
+    }
+
+    return true;
+}
+
+// Drives the network layer for a while, letting finished requests settle.
+void settle(CurlHttpIO& io, PosixWaiter& waiter)
+{
+    auto until = std::chrono::steady_clock::now() + 300ms;
+
+    pump(io,
+         waiter,
+         [until]()
+         {
+             return std::chrono::steady_clock::now() >= until;
+         });
+}
+
+// Prepares a chunk-like request.
+std::unique_ptr<HttpReq> chunkRequest(CurlHttpIO& io, const std::string& url)
+{
+    auto request = std::make_unique<HttpReq>(true);
+
+    request->posturl = url;
+    request->type = REQ_BINARY;
+    request->method = METHOD_POST;
+    request->httpio = &io;
+
+    // As HttpReq::post() does, the length is learnt from the response.
+    request->contentlength = -1;
+
+    return request;
+}
+
+bool finished(const HttpReq& request)
+{
+    return request.status == REQ_SUCCESS || request.status == REQ_FAILURE;
+}
+
+// Issues a chunk-like request and returns how long it took to complete.
+std::optional<std::chrono::milliseconds>
+    fetch(CurlHttpIO& io, PosixWaiter& waiter, const std::string& url)
+{
+    auto request = chunkRequest(io, url);
+    auto started = std::chrono::steady_clock::now();
+
+    io.post(request.get());
+
+    auto completed = pump(io,
+                          waiter,
+                          [&request]()
+                          {
+                              return finished(*request);
+                          });
+
+    if (!completed || request->status != REQ_SUCCESS)
+        return std::nullopt;
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started);
+}
+
+// Issues count concurrent chunk-like requests and returns how long they took to complete.
+std::optional<std::chrono::milliseconds>
+    fetchConcurrently(CurlHttpIO& io, PosixWaiter& waiter, const std::string& url, int count)
+{
+    std::vector<std::unique_ptr<HttpReq>> requests;
+
+    auto started = std::chrono::steady_clock::now();
+
+    while (count--)
+    {
+        requests.emplace_back(chunkRequest(io, url));
+        io.post(requests.back().get());
+    }
+
+    auto completed = pump(io,
+                          waiter,
+                          [&requests]()
+                          {
+                              return std::all_of(requests.begin(),
+                                                 requests.end(),
+                                                 [](const std::unique_ptr<HttpReq>& request)
+                                                 {
+                                                     return finished(*request);
+                                                 });
+                          });
+
+    if (!completed)
+        return std::nullopt;
+
+    for (auto& request: requests)
+    {
+        // Responses are accounted for separately even when sharing a connection.
+        if (request->status != REQ_SUCCESS ||
+            request->contentlength != static_cast<m_off_t>(request->in.size()))
+            return std::nullopt;
+    }
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started);
+}
+
+} // anonymous
+
+TEST(CurlHttpIO, prewarmedConnectionIsReused)
+{
+    StandInHttpServer::Options options;
+    options.tls = true;
+
+    StandInHttpServer server(options, respond);
+    ASSERT_NE(server.port(), 0);
+
+    CurlHttpIO io;
+    PosixWaiter waiter;
+
+    io.prewarm(server.url() + "/dl/chunk", GET);
+
+    // Prewarming the same host again is a no-op.
+    io.prewarm(server.url() + "/dl/other", GET);
+
+    ASSERT_TRUE(pump(io,
+                     waiter,
+                     [&server]()
+                     {
+                         return server.requests() == 1;
+                     }));
+
+    settle(io, waiter);
+
+    ASSERT_TRUE(fetch(io, waiter, server.url() + "/dl/chunk/0-1023"));
+
+    EXPECT_EQ(server.connections(), 1u);
+    EXPECT_EQ(server.requests(), 2u);
+}
+
+TEST(CurlHttpIO, prewarmIgnoresAPIRequests)
+{
+    StandInHttpServer::Options options;
+    options.tls = true;
+
+    StandInHttpServer server(options, respond);
+    ASSERT_NE(server.port(), 0);
+
+    CurlHttpIO io;
+    PosixWaiter waiter;
+
+    io.prewarm(server.url() + "/cs", API);
+
+    settle(io, waiter);
+
+    EXPECT_EQ(server.connections(), 0u);
+}
+
+TEST(CurlHttpIO, tlsSessionsSurviveRestart)
+{
+    StandInHttpServer::Options options;
+    options.tls = true;
+
+    StandInHttpServer server(options, respond);
+    ASSERT_NE(server.port(), 0);
+
+    std::string sessions;
+
+    {
+        CurlHttpIO io;
+        PosixWaiter waiter;
+
+        ASSERT_TRUE(fetch(io, waiter, server.url() + "/dl/chunk"));
+
+        if (!io.exportTlsSessions(sessions))
+            GTEST_SKIP() << "cURL can't export TLS sessions";
+    }
+
+    CurlHttpIO io;
+    PosixWaiter waiter;
+
+    ASSERT_TRUE(io.importTlsSessions(sessions));
+    ASSERT_TRUE(fetch(io, waiter, server.url() + "/dl/chunk"));
+
+    EXPECT_EQ(server.connections(), 2u);
+    EXPECT_EQ(server.resumedSessions(), 1u);
+}
+
+// Compares the latency of the first storage request after a restart, with
+// and without a prewarmed connection and a persisted TLS session.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(CurlHttpIO, DISABLED_benchmarkFirstRequestLatency)
+{
+    static constexpr int ROUNDS = 10;
+
+    StandInHttpServer::Options options;
+    options.tls = true;
+    options.latency = 20ms;
+    options.handshakeLatency = 60ms;
+
+    StandInHttpServer server(options, respond);
+    ASSERT_NE(server.port(), 0);
+
+    auto url = server.url() + "/dl/chunk";
+
+    std::string sessions;
+
+    {
+        CurlHttpIO io;
+        PosixWaiter waiter;
+
+        ASSERT_TRUE(fetch(io, waiter, url));
+
+        if (!io.exportTlsSessions(sessions))
+            sessions.clear();
+    }
+
+    auto measure = [&](bool prewarm, bool resume)
+    {
+        std::chrono::milliseconds total{0};
+
+        for (int i = 0; i < ROUNDS; ++i)
+        {
+            CurlHttpIO io;
+            PosixWaiter waiter;
+
+            if (resume)
+                io.importTlsSessions(sessions);
+
+            if (prewarm)
+            {
+                auto requests = server.requests();
+
+                io.prewarm(url, GET);
+
+                // Emulates the time it takes to fetch the nodes.
+                EXPECT_TRUE(pump(io,
+                                 waiter,
+                                 [&server, requests]()
+                                 {
+                                     return server.requests() > requests;
+                                 }));
+
+                settle(io, waiter);
+            }
+
+            auto elapsed = fetch(io, waiter, url);
+            EXPECT_TRUE(elapsed);
+
+            total += elapsed.value_or(0ms);
+        }
+
+        return total / ROUNDS;
+    };
+
+    std::cout << "First request latency (average of " << ROUNDS << " rounds)" << std::endl;
+    std::cout << "  cold:      " << measure(false, false).count() << "ms" << std::endl;
+    std::cout << "  prewarmed: " << measure(true, false).count() << "ms" << std::endl;
+
+    if (sessions.empty())
+    {
+        std::cout << "  resumed:   unsupported by this cURL" << std::endl;
+        return;
+    }
+
+    std::cout << "  resumed:   " << measure(false, true).count() << "ms" << std::endl;
+}
+
+TEST(CurlHttpIO, http2MultiplexesConcurrentRequests)
+{
+    StandInHttpServer::Options options;
+    options.tls = true;
+    options.http2 = true;
+
+    StandInHttpServer server(options, respond);
+    ASSERT_NE(server.port(), 0);
+
+    CurlHttpIO io;
+    PosixWaiter waiter;
+
+    if (!io.setHttp2(true))
+        GTEST_SKIP() << "cURL built without HTTP/2 support";
+
+    ASSERT_TRUE(fetchConcurrently(io, waiter, server.url() + "/dl/chunk", 8));
+
+    EXPECT_EQ(server.connections(), 1u);
+    EXPECT_EQ(server.http2Connections(), 1u);
+    EXPECT_EQ(server.requests(), 8u);
+}
+
+TEST(CurlHttpIO, http2FallsBackToHttp1)
+{
+    StandInHttpServer::Options options;
+    options.tls = true;
+
+    StandInHttpServer server(options, respond);
+    ASSERT_NE(server.port(), 0);
+
+    CurlHttpIO io;
+    PosixWaiter waiter;
+
+    if (!io.setHttp2(true))
+        GTEST_SKIP() << "cURL built without HTTP/2 support";
+
+    ASSERT_TRUE(fetchConcurrently(io, waiter, server.url() + "/dl/chunk", 4));
+
+    EXPECT_EQ(server.http2Connections(), 0u);
+    EXPECT_EQ(server.requests(), 4u);
+}
+
+TEST(CurlHttpIO, http1IsUsedByDefault)
+{
+    StandInHttpServer::Options options;
+    options.tls = true;
+    options.http2 = true;
+
+    StandInHttpServer server(options, respond);
+    ASSERT_NE(server.port(), 0);
+
+    CurlHttpIO io;
+    PosixWaiter waiter;
+
+    ASSERT_TRUE(fetchConcurrently(io, waiter, server.url() + "/dl/chunk", 4));
+
+    EXPECT_EQ(server.http2Connections(), 0u);
+    EXPECT_EQ(server.requests(), 4u);
+}
+
+// Compares how long a burst of concurrent chunk requests to the same storage
+// host takes over HTTP/1.1 and over multiplexed HTTP/2.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(CurlHttpIO, DISABLED_benchmarkConcurrentChunks)
+{
+    static constexpr int ROUNDS = 5;
+    static constexpr int CHUNKS = 16;
+
+    StandInHttpServer::Options options;
+    options.tls = true;
+    options.http2 = true;
+    options.latency = 20ms;
+    options.handshakeLatency = 60ms;
+
+    StandInHttpServer server(options,
+                             [](const StandInHttpServer::Request&)
+                             {
+                                 return StandInHttpServer::Response{200,
+                                                                    std::string(256 * 1024, 'x')};
+                             });
+    ASSERT_NE(server.port(), 0);
+
+    auto measure = [&](bool http2)
+    {
+        std::chrono::milliseconds total{0};
+
+        auto connections = server.connections();
+
+        for (int i = 0; i < ROUNDS; ++i)
+        {
+            CurlHttpIO io;
+            PosixWaiter waiter;
+
+            if (http2 && !io.setHttp2(true))
+                return std::string("unsupported by this cURL");
+
+            auto elapsed = fetchConcurrently(io, waiter, server.url() + "/dl/chunk", CHUNKS);
+            EXPECT_TRUE(elapsed);
+
+            total += elapsed.value_or(0ms);
+        }
+
+        return std::to_string((total / ROUNDS).count()) + "ms, connections: " +
+               std::to_string((server.connections() - connections) / ROUNDS);
+    };
+
+    std::cout << CHUNKS << " concurrent chunks (average of " << ROUNDS << " rounds)" << std::endl;
+    std::cout << "  HTTP/1.1: " << measure(false) << std::endl;
+    std::cout << "  HTTP/2:   " << measure(true) << std::endl;
+}
+
+// Compares how long a download split in requests takes over a throttled
+// link with fixed connections and request sizes, and when they are adapted
+// to the measured throughput as TransferSlot does for non-raid transfers.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(CurlHttpIO, DISABLED_benchmarkAdaptiveTransfer)
+{
+    static constexpr m_off_t MB = 1024 * 1024;
+    static constexpr m_off_t SIZE = 48 * MB;
+    static constexpr unsigned MAX_CONNECTIONS = 8;
+
+    StandInHttpServer::Options options;
+    options.latency = 30ms;
+    options.bytesPerSecond = static_cast<std::size_t>(2 * MB);
+    options.linkBytesPerSecond = static_cast<std::size_t>(8 * MB);
+
+    // Answers /dl/<n> with n bytes.
+    StandInHttpServer server(options,
+                             [](const StandInHttpServer::Request& request)
+                             {
+                                 auto length = request.path.substr(request.path.rfind('/') + 1);
+
+                                 return StandInHttpServer::Response{
+                                     200,
+                                     std::string(std::stoul(length), 'x')};
+                             });
+    ASSERT_NE(server.port(), 0);
+
+    auto download = [&](AdaptiveTransferController* controller,
+                        unsigned connections,
+                        m_off_t requestSize) -> std::string
+    {
+        CurlHttpIO io;
+        PosixWaiter waiter;
+
+        std::vector<std::unique_ptr<HttpReq>> requests(MAX_CONNECTIONS);
+
+        auto started = std::chrono::steady_clock::now();
+        auto remaining = SIZE;
+
+        while (remaining || std::any_of(requests.begin(),
+                                        requests.end(),
+                                        [](const auto& r)
+                                        {
+                                            return r != nullptr;
+                                        }))
+        {
+            auto wanted = controller ? controller->connections() : connections;
+            auto length = controller && controller->requestSize() ? controller->requestSize() :
+                                                                     requestSize;
+
+            for (unsigned i = 0; i < wanted && remaining; ++i)
+            {
+                if (requests[i])
+                    continue;
+
+                auto bytes = std::min(length, remaining);
+
+                requests[i] = chunkRequest(io, server.url() + "/dl/" + std::to_string(bytes));
+                io.post(requests[i].get());
+                remaining -= bytes;
+
+                if (controller)
+                    controller->requestStarted(i, std::chrono::steady_clock::now());
+            }
+
+            auto done = pump(io,
+                             waiter,
+                             [&requests]()
+                             {
+                                 return std::any_of(requests.begin(),
+                                                    requests.end(),
+                                                    [](const std::unique_ptr<HttpReq>& request)
+                                                    {
+                                                        return request && finished(*request);
+                                                    });
+                             },
+                             60s);
+
+            if (!done)
+                return "timed out";
+
+            for (unsigned i = 0; i < requests.size(); ++i)
+            {
+                if (!requests[i] || !finished(*requests[i]))
+                    continue;
+
+                if (requests[i]->status != REQ_SUCCESS)
+                    return "failed";
+
+                if (controller)
+                    controller->requestCompleted(i,
+                                                 static_cast<m_off_t>(requests[i]->in.size()),
+                                                 std::nullopt,
+                                                 std::chrono::steady_clock::now());
+
+                requests[i].reset();
+            }
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started);
+
+        return std::to_string(elapsed.count()) + "ms";
+    };
+
+    AdaptiveTransferController::Limits limits;
+    limits.maxConnections = MAX_CONNECTIONS;
+    limits.minRequestSize = MB / 4;
+    limits.maxRequestSize = 8 * MB;
+
+    AdaptiveTransferController controller(limits, std::chrono::steady_clock::now());
+
+    std::cout << SIZE / MB << " MB over 2 MB/s connections sharing an 8 MB/s link" << std::endl;
+    std::cout << "  fixed 2 x 1 MB: " << download(nullptr, 2, MB) << std::endl;
+    std::cout << "  fixed 8 x 1 MB: " << download(nullptr, 8, MB) << std::endl;
+    std::cout << "  adaptive:       " << download(&controller, 0, MB)
+              << " (connections: " << controller.connections()
+              << ", request size: " << controller.requestSize() / 1024 << " KB)" << std::endl;
+}
+
+// Compares how many small files per second get uploaded when each completes
+// with its own putnodes, and when those finishing together share one, as
+// MegaClient does with MegaApi::setSmallUploadBatching enabled.
+//
+// A stand-in storage server receives the uploads, and a stand-in API server
+// the putnodes, which are all for the same folder. The API server handles one
+// request at a time, as the client sends them, and charges a fixed cost for
+// each command besides a small one per node.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(CurlHttpIO, DISABLED_benchmarkSmallFileUploads)
+{
+    static constexpr int FILES = 1000;
+    static constexpr int SLOTS = 32;
+    static constexpr auto COMMAND_COST = 2ms;
+    static constexpr auto NODE_COST = 200us;
+
+    StandInHttpServer::Options options;
+    options.latency = 20ms;
+
+    // Answers each upload with an upload token.
+    StandInHttpServer storage(options,
+                              [](const StandInHttpServer::Request&)
+                              {
+                                  return StandInHttpServer::Response{200, std::string(36, 't')};
+                              });
+    ASSERT_NE(storage.port(), 0);
+
+    // Answers every command of a request with success.
+    StandInHttpServer api(options,
+                          [&](const StandInHttpServer::Request& request)
+                          {
+                              auto commands = 0;
+                              auto nodes = 0;
+
+                              for (auto i = request.body.find(R"("a":"p")"); i != std::string::npos;
+                                   i = request.body.find(R"("a":"p")", i + 1))
+                                  ++commands;
+
+                              for (auto i = request.body.find(R"("h":")"); i != std::string::npos;
+                                   i = request.body.find(R"("h":")", i + 1))
+                                  ++nodes;
+
+                              std::this_thread::sleep_for(COMMAND_COST * commands +
+                                                          NODE_COST * nodes);
+
+                              std::string results = "[0";
+
+                              for (auto i = 1; i < commands; ++i)
+                                  results += ",0";
+
+                              return StandInHttpServer::Response{200, results + "]"};
+                          });
+    ASSERT_NE(api.port(), 0);
+
+    auto upload = [&](std::size_t size, bool batched) -> std::string
+    {
+        CurlHttpIO io;
+        PosixWaiter waiter;
+
+        std::vector<std::unique_ptr<HttpReq>> uploads(SLOTS);
+        std::unique_ptr<HttpReq> putnodes;
+
+        std::string node = R"({"h":")" + std::string(36, 't') + R"(","t":0,"a":")" +
+                           std::string(64, 'a') + R"(","k":")" + std::string(43, 'k') + "\"}";
+
+        auto started = std::chrono::steady_clock::now();
+        auto queued = FILES;
+        auto waiting = 0;
+        auto sent = 0;
+        auto completed = 0;
+
+        while (completed < FILES)
+        {
+            for (auto& slot: uploads)
+            {
+                if (slot || !queued)
+                    continue;
+
+                slot = chunkRequest(io, storage.url() + "/ul/0");
+                slot->out->assign(size, 'x');
+                io.post(slot.get());
+                --queued;
+            }
+
+            // One API request in flight at a time, carrying every putnodes ready to go.
+            if (!putnodes && waiting)
+            {
+                auto command = [&node](int nodes)
+                {
+                    std::string command = R"({"a":"p","t":"AAAAAAAA","n":[)" + node;
+
+                    while (--nodes)
+                        command += "," + node;
+
+                    return command + "]}";
+                };
+
+                std::string body = batched ? command(waiting) : command(1);
+
+                for (auto i = 1; !batched && i < waiting; ++i)
+                    body += "," + command(1);
+
+                putnodes = chunkRequest(io, api.url() + "/cs");
+                putnodes->out->assign("[" + body + "]");
+                io.post(putnodes.get());
+
+                sent = waiting;
+                waiting = 0;
+            }
+
+            auto done = pump(io,
+                             waiter,
+                             [&]()
+                             {
+                                 return (putnodes && finished(*putnodes)) ||
+                                        std::any_of(uploads.begin(),
+                                                    uploads.end(),
+                                                    [](const std::unique_ptr<HttpReq>& request)
+                                                    {
+                                                        return request && finished(*request);
+                                                    });
+                             },
+                             60s);
+
+            if (!done)
+                return "timed out";
+
+            for (auto& slot: uploads)
+            {
+                if (!slot || !finished(*slot))
+                    continue;
+
+                if (slot->status != REQ_SUCCESS)
+                    return "failed";
+
+                slot.reset();
+                ++waiting;
+            }
+
+            if (putnodes && finished(*putnodes))
+            {
+                if (putnodes->status != REQ_SUCCESS)
+                    return "failed";
+
+                putnodes.reset();
+                completed += sent;
+                sent = 0;
+            }
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started);
+
+        return std::to_string(FILES * 1000 / std::max<long long>(elapsed.count(), 1)) +
+               " files/s";
+    };
+
+    std::cout << FILES << " uploads to one folder, " << SLOTS << " at once" << std::endl;
+
+    for (std::size_t size: {1024, 4096, 16384, 65536})
+    {
+        std::cout << "  " << size / 1024 << " KB: one putnodes each " << upload(size, false)
+                  << ", batched " << upload(size, true) << std::endl;
+    }
+}
@@ -110,9 +110,9 @@ public:
         return std::nullopt;
     }
 
-    bool getRecentNodes(const mega::NodeSearchPage&,
+    bool getRecentFiles(const mega::NodeSearchPage&,
                         mega::m_time_t /*since*/,
-                        std::vector<std::pair<mega::NodeHandle, mega::NodeSerialized>>&) override
+                        std::vector<mega::RecentFile>&) override
     {
         return false;
     }
@@ -0,0 +1,364 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega.h>
+#include <stdfs.h>
+
+#if defined(__linux__) && !defined(__ANDROID__) && defined(ENABLE_SYNC) && defined(USE_INOTIFY)
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+using namespace mega;
+
+namespace
+{
+
+class FilesystemNotify: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        mPath = std::filesystem::current_path() / "filesystem_notify";
+
+        std::filesystem::remove_all(mPath);
+        std::filesystem::create_directory(mPath);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(mPath);
+    }
+
+    LocalPath localPath(const std::filesystem::path& path) const
+    {
+        return LocalPath::fromAbsolutePath(path_u8string(path));
+    }
+
+    static void createFile(const std::filesystem::path& path)
+    {
+        std::ofstream(path).put('x');
+    }
+
+    std::filesystem::path mPath;
+};
+
+// Reads one event at a time, as inotify events used to be.
+size_t readInotifyEventsOneByOne(int fd)
+{
+    char buffer[sizeof(inotify_event) + NAME_MAX + 1];
+    size_t count = 0;
+    ssize_t l;
+
+    while ((l = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        for (ssize_t p = 0; p < l; ++count)
+            p += static_cast<ssize_t>(offsetof(inotify_event, name) +
+                                      reinterpret_cast<inotify_event*>(buffer + p)->len);
+    }
+
+    return count;
+}
+
+} // anonymous
+
+TEST_F(FilesystemNotify, readInotifyEventsReadsEveryEvent)
+{
+    static constexpr size_t COUNT = 2000;
+
+    auto fd = inotify_init1(IN_NONBLOCK);
+    ASSERT_GE(fd, 0);
+
+    const MrProper closeFd(
+        [fd]()
+        {
+            close(fd);
+        });
+
+    auto wd = inotify_add_watch(fd, mPath.c_str(), LinuxFileSystemAccess::INOTIFY_EVENTS);
+    ASSERT_GE(wd, 0);
+
+    // Names long enough that the events span several reads.
+    auto name = [](size_t i)
+    {
+        return std::string(200, 'f') + std::to_string(i);
+    };
+
+    for (size_t i = 0; i < COUNT; ++i)
+        createFile(mPath / name(i));
+
+    std::set<std::string> created;
+    std::set<std::string> written;
+    vector<char> buffer;
+
+    LinuxFileSystemAccess::readInotifyEvents(fd,
+                                             buffer,
+                                             [&](const inotify_event& event)
+                                             {
+                                                 ASSERT_EQ(event.wd, wd);
+                                                 ASSERT_GT(event.len, 0u);
+
+                                                 if (event.mask & IN_CREATE)
+                                                     created.emplace(event.name);
+
+                                                 if (event.mask & IN_CLOSE_WRITE)
+                                                     written.emplace(event.name);
+                                             });
+
+    EXPECT_EQ(buffer.size(), LinuxFileSystemAccess::EVENT_BUFFER_SIZE);
+    ASSERT_EQ(created.size(), COUNT);
+    ASSERT_EQ(written.size(), COUNT);
+
+    for (size_t i = 0; i < COUNT; ++i)
+        ASSERT_TRUE(created.count(name(i))) << i;
+}
+
+#ifdef USE_FANOTIFY
+
+TEST_F(FilesystemNotify, readFanotifyEventsReportsDirectoryAndName)
+{
+    auto fd = fanotify_init(FAN_CLASS_NOTIF | FAN_REPORT_DFID_NAME | FAN_NONBLOCK, O_RDONLY);
+
+    if (fd < 0)
+        GTEST_SKIP() << "fanotify unavailable: " << errno;
+
+    const MrProper closeFd(
+        [fd]()
+        {
+            close(fd);
+        });
+
+    ASSERT_EQ(fanotify_mark(fd,
+                            FAN_MARK_ADD | FAN_MARK_FILESYSTEM,
+                            LinuxFileSystemAccess::FANOTIFY_EVENTS,
+                            AT_FDCWD,
+                            mPath.c_str()),
+              0);
+
+    std::filesystem::create_directory(mPath / "d");
+
+    string fsid;
+    string root;
+    string folder;
+
+    ASSERT_TRUE(LinuxFileSystemAccess::fanotifyFsid(localPath(mPath), fsid));
+    ASSERT_TRUE(LinuxFileSystemAccess::fanotifyKey(localPath(mPath), fsid, root));
+    ASSERT_TRUE(LinuxFileSystemAccess::fanotifyKey(localPath(mPath / "d"), fsid, folder));
+    ASSERT_NE(root, folder);
+
+    createFile(mPath / "d" / "f");
+    std::filesystem::remove(mPath / "d" / "f");
+    std::filesystem::remove(mPath / "d");
+
+    uint64_t folderEvents = 0;
+    uint64_t rootEvents = 0;
+    uint64_t selfEvents = 0;
+    vector<char> buffer;
+
+    LinuxFileSystemAccess::readFanotifyEvents(
+        fd,
+        buffer,
+        [&](const fanotify_event_metadata& metadata, const string& key, const char* name)
+        {
+            if (key == folder && !strcmp(name, "f"))
+                folderEvents |= metadata.mask;
+
+            if (key == root && !strcmp(name, "d"))
+                rootEvents |= metadata.mask;
+
+            if (key == folder && !*name)
+                selfEvents |= metadata.mask;
+        });
+
+    EXPECT_EQ(folderEvents, FAN_CREATE | FAN_CLOSE_WRITE | FAN_DELETE);
+    EXPECT_EQ(rootEvents, FAN_CREATE | FAN_DELETE | FAN_ONDIR);
+    EXPECT_EQ(selfEvents, FAN_DELETE_SELF | FAN_ONDIR);
+}
+
+#endif // USE_FANOTIFY
+
+// Time taken to set up monitoring for a tree of 500k folders, and to read
+// the events for changes in them: with an inotify watch per folder, and
+// with a fanotify mark on the filesystem (when privileged.)
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST_F(FilesystemNotify, DISABLED_benchmark)
+{
+    static constexpr size_t FANOUT = 100;
+    static constexpr size_t FOLDERS = 5000;
+
+    // Below the default max_queued_events, so that no events are lost.
+    static constexpr size_t FILES_PER_ROUND = 4000;
+    static constexpr size_t ROUNDS = 25;
+
+    std::vector<std::filesystem::path> folders;
+
+    for (size_t i = 0; i < FANOUT; ++i)
+    {
+        folders.emplace_back(mPath / std::to_string(i));
+
+        for (size_t j = 0; j < FOLDERS; ++j)
+            folders.emplace_back(folders[i * (FOLDERS + 1)] / std::to_string(j));
+    }
+
+    for (auto& folder: folders)
+        std::filesystem::create_directory(folder);
+
+    std::cout << folders.size() << " folders" << std::endl;
+
+    auto milliseconds = [](auto started)
+    {
+        auto elapsed = std::chrono::steady_clock::now() - started;
+        return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    };
+
+    // Creates files throughout the tree, timing how long reading the
+    // resulting events takes.
+    auto throughput = [&](const char* what, std::function<size_t()> read)
+    {
+        std::chrono::steady_clock::duration elapsed{};
+        size_t events = 0;
+
+        for (size_t round = 0; round < ROUNDS; ++round)
+        {
+            for (size_t i = 0; i < FILES_PER_ROUND; ++i)
+            {
+                auto& folder = folders[(round * FILES_PER_ROUND + i) * 7919 % folders.size()];
+                createFile(folder / ("f" + std::to_string(round)));
+            }
+
+            auto started = std::chrono::steady_clock::now();
+            events += read();
+            elapsed += std::chrono::steady_clock::now() - started;
+        }
+
+        std::cout << what << ": " << events << " events read in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms"
+                  << std::endl;
+    };
+
+    {
+        auto fd = inotify_init1(IN_NONBLOCK);
+        ASSERT_GE(fd, 0);
+
+        const MrProper closeFd(
+            [fd]()
+            {
+                close(fd);
+            });
+
+        auto started = std::chrono::steady_clock::now();
+        size_t failed = 0;
+
+        for (auto& folder: folders)
+            failed += inotify_add_watch(fd, folder.c_str(), LinuxFileSystemAccess::INOTIFY_EVENTS) < 0;
+
+        std::cout << "inotify: watches added in " << milliseconds(started) << "ms (" << failed
+                  << " failed, see fs.inotify.max_user_watches)" << std::endl;
+
+        throughput("inotify, one event per read",
+                   [fd]()
+                   {
+                       return readInotifyEventsOneByOne(fd);
+                   });
+
+        vector<char> buffer;
+
+        throughput("inotify, batched reads",
+                   [fd, &buffer]()
+                   {
+                       size_t count = 0;
+
+                       LinuxFileSystemAccess::readInotifyEvents(fd,
+                                                                buffer,
+                                                                [&count](const inotify_event&)
+                                                                {
+                                                                    ++count;
+                                                                });
+
+                       return count;
+                   });
+    }
+
+#ifdef USE_FANOTIFY
+    auto fd = fanotify_init(FAN_CLASS_NOTIF | FAN_REPORT_DFID_NAME | FAN_NONBLOCK, O_RDONLY);
+
+    if (fd < 0)
+    {
+        std::cout << "fanotify unavailable: " << errno << std::endl;
+        return;
+    }
+
+    const MrProper closeFd(
+        [fd]()
+        {
+            close(fd);
+        });
+
+    auto started = std::chrono::steady_clock::now();
+
+    ASSERT_EQ(fanotify_mark(fd,
+                            FAN_MARK_ADD | FAN_MARK_FILESYSTEM,
+                            LinuxFileSystemAccess::FANOTIFY_EVENTS,
+                            AT_FDCWD,
+                            mPath.c_str()),
+              0);
+
+    // The directories still need to be recognized in the events.
+    string fsid;
+    ASSERT_TRUE(LinuxFileSystemAccess::fanotifyFsid(localPath(mPath), fsid));
+
+    std::map<string, size_t> keys;
+    string key;
+
+    for (auto& folder: folders)
+    {
+        ASSERT_TRUE(LinuxFileSystemAccess::fanotifyKey(localPath(folder), fsid, key));
+        keys.emplace(key, keys.size());
+    }
+
+    std::cout << "fanotify: filesystem marked and folders identified in " << milliseconds(started)
+              << "ms" << std::endl;
+
+    vector<char> buffer;
+
+    throughput("fanotify",
+               [fd, &buffer, &keys]()
+               {
+                   size_t count = 0;
+
+                   LinuxFileSystemAccess::readFanotifyEvents(
+                       fd,
+                       buffer,
+                       [&](const fanotify_event_metadata&, const string& key, const char*)
+                       {
+                           count += keys.count(key);
+                       });
+
+                   return count;
+               });
+#endif // USE_FANOTIFY
+}
+
+#endif // __linux__ && !__ANDROID__ && ENABLE_SYNC && USE_INOTIFY
@@ -3,18 +3,25 @@
 #include "mega/gfx/worker/commands.h"
 #include "mega/gfx/worker/comms.h"
 
+#include <algorithm>
 #include <chrono>
 
 using mega::GfxDimension;
 using mega::gfx::CommandHello;
 using mega::gfx::CommandHelloResponse;
 using mega::gfx::CommandNewGfx;
+using mega::gfx::CommandNewGfxBatch;
+using mega::gfx::CommandNewGfxBatchResponse;
 using mega::gfx::CommandNewGfxResponse;
 using mega::gfx::CommandSerializer;
 using mega::gfx::CommandShutDown;
 using mega::gfx::CommandShutDownResponse;
 using mega::gfx::CommandSupportFormats;
 using mega::gfx::CommandSupportFormatsResponse;
+using mega::gfx::GfxBatchImage;
+using mega::gfx::GfxBatchResult;
+using mega::gfx::GfxTask;
+using mega::gfx::GfxTaskProcessStatus;
 using mega::gfx::IReader;
 using std::chrono::milliseconds;
 
@@ -34,6 +41,34 @@ namespace gfx
         return lhs.ErrorCode == rhs.ErrorCode && lhs.ErrorText == rhs.ErrorText && lhs.Images == rhs.Images;
     }
 
+    bool operator==(const CommandNewGfxBatch& lhs, const CommandNewGfxBatch& rhs)
+    {
+        auto sameTask = [](const GfxTask& lhs, const GfxTask& rhs)
+        {
+            return lhs.Path == rhs.Path && lhs.Dimensions == rhs.Dimensions;
+        };
+
+        return std::equal(lhs.Tasks.begin(), lhs.Tasks.end(), rhs.Tasks.begin(), rhs.Tasks.end(), sameTask) &&
+               lhs.SharedMemoryName == rhs.SharedMemoryName &&
+               lhs.SharedMemorySize == rhs.SharedMemorySize;
+    }
+
+    bool operator==(const CommandNewGfxBatchResponse& lhs, const CommandNewGfxBatchResponse& rhs)
+    {
+        auto sameImage = [](const GfxBatchImage& lhs, const GfxBatchImage& rhs)
+        {
+            return lhs.Data == rhs.Data && lhs.Offset == rhs.Offset && lhs.Length == rhs.Length;
+        };
+
+        auto sameResult = [&sameImage](const GfxBatchResult& lhs, const GfxBatchResult& rhs)
+        {
+            return lhs.ProcessStatus == rhs.ProcessStatus &&
+                   std::equal(lhs.Images.begin(), lhs.Images.end(), rhs.Images.begin(), rhs.Images.end(), sameImage);
+        };
+
+        return std::equal(lhs.Results.begin(), lhs.Results.end(), rhs.Results.begin(), rhs.Results.end(), sameResult);
+    }
+
     bool operator==(const CommandShutDown& /*lhs*/, const CommandShutDown& /*rhs*/)
     {
         return true;
@@ -125,6 +160,61 @@ TEST(GfxCommandSerializer, CommandNewGfxResponseSerializeAndUnserializeSuccessfu
     ASSERT_EQ(sourceCommand, *targetCommand);
 }
 
+TEST(GfxCommandSerializer, CommandNewGfxBatchSerializeAndUnserializeSuccessfully)
+{
+    CommandNewGfxBatch sourceCommand;
+    sourceCommand.Tasks.push_back(GfxTask{"c:\\path\\image.png", {{200, 0}, {1000, 1000}}});
+    sourceCommand.Tasks.push_back(GfxTask{"c:\\path\\photo.jpg", {{250, 0}}});
+    sourceCommand.SharedMemoryName = "/mega_gfx_1_1";
+    sourceCommand.SharedMemorySize = 3 * 1024 * 1024;
+
+    auto data = CommandSerializer::serialize(&sourceCommand);
+    ASSERT_NE(data, nullptr);
+
+    StringReader reader(std::move(*data));
+    auto command = CommandSerializer::unserialize(reader, 5000ms);
+    ASSERT_NE(command, nullptr);
+    auto targetCommand = dynamic_cast<CommandNewGfxBatch*>(command.get());
+    ASSERT_NE(targetCommand, nullptr);
+    ASSERT_EQ(sourceCommand, *targetCommand);
+}
+
+TEST(GfxCommandSerializer, CommandNewGfxBatchEmptyFailsToUnserialize)
+{
+    CommandNewGfxBatch sourceCommand;
+
+    auto data = CommandSerializer::serialize(&sourceCommand);
+    ASSERT_NE(data, nullptr);
+
+    StringReader reader(std::move(*data));
+    ASSERT_EQ(CommandSerializer::unserialize(reader, 5000ms), nullptr);
+}
+
+TEST(GfxCommandSerializer, CommandNewGfxBatchResponseSerializeAndUnserializeSuccessfully)
+{
+    GfxBatchResult shared;
+    shared.ProcessStatus = GfxTaskProcessStatus::SUCCESS;
+    shared.Images.push_back(GfxBatchImage{"", 0, 4096});
+    shared.Images.push_back(GfxBatchImage{"imagedata", 0, 0});
+
+    GfxBatchResult failed;
+    failed.Images.push_back(GfxBatchImage{});
+
+    CommandNewGfxBatchResponse sourceCommand;
+    sourceCommand.Results.push_back(shared);
+    sourceCommand.Results.push_back(failed);
+
+    auto data = CommandSerializer::serialize(&sourceCommand);
+    ASSERT_NE(data, nullptr);
+
+    StringReader reader(std::move(*data));
+    auto command = CommandSerializer::unserialize(reader, 5000ms);
+    ASSERT_NE(command, nullptr);
+    auto targetCommand = dynamic_cast<CommandNewGfxBatchResponse*>(command.get());
+    ASSERT_NE(targetCommand, nullptr);
+    ASSERT_EQ(sourceCommand, *targetCommand);
+}
+
 TEST(GfxCommandSerializer, CommandShutdownSerializeAndUnserializeSuccessfully)
 {
     CommandShutDown sourceCommand;
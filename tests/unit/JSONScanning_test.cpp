@@ -0,0 +1,290 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+#include <mega/json.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace mega;
+
+namespace
+{
+
+struct Stored
+{
+    bool result = false;
+    std::string value;
+    size_t consumed = 0;
+
+    bool operator==(const Stored& other) const
+    {
+        return result == other.result && value == other.value && consumed == other.consumed;
+    }
+};
+
+std::ostream& operator<<(std::ostream& os, const Stored& stored)
+{
+    return os << stored.result << " '" << stored.value << "' " << stored.consumed;
+}
+
+// The character at a time scan, as the block at a time one must find the same.
+Stored referenceStoreobject(const char* json)
+{
+    Stored stored;
+    int openobject[2] = {0};
+    bool escaped = false;
+    auto pos = json;
+
+    while (*(const signed char*)pos > 0 && *pos <= ' ')
+        pos++;
+
+    if (*pos == ']' || *pos == '}')
+        return stored;
+
+    if (*pos == ',')
+        pos++;
+
+    auto ptr = pos;
+
+    for (;;)
+    {
+        if (*ptr == '[' || *ptr == '{')
+        {
+            openobject[*ptr == '[']++;
+        }
+        else if (*ptr == ']' || *ptr == '}')
+        {
+            openobject[*ptr == ']']--;
+        }
+        else if (*ptr == '"')
+        {
+            ptr++;
+
+            while (*ptr && (escaped || *ptr != '"'))
+            {
+                escaped = *ptr == '\\' && !escaped;
+                ptr++;
+            }
+
+            if (!*ptr)
+                return stored;
+        }
+        else if ((*ptr >= '0' && *ptr <= '9') || *ptr == '-' || *ptr == '.')
+        {
+            ptr++;
+
+            while ((*ptr >= '0' && *ptr <= '9') || *ptr == '.' || *ptr == 'e' || *ptr == 'E')
+                ptr++;
+
+            ptr--;
+        }
+        else if (*ptr != ':' && *ptr != ',')
+        {
+            return stored;
+        }
+
+        ptr++;
+
+        if (!openobject[0] && !openobject[1])
+        {
+            stored.result = true;
+            stored.value = *pos == '"' ? std::string(pos + 1, static_cast<size_t>(ptr - pos - 2)) :
+                                         std::string(pos, static_cast<size_t>(ptr - pos));
+            stored.consumed = static_cast<size_t>(ptr - json);
+            return stored;
+        }
+    }
+}
+
+Stored storeobject(const char* json)
+{
+    Stored stored;
+    JSON j(json);
+
+    stored.result = j.storeobject(&stored.value);
+
+    if (stored.result)
+        stored.consumed = static_cast<size_t>(j.pos - json);
+    else
+        stored.value.clear();
+
+    return stored;
+}
+
+// Something like a fetchnodes response: nodes with handles, keys and encrypted attributes.
+std::string nodes(std::mt19937& random, size_t count)
+{
+    static const std::string B64 =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    auto b64 = [&](size_t length)
+    {
+        std::string s;
+        for (size_t i = 0; i < length; ++i)
+            s += B64[random() % B64.size()];
+        return s;
+    };
+
+    std::string json = "{\"f\":[";
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        json += i ? "," : "";
+        json += "{\"h\":\"" + b64(8) + "\",\"p\":\"" + b64(8) + "\",\"u\":\"" + b64(11) +
+                "\",\"t\":" + std::to_string(i % 2) + ",\"a\":\"" + b64(random() % 200 + 40) +
+                "\",\"k\":\"" + b64(8) + ":" + b64(22) + "\",\"s\":" + std::to_string(random()) +
+                ",\"fa\":\"" + b64(8) + ":0*" + b64(11) + "\",\"ts\":" +
+                std::to_string(1700000000 + i) + "}";
+    }
+
+    return json + "],\"ok\":[],\"s\":[{\"u\":\"" + b64(11) + "\",\"r\":2}]}";
+}
+
+} // anonymous
+
+TEST(JSONScanning, storeobjectSkipsValues)
+{
+    for (std::string json: {"{}",
+                            "[]",
+                            "\"\"",
+                            "{\"a\":[1,2,{\"b\":\"}]\"}],\"c\":-1.5}rest",
+                            "[\"\\\"\",\"\\\\\",\"\\\\\\\"]\"]]",
+                            ",{\"a\":1}",
+                            "  [[[[[]]]]],1",
+                            "\"a\\\\\"b\""})
+    {
+        ASSERT_EQ(storeobject(json.c_str()), referenceStoreobject(json.c_str())) << json;
+    }
+
+    auto stored = storeobject("{\"a\":[1,2,{\"b\":\"}]\"}],\"c\":-1.5}rest");
+
+    EXPECT_TRUE(stored.result);
+    EXPECT_EQ(stored.value, "{\"a\":[1,2,{\"b\":\"}]\"}],\"c\":-1.5}");
+}
+
+TEST(JSONScanning, storeobjectMatchesCharacterAtATimeScan)
+{
+    std::mt19937 random(1);
+
+    // mostly well formed values, with some characters that storeobject() rejects or treats specially
+    static const std::string CHARACTERS = "{}[]\"\"\"\\\\::,,01234567-.eE+ xyz\x80";
+
+    auto base = nodes(random, 3);
+
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        std::string json;
+
+        if (i % 2)
+        {
+            // a large value with a few changed characters
+            json = base;
+            for (auto n = random() % 3; n--;)
+                json[random() % json.size()] = CHARACTERS[random() % CHARACTERS.size()];
+        }
+        else
+        {
+            json = random() % 2 ? "{" : "[";
+            for (auto n = random() % 300; n--;)
+                json += CHARACTERS[random() % CHARACTERS.size()];
+        }
+
+        // at every offset within a block
+        std::string buffer(random() % 64, ' ');
+        buffer[0] = ',';
+        buffer += json;
+
+        auto start = buffer.c_str() + random() % buffer.size();
+
+        ASSERT_EQ(storeobject(start), referenceStoreobject(start)) << start;
+    }
+}
+
+TEST(JSONScanning, storeobjectHandlesLargeValues)
+{
+    std::mt19937 random(2);
+
+    auto json = nodes(random, 1000);
+    auto stored = storeobject(json.c_str());
+
+    ASSERT_TRUE(stored.result);
+    EXPECT_EQ(stored.consumed, json.size());
+    EXPECT_EQ(stored, referenceStoreobject(json.c_str()));
+
+    // an unterminated value is an error
+    json.pop_back();
+    EXPECT_FALSE(storeobject(json.c_str()).result);
+}
+
+// Skips a large fetchnodes-like response as a whole and node by node, and
+// compares with the character at a time scan.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(JSONScanning, DISABLED_benchmarkStoreobject)
+{
+    std::mt19937 random(3);
+
+    auto json = nodes(random, 200000);
+
+    auto time = [](auto&& f)
+    {
+        auto started = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < 10; ++i)
+            f();
+
+        auto elapsed = std::chrono::steady_clock::now() - started;
+        return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    };
+
+    size_t sink = 0;
+
+    auto whole = time([&]() { sink += storeobject(json.c_str()).consumed; });
+    auto referenceWhole = time([&]() { sink += referenceStoreobject(json.c_str()).consumed; });
+
+    // node by node, as the streaming fetchnodes parser does
+    auto nodeByNode = time(
+        [&]()
+        {
+            JSON j(json.c_str() + 6);
+
+            while (*j.pos == '{' || *j.pos == ',')
+                sink += j.storeobject();
+        });
+
+    auto referenceNodeByNode = time(
+        [&]()
+        {
+            auto pos = json.c_str() + 6;
+            Stored stored;
+
+            while ((stored = referenceStoreobject(pos)).result && (*pos == '{' || *pos == ','))
+                pos += stored.consumed;
+
+            sink += stored.consumed;
+        });
+
+    std::cout << json.size() << " bytes x 10: whole " << whole << "ms (character at a time "
+              << referenceWhole << "ms), node by node " << nodeByNode
+              << "ms (character at a time " << referenceNodeByNode << "ms)"
+              << (sink ? "" : " ") << std::endl;
+}
@@ -0,0 +1,272 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+#include <mega/syncinternals/syncinternals.h>
+#include <stdfs.h>
+
+#ifdef ENABLE_SYNC
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+using namespace mega;
+
+namespace
+{
+
+class MacComputationTest: public ::testing::Test
+{
+protected:
+    static constexpr unsigned WORKER_THREADS = 4;
+
+    void SetUp() override
+    {
+        mPath = std::filesystem::current_path() / "mac_computation";
+
+        std::filesystem::remove_all(mPath);
+        std::filesystem::create_directory(mPath);
+
+        mClient = mt::makeClient(mApp, nullptr, WORKER_THREADS);
+    }
+
+    void TearDown() override
+    {
+        mClient.reset();
+        std::filesystem::remove_all(mPath);
+    }
+
+    LocalPath localPath(const std::filesystem::path& path) const
+    {
+        return LocalPath::fromAbsolutePath(path_u8string(path));
+    }
+
+    // A file whose content differs in every chunk, so misplaced chunk MACs show up
+    std::filesystem::path createFile(const std::string& name, m_off_t size) const
+    {
+        auto path = mPath / name;
+        std::ofstream out(path, std::ios::binary);
+
+        for (m_off_t i = 0; i < size; ++i)
+            out.put(static_cast<char>((i * 31 + i / 4096) & 0xff));
+
+        return path;
+    }
+
+    std::shared_ptr<MacComputationState> makeState(const std::filesystem::path& path,
+                                                   MacComputationThrottle& throttle) const
+    {
+        auto state = std::make_shared<MacComputationState>(
+            static_cast<m_off_t>(std::filesystem::file_size(path)),
+            localPath(path),
+            throttle);
+
+        for (size_t i = 0; i < state->transferkey.size(); ++i)
+            state->transferkey[i] = static_cast<byte>(i * 7 + 1);
+
+        state->ctriv = 0x0123456789abcdefLL;
+        return state;
+    }
+
+    // The MAC computed in one pass on this thread, as uploads do
+    int64_t referenceMac(const MacComputationState& state) const
+    {
+        auto fa = mClient->fsaccess->newfileaccess();
+        EXPECT_TRUE(fa->fopen(state.filePath, OpenFlag::OPEN_RDONLY, FSLogging::logOnError));
+
+        SymmCipher cipher;
+        cipher.setkey(state.transferkey.data());
+
+        auto [ok, mac] = generateMetaMac(cipher, *fa, state.ctriv, std::nullopt);
+        EXPECT_TRUE(ok);
+        return mac;
+    }
+
+    // Advances the computation as the sync loop does, until it's no longer pending
+    MacAdvanceResult run(const std::shared_ptr<MacComputationState>& state)
+    {
+        MacAdvanceResult result;
+
+        while ((result = advanceMacComputation(*mClient, state, "MacComputationTest: ")) ==
+               MacAdvanceResult::Pending)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return result;
+    }
+
+    MegaApp mApp;
+    std::shared_ptr<MegaClient> mClient;
+    std::filesystem::path mPath;
+};
+
+} // anonymous
+
+TEST_F(MacComputationTest, rangesComputedInParallelGiveTheFileMac)
+{
+    MacComputationThrottle throttle;
+
+    // Several ranges, the last of them partial
+    auto state = makeState(createFile("file", 3 * MacComputationState::BUFFER_SIZE + 12345),
+                           throttle);
+
+    ASSERT_EQ(run(state), MacAdvanceResult::Ready);
+    EXPECT_EQ(state->localMac, referenceMac(*state));
+    EXPECT_FALSE(state->hasRangesInFlight());
+    EXPECT_EQ(throttle.currentBytes(), 0);
+}
+
+TEST_F(MacComputationTest, smallAndEmptyFiles)
+{
+    MacComputationThrottle throttle;
+
+    for (m_off_t size: {m_off_t(0), m_off_t(1), m_off_t(128 * 1024 + 5)})
+    {
+        auto state = makeState(createFile("file" + std::to_string(size), size), throttle);
+
+        ASSERT_EQ(run(state), MacAdvanceResult::Ready) << size;
+        EXPECT_EQ(state->localMac, referenceMac(*state)) << size;
+    }
+}
+
+TEST_F(MacComputationTest, fileChangingSizeIsObsolete)
+{
+    MacComputationThrottle throttle;
+
+    auto path = createFile("file", 1024 * 1024);
+    auto state = makeState(path, throttle);
+
+    std::filesystem::resize_file(path, 512 * 1024);
+
+    EXPECT_EQ(run(state), MacAdvanceResult::Obsolete);
+}
+
+TEST_F(MacComputationTest, rangesInFlightAreBoundedByFileAndBudget)
+{
+    static constexpr m_off_t RANGE = 1024 * 1024;
+
+    MacComputationThrottle throttle(kDefaultMaxConcurrentMacComputations, 6 * RANGE);
+
+    // The first range always fits, even if it's larger than the whole budget
+    MacComputationThrottle tiny(1, RANGE / 2);
+    ASSERT_TRUE(tiny.tryAcquireBytes(RANGE));
+    EXPECT_FALSE(tiny.tryAcquireBytes(1));
+    tiny.releaseBytes(RANGE);
+
+    auto path = createFile("file", 1);
+    auto first = makeState(path, throttle);
+    auto second = makeState(path, throttle);
+
+    for (unsigned i = 0; i < MacComputationState::MAX_RANGES_IN_FLIGHT; ++i)
+        ASSERT_TRUE(first->tryStartRange(RANGE));
+
+    // The file has as many ranges in flight as it may
+    EXPECT_FALSE(first->tryStartRange(RANGE));
+
+    // The other file gets what's left of the budget
+    EXPECT_TRUE(second->tryStartRange(RANGE));
+    EXPECT_TRUE(second->tryStartRange(RANGE));
+    EXPECT_FALSE(second->tryStartRange(RANGE));
+    EXPECT_EQ(throttle.currentBytes(), 6 * RANGE);
+
+    first->finishRange(RANGE);
+    EXPECT_TRUE(second->tryStartRange(RANGE));
+
+    // Ranges still reserved when a state goes away are given back
+    first.reset();
+    EXPECT_EQ(throttle.currentBytes(), 3 * RANGE);
+
+    second.reset();
+    EXPECT_EQ(throttle.currentBytes(), 0);
+}
+
+// MAC throughput over many large files, verified as the sync engine does:
+// a few files at a time, each with several ranges in flight on the worker pool.
+// The files are sparse, so this measures the pipeline rather than the disk.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST_F(MacComputationTest, DISABLED_benchmark)
+{
+    static constexpr int NUM_FILES = 100;
+    static constexpr m_off_t FILE_SIZE = 1024LL * 1024 * 1024;
+
+    MacComputationThrottle throttle;
+    std::vector<std::shared_ptr<MacComputationState>> pending;
+
+    for (int i = 0; i < NUM_FILES; ++i)
+    {
+        auto path = mPath / ("file" + std::to_string(i));
+        std::ofstream(path).put('x');
+        std::filesystem::resize_file(path, static_cast<std::uintmax_t>(FILE_SIZE));
+
+        pending.emplace_back(makeState(path, throttle));
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<MacComputationState>> active;
+    int failed = 0;
+
+    while (!pending.empty() || !active.empty())
+    {
+        while (!pending.empty() && throttle.tryAcquireFile())
+        {
+            pending.back()->throttleSlotAcquired = true;
+            active.emplace_back(std::move(pending.back()));
+            pending.pop_back();
+        }
+
+        for (auto it = active.begin(); it != active.end();)
+        {
+            auto result = advanceMacComputation(*mClient, *it, "MacComputationTest: ");
+
+            if (result == MacAdvanceResult::Pending)
+            {
+                ++it;
+                continue;
+            }
+
+            failed += result != MacAdvanceResult::Ready;
+            it = active.erase(it);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - started)
+                       .count();
+
+    EXPECT_EQ(failed, 0);
+
+    std::cout << "computed the MACs of " << NUM_FILES << " files of " << FILE_SIZE
+              << " bytes in " << elapsed << "ms ("
+              << static_cast<double>(NUM_FILES * FILE_SIZE) / 1048576.0 /
+                     (static_cast<double>(std::max<decltype(elapsed)>(elapsed, 1)) / 1000.0)
+              << " MB/s) with " << WORKER_THREADS << " worker threads" << std::endl;
+}
+
+#endif // ENABLE_SYNC
@@ -0,0 +1,208 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega/base64.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+#include <mega/node.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace mega;
+
+namespace
+{
+
+// Nodes inside an incoming share, whose keys are encrypted with the share key.
+struct SharedFolder
+{
+    NodeHandle share;
+    SymmCipher shareKey;
+    sharedNode_vector nodes;
+};
+
+SharedFolder makeSharedFolder(MegaClient& client, size_t count, handle firstHandle)
+{
+    SharedFolder folder;
+
+    folder.share.set6byte(firstHandle);
+
+    byte shareKey[SymmCipher::KEYLENGTH];
+    client.rng.genblock(shareKey, sizeof(shareKey));
+    folder.shareKey.setkey(shareKey);
+
+    auto shareHandle = Base64Str<MegaClient::NODEHANDLE>(folder.share.as8byte());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto node = std::make_shared<Node>(client,
+                                           NodeHandle().set6byte(firstHandle + 1 + i),
+                                           folder.share,
+                                           FILENODE,
+                                           1024,
+                                           UNDEF,
+                                           nullptr,
+                                           0);
+
+        byte key[FILENODEKEYLENGTH];
+        client.rng.genblock(key, sizeof(key));
+
+        // attributes encrypted with the node key
+        SymmCipher nodeKey;
+        std::string keyString(reinterpret_cast<const char*>(key), sizeof(key));
+        nodeKey.setkey(&keyString);
+
+        std::string attrs;
+        auto json = "\"n\":\"file" + std::to_string(i) + "\"";
+        MegaClient::makeattr(&nodeKey, &attrs, json.c_str());
+
+        node->attrstring = std::make_unique<std::string>();
+        Base64::btoa(attrs, *node->attrstring);
+
+        // key encrypted with the share key
+        folder.shareKey.ecb_encrypt(key, key, sizeof(key));
+
+        std::string encryptedKey;
+        Base64::btoa(std::string(reinterpret_cast<const char*>(key), sizeof(key)), encryptedKey);
+        node->setKey(std::string(shareHandle) + ":" + encryptedKey);
+
+        client.mNodeManager.addNodePendingApplykey(node);
+        folder.nodes.emplace_back(std::move(node));
+    }
+
+    return folder;
+}
+
+void receiveShareKey(MegaClient& client, const SharedFolder& folder)
+{
+    client.mNewKeyRepository[folder.share].assign(folder.shareKey.key,
+                                                  folder.shareKey.key + SymmCipher::KEYLENGTH);
+}
+
+} // anonymous
+
+TEST(NodeKeys, applyKeysInParallelOnceShareKeyArrives)
+{
+    MegaApp app;
+    auto client = mt::makeClient(app, nullptr, 2);
+
+    auto count = NodeManager::MIN_NODES_TO_APPLY_KEYS_IN_PARALLEL * 2;
+    auto folder = makeSharedFolder(*client, count, 1);
+    auto other = makeSharedFolder(*client, 10, 1000000);
+
+    client->mNodeManager.applyKeys();
+
+    for (auto& node: folder.nodes)
+        ASSERT_FALSE(node->keyApplied());
+
+    receiveShareKey(*client, folder);
+    client->mNodeManager.applyKeys();
+
+    for (size_t i = 0; i < folder.nodes.size(); ++i)
+    {
+        auto& node = folder.nodes[i];
+
+        ASSERT_TRUE(node->keyApplied());
+        ASSERT_FALSE(node->attrstring);
+        ASSERT_EQ(node->attrs.map['n'], "file" + std::to_string(i));
+    }
+
+    // Nodes of shares whose key hasn't arrived stay pending.
+    for (auto& node: other.nodes)
+    {
+        EXPECT_FALSE(node->keyApplied());
+        EXPECT_TRUE(node->attrstring);
+    }
+
+    EXPECT_EQ(client->mNodeManager.getNumNodesKeyApplied(), static_cast<long long>(count));
+}
+
+TEST(NodeKeys, applyKeysKeepsNodesWithUndecryptableAttributesPending)
+{
+    MegaApp app;
+    auto client = mt::makeClient(app, nullptr, 2);
+
+    auto folder = makeSharedFolder(*client, NodeManager::MIN_NODES_TO_APPLY_KEYS_IN_PARALLEL, 1);
+
+    // Attributes that aren't valid for the node key.
+    auto corrupt = folder.nodes.front();
+    corrupt->attrstring->assign(corrupt->attrstring->size(), 'A');
+
+    receiveShareKey(*client, folder);
+    client->mNodeManager.applyKeys();
+
+    // As with any foreign key, the key is kept encrypted in case an updated share key arrives.
+    EXPECT_FALSE(corrupt->keyApplied());
+    EXPECT_TRUE(corrupt->attrstring);
+
+    for (size_t i = 1; i < folder.nodes.size(); ++i)
+        ASSERT_TRUE(folder.nodes[i]->keyApplied());
+}
+
+// Applies a share key to the nodes of a large incoming share one by one, and
+// through NodeManager::applyKeys with the client's worker threads.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(NodeKeys, DISABLED_benchmarkApplyShareKey)
+{
+    static constexpr size_t COUNT = 500000;
+
+    MegaApp app;
+    auto client = mt::makeClient(app, nullptr, std::thread::hardware_concurrency());
+
+    {
+        auto folder = makeSharedFolder(*client, COUNT, 1);
+
+        receiveShareKey(*client, folder);
+
+        auto started = std::chrono::steady_clock::now();
+
+        for (auto& node: folder.nodes)
+            node->applykey();
+
+        auto elapsed = std::chrono::steady_clock::now() - started;
+
+        std::cout << "serial:   "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms"
+                  << std::endl;
+    }
+
+    {
+        auto folder = makeSharedFolder(*client, COUNT, 1);
+
+        receiveShareKey(*client, folder);
+
+        auto started = std::chrono::steady_clock::now();
+
+        client->mNodeManager.applyKeys();
+
+        auto elapsed = std::chrono::steady_clock::now() - started;
+
+        std::cout << "parallel: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms ("
+                  << std::thread::hardware_concurrency() << " threads)" << std::endl;
+
+        for (auto& node: folder.nodes)
+            ASSERT_TRUE(node->keyApplied());
+    }
+}
@@ -0,0 +1,297 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+
+#include <array>
+#include <chrono>
+#include <iostream>
+
+using namespace mega;
+
+namespace
+{
+
+// A file with attributes, file attributes and a public link, in the legacy format
+// (see Serialization.Node_forFile_withoutShares_32bit)
+std::string legacyFile()
+{
+    const std::array<char, 131> rawData = {
+        0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2a, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x2b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x58, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x2c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x58, 0x58, 0x58, 0x58,
+        0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58,
+        0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58, 0x58,
+        0x58, 0x58, 0x58, 0x58, 0x05, 0x00, 0x62, 0x6c, 0x61, 0x68, 0x00, 0x01,
+        0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x65, 0x03,
+        0x00, 0x66, 0x6f, 0x6f, 0x01, 0x66, 0x03, 0x00, 0x62, 0x61, 0x72, 0x00,
+        0x2a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+
+    return std::string(rawData.data(), rawData.size());
+}
+
+std::string record(const std::string& legacy)
+{
+    std::string result;
+    NodeData(legacy.data(), legacy.size(), NodeData::COMPONENT_ALL).toRecord(result);
+    return result;
+}
+
+void checkLegacyFile(const NodeRecord& r)
+{
+    ASSERT_TRUE(r.valid());
+    EXPECT_EQ(r.type(), FILENODE);
+    EXPECT_EQ(r.size(), 12);
+    EXPECT_EQ(r.nodeHandle(), 42u);
+    EXPECT_EQ(r.parentHandle(), 43u);
+    EXPECT_EQ(r.owner(), 88u);
+    EXPECT_EQ(r.ctime(), 44);
+    EXPECT_EQ(r.section(NodeRecord::NODE_KEY), std::string(FILENODEKEYLENGTH, 'X'));
+    EXPECT_EQ(r.section(NodeRecord::FILE_ATTRIBUTES), "blah");
+    EXPECT_EQ(r.flags(), NodeRecord::EXPORTED);
+    EXPECT_EQ(r.linkHandle(), 42u);
+    EXPECT_EQ(r.linkCreation(), 1);
+    EXPECT_EQ(r.linkExpiry(), 2);
+    EXPECT_EQ(r.numShares(), 0);
+    EXPECT_EQ(r.attribute(101), std::optional<std::string_view>("foo"));
+    EXPECT_EQ(r.attribute(102), std::optional<std::string_view>("bar"));
+    EXPECT_FALSE(r.attribute(103));
+}
+
+} // anonymous
+
+TEST(NodeRecord, legacyNodesAreConverted)
+{
+    auto legacy = legacyFile();
+    ASSERT_FALSE(NodeRecord::isRecord(legacy.data(), legacy.size()));
+
+    auto converted = record(legacy);
+    ASSERT_TRUE(NodeRecord::isRecord(converted.data(), converted.size()));
+    checkLegacyFile(NodeRecord(converted.data(), converted.size()));
+
+    // Records are left as they are.
+    std::string again;
+    ASSERT_TRUE(NodeData(converted.data(), converted.size(), NodeData::COMPONENT_ALL).toRecord(again));
+    EXPECT_EQ(again, converted);
+}
+
+TEST(NodeRecord, nodeDataReadsRecordsInPlace)
+{
+    auto converted = record(legacyFile());
+
+    NodeData nd(converted.data(), converted.size(), NodeData::COMPONENT_ATTRS);
+    EXPECT_EQ(nd.getHandle(), 42u);
+    EXPECT_EQ(nd.getLabel(), LBL_UNKNOWN);
+    EXPECT_EQ(nd.getMtime(), 0);
+}
+
+TEST(NodeRecord, invalidRecordsAreRejected)
+{
+    auto converted = record(legacyFile());
+
+    // truncated
+    EXPECT_FALSE(NodeRecord(converted.data(), NodeRecord::HEADER_SIZE - 1).valid());
+    EXPECT_FALSE(NodeRecord(converted.data(), converted.size() - 1).valid());
+
+    // from a newer version
+    auto newer = converted;
+    newer[8] = NodeRecord::FORMAT_VERSION + 1;
+    EXPECT_FALSE(NodeRecord(newer.data(), newer.size()).valid());
+
+    NodeData nd(converted.data(), converted.size() - 1, NodeData::COMPONENT_ALL);
+    EXPECT_EQ(nd.getHandle(), UNDEF);
+}
+
+TEST(NodeRecord, nodesAreSerializedAsRecords)
+{
+    MegaApp app;
+    auto client = mt::makeClient(app);
+
+    auto& parent = mt::makeNode(*client, FOLDERNODE, NodeHandle().set6byte(43));
+    std::unique_ptr<Node> n{&mt::makeNode(*client, FILENODE, NodeHandle().set6byte(42), &parent)};
+    n->size = 12;
+    n->owner = 88;
+    n->ctime = 44;
+    n->attrs.map = attr_map{{101, "foo"}, {102, "bar"}};
+    n->fileattrstring = "blah";
+    n->plink.reset(new PublicLink{n->nodehandle, 1, 2, false});
+
+    std::string data;
+    ASSERT_TRUE(n->serialize(&data));
+    ASSERT_TRUE(NodeRecord::isRecord(data.data(), data.size()));
+
+    NodeRecord r(data.data(), data.size());
+    ASSERT_TRUE(r.valid());
+    EXPECT_EQ(r.nodeHandle(), n->nodehandle);
+    EXPECT_EQ(r.parentHandle(), parent.nodehandle);
+    EXPECT_EQ(r.section(NodeRecord::FILE_ATTRIBUTES), "blah");
+    EXPECT_EQ(r.attribute(102), std::optional<std::string_view>("bar"));
+}
+
+class NodeRecordMigrationTest: public testing::Test
+{
+protected:
+    FSACCESS_CLASS mFsAccess;
+    PrnGen mRng;
+    LocalPath mRootPath;
+    const std::string mName = "noderecord";
+
+    void SetUp() override
+    {
+        ASSERT_TRUE(mFsAccess.cwd(mRootPath));
+        mRootPath.appendWithSeparator(LocalPath::fromRelativePath("noderecord_db"), false);
+
+        mFsAccess.emptydirlocal(mRootPath);
+        mFsAccess.rmdirlocal(mRootPath);
+        ASSERT_TRUE(mFsAccess.mkdirlocal(mRootPath, false, true));
+    }
+
+    void TearDown() override
+    {
+        mFsAccess.emptydirlocal(mRootPath);
+        mFsAccess.rmdirlocal(mRootPath);
+    }
+
+    std::unique_ptr<DbTable> open(SqliteDbAccess& dbAccess)
+    {
+        return std::unique_ptr<DbTable>(
+            dbAccess.openTableWithNodes(mRng, mFsAccess, mName, 0, nullptr));
+    }
+
+    // runs statements on the DB file, behind the SDK's back
+    void exec(SqliteDbAccess& dbAccess,
+              const std::string& sql,
+              const std::function<void(sqlite3_stmt*)>& row = nullptr)
+    {
+        auto path = dbAccess.databasePath(mFsAccess, mName, DbAccess::DB_VERSION);
+
+        sqlite3* db = nullptr;
+        ASSERT_EQ(sqlite3_open(path.toPath(false).c_str(), &db), SQLITE_OK);
+        ASSERT_TRUE(SqliteAccountState::registerNodeFunctions(db));
+
+        sqlite3_stmt* stmt = nullptr;
+        ASSERT_EQ(sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr), SQLITE_OK);
+
+        int result;
+        while ((result = sqlite3_step(stmt)) == SQLITE_ROW)
+        {
+            if (row)
+                row(stmt);
+        }
+
+        EXPECT_EQ(result, SQLITE_DONE);
+        sqlite3_finalize(stmt);
+        sqlite3_close(db);
+    }
+};
+
+TEST_F(NodeRecordMigrationTest, legacyNodesAreRewrittenOnOpen)
+{
+    SqliteDbAccess dbAccess(mRootPath);
+    ASSERT_TRUE(open(dbAccess));
+
+    // as left by a version that didn't know about records
+    auto legacy = legacyFile();
+    exec(dbAccess, "PRAGMA user_version = 0");
+    exec(dbAccess,
+         "INSERT INTO nodes (nodehandle, parenthandle, type, counter, node) VALUES (42, 43, 0, "
+         "x'', x'" +
+             Utils::stringToHex(legacy, false) + "')");
+    exec(dbAccess,
+         "SELECT ownerVirtual FROM nodes",
+         [](sqlite3_stmt* stmt)
+         {
+             EXPECT_EQ(sqlite3_column_int64(stmt, 0), 88);
+         });
+
+    ASSERT_TRUE(open(dbAccess));
+
+    std::string node;
+    exec(dbAccess,
+         "SELECT node, ownerVirtual FROM nodes",
+         [&node](sqlite3_stmt* stmt)
+         {
+             node.assign(static_cast<const char*>(sqlite3_column_blob(stmt, 0)),
+                         static_cast<size_t>(sqlite3_column_bytes(stmt, 0)));
+             EXPECT_EQ(sqlite3_column_int64(stmt, 1), 88);
+         });
+
+    ASSERT_TRUE(NodeRecord::isRecord(node.data(), node.size()));
+    checkLegacyFile(NodeRecord(node.data(), node.size()));
+
+    exec(dbAccess,
+         "PRAGMA user_version",
+         [](sqlite3_stmt* stmt)
+         {
+             EXPECT_EQ(sqlite3_column_int(stmt, 0), NodeRecord::FORMAT_VERSION);
+         });
+}
+
+// Nodes loaded per second from the legacy format and from records, and
+// handle and attribute lookups per second without loading the node.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(NodeRecord, DISABLED_benchmark)
+{
+    static constexpr int COUNT = 200000;
+
+    MegaApp app;
+    auto client = mt::makeClient(app);
+
+    auto legacy = legacyFile();
+    auto converted = record(legacy);
+
+    auto rate = [](std::chrono::steady_clock::time_point started)
+    {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - started)
+                      .count();
+        return static_cast<long long>(COUNT * 1000000.0 / static_cast<double>(std::max<decltype(us)>(us, 1)));
+    };
+
+    for (auto* format: {&legacy, &converted})
+    {
+        auto name = format == &legacy ? "legacy" : "record";
+
+        auto started = std::chrono::steady_clock::now();
+        for (int i = 0; i < COUNT; ++i)
+        {
+            std::list<std::unique_ptr<NewShare>> shares;
+            auto n = Node::unserialize(*client, format, false, shares);
+            ASSERT_TRUE(n);
+        }
+        std::cout << name << ": " << rate(started) << " nodes/s loaded" << std::endl;
+
+        started = std::chrono::steady_clock::now();
+        for (int i = 0; i < COUNT; ++i)
+        {
+            NodeData nd(format->data(), format->size(), NodeData::COMPONENT_ATTRS);
+            ASSERT_EQ(nd.getHandle(), 42u);
+            ASSERT_EQ(nd.getLabel(), LBL_UNKNOWN);
+        }
+        std::cout << name << ": " << rate(started) << " nodes/s looked up" << std::endl;
+    }
+}
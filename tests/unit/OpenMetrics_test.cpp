@@ -0,0 +1,121 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+#include <mega/openmetrics.h>
+
+#include <regex>
+#include <sstream>
+
+using namespace mega;
+using stats::OpenMetricsWriter;
+
+TEST(OpenMetrics, writesFamiliesAndSamples)
+{
+    OpenMetricsWriter writer;
+
+    writer.family("transfers_started", OpenMetricsWriter::Type::COUNTER, "Transfers started.");
+    writer.sample({}, 3);
+
+    writer.family("transfer_median_size_bytes",
+                  OpenMetricsWriter::Type::GAUGE,
+                  "Median size.",
+                  "bytes");
+    writer.sample({{"direction", "upload"}}, 1024);
+    writer.sample({{"direction", "download"}}, 0.5);
+
+    EXPECT_EQ(writer.finish(),
+              "# TYPE mega_transfers_started counter\n"
+              "# HELP mega_transfers_started Transfers started.\n"
+              "mega_transfers_started_total 3\n"
+              "# TYPE mega_transfer_median_size_bytes gauge\n"
+              "# UNIT mega_transfer_median_size_bytes bytes\n"
+              "# HELP mega_transfer_median_size_bytes Median size.\n"
+              "mega_transfer_median_size_bytes{direction=\"upload\"} 1024\n"
+              "mega_transfer_median_size_bytes{direction=\"download\"} 0.5\n"
+              "# EOF\n");
+}
+
+TEST(OpenMetrics, writesCumulativeHistogramBuckets)
+{
+    OpenMetricsWriter writer;
+
+    writer.family("scope_duration_seconds",
+                  OpenMetricsWriter::Type::HISTOGRAM,
+                  "Time spent.",
+                  "seconds");
+    writer.histogram({{"scope", "exec"}}, {0.001, 0.1}, {2, 0, 5}, 1.25);
+
+    EXPECT_EQ(writer.finish(),
+              "# TYPE mega_scope_duration_seconds histogram\n"
+              "# UNIT mega_scope_duration_seconds seconds\n"
+              "# HELP mega_scope_duration_seconds Time spent.\n"
+              "mega_scope_duration_seconds_bucket{scope=\"exec\",le=\"0.001\"} 2\n"
+              "mega_scope_duration_seconds_bucket{scope=\"exec\",le=\"0.1\"} 2\n"
+              "mega_scope_duration_seconds_bucket{scope=\"exec\",le=\"+Inf\"} 7\n"
+              "mega_scope_duration_seconds_count{scope=\"exec\"} 7\n"
+              "mega_scope_duration_seconds_sum{scope=\"exec\"} 1.25\n"
+              "# EOF\n");
+}
+
+TEST(OpenMetrics, escapesLabelValues)
+{
+    EXPECT_EQ(OpenMetricsWriter::escape("a\"b\\c\nd"), "a\\\"b\\\\c\\nd");
+}
+
+TEST(OpenMetrics, clientExportsTransferStatistics)
+{
+    MegaApp app;
+    auto client = mt::makeClient(app);
+
+    auto metrics = client->openMetrics();
+
+    // Every line is a descriptor or a sample, and the exposition is terminated.
+    std::regex descriptor("# (TYPE|UNIT|HELP) mega_[a-z_]+ .*");
+    std::regex sample("mega_[a-z_]+(\\{[a-z]+=\"[^\"]*\"(,[a-z]+=\"[^\"]*\")*\\})? [-+0-9.eInfNa]+");
+
+    std::istringstream lines(metrics);
+    std::string line;
+    std::string last;
+
+    while (std::getline(lines, line))
+    {
+        last = line;
+
+        if (line == "# EOF")
+            continue;
+
+        EXPECT_TRUE(std::regex_match(line, descriptor) || std::regex_match(line, sample)) << line;
+    }
+
+    EXPECT_EQ(last, "# EOF");
+
+    EXPECT_NE(metrics.find("mega_transfer_median_speed_bytes_per_second{direction=\"upload\"} 0\n"),
+              std::string::npos);
+    EXPECT_NE(metrics.find("mega_transfer_median_speed_bytes_per_second{direction=\"download\"} 0\n"),
+              std::string::npos);
+
+#ifdef MEGA_MEASURE_CODE
+    EXPECT_NE(metrics.find("mega_scope_duration_seconds_count{scope=\"MegaClient_exec\"}"),
+              std::string::npos);
+#endif
+}
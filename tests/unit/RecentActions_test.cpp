@@ -0,0 +1,249 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "mega.h"
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using namespace mega;
+
+class RecentActionsTest: public testing::Test
+{
+protected:
+    MegaApp mApp;
+    NodeManager::MissingParentNodes mMissingParentNodes;
+    uint64_t mIndex = 1;
+    std::shared_ptr<MegaClient> mClient;
+    std::shared_ptr<Node> mRoot;
+
+    // the start of a six hour window, so every file added falls in the same one
+    static constexpr m_time_t FILE_CTIME = 1700006400;
+
+    void SetUp() override
+    {
+        auto dbAccess = new SqliteDbAccess(LocalPath::fromAbsolutePath("."));
+        mClient = mt::makeClient(mApp, dbAccess);
+        mClient->sid =
+            "AWA5YAbtb4JO-y2zWxmKZpSe5-6XM7CTEkA-3Nv7J4byQUpOazdfSC1ZUFlS-kah76gPKUEkTF9g7MeE";
+        mClient->opensctable();
+        mClient->mNodeManager.setCacheLRUMaxSize(1000);
+        table().removeNodes();
+
+        mRoot = addNode(ROOTNODE, nullptr);
+        addNode(VAULTNODE, nullptr);
+        addNode(RUBBISHNODE, nullptr);
+
+        table().createIndexes(false, false);
+    }
+
+    void TearDown() override
+    {
+        mRoot.reset();
+        mClient.reset();
+    }
+
+    DBTableNodes& table()
+    {
+        return *dynamic_cast<DBTableNodes*>(mClient->sctable.get());
+    }
+
+    std::shared_ptr<Node> addNode(nodetype_t type,
+                                  const std::shared_ptr<Node>& parent,
+                                  const std::string& name = std::string(),
+                                  handle owner = 1,
+                                  m_time_t ctime = FILE_CTIME)
+    {
+        auto& nodeRef = mt::makeNode(*mClient, type, NodeHandle().set6byte(mIndex++), parent.get());
+        std::shared_ptr<Node> node(&nodeRef);
+
+        node->owner = owner;
+        node->ctime = ctime;
+
+        if (!name.empty())
+            node->attrs.map['n'] = name;
+
+        if (type == FILENODE)
+        {
+            node->size = 1;
+            node->mtime = ctime;
+            node->isvalid = true;
+            node->serializefingerprint(&node->attrs.map['c']);
+            node->setfingerprint();
+        }
+
+        mClient->mNodeManager.addNode(node, !!parent, !parent, mMissingParentNodes);
+        mClient->mNodeManager.saveNodeInDb(node.get());
+        return node;
+    }
+
+    static std::vector<std::string> names(const recentaction& ra)
+    {
+        std::vector<std::string> result;
+
+        for (auto& node: ra.nodes)
+            result.emplace_back(node->displayname());
+
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+TEST_F(RecentActionsTest, filesAreBucketedWithoutLoadingTheirNodes)
+{
+    auto folder = addNode(FOLDERNODE, mRoot, "folder");
+    auto other = addNode(FOLDERNODE, mRoot, "other");
+
+    addNode(FILENODE, folder, "a.jpg");
+    addNode(FILENODE, folder, "b.mp4");
+    addNode(FILENODE, folder, "c.txt");
+    addNode(FILENODE, folder, "d.txt", 2);
+    addNode(FILENODE, other, "e.jpg");
+
+    // a file with a previous version
+    auto updated = addNode(FILENODE, folder, "f.txt");
+    addNode(FILENODE, updated, "f.txt", 1, FILE_CTIME - 1);
+
+    std::vector<RecentFile> files;
+    ASSERT_TRUE(table().getRecentFiles(NodeSearchPage{0, 0}, 0, files));
+
+    // versions aren't recent files themselves
+    ASSERT_EQ(files.size(), 6u);
+
+    for (auto& file: files)
+    {
+        EXPECT_EQ(file.ctime, FILE_CTIME);
+
+        if (file.nodeHandle == updated->nodeHandle())
+            EXPECT_TRUE(file.updated);
+        else
+            EXPECT_FALSE(file.updated);
+    }
+
+    auto actions = mClient->getRecentActions(100, 0, false);
+    ASSERT_EQ(actions.size(), 5u);
+
+    auto find = [&actions](handle owner, const std::shared_ptr<Node>& parent, bool media, bool upd)
+    {
+        return std::find_if(actions.begin(),
+                            actions.end(),
+                            [&](const recentaction& ra)
+                            {
+                                return ra.meta.user == owner &&
+                                       ra.meta.parent == parent->nodehandle &&
+                                       ra.meta.media == media && ra.meta.updated == upd;
+                            });
+    };
+
+    auto media = find(1, folder, true, false);
+    ASSERT_NE(media, actions.end());
+    EXPECT_EQ(names(*media), (std::vector<std::string>{"a.jpg", "b.mp4"}));
+
+    auto documents = find(1, folder, false, false);
+    ASSERT_NE(documents, actions.end());
+    EXPECT_EQ(names(*documents), (std::vector<std::string>{"c.txt"}));
+
+    auto otherOwner = find(2, folder, false, false);
+    ASSERT_NE(otherOwner, actions.end());
+    EXPECT_EQ(names(*otherOwner), (std::vector<std::string>{"d.txt"}));
+
+    auto otherFolder = find(1, other, true, false);
+    ASSERT_NE(otherFolder, actions.end());
+    EXPECT_EQ(names(*otherFolder), (std::vector<std::string>{"e.jpg"}));
+
+    auto versioned = find(1, folder, false, true);
+    ASSERT_NE(versioned, actions.end());
+    EXPECT_EQ(names(*versioned), (std::vector<std::string>{"f.txt"}));
+
+    // The ids built from the DB's columns find the same buckets.
+    recentaction byId;
+    ASSERT_EQ(mClient->getRecentActionById(media->id.c_str(), byId), API_OK);
+    EXPECT_EQ(names(byId), names(*media));
+}
+
+TEST_F(RecentActionsTest, sensitiveFoldersAreExcluded)
+{
+    auto folder = addNode(FOLDERNODE, mRoot, "folder");
+    auto hidden = addNode(FOLDERNODE, mRoot, "hidden");
+    hidden->attrs.map[AttrMap::string2nameid("sen")] = "1";
+    mClient->mNodeManager.saveNodeInDb(hidden.get());
+    auto nested = addNode(FOLDERNODE, hidden, "nested");
+
+    addNode(FILENODE, folder, "a.txt", 1, FILE_CTIME + 3);
+    addNode(FILENODE, hidden, "b.txt", 1, FILE_CTIME + 2);
+    addNode(FILENODE, nested, "c.txt", 1, FILE_CTIME + 1);
+    addNode(FILENODE, folder, "d.txt", 1, FILE_CTIME);
+
+    auto files = mClient->mNodeManager.getRecentFiles(2, 0, true);
+    ASSERT_EQ(files.size(), 2u);
+    EXPECT_EQ(files[0].ctime, FILE_CTIME + 3);
+    EXPECT_EQ(files[1].ctime, FILE_CTIME);
+
+    EXPECT_EQ(mClient->mNodeManager.getRecentFiles(10, 0, false).size(), 4u);
+}
+
+// Time taken to add files, which keeps the DB's recents index up to date, and
+// to get recent actions out of them.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST_F(RecentActionsTest, DISABLED_benchmark)
+{
+    static constexpr int NUM_FOLDERS = 500;
+    static constexpr int FILES_PER_FOLDER = 200;
+    static const std::vector<unsigned> MAX_COUNTS = {50, 500, 5000};
+
+    auto started = std::chrono::steady_clock::now();
+    mClient->sctable->begin();
+
+    for (int i = 0; i < NUM_FOLDERS; ++i)
+    {
+        auto folder = addNode(FOLDERNODE, mRoot, "folder" + std::to_string(i));
+
+        for (int j = 0; j < FILES_PER_FOLDER; ++j)
+        {
+            auto name = "file" + std::to_string(j) + (j % 2 ? ".jpg" : ".txt");
+            addNode(FILENODE, folder, name, 1 + static_cast<handle>(j % 3), FILE_CTIME + j * 600);
+        }
+    }
+
+    mClient->sctable->commit();
+
+    std::cout << "added " << NUM_FOLDERS * FILES_PER_FOLDER << " files in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - started)
+                     .count()
+              << "ms" << std::endl;
+
+    for (auto maxcount: MAX_COUNTS)
+    {
+        started = std::chrono::steady_clock::now();
+        auto actions = mClient->getRecentActions(maxcount, 0, false);
+
+        std::cout << "maxcount " << maxcount << ": " << actions.size() << " buckets in "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - started)
+                         .count()
+                  << "us" << std::endl;
+    }
+}
@@ -321,7 +321,7 @@ TEST(Serialization, Node_forFile_withoutParent_withoutShares_withoutAttrs_withou
     n->ctime = 44;
     std::string data;
     ASSERT_TRUE(n->serialize(&data));
-    ASSERT_EQ(90u, data.size());
+    ASSERT_EQ(120u, data.size());
     auto dn = client.cli->mNodeManager.getNodeFromBlob(&data);
     checkDeserializedNode(*dn, *n);
 }
@@ -335,7 +335,7 @@ TEST(Serialization, Node_forFolder_withoutParent_withoutShares_withoutAttrs_with
     n->ctime = 44;
     std::string data;
     ASSERT_TRUE(n->serialize(&data));
-    ASSERT_EQ(71u, data.size());
+    ASSERT_EQ(104u, data.size());
     auto dn = client.cli->mNodeManager.getNodeFromBlob(&data);
     checkDeserializedNode(*dn, *n);
 }
@@ -350,7 +350,7 @@ TEST(Serialization, Node_forFile_withoutShares_withoutAttrs_withoutFileAttrStrin
     n->ctime = 44;
     std::string data;
     ASSERT_TRUE(n->serialize(&data));
-    ASSERT_EQ(90u, data.size());
+    ASSERT_EQ(120u, data.size());
     auto dn = client.cli->mNodeManager.getNodeFromBlob(&data);
     checkDeserializedNode(*dn, *n);
 }
@@ -369,7 +369,7 @@ TEST(Serialization, Node_forFile_withoutShares_withoutFileAttrString_withoutPlin
     };
     std::string data;
     ASSERT_TRUE(n->serialize(&data));
-    ASSERT_EQ(104u, data.size());
+    ASSERT_EQ(154u, data.size());
     auto dn = client.cli->mNodeManager.getNodeFromBlob(&data);
     checkDeserializedNode(*dn, *n);
 }
@@ -389,7 +389,7 @@ TEST(Serialization, Node_forFile_withoutShares_withoutPlink)
     n->fileattrstring = "blah";
     std::string data;
     ASSERT_TRUE(n->serialize(&data));
-    ASSERT_EQ(108u, data.size());
+    ASSERT_EQ(158u, data.size());
     auto dn = client.cli->mNodeManager.getNodeFromBlob(&data);
     checkDeserializedNode(*dn, *n);
 }
@@ -410,7 +410,7 @@ TEST(Serialization, Node_forFile_withoutShares)
     n->plink.reset(new mega::PublicLink{n->nodehandle, 1, 2, false});
     std::string data;
     ASSERT_TRUE(n->serialize(&data));
-    ASSERT_EQ(131u, data.size());
+    ASSERT_EQ(182u, data.size());
     auto dn = client.cli->mNodeManager.getNodeFromBlob(&data);
     checkDeserializedNode(*dn, *n);
 }
@@ -432,7 +432,7 @@ TEST(Serialization, Node_forFile_withoutShares_withAuthKey)
     n->plink.reset(new mega::PublicLink{n->nodehandle, 1, 2, false, "someAuthKey"});
     std::string data;
     ASSERT_TRUE(n->serialize(&data));
-    ASSERT_EQ(142u, data.size());
+    ASSERT_EQ(193u, data.size());
     auto dn = client.cli->mNodeManager.getNodeFromBlob(&data);
     checkDeserializedNode(*dn, *n);
 }
@@ -482,7 +482,7 @@ TEST(Serialization, Node_forFolder_withoutShares_withoutAttrs_withoutFileAttrStr
     n->ctime = 44;
     std::string data;
     ASSERT_TRUE(n->serialize(&data));
-    ASSERT_EQ(71u, data.size());
+    ASSERT_EQ(104u, data.size());
     auto dn = client.cli->mNodeManager.getNodeFromBlob(&data);
     checkDeserializedNode(*dn, *n);
 }
@@ -501,7 +501,7 @@ TEST(Serialization, Node_forFolder_withoutShares_withoutFileAttrString_withoutPl
     };
     std::string data;
     ASSERT_TRUE(n->serialize(&data));
-    ASSERT_EQ(85u, data.size());
+    ASSERT_EQ(138u, data.size());
     auto dn = client.cli->mNodeManager.getNodeFromBlob(&data);
     checkDeserializedNode(*dn, *n);
 }
@@ -521,7 +521,7 @@ TEST(Serialization, Node_forFolder_withoutShares_withoutPlink)
     n->fileattrstring = "blah";
     std::string data;
     ASSERT_TRUE(n->serialize(&data));
-    ASSERT_EQ(85u, data.size());
+    ASSERT_EQ(138u, data.size());
     auto dn = client.cli->mNodeManager.getNodeFromBlob(&data);
     checkDeserializedNode(*dn, *n, true);
 }
@@ -543,7 +543,7 @@ TEST(Serialization, Node_forFolder_withoutShares)
     std::string data;
     ASSERT_TRUE(n->serialize(&data));
 
-    ASSERT_EQ(108u, data.size());
+    ASSERT_EQ(162u, data.size());
     auto dn = client.cli->mNodeManager.getNodeFromBlob(&data);
     checkDeserializedNode(*dn, *n, true);
 }
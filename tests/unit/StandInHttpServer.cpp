@@ -0,0 +1,846 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "StandInHttpServer.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+namespace mt
+{
+
+namespace
+{
+
+// Prefers HTTP/2 when the client offers it.
+int selectProtocol(SSL*,
+                   const unsigned char** selected,
+                   unsigned char* selectedLength,
+                   const unsigned char* offered,
+                   unsigned int offeredLength,
+                   void*)
+{
+    static const unsigned char supported[] = "\x02h2\x08http/1.1";
+
+    auto result = SSL_select_next_proto(const_cast<unsigned char**>(selected),
+                                        selectedLength,
+                                        supported,
+                                        sizeof(supported) - 1,
+                                        offered,
+                                        offeredLength);
+
+    if (result != OPENSSL_NPN_NEGOTIATED)
+        return SSL_TLSEXT_ERR_NOACK;
+
+    return SSL_TLSEXT_ERR_OK;
+}
+
+// Creates a server context with a throwaway self-signed certificate.
+std::shared_ptr<SSL_CTX> makeTlsContext(bool http2)
+{
+    std::shared_ptr<SSL_CTX> context(SSL_CTX_new(TLS_server_method()), SSL_CTX_free);
+    if (!context)
+        return nullptr;
+
+    std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> keyContext(
+        EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr),
+        EVP_PKEY_CTX_free);
+
+    EVP_PKEY* rawKey = nullptr;
+
+    if (!keyContext || EVP_PKEY_keygen_init(keyContext.get()) <= 0 ||
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyContext.get(), NID_X9_62_prime256v1) <= 0 ||
+        EVP_PKEY_keygen(keyContext.get(), &rawKey) <= 0)
+        return nullptr;
+
+    std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key(rawKey, EVP_PKEY_free);
+    std::unique_ptr<X509, decltype(&X509_free)> certificate(X509_new(), X509_free);
+
+    if (!certificate)
+        return nullptr;
+
+    X509_set_version(certificate.get(), 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate.get()), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate.get()), 0);
+    X509_gmtime_adj(X509_getm_notAfter(certificate.get()), 24 * 3600);
+    X509_set_pubkey(certificate.get(), key.get());
+
+    auto* name = X509_get_subject_name(certificate.get());
+    X509_NAME_add_entry_by_txt(name,
+                               "CN",
+                               MBSTRING_ASC,
+                               reinterpret_cast<const unsigned char*>("127.0.0.1"),
+                               -1,
+                               -1,
+                               0);
+    X509_set_issuer_name(certificate.get(), name);
+
+    if (!X509_sign(certificate.get(), key.get(), EVP_sha256()) ||
+        SSL_CTX_use_certificate(context.get(), certificate.get()) != 1 ||
+        SSL_CTX_use_PrivateKey(context.get(), key.get()) != 1)
+        return nullptr;
+
+    // Allow clients to resume sessions, both by ID and by ticket.
+    static const unsigned char sessionContext[] = "StandInHttpServer";
+
+    SSL_CTX_set_session_id_context(context.get(), sessionContext, sizeof(sessionContext) - 1);
+    SSL_CTX_set_session_cache_mode(context.get(), SSL_SESS_CACHE_SERVER);
+
+    if (http2)
+        SSL_CTX_set_alpn_select_cb(context.get(), selectProtocol, nullptr);
+
+    return context;
+}
+
+// HTTP/2 frame types and flags (RFC 9113, section 6.)
+enum FrameType : std::uint8_t
+{
+    FRAME_DATA = 0x0,
+    FRAME_HEADERS = 0x1,
+    FRAME_RST_STREAM = 0x3,
+    FRAME_SETTINGS = 0x4,
+    FRAME_PING = 0x6,
+    FRAME_GOAWAY = 0x7,
+    FRAME_WINDOW_UPDATE = 0x8
+}; // FrameType
+
+enum FrameFlag : std::uint8_t
+{
+    FLAG_ACK = 0x1,
+    FLAG_END_STREAM = 0x1,
+    FLAG_END_HEADERS = 0x4,
+    FLAG_PADDED = 0x8,
+    FLAG_PRIORITY = 0x20
+}; // FrameFlag
+
+std::uint32_t readUint32(const std::string& data, std::size_t offset)
+{
+    std::uint32_t value = 0;
+
+    for (std::size_t i = 0; i < 4; ++i)
+        value = (value << 8) | static_cast<unsigned char>(data[offset + i]);
+
+    return value;
+}
+
+std::string uint32String(std::uint32_t value)
+{
+    std::string result;
+
+    for (int shift = 24; shift >= 0; shift -= 8)
+        result.push_back(static_cast<char>((value >> shift) & 0xff));
+
+    return result;
+}
+
+std::string frame(std::uint8_t type,
+                  std::uint8_t flags,
+                  std::uint32_t stream,
+                  const std::string& payload)
+{
+    auto length = static_cast<std::uint32_t>(payload.size());
+
+    // The length is a 24-bit field.
+    auto result = uint32String(length).substr(1);
+
+    result.push_back(static_cast<char>(type));
+    result.push_back(static_cast<char>(flags));
+    result += uint32String(stream & 0x7fffffff);
+    result += payload;
+
+    return result;
+}
+
+// Strips the padding (and priority) fields from a frame's payload.
+bool framePayload(std::uint8_t flags, std::string& payload)
+{
+    std::size_t begin = 0;
+    std::size_t end = payload.size();
+
+    if (flags & FLAG_PADDED)
+    {
+        if (payload.empty())
+            return false;
+
+        std::size_t padding = static_cast<unsigned char>(payload[0]);
+
+        if (padding >= end)
+            return false;
+
+        begin = 1;
+        end -= padding;
+    }
+
+    payload = payload.substr(begin, end - begin);
+    return true;
+}
+
+// Figures out a request's method from its (HPACK-encoded) header block.
+//
+// cURL sends :method first, as an indexed field when it is GET or POST.
+std::string requestMethod(const std::string& block)
+{
+    std::size_t i = 0;
+
+    // Skip dynamic table size updates.
+    while (i < block.size() && (static_cast<unsigned char>(block[i]) & 0xe0) == 0x20)
+    {
+        if ((static_cast<unsigned char>(block[i++]) & 0x1f) != 0x1f)
+            continue;
+
+        while (i < block.size() && (static_cast<unsigned char>(block[i++]) & 0x80))
+            ;
+    }
+
+    if (i < block.size() && static_cast<unsigned char>(block[i]) == 0x82)
+        return "GET";
+
+    if (i < block.size() && static_cast<unsigned char>(block[i]) == 0x83)
+        return "POST";
+
+    return "HEAD";
+}
+
+// Encodes the header block of a response, without Huffman coding nor indexing.
+std::string responseHeaders(int status, std::size_t contentLength)
+{
+    std::string block;
+
+    auto literal = [&block](const std::string& value)
+    {
+        block.push_back(static_cast<char>(value.size()));
+        block += value;
+    };
+
+    // :status (static table entry 8 is ":status: 200")
+    if (status == 200)
+    {
+        block.push_back('\x88');
+    }
+    else
+    {
+        block.push_back('\x08');
+        literal(std::to_string(status));
+    }
+
+    // content-length (static table entry 28)
+    block.push_back('\x0f');
+    block.push_back('\x0d');
+    literal(std::to_string(contentLength));
+
+    return block;
+}
+
+} // anonymous
+
+struct StandInHttpServer::Connection
+{
+    ~Connection()
+    {
+        if (mSsl)
+            SSL_free(mSsl);
+
+        close(mSocket);
+    }
+
+    // Receive some data, returns 0 on disconnection.
+    long receive(char* buffer, std::size_t length)
+    {
+        if (mSsl)
+            return SSL_read(mSsl, buffer, static_cast<int>(length));
+
+        return recv(mSocket, buffer, length, 0);
+    }
+
+    // Whether data can be received without blocking for longer than timeout.
+    bool readable(std::chrono::milliseconds timeout)
+    {
+        if (mSsl && SSL_pending(mSsl) > 0)
+            return true;
+
+        pollfd descriptor{mSocket, POLLIN, 0};
+
+        return poll(&descriptor, 1, static_cast<int>(timeout.count())) > 0;
+    }
+
+    // Send all of data, honouring the bandwidth limits.
+    bool send(const std::string& data, std::size_t bytesPerSecond, StandInHttpServer& server)
+    {
+        static constexpr std::size_t CHUNK = 16 * 1024;
+
+        for (std::size_t sent = 0; sent < data.size();)
+        {
+            auto length = std::min(CHUNK, data.size() - sent);
+            auto begun = std::chrono::steady_clock::now();
+
+            long written = mSsl ? SSL_write(mSsl, data.data() + sent, static_cast<int>(length)) :
+                                  ::send(mSocket, data.data() + sent, length, MSG_NOSIGNAL);
+
+            if (written <= 0)
+                return false;
+
+            sent += static_cast<std::size_t>(written);
+
+            server.throughLink(static_cast<std::size_t>(written));
+
+            if (!bytesPerSecond)
+                continue;
+
+            auto budget = std::chrono::microseconds(static_cast<long long>(written) * 1000000 /
+                                                    static_cast<long long>(bytesPerSecond));
+
+            std::this_thread::sleep_until(begun + budget);
+        }
+
+        return true;
+    }
+
+    void shutdown()
+    {
+        ::shutdown(mSocket, SHUT_RDWR);
+    }
+
+    int mSocket = -1;
+    SSL* mSsl = nullptr;
+}; // Connection
+
+StandInHttpServer::StandInHttpServer(const Options& options, Handler handler):
+    mOptions(options),
+    mHandler(std::move(handler))
+{
+    if (mOptions.tls && !(mTlsContext = makeTlsContext(mOptions.http2)))
+        return;
+
+    mListener = socket(AF_INET, SOCK_STREAM, 0);
+    if (mListener < 0)
+        return;
+
+    int enable = 1;
+    setsockopt(mListener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+
+    socklen_t length = sizeof(address);
+
+    if (bind(mListener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) ||
+        listen(mListener, 128) ||
+        getsockname(mListener, reinterpret_cast<sockaddr*>(&address), &length))
+    {
+        close(mListener);
+        mListener = -1;
+        return;
+    }
+
+    mPort = ntohs(address.sin_port);
+    mAcceptor = std::thread(&StandInHttpServer::acceptLoop, this);
+}
+
+StandInHttpServer::~StandInHttpServer()
+{
+    mStopping = true;
+
+    if (mAcceptor.joinable())
+        mAcceptor.join();
+
+    std::vector<std::thread> workers;
+
+    {
+        std::lock_guard<std::mutex> guard(mWorkersLock);
+
+        // Wake up workers blocked on their connections.
+        for (auto& connection: mOpenConnections)
+            connection->shutdown();
+
+        workers.swap(mWorkers);
+    }
+
+    for (auto& worker: workers)
+        worker.join();
+
+    if (mListener >= 0)
+        close(mListener);
+}
+
+int StandInHttpServer::port() const
+{
+    return mPort;
+}
+
+std::string StandInHttpServer::url() const
+{
+    return (mOptions.tls ? "https://127.0.0.1:" : "http://127.0.0.1:") + std::to_string(mPort);
+}
+
+unsigned StandInHttpServer::connections() const
+{
+    return mConnections;
+}
+
+unsigned StandInHttpServer::resumedSessions() const
+{
+    return mResumedSessions;
+}
+
+unsigned StandInHttpServer::requests() const
+{
+    return mRequests;
+}
+
+unsigned StandInHttpServer::http2Connections() const
+{
+    return mHttp2Connections;
+}
+
+void StandInHttpServer::throughLink(std::size_t bytes)
+{
+    if (!mOptions.linkBytesPerSecond)
+        return;
+
+    std::chrono::steady_clock::time_point until;
+
+    {
+        std::lock_guard<std::mutex> guard(mLinkLock);
+
+        auto duration = std::chrono::microseconds(
+            static_cast<long long>(bytes) * 1000000 /
+            static_cast<long long>(mOptions.linkBytesPerSecond));
+
+        mLinkFree = std::max(mLinkFree, std::chrono::steady_clock::now()) + duration;
+        until = mLinkFree;
+    }
+
+    std::this_thread::sleep_until(until);
+}
+
+void StandInHttpServer::acceptLoop()
+{
+    while (!mStopping)
+    {
+        pollfd descriptor{mListener, POLLIN, 0};
+
+        if (poll(&descriptor, 1, 50) <= 0)
+            continue;
+
+        int socket = accept(mListener, nullptr, nullptr);
+        if (socket < 0)
+            continue;
+
+        int enable = 1;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        auto connection = std::make_shared<Connection>();
+        connection->mSocket = socket;
+
+        ++mConnections;
+
+        std::lock_guard<std::mutex> guard(mWorkersLock);
+
+        mOpenConnections.emplace_back(connection);
+        mWorkers.emplace_back(&StandInHttpServer::serve, this, std::move(connection));
+    }
+}
+
+void StandInHttpServer::serve(std::shared_ptr<Connection> connection)
+{
+    std::this_thread::sleep_for(mOptions.handshakeLatency);
+
+    if (mTlsContext)
+    {
+        connection->mSsl = SSL_new(static_cast<SSL_CTX*>(mTlsContext.get()));
+        SSL_set_fd(connection->mSsl, connection->mSocket);
+
+        if (SSL_accept(connection->mSsl) != 1)
+            return;
+
+        if (SSL_session_reused(connection->mSsl))
+            ++mResumedSessions;
+
+        const unsigned char* protocol = nullptr;
+        unsigned int length = 0;
+
+        SSL_get0_alpn_selected(connection->mSsl, &protocol, &length);
+
+        if (length == 2 && !std::memcmp(protocol, "h2", 2))
+        {
+            ++mHttp2Connections;
+            serveHttp2(*connection);
+            return;
+        }
+    }
+
+    serveHttp1(*connection);
+}
+
+void StandInHttpServer::serveHttp1(Connection& connection)
+{
+    std::string pending;
+    char buffer[16 * 1024];
+
+    while (!mStopping)
+    {
+        auto headerEnd = pending.find("\r\n\r\n");
+
+        if (headerEnd == std::string::npos)
+        {
+            auto received = connection.receive(buffer, sizeof(buffer));
+            if (received <= 0)
+                return;
+
+            pending.append(buffer, static_cast<std::size_t>(received));
+            continue;
+        }
+
+        Request request;
+
+        auto head = pending.substr(0, headerEnd);
+        auto firstSpace = head.find(' ');
+        auto secondSpace = head.find(' ', firstSpace + 1);
+
+        request.method = head.substr(0, firstSpace);
+        request.path = head.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+
+        std::size_t contentLength = 0;
+        bool keepAlive = true;
+
+        for (auto begin = head.find("\r\n"); begin != std::string::npos;)
+        {
+            auto end = head.find("\r\n", begin + 2);
+            auto line = head.substr(begin + 2, end == std::string::npos ? end : end - begin - 2);
+
+            std::transform(line.begin(),
+                           line.end(),
+                           line.begin(),
+                           [](unsigned char c)
+                           {
+                               return static_cast<char>(std::tolower(c));
+                           });
+
+            if (!line.compare(0, 15, "content-length:"))
+                contentLength = std::strtoul(line.c_str() + 15, nullptr, 10);
+            else if (line.find("connection: close") == 0)
+                keepAlive = false;
+
+            begin = end;
+        }
+
+        while (pending.size() < headerEnd + 4 + contentLength)
+        {
+            auto received = connection.receive(buffer, sizeof(buffer));
+            if (received <= 0)
+                return;
+
+            pending.append(buffer, static_cast<std::size_t>(received));
+        }
+
+        request.body = pending.substr(headerEnd + 4, contentLength);
+        pending.erase(0, headerEnd + 4 + contentLength);
+
+        std::this_thread::sleep_for(mOptions.latency);
+
+        auto response = mHandler ? mHandler(request) : Response{};
+
+        ++mRequests;
+
+        std::string reply = "HTTP/1.1 " + std::to_string(response.status) + " Stand-in\r\n" +
+                            "Content-Length: " + std::to_string(response.body.size()) + "\r\n" +
+                            "Content-Type: application/octet-stream\r\n" +
+                            (keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n") +
+                            "\r\n";
+
+        if (request.method != "HEAD")
+            reply += response.body;
+
+        if (!connection.send(reply, mOptions.bytesPerSecond, *this) || !keepAlive)
+            return;
+    }
+}
+
+void StandInHttpServer::serveHttp2(Connection& connection)
+{
+    static const std::string PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+    static constexpr std::int64_t DEFAULT_WINDOW = 65535;
+    static constexpr std::size_t MAX_FRAME = 16384;
+    static constexpr std::size_t FRAME_HEADER = 9;
+
+    struct Stream
+    {
+        Request request;
+        std::int64_t window = DEFAULT_WINDOW;
+        std::chrono::steady_clock::time_point due;
+        bool received = false;
+        bool responding = false;
+        std::string body;
+        std::size_t sent = 0;
+    }; // Stream
+
+    std::map<std::uint32_t, Stream> streams;
+    std::int64_t connectionWindow = DEFAULT_WINDOW;
+    std::int64_t initialWindow = DEFAULT_WINDOW;
+
+    auto receivedRequest = [this](Stream& stream)
+    {
+        stream.received = true;
+        stream.due = std::chrono::steady_clock::now() + mOptions.latency;
+    };
+
+    // Our settings are the protocol's defaults.
+    if (!connection.send(frame(FRAME_SETTINGS, 0, 0, {}), 0, *this))
+        return;
+
+    std::string pending;
+    char buffer[16 * 1024];
+    bool prefaced = false;
+
+    while (!mStopping)
+    {
+        if (!prefaced && pending.size() >= PREFACE.size())
+        {
+            if (pending.compare(0, PREFACE.size(), PREFACE))
+                return;
+
+            pending.erase(0, PREFACE.size());
+            prefaced = true;
+        }
+
+        // Process the frames received so far.
+        while (prefaced && pending.size() >= FRAME_HEADER)
+        {
+            auto length = readUint32(pending, 0) >> 8;
+
+            if (pending.size() < FRAME_HEADER + length)
+                break;
+
+            auto type = static_cast<std::uint8_t>(pending[3]);
+            auto flags = static_cast<std::uint8_t>(pending[4]);
+            auto id = readUint32(pending, 5) & 0x7fffffff;
+            auto payload = pending.substr(FRAME_HEADER, length);
+
+            pending.erase(0, FRAME_HEADER + length);
+
+            std::string reply;
+
+            switch (type)
+            {
+                case FRAME_HEADERS:
+                {
+                    if (!framePayload(flags, payload))
+                        return;
+
+                    if ((flags & FLAG_PRIORITY) && payload.size() >= 5)
+                        payload.erase(0, 5);
+
+                    // Trailers, if any, are of no interest.
+                    if (streams.count(id))
+                        break;
+
+                    auto& stream = streams[id];
+
+                    stream.request.method = requestMethod(payload);
+                    stream.window = initialWindow;
+
+                    if (flags & FLAG_END_STREAM)
+                        receivedRequest(stream);
+
+                    break;
+                }
+                case FRAME_DATA:
+                {
+                    // Give the client back the window it used up.
+                    if (length)
+                        reply += frame(FRAME_WINDOW_UPDATE, 0, 0, uint32String(length));
+
+                    if (!framePayload(flags, payload))
+                        return;
+
+                    auto i = streams.find(id);
+                    if (i == streams.end())
+                        break;
+
+                    i->second.request.body += payload;
+
+                    if (flags & FLAG_END_STREAM)
+                        receivedRequest(i->second);
+                    else if (length)
+                        reply += frame(FRAME_WINDOW_UPDATE, 0, id, uint32String(length));
+
+                    break;
+                }
+                case FRAME_RST_STREAM:
+                    streams.erase(id);
+                    break;
+                case FRAME_SETTINGS:
+                {
+                    if (flags & FLAG_ACK)
+                        break;
+
+                    for (std::size_t i = 0; i + 6 <= payload.size(); i += 6)
+                    {
+                        auto identifier = readUint32(payload, i) >> 16;
+
+                        // SETTINGS_INITIAL_WINDOW_SIZE
+                        if (identifier != 0x4)
+                            continue;
+
+                        std::int64_t window = readUint32(payload, i + 2);
+
+                        for (auto& stream: streams)
+                            stream.second.window += window - initialWindow;
+
+                        initialWindow = window;
+                    }
+
+                    reply += frame(FRAME_SETTINGS, FLAG_ACK, 0, {});
+                    break;
+                }
+                case FRAME_PING:
+                    if (!(flags & FLAG_ACK))
+                        reply += frame(FRAME_PING, FLAG_ACK, 0, payload);
+                    break;
+                case FRAME_GOAWAY:
+                    return;
+                case FRAME_WINDOW_UPDATE:
+                {
+                    if (payload.size() < 4)
+                        return;
+
+                    std::int64_t increment = readUint32(payload, 0) & 0x7fffffff;
+
+                    if (!id)
+                        connectionWindow += increment;
+                    else if (auto i = streams.find(id); i != streams.end())
+                        i->second.window += increment;
+
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            if (!reply.empty() && !connection.send(reply, 0, *this))
+                return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto timeout = std::chrono::milliseconds(50);
+
+        // Answer the requests whose latency has elapsed, as far as flow control allows.
+        for (auto i = streams.begin(); i != streams.end();)
+        {
+            auto& stream = i->second;
+
+            if (!stream.received)
+            {
+                ++i;
+                continue;
+            }
+
+            if (!stream.responding && stream.due > now)
+            {
+                auto remaining =
+                    std::chrono::ceil<std::chrono::milliseconds>(stream.due - now);
+
+                timeout = std::min(timeout, remaining);
+                ++i;
+                continue;
+            }
+
+            if (!stream.responding)
+            {
+                auto response = mHandler ? mHandler(stream.request) : Response{};
+
+                ++mRequests;
+
+                auto headersOnly = stream.request.method == "HEAD" || response.body.empty();
+                auto headers = responseHeaders(response.status, response.body.size());
+                auto flags = static_cast<std::uint8_t>(FLAG_END_HEADERS);
+
+                if (headersOnly)
+                    flags |= FLAG_END_STREAM;
+
+                if (!connection.send(frame(FRAME_HEADERS, flags, i->first, headers), 0, *this))
+                    return;
+
+                if (headersOnly)
+                {
+                    i = streams.erase(i);
+                    continue;
+                }
+
+                stream.body = std::move(response.body);
+                stream.responding = true;
+            }
+
+            while (stream.sent < stream.body.size())
+            {
+                auto window = std::max<std::int64_t>(0, std::min(connectionWindow, stream.window));
+                auto length = std::min({MAX_FRAME,
+                                        stream.body.size() - stream.sent,
+                                        static_cast<std::size_t>(window)});
+
+                if (!length)
+                    break;
+
+                auto last = stream.sent + length == stream.body.size();
+                auto data = frame(FRAME_DATA,
+                                  last ? FLAG_END_STREAM : 0,
+                                  i->first,
+                                  stream.body.substr(stream.sent, length));
+
+                if (!connection.send(data, mOptions.bytesPerSecond, *this))
+                    return;
+
+                stream.sent += length;
+                stream.window -= static_cast<std::int64_t>(length);
+                connectionWindow -= static_cast<std::int64_t>(length);
+            }
+
+            if (stream.sent == stream.body.size())
+                i = streams.erase(i);
+            else
+                ++i;
+        }
+
+        if (!connection.readable(timeout))
+            continue;
+
+        auto received = connection.receive(buffer, sizeof(buffer));
+        if (received <= 0)
+            return;
+
+        pending.append(buffer, static_cast<std::size_t>(received));
+    }
+}
+
+
+} // mt
@@ -0,0 +1,140 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mt
+{
+
+// A minimal HTTP/1.1 server listening on the loopback interface.
+//
+// It stands in for the API and storage servers in tests and benchmarks that
+// need real sockets (and optionally TLS) without reaching the network.
+//
+// Over TLS it can also speak a small subset of HTTP/2, enough for cURL
+// to multiplex requests. Header blocks aren't decoded in that mode, so
+// requests only carry their method when it is GET or POST (anything else
+// is reported, and answered, as HEAD) and their path is left empty.
+class StandInHttpServer
+{
+public:
+    struct Request
+    {
+        std::string method;
+        std::string path;
+        std::string body;
+    };
+
+    struct Response
+    {
+        int status = 200;
+        std::string body;
+    };
+
+    using Handler = std::function<Response(const Request&)>;
+
+    struct Options
+    {
+        // Serve over TLS, with a self-signed certificate generated on startup.
+        bool tls = false;
+
+        // Delay before answering each request, emulating a distant server.
+        std::chrono::milliseconds latency{0};
+
+        // Delay before accepting each new connection, emulating the cost of the
+        // TCP and TLS handshakes over a distant link.
+        std::chrono::milliseconds handshakeLatency{0};
+
+        // Upper bound on the bytes per second sent on each connection (0 = unlimited).
+        std::size_t bytesPerSecond = 0;
+
+        // Upper bound on the bytes per second sent across all connections, emulating a
+        // bottleneck they share (0 = unlimited).
+        std::size_t linkBytesPerSecond = 0;
+
+        // Offer HTTP/2 through ALPN (requires tls).
+        bool http2 = false;
+    };
+
+    StandInHttpServer(const Options& options, Handler handler);
+    ~StandInHttpServer();
+
+    // The port the server listens on, 0 if it couldn't start.
+    int port() const;
+
+    // Base URL such as https://127.0.0.1:12345
+    std::string url() const;
+
+    // Number of connections accepted so far.
+    unsigned connections() const;
+
+    // Number of TLS handshakes that resumed a previous session.
+    unsigned resumedSessions() const;
+
+    // Number of requests served so far.
+    unsigned requests() const;
+
+    // Number of connections that negotiated HTTP/2.
+    unsigned http2Connections() const;
+
+private:
+    struct Connection;
+
+    void acceptLoop();
+    void serve(std::shared_ptr<Connection> connection);
+    void serveHttp1(Connection& connection);
+    void serveHttp2(Connection& connection);
+
+    // Wait until bytes would have gone through the shared link.
+    void throughLink(std::size_t bytes);
+
+    Options mOptions;
+    Handler mHandler;
+
+    int mListener = -1;
+    int mPort = 0;
+
+    std::shared_ptr<void> mTlsContext;
+
+    std::atomic<bool> mStopping{false};
+    std::atomic<unsigned> mConnections{0};
+    std::atomic<unsigned> mResumedSessions{0};
+    std::atomic<unsigned> mRequests{0};
+    std::atomic<unsigned> mHttp2Connections{0};
+
+    std::mutex mLinkLock;
+    std::chrono::steady_clock::time_point mLinkFree;
+
+    std::mutex mWorkersLock;
+    std::vector<std::thread> mWorkers;
+    std::vector<std::shared_ptr<Connection>> mOpenConnections;
+
+    std::thread mAcceptor;
+}; // StandInHttpServer
+
+} // mt
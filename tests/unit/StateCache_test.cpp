@@ -0,0 +1,160 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega/db/sqlite.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+#include <mega/user.h>
+#include <stdfs.h>
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <thread>
+
+using namespace mega;
+
+namespace
+{
+
+// A client with a state cache, as left by fetchnodes.
+std::shared_ptr<MegaClient> makeCachingClient(MegaApp& app, const LocalPath& folder, unsigned threads)
+{
+    auto client = mt::makeClient(app, new SqliteDbAccess(folder), threads);
+
+    client->sctable.reset(client->dbaccess->open(client->rng,
+                                                 *client->fsaccess,
+                                                 "statecache",
+                                                 DB_OPEN_FLAG_TRANSACTED,
+                                                 nullptr));
+
+    handle scsn = 1;
+    client->scsn.setScsn(scsn);
+    client->sctable->put(MegaClient::CACHEDSCSN, (char*)&scsn, sizeof scsn);
+
+    return client;
+}
+
+void changeUsers(MegaClient& client, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto* user = client.finduser(static_cast<handle>(i + 1), 1);
+        user->email = "user" + std::to_string(i) + "@mega.co.nz";
+        client.notifyuser(user);
+    }
+}
+
+} // anonymous
+
+TEST(StateCache, updatescWritesRecordsEncodedInParallelInOrder)
+{
+    auto path = std::filesystem::current_path() / "state_cache";
+    const MrProper cleanUp(
+        [path]()
+        {
+            std::filesystem::remove_all(path);
+        });
+
+    std::filesystem::create_directory(path);
+    auto folder = LocalPath::fromAbsolutePath(path_u8string(path));
+
+    MegaApp app;
+    auto client = makeCachingClient(app, folder, 2);
+
+    // records for several chunks
+    changeUsers(*client, MegaClient::SC_RECORDS_PER_CHUNK * 4 + 3);
+
+    {
+        DBTableTransactionCommitter committer(client->sctable);
+        client->updatesc();
+    }
+
+    // ids are assigned as the records are written, in the order they're notified
+    uint32_t previous = 0;
+    std::map<uint32_t, std::string> expected;
+
+    for (auto* user: client->usernotify)
+    {
+        ASSERT_GT(user->dbid, previous);
+        previous = user->dbid;
+
+        std::string data;
+        ASSERT_TRUE(user->serialize(&data));
+        expected[user->dbid] = data;
+    }
+
+    // and each of them reads back as written by put()
+    std::map<uint32_t, std::string> read;
+    uint32_t id;
+    std::string data;
+
+    client->sctable->rewind();
+    while (client->sctable->next(&id, &data, &client->key))
+    {
+        if ((id & (DbTable::IDSPACING - 1)) == MegaClient::CACHEDUSER)
+            read[id] = data;
+    }
+
+    EXPECT_EQ(read, expected);
+}
+
+// Time spent by updatesc writing a large number of changed users, encoding
+// them on the SDK thread only and on worker threads.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(StateCache, DISABLED_benchmarkUpdatesc)
+{
+    static constexpr size_t COUNT = 200000;
+
+    auto path = std::filesystem::current_path() / "state_cache";
+    const MrProper cleanUp(
+        [path]()
+        {
+            std::filesystem::remove_all(path);
+        });
+
+    for (unsigned threads: {0u, std::thread::hardware_concurrency()})
+    {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directory(path);
+        auto folder = LocalPath::fromAbsolutePath(path_u8string(path));
+
+        MegaApp app;
+        auto client = makeCachingClient(app, folder, threads);
+
+        changeUsers(*client, COUNT);
+
+        auto started = std::chrono::steady_clock::now();
+
+        {
+            DBTableTransactionCommitter committer(client->sctable);
+            client->updatesc();
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - started;
+
+        std::cout << threads << " threads: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms"
+                  << std::endl;
+    }
+}
@@ -0,0 +1,237 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+#include <mega.h>
+#include <mega/megaapp.h>
+#include <mega/megaclient.h>
+#include <mega/timerqueue.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace mega;
+using namespace std::chrono_literals;
+
+TEST(TimerQueue, firesDueTimersInOrder)
+{
+    TimerQueue timers;
+    std::vector<int> fired;
+
+    timers.schedule(2ms, [&fired]() { fired.push_back(2); });
+    timers.schedule(0ms, [&fired]() { fired.push_back(0); });
+    timers.schedule(1ms, [&fired]() { fired.push_back(1); });
+    timers.schedule(1h, [&fired]() { fired.push_back(3); });
+
+    // Nothing is due yet a millisecond ago
+    EXPECT_EQ(timers.fire(TimerQueue::Clock::now() - 1ms), 0u);
+
+    EXPECT_EQ(timers.fire(TimerQueue::Clock::now() + 10ms), 3u);
+    EXPECT_EQ(fired, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(timers.size(), 1u);
+}
+
+TEST(TimerQueue, cancelledTimersDontFire)
+{
+    TimerQueue timers;
+    bool fired = false;
+
+    auto id = timers.schedule(0ms, [&fired]() { fired = true; });
+    auto later = timers.schedule(1h, []() {});
+
+    EXPECT_TRUE(timers.cancel(id));
+    EXPECT_FALSE(timers.cancel(id));
+
+    // The next deadline skips the cancelled timer
+    auto next = timers.timeUntilNext();
+    ASSERT_TRUE(next);
+    EXPECT_GT(*next, 59min);
+
+    EXPECT_EQ(timers.fire(TimerQueue::Clock::now() + 1ms), 0u);
+    EXPECT_FALSE(fired);
+
+    EXPECT_TRUE(timers.cancel(later));
+    EXPECT_TRUE(timers.empty());
+    EXPECT_FALSE(timers.timeUntilNext());
+}
+
+TEST(TimerQueue, callbacksCanScheduleMore)
+{
+    TimerQueue timers;
+    int count = 0;
+
+    std::function<void()> again = [&]()
+    {
+        if (++count < 3)
+            timers.schedule(0ms, again);
+    };
+
+    timers.schedule(0ms, again);
+
+    // What a callback schedules waits for the next pass, so fire() always returns
+    for (int pass = 1; pass <= 3; ++pass)
+    {
+        EXPECT_EQ(timers.fire(TimerQueue::Clock::now() + 1ms), 1u);
+        EXPECT_EQ(count, pass);
+    }
+
+    EXPECT_TRUE(timers.empty());
+}
+
+TEST(TimerQueue, waiterCeilingHasMillisecondResolution)
+{
+    WAIT_CLASS waiter;
+
+    waiter.init(NEVER);
+    EXPECT_EQ(waiter.timeoutms(), -1);
+
+    waiter.init(3);
+    EXPECT_EQ(waiter.timeoutms(), 300);
+
+    // Only ever lowered
+    waiter.wakeupwithin(20ms);
+    waiter.wakeupwithin(50ms);
+    EXPECT_EQ(waiter.timeoutms(), 20);
+
+    // A new cycle starts without it
+    waiter.init(NEVER);
+    EXPECT_EQ(waiter.timeoutms(), -1);
+
+    waiter.wakeupwithin(5ms);
+
+    auto started = std::chrono::steady_clock::now();
+    EXPECT_TRUE(waiter.wait() & Waiter::NEEDEXEC);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    EXPECT_GE(elapsed, 4ms);
+    EXPECT_LT(elapsed, 100ms);
+}
+
+// How late short timers fire when the waiter sleeps until them, compared with
+// rounding the wait up to a whole decisecond as the loop used to.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(TimerQueue, DISABLED_latencyBenchmark)
+{
+    static constexpr int ROUNDS = 200;
+    static const std::vector<TimerQueue::Clock::duration> DELAYS = {1ms, 5ms, 20ms};
+
+    WAIT_CLASS waiter;
+    TimerQueue timers;
+
+    for (bool decisecond: {false, true})
+    {
+        for (auto delay: DELAYS)
+        {
+            std::vector<TimerQueue::Clock::duration> lateness;
+
+            for (int i = 0; i < ROUNDS; ++i)
+            {
+                auto due = TimerQueue::Clock::now() + delay;
+                bool fired = false;
+
+                timers.schedule(delay,
+                                [&]()
+                                {
+                                    lateness.push_back(TimerQueue::Clock::now() - due);
+                                    fired = true;
+                                });
+
+                while (!fired)
+                {
+                    auto next = std::chrono::ceil<std::chrono::milliseconds>(
+                        timers.timeUntilNext().value_or(TimerQueue::Clock::duration::zero()));
+
+                    if (decisecond)
+                    {
+                        waiter.init((next.count() + 99) / 100);
+                    }
+                    else
+                    {
+                        waiter.init(NEVER);
+                        waiter.wakeupwithin(next);
+                    }
+
+                    waiter.wait();
+                    timers.fire();
+                }
+            }
+
+            std::sort(lateness.begin(), lateness.end());
+
+            auto us = [](TimerQueue::Clock::duration d)
+            {
+                return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+            };
+
+            std::cout << (decisecond ? "decisecond" : "millisecond") << " ceiling, "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(delay).count()
+                      << "ms timers: median " << us(lateness[lateness.size() / 2])
+                      << "us late, p99 " << us(lateness[lateness.size() * 99 / 100])
+                      << "us late" << std::endl;
+        }
+    }
+}
+
+// Wakeups and CPU used by an idle client's event loop.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(TimerQueue, DISABLED_idleBenchmark)
+{
+    static constexpr auto DURATION = 5s;
+
+    MegaApp app;
+    auto client = mt::makeClient(app);
+
+    std::atomic<bool> stop{false};
+    unsigned wakeups = 0;
+
+    auto cpuStarted = std::clock();
+
+    std::thread loop(
+        [&]()
+        {
+            while (!stop)
+            {
+                if (client->wait() & Waiter::NEEDEXEC)
+                {
+                    ++wakeups;
+                    client->exec();
+                }
+            }
+        });
+
+    std::this_thread::sleep_for(DURATION);
+
+    stop = true;
+    client->waiter->notify();
+    loop.join();
+
+    auto cpuMs = static_cast<double>(std::clock() - cpuStarted) * 1000.0 / CLOCKS_PER_SEC;
+
+    std::cout << "idle for "
+              << std::chrono::duration_cast<std::chrono::seconds>(DURATION).count() << "s: "
+              << wakeups << " wakeups, " << cpuMs << "ms of CPU" << std::endl;
+}
@@ -0,0 +1,169 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+#include <mega/types.h>
+
+#include <chrono>
+#include <iostream>
+#include <regex>
+#include <set>
+#include <thread>
+
+using namespace mega;
+
+namespace
+{
+
+size_t count(const std::string& haystack, const std::string& needle)
+{
+    size_t n = 0;
+
+    for (auto i = haystack.find(needle); i != std::string::npos; i = haystack.find(needle, i + 1))
+        ++n;
+
+    return n;
+}
+
+} // anonymous
+
+TEST(Trace, recordsNothingUnlessStarted)
+{
+    trace::start();
+    trace::stop();
+
+    CodeCounter::ScopeStats stats("trace_test_untraced");
+    {
+        CodeCounter::ScopeTimer timer(stats);
+    }
+
+    EXPECT_EQ(count(trace::chromeJson(), "trace_test_untraced"), 0u);
+}
+
+TEST(Trace, recordsScopeTimersOnEachThread)
+{
+    CodeCounter::ScopeStats outer("trace_test_outer");
+    CodeCounter::ScopeStats inner("trace_test_inner \"quoted\"");
+
+    trace::start();
+
+    auto work = [&]()
+    {
+        CodeCounter::ScopeTimer timer(outer);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            CodeCounter::ScopeTimer innerTimer(inner);
+        }
+    };
+
+    std::thread worker(
+        [&]()
+        {
+            trace::setThreadName("trace test worker");
+            work();
+        });
+
+    work();
+    worker.join();
+
+    trace::stop();
+
+    auto json = trace::chromeJson();
+
+    EXPECT_EQ(count(json, "\"name\":\"trace_test_outer\""), 2u);
+    EXPECT_EQ(count(json, "\"name\":\"trace_test_inner \\\"quoted\\\"\""), 6u);
+    EXPECT_EQ(count(json, "\"args\":{\"name\":\"trace test worker\"}"), 1u);
+
+    // Spans on the two threads are told apart.
+    std::regex span("\\{\"ph\":\"X\",\"pid\":1,\"tid\":(\\d+),\"name\":\"trace_test_outer\","
+                    "\"ts\":\\d+\\.\\d{3},\"dur\":\\d+\\.\\d{3}\\}");
+    std::set<std::string> tids;
+
+    for (std::sregex_iterator i(json.begin(), json.end(), span), end; i != end; ++i)
+        tids.emplace((*i)[1]);
+
+    EXPECT_EQ(tids.size(), 2u);
+
+    // Restarting discards the previous trace.
+    trace::start();
+    trace::stop();
+
+    EXPECT_EQ(count(trace::chromeJson(), "trace_test_outer"), 0u);
+}
+
+TEST(Trace, spanCompletedEarlyIsRecordedOnce)
+{
+    trace::start();
+
+    {
+        trace::Span span(trace::intern("trace_test_early"));
+        span.complete();
+    }
+
+    trace::stop();
+
+    EXPECT_EQ(count(trace::chromeJson(), "\"name\":\"trace_test_early\""), 1u);
+}
+
+TEST(Trace, internReturnsTheSameName)
+{
+    auto* name = trace::intern("trace_test_interned");
+
+    EXPECT_STREQ(name, "trace_test_interned");
+    EXPECT_EQ(name, trace::intern(std::string("trace_test_") + "interned"));
+}
+
+// Time taken by a million scope timers, with tracing off and on.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(Trace, DISABLED_benchmark)
+{
+    static constexpr int COUNT = 1000000;
+
+    CodeCounter::ScopeStats stats("trace_test_benchmark");
+
+    auto time = [&]()
+    {
+        auto started = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < COUNT; ++i)
+        {
+            CodeCounter::ScopeTimer timer(stats);
+        }
+
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - started)
+            .count();
+    };
+
+    std::cout << "not tracing: " << time() << "us" << std::endl;
+
+    trace::start();
+    std::cout << "tracing: " << time() << "us" << std::endl;
+    trace::stop();
+
+    auto started = std::chrono::steady_clock::now();
+    auto json = trace::chromeJson();
+
+    std::cout << "exported " << json.size() << " bytes in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - started)
+                     .count()
+              << "ms" << std::endl;
+}
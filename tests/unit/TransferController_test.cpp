@@ -0,0 +1,373 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+#include <mega/transfercontroller.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+using namespace mega;
+using namespace std::chrono_literals;
+
+using Controller = AdaptiveTransferController;
+using Clock = Controller::Clock;
+
+namespace
+{
+
+constexpr m_off_t MB = 1024 * 1024;
+
+Controller::Limits limits(unsigned maxConnections)
+{
+    Controller::Limits limits;
+
+    limits.maxConnections = maxConnections;
+    limits.minRequestSize = MB;
+    limits.maxRequestSize = 16 * MB;
+
+    return limits;
+}
+
+// A simulated path to a storage server.
+struct Link
+{
+    // Bytes per second shared by all connections.
+    m_off_t bandwidth = 0;
+
+    // Bytes per second a single connection can reach.
+    m_off_t perConnection = 0;
+
+    // Time to the first byte of each response.
+    std::chrono::milliseconds firstByte{0};
+};
+
+// Transfers size bytes over link in virtual time, with the connections and
+// request sizes decided by controller (or fixed ones if no controller is given).
+//
+// Connections that are receiving data share the link evenly, each limited to
+// the rate a single connection can reach.
+std::chrono::milliseconds simulate(Controller* controller,
+                                   const Link& link,
+                                   m_off_t size,
+                                   unsigned connections = 1,
+                                   m_off_t requestSize = MB)
+{
+    struct Request
+    {
+        m_off_t size = 0;
+        m_off_t remaining = 0;
+        Clock::time_point firstByte;
+    };
+
+    auto started = Clock::time_point{};
+    auto now = started;
+
+    std::vector<std::optional<Request>> requests(controller ? 64 : connections);
+
+    for (auto remaining = size;;)
+    {
+        auto wanted = controller ? controller->connections() : connections;
+        auto length = controller && controller->requestSize() ? controller->requestSize() :
+                                                                 requestSize;
+
+        for (unsigned i = 0; i < wanted && remaining > 0; ++i)
+        {
+            if (requests[i])
+                continue;
+
+            auto bytes = std::min(length, remaining);
+
+            requests[i] = Request{bytes, bytes, now + link.firstByte};
+            remaining -= bytes;
+
+            if (controller)
+                controller->requestStarted(i, now);
+        }
+
+        m_off_t receiving = 0;
+
+        for (const auto& request: requests)
+            receiving += request && request->firstByte <= now;
+
+        auto share = std::min(link.perConnection, link.bandwidth / std::max<m_off_t>(receiving, 1));
+
+        // Advance to the next first byte or completion.
+        std::optional<Clock::time_point> next;
+
+        for (const auto& request: requests)
+        {
+            if (!request)
+                continue;
+
+            auto when = request->firstByte;
+
+            if (when <= now)
+                when = now + std::chrono::milliseconds(
+                                 (request->remaining * 1000 + share - 1) / share);
+
+            next = std::min(next.value_or(when), when);
+        }
+
+        if (!next)
+            break;
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(*next - now);
+
+        for (unsigned i = 0; i < requests.size(); ++i)
+        {
+            auto& request = requests[i];
+
+            if (!request || request->firstByte > now)
+                continue;
+
+            request->remaining -= std::min(request->remaining, share * elapsed.count() / 1000);
+
+            if (request->remaining)
+                continue;
+
+            if (controller)
+                controller->requestCompleted(i, request->size, link.firstByte, *next);
+
+            request.reset();
+        }
+
+        now = *next;
+    }
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now - started);
+}
+
+// Completes requests until the current round ends.
+void finishRound(Controller& controller, Clock::time_point& now)
+{
+    for (auto rounds = controller.rounds(); controller.rounds() == rounds;)
+    {
+        now += 1s;
+
+        controller.requestStarted(0, now);
+        controller.requestCompleted(0, controller.requestSize(), 50ms, now + 1s);
+    }
+
+    now += 1s;
+}
+
+} // anonymous
+
+TEST(AdaptiveTransferController, startsWithTwoConnections)
+{
+    Controller controller(limits(8), Clock::now());
+
+    EXPECT_EQ(controller.connections(), 2u);
+    EXPECT_EQ(controller.requestSize(), 0);
+    EXPECT_EQ(controller.phase(), Controller::STARTUP);
+
+    Controller single(limits(1), Clock::now());
+
+    EXPECT_EQ(single.connections(), 1u);
+}
+
+TEST(AdaptiveTransferController, growsWhileThroughputGrows)
+{
+    // Each connection is limited to 1 MB/s, the link allows 8.
+    Link link{8 * MB, MB, 50ms};
+
+    Controller controller(limits(32), Clock::time_point{});
+
+    simulate(&controller, link, 1024 * MB);
+
+    EXPECT_EQ(controller.phase(), Controller::STEADY);
+    EXPECT_GE(controller.connections(), 8u);
+    EXPECT_LE(controller.connections(), 9u);
+    EXPECT_NEAR(static_cast<double>(controller.bandwidth()), 8.0 * MB, 1.0 * MB);
+}
+
+TEST(AdaptiveTransferController, holdsBackWhenTheLinkIsShared)
+{
+    // A single connection can fill the link.
+    Link link{4 * MB, 4 * MB, 20ms};
+
+    Controller controller(limits(16), Clock::time_point{});
+
+    simulate(&controller, link, 256 * MB);
+
+    EXPECT_EQ(controller.phase(), Controller::STEADY);
+    EXPECT_LE(controller.connections(), 3u);
+}
+
+TEST(AdaptiveTransferController, neverExceedsTheLimits)
+{
+    Link link{64 * MB, MB, 10ms};
+
+    Controller controller(limits(4), Clock::time_point{});
+
+    simulate(&controller, link, 256 * MB);
+
+    EXPECT_EQ(controller.connections(), 4u);
+    EXPECT_GE(controller.requestSize(), MB);
+    EXPECT_LE(controller.requestSize(), 16 * MB);
+}
+
+TEST(AdaptiveTransferController, sizesRequestsByThroughputPerConnection)
+{
+    Link link{8 * MB, 2 * MB, 50ms};
+
+    Controller controller(limits(16), Clock::time_point{});
+
+    simulate(&controller, link, 512 * MB);
+
+    // About two seconds' worth of data at the rate of each connection.
+    auto expected = controller.bandwidth() / controller.connections() * 2;
+
+    EXPECT_NEAR(static_cast<double>(controller.requestSize()),
+                static_cast<double>(expected),
+                static_cast<double>(MB));
+}
+
+TEST(AdaptiveTransferController, requestsLastSeveralTimesTheFirstByte)
+{
+    // With a slow first byte, short requests would waste most of their time waiting.
+    Link link{2 * MB, 2 * MB, 500ms};
+
+    Controller controller(limits(1), Clock::time_point{});
+
+    simulate(&controller, link, 256 * MB);
+
+    // Eight times the first byte rather than the usual two seconds.
+    EXPECT_EQ(controller.minFirstByte(), 500ms);
+    EXPECT_NEAR(static_cast<double>(controller.requestSize()),
+                static_cast<double>(controller.bandwidth() * 4),
+                static_cast<double>(MB / 4));
+}
+
+TEST(AdaptiveTransferController, backsOffWhenRequestsFail)
+{
+    Link link{8 * MB, MB, 50ms};
+
+    Controller controller(limits(32), Clock::time_point{});
+
+    simulate(&controller, link, 1024 * MB);
+
+    auto now = Clock::time_point{} + 1h;
+
+    finishRound(controller, now);
+
+    auto connections = controller.connections();
+    auto requestSize = controller.requestSize();
+
+    ASSERT_EQ(controller.phase(), Controller::STEADY);
+
+    // A whole round of failures.
+    for (unsigned i = 0; i < connections; ++i)
+        controller.requestStarted(i, now);
+
+    for (unsigned i = 0; i < connections; ++i)
+        controller.requestFailed(i, now + 1s);
+
+    EXPECT_EQ(controller.connections(), connections - 1);
+    EXPECT_LT(controller.requestSize(), requestSize);
+}
+
+TEST(AdaptiveTransferController, backsOffWhenTheFirstByteInflates)
+{
+    Link link{8 * MB, MB, 50ms};
+
+    Controller controller(limits(32), Clock::time_point{});
+
+    simulate(&controller, link, 1024 * MB);
+
+    auto now = Clock::time_point{} + 1h;
+
+    finishRound(controller, now);
+
+    auto connections = controller.connections();
+
+    for (unsigned i = 0; i < connections; ++i)
+        controller.requestStarted(i, now);
+
+    for (unsigned i = 0; i < connections; ++i)
+        controller.requestCompleted(i, controller.requestSize(), 400ms, now + 2s);
+
+    EXPECT_EQ(controller.connections(), connections - 1);
+}
+
+TEST(AdaptiveTransferController, ignoresRequestsItDidntSeeStart)
+{
+    Controller controller(limits(8), Clock::time_point{});
+
+    controller.requestCompleted(0, MB, 10ms, Clock::time_point{} + 1s);
+    controller.requestFailed(1, Clock::time_point{} + 1s);
+    controller.requestCompleted(100, MB, 10ms, Clock::time_point{} + 1s);
+
+    EXPECT_EQ(controller.rounds(), 0u);
+    EXPECT_EQ(controller.bandwidth(), 0);
+    EXPECT_FALSE(controller.minFirstByte());
+
+    // Completions are only accounted once.
+    controller.requestStarted(0, Clock::time_point{});
+    controller.requestCompleted(0, MB, 10ms, Clock::time_point{} + 1s);
+    controller.requestCompleted(0, MB, 10ms, Clock::time_point{} + 2s);
+
+    EXPECT_EQ(controller.rounds(), 0u);
+}
+
+// Compares how long simulated transfers take with fixed connections and
+// request sizes, and with the adaptive controller, over a few kinds of links.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(AdaptiveTransferController, DISABLED_benchmarkSimulatedLinks)
+{
+    static constexpr m_off_t SIZE = 512 * MB;
+
+    struct Scenario
+    {
+        const char* name;
+        Link link;
+    };
+
+    const Scenario scenarios[] = {
+        {"per-connection throttling", {32 * MB, 2 * MB, 50ms}},
+        {"shared bottleneck", {8 * MB, 8 * MB, 50ms}},
+        {"distant server", {16 * MB, 4 * MB, 300ms}},
+        {"slow link", {MB / 2, MB / 2, 100ms}},
+    };
+
+    for (const auto& scenario: scenarios)
+    {
+        std::cout << scenario.name << std::endl;
+
+        for (unsigned connections: {1u, 4u, 8u})
+        {
+            auto elapsed = simulate(nullptr, scenario.link, SIZE, connections, 8 * MB);
+
+            std::cout << "  fixed " << connections << " x 8 MB: " << elapsed.count() << "ms"
+                      << std::endl;
+        }
+
+        Controller controller(limits(8), Clock::time_point{});
+
+        auto elapsed = simulate(&controller, scenario.link, SIZE);
+
+        std::cout << "  adaptive:      " << elapsed.count()
+                  << "ms (connections: " << controller.connections()
+                  << ", request size: " << controller.requestSize() / 1024 << " KB)" << std::endl;
+    }
+}
@@ -0,0 +1,465 @@
+/**
+ * (c) 2026 by Mega Limited, New Zealand
+ *
+ * This file is part of the MEGA SDK - Client Access Engine.
+ *
+ * Applications using the MEGA API must present a valid application key
+ * and comply with the the rules set forth in the Terms of Service.
+ *
+ * The MEGA SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * @copyright Simplified (2-clause) BSD License.
+ *
+ * You should have received a copy of the license along with this
+ * program.
+ */
+
+#include <gtest/gtest.h>
+#include <mega/transferscheduler.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace mega;
+
+using Job = TransferScheduler::Job;
+
+namespace
+{
+
+constexpr m_off_t KB = 1024;
+constexpr m_off_t MB = 1024 * KB;
+constexpr unsigned MAX_SLOTS = 48;
+
+Job job(m_off_t size, TransferScheduler::Flow flow = TransferScheduler::FLOW_APP)
+{
+    return Job{flow, size, size};
+}
+
+std::vector<m_off_t> sizes(const std::vector<Job>& jobs, const std::vector<size_t>& order)
+{
+    std::vector<m_off_t> sizes;
+
+    for (auto i: order)
+        sizes.emplace_back(jobs[i].size);
+
+    return sizes;
+}
+
+// Where transfers of a simulated mix go.
+struct Link
+{
+    // Bytes per second shared by all transfers.
+    double bandwidth = 0;
+
+    // Bytes per second a single transfer can reach.
+    double perSlot = 0;
+
+    // Seconds each transfer spends before moving data (URLs, opening files, putnodes...).
+    double setup = 0;
+};
+
+struct Report
+{
+    double seconds = 0;
+    double throughput = 0;
+    double medianCompletion = 0;
+    double tailCompletion = 0;
+    unsigned slotLimit = 0;
+};
+
+// Replays a mix of transfers, all queued at once in the given order, through
+// the scheduler in virtual time, as MegaClient::dispatchTransfers would.
+Report simulate(TransferScheduler& scheduler, const std::vector<Job>& mix, const Link& link)
+{
+    // Time step, one decisecond.
+    static constexpr double STEP = 0.1;
+
+    struct Active
+    {
+        size_t index;
+        double setupLeft;
+        double remaining;
+    };
+
+    std::vector<size_t> pending(mix.size());
+    std::vector<Active> active;
+    std::vector<double> completions;
+
+    for (size_t i = 0; i < mix.size(); ++i)
+        pending[i] = i;
+
+    double total = 0;
+    double speed = 0;
+    dstime ds = 0;
+
+    for (auto& job: mix)
+        total += static_cast<double>(job.size);
+
+    while (!pending.empty() || !active.empty())
+    {
+        scheduler.sample(static_cast<unsigned>(active.size()), static_cast<m_off_t>(speed), ds);
+
+        if (active.size() < scheduler.slotLimit() && !pending.empty())
+        {
+            // Only the head of the queue is a candidate, as with TransferList::nexttransfers.
+            auto window = std::min(TransferScheduler::CANDIDATE_WINDOW, pending.size());
+
+            std::vector<Job> candidates;
+
+            for (size_t i = 0; i < window; ++i)
+                candidates.emplace_back(mix[pending[i]]);
+
+            std::vector<size_t> chosen;
+
+            for (auto i: scheduler.order(candidates))
+            {
+                if (active.size() >= scheduler.slotLimit())
+                    break;
+
+                scheduler.started(candidates[i]);
+                active.push_back(
+                    Active{pending[i], link.setup, static_cast<double>(candidates[i].size)});
+                chosen.emplace_back(i);
+            }
+
+            std::sort(chosen.rbegin(), chosen.rend());
+
+            for (auto i: chosen)
+                pending.erase(pending.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+
+        auto moving = std::count_if(active.begin(),
+                                    active.end(),
+                                    [](const Active& transfer)
+                                    {
+                                        return transfer.setupLeft <= 0;
+                                    });
+
+        auto share = moving ? std::min(link.perSlot, link.bandwidth / static_cast<double>(moving)) :
+                              0.0;
+        double delivered = 0;
+
+        ++ds;
+
+        for (auto& transfer: active)
+        {
+            if (transfer.setupLeft > 0)
+            {
+                transfer.setupLeft -= STEP;
+                continue;
+            }
+
+            auto bytes = std::min(transfer.remaining, share * STEP);
+
+            transfer.remaining -= bytes;
+            delivered += bytes;
+        }
+
+        auto finished = std::partition(active.begin(),
+                                       active.end(),
+                                       [](const Active& transfer)
+                                       {
+                                           return transfer.setupLeft > 0 || transfer.remaining > 0;
+                                       });
+
+        for (auto i = finished; i != active.end(); ++i)
+            completions.emplace_back(static_cast<double>(ds) * STEP);
+
+        active.erase(finished, active.end());
+
+        // Smoothed over a couple of seconds, as HttpIO's transfer speeds are.
+        speed += (delivered / STEP - speed) / 20;
+    }
+
+    std::sort(completions.begin(), completions.end());
+
+    Report report;
+
+    report.seconds = static_cast<double>(ds) * STEP;
+    report.throughput = total / report.seconds;
+    report.medianCompletion = completions[completions.size() / 2];
+    report.tailCompletion = completions[completions.size() * 99 / 100];
+    report.slotLimit = scheduler.slotLimit();
+
+    return report;
+}
+
+// A couple of large downloads queued ahead of many small files from a sync.
+std::vector<Job> mixedWorkload()
+{
+    std::vector<Job> mix;
+
+    for (int i = 0; i < 4; ++i)
+        mix.emplace_back(job(1024 * MB));
+
+    for (int i = 0; i < 2000; ++i)
+        mix.emplace_back(job((i % 7 + 1) * 64 * KB, TransferScheduler::FLOW_SYNC));
+
+    return mix;
+}
+
+} // anonymous
+
+TEST(TransferScheduler, priorityPolicyKeepsQueueOrder)
+{
+    TransferScheduler scheduler(MAX_SLOTS);
+
+    std::vector<Job> jobs = {job(30), job(10), job(20, TransferScheduler::FLOW_SYNC), job(5)};
+
+    EXPECT_EQ(scheduler.order(jobs), (std::vector<size_t>{0, 1, 2, 3}));
+    EXPECT_FALSE(scheduler.smallFilesFirst());
+}
+
+TEST(TransferScheduler, smallestFirst)
+{
+    TransferScheduler scheduler(MAX_SLOTS);
+    scheduler.setPolicy(TransferScheduler::POLICY_SMALLEST_FIRST);
+
+    std::vector<Job> jobs = {job(30), job(10), job(20, TransferScheduler::FLOW_SYNC), job(10)};
+
+    // Ties keep their queue order.
+    EXPECT_EQ(scheduler.order(jobs), (std::vector<size_t>{1, 3, 2, 0}));
+    EXPECT_TRUE(scheduler.smallFilesFirst());
+}
+
+TEST(TransferScheduler, shortestRemainingCountsProgress)
+{
+    TransferScheduler scheduler(MAX_SLOTS);
+    scheduler.setPolicy(TransferScheduler::POLICY_SHORTEST_REMAINING);
+
+    std::vector<Job> jobs = {Job{TransferScheduler::FLOW_APP, 100 * MB, 1 * MB}, job(10 * MB)};
+
+    EXPECT_EQ(scheduler.order(jobs), (std::vector<size_t>{0, 1}));
+}
+
+TEST(TransferScheduler, flowsShareByWeight)
+{
+    TransferScheduler scheduler(MAX_SLOTS);
+    scheduler.setWeight(TransferScheduler::FLOW_APP, 1);
+    scheduler.setWeight(TransferScheduler::FLOW_SYNC, 3);
+
+    std::vector<Job> jobs;
+
+    for (int i = 0; i < 8; ++i)
+        jobs.emplace_back(job(MB));
+
+    for (int i = 0; i < 8; ++i)
+        jobs.emplace_back(job(MB, TransferScheduler::FLOW_SYNC));
+
+    auto order = scheduler.order(jobs);
+    auto syncs = std::count_if(order.begin(),
+                               order.begin() + 8,
+                               [&jobs](size_t i)
+                               {
+                                   return jobs[i].flow == TransferScheduler::FLOW_SYNC;
+                               });
+
+    EXPECT_EQ(syncs, 6);
+}
+
+TEST(TransferScheduler, flowsShareBytesRatherThanTransfers)
+{
+    TransferScheduler scheduler(MAX_SLOTS);
+    scheduler.setWeight(TransferScheduler::FLOW_APP, 1);
+    scheduler.setWeight(TransferScheduler::FLOW_SYNC, 1);
+
+    // One large app transfer is worth many small sync transfers.
+    std::vector<Job> jobs = {job(64 * MB)};
+
+    for (int i = 0; i < 40; ++i)
+        jobs.emplace_back(job(MB, TransferScheduler::FLOW_SYNC));
+
+    jobs.emplace_back(job(MB));
+
+    auto order = scheduler.order(jobs);
+
+    EXPECT_EQ(order.front(), 0u);
+    EXPECT_EQ(sizes(jobs, {order.begin() + 1, order.begin() + 41}),
+              std::vector<m_off_t>(40, MB));
+}
+
+TEST(TransferScheduler, startedTransfersAreCharged)
+{
+    TransferScheduler scheduler(MAX_SLOTS);
+    scheduler.setWeight(TransferScheduler::FLOW_APP, 1);
+    scheduler.setWeight(TransferScheduler::FLOW_SYNC, 1);
+
+    for (int i = 0; i < 4; ++i)
+        scheduler.started(job(MB));
+
+    std::vector<Job> jobs = {job(MB), job(MB), job(MB, TransferScheduler::FLOW_SYNC)};
+
+    EXPECT_EQ(scheduler.order(jobs).front(), 2u);
+}
+
+TEST(TransferScheduler, clearingWeightsRestoresQueueOrder)
+{
+    TransferScheduler scheduler(MAX_SLOTS);
+    scheduler.setWeight(TransferScheduler::FLOW_APP, 1);
+    scheduler.setWeight(TransferScheduler::FLOW_SYNC, 1);
+
+    for (int i = 0; i < 4; ++i)
+        scheduler.started(job(MB));
+
+    std::vector<Job> jobs = {job(MB), job(MB), job(MB, TransferScheduler::FLOW_SYNC)};
+
+    ASSERT_TRUE(scheduler.reordersQueue());
+
+    scheduler.clearWeights();
+
+    EXPECT_FALSE(scheduler.reordersQueue());
+    EXPECT_EQ(scheduler.weight(TransferScheduler::FLOW_SYNC), 1u);
+    EXPECT_EQ(scheduler.order(jobs), (std::vector<size_t>{0, 1, 2}));
+}
+
+TEST(TransferScheduler, fixedSlotsByDefault)
+{
+    TransferScheduler scheduler(MAX_SLOTS);
+
+    scheduler.sample(MAX_SLOTS, 10 * MB, 0);
+    scheduler.sample(MAX_SLOTS, 1 * MB, 100);
+
+    EXPECT_EQ(scheduler.slotLimit(), MAX_SLOTS);
+}
+
+TEST(TransferScheduler, adaptiveSlotsGrowWhileThroughputGrows)
+{
+    TransferScheduler scheduler(MAX_SLOTS);
+    scheduler.setAdaptiveSlots(true);
+
+    auto limit = scheduler.slotLimit();
+    dstime now = 0;
+
+    EXPECT_EQ(limit, TransferScheduler::INITIAL_SLOTS);
+
+    // Nothing is learnt while the slots aren't all in use.
+    scheduler.sample(limit - 1, 10 * MB, now);
+    EXPECT_EQ(scheduler.slotLimit(), limit);
+
+    // A probe that pays off is kept...
+    now += TransferScheduler::SAMPLE_INTERVAL;
+    scheduler.sample(limit, 10 * MB, now);
+    EXPECT_EQ(scheduler.slotLimit(), limit + TransferScheduler::SLOT_STEP);
+
+    now += TransferScheduler::SAMPLE_INTERVAL;
+    scheduler.sample(limit + TransferScheduler::SLOT_STEP, 15 * MB, now);
+    EXPECT_EQ(scheduler.slotLimit(), limit + TransferScheduler::SLOT_STEP);
+
+    // ...one that doesn't is reverted...
+    limit = scheduler.slotLimit();
+    now += TransferScheduler::SAMPLE_INTERVAL;
+    scheduler.sample(limit, 15 * MB, now);
+    EXPECT_EQ(scheduler.slotLimit(), limit + TransferScheduler::SLOT_STEP);
+
+    now += TransferScheduler::SAMPLE_INTERVAL;
+    scheduler.sample(limit + TransferScheduler::SLOT_STEP, 15 * MB, now);
+    EXPECT_EQ(scheduler.slotLimit(), limit);
+
+    // ...and not tried again for a while.
+    for (unsigned i = 0; i < TransferScheduler::PROBE_HOLDOFF; ++i)
+    {
+        now += TransferScheduler::SAMPLE_INTERVAL;
+        scheduler.sample(limit, 15 * MB, now);
+        EXPECT_EQ(scheduler.slotLimit(), limit);
+    }
+
+    now += TransferScheduler::SAMPLE_INTERVAL;
+    scheduler.sample(limit, 15 * MB, now);
+    EXPECT_EQ(scheduler.slotLimit(), limit + TransferScheduler::SLOT_STEP);
+}
+
+TEST(TransferScheduler, adaptiveSlotsNeverExceedTheMaximum)
+{
+    TransferScheduler scheduler(MAX_SLOTS);
+    scheduler.setAdaptiveSlots(true);
+
+    m_off_t speed = MB;
+
+    for (dstime now = 0; now < 100 * TransferScheduler::SAMPLE_INTERVAL;
+         now += TransferScheduler::SAMPLE_INTERVAL)
+    {
+        scheduler.sample(scheduler.slotLimit(), speed, now);
+        speed *= 2;
+    }
+
+    EXPECT_EQ(scheduler.slotLimit(), MAX_SLOTS);
+
+    scheduler.setAdaptiveSlots(false);
+    EXPECT_EQ(scheduler.slotLimit(), MAX_SLOTS);
+}
+
+TEST(TransferScheduler, smallFilesFirstShortenCompletionOfMixedWorkloads)
+{
+    Link link{50.0 * MB, 8.0 * MB, 0.5};
+
+    TransferScheduler priority(16);
+    TransferScheduler smallest(16);
+    smallest.setPolicy(TransferScheduler::POLICY_SMALLEST_FIRST);
+
+    auto byPriority = simulate(priority, mixedWorkload(), link);
+    auto bySize = simulate(smallest, mixedWorkload(), link);
+
+    // The large files finish last either way, but the small ones no longer wait behind them.
+    EXPECT_LT(bySize.medianCompletion, byPriority.medianCompletion);
+    EXPECT_LT(bySize.tailCompletion, byPriority.tailCompletion);
+}
+
+// Replays a mix of large and small transfers with different scheduler
+// settings, and reports aggregate throughput and completion times.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(TransferScheduler, DISABLED_simulateTransferMix)
+{
+    struct Setting
+    {
+        const char* name;
+        TransferScheduler::Policy policy;
+        bool adaptiveSlots;
+        unsigned syncWeight;
+    };
+
+    const Setting settings[] = {
+        {"priority", TransferScheduler::POLICY_PRIORITY, false, 0},
+        {"smallest first", TransferScheduler::POLICY_SMALLEST_FIRST, false, 0},
+        {"shortest remaining", TransferScheduler::POLICY_SHORTEST_REMAINING, false, 0},
+        {"priority, app:sync 1:3", TransferScheduler::POLICY_PRIORITY, false, 3},
+        {"priority, adaptive slots", TransferScheduler::POLICY_PRIORITY, true, 0},
+        {"smallest first, adaptive slots", TransferScheduler::POLICY_SMALLEST_FIRST, true, 0},
+    };
+
+    const std::pair<const char*, Link> links[] = {
+        {"fast link (50 MB/s, 8 MB/s per transfer)", {50.0 * MB, 8.0 * MB, 0.5}},
+        {"slow link (4 MB/s, 2 MB/s per transfer)", {4.0 * MB, 2.0 * MB, 0.5}},
+    };
+
+    for (auto& [description, link]: links)
+    {
+        std::cout << "4 x 1 GB then 2000 small files, " << description << std::endl;
+
+        for (auto& setting: settings)
+        {
+            TransferScheduler scheduler(MAX_SLOTS);
+
+            scheduler.setPolicy(setting.policy);
+            scheduler.setAdaptiveSlots(setting.adaptiveSlots);
+
+            if (setting.syncWeight)
+            {
+                scheduler.setWeight(TransferScheduler::FLOW_APP, 1);
+                scheduler.setWeight(TransferScheduler::FLOW_SYNC, setting.syncWeight);
+            }
+
+            auto report = simulate(scheduler, mixedWorkload(), link);
+
+            std::cout << std::fixed << std::setprecision(1) << "  " << std::left << std::setw(32)
+                      << setting.name << std::right << report.throughput / MB << " MB/s, median "
+                      << report.medianCompletion << "s, p99 " << report.tailCompletion
+                      << "s, slots " << report.slotLimit << std::endl;
+        }
+    }
+}
@@ -16,12 +16,20 @@
  * program.
  */
 
+#include "mega/db/sqlite.h"
 #include "mega/megaapp.h"
+#include "mega/megaclient.h"
 #include "mega/raid.h"
 #include "mega/transfer.h"
 #include "utils.h"
 
 #include <gtest/gtest.h>
+#include <stdfs.h>
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <thread>
 
 namespace
 {
@@ -64,6 +72,61 @@ void setupTransfer(mega::Transfer& tf,
               transferkeyChar);
     tf.lastaccesstime = lastaccesstime;
 }
+
+// Records what is resumed from the transfer cache, without resuming anything.
+struct ResumeApp: mega::MegaApp
+{
+    std::vector<uint32_t> resumed;
+    std::chrono::steady_clock::time_point firstResumed;
+
+    void file_resume(std::string*, mega::direction_t*, uint32_t dbid, FileResumeData&) override
+    {
+        if (resumed.empty())
+            firstResumed = std::chrono::steady_clock::now();
+
+        resumed.emplace_back(dbid);
+    }
+};
+
+// Stands in for the files of the transfers, which are serialized by the app.
+struct CachedFile: mega::Cacheable
+{
+    std::string data = std::string(200, 'F');
+
+    bool serialize(std::string* d) const override
+    {
+        d->append(data);
+        return true;
+    }
+};
+
+// Fills the transfer cache of a client that isn't logged in, as the previous
+// run of the app would have left it.
+void fillTransferCache(mega::MegaApp& app, const mega::LocalPath& folder, size_t count)
+{
+    auto client = mt::makeClient(app, new mega::SqliteDbAccess(folder));
+
+    client->enabletransferresumption();
+    ASSERT_TRUE(client->tctable);
+
+    mega::TransferDbCommitter committer(client->tctable);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        mega::Transfer tf{client.get(), mega::GET};
+        setupTransfer(tf, "file" + std::to_string(i), 'X', 1, 2, 'Y', 3);
+        tf.size = static_cast<m_off_t>(i + 1);
+        tf.mtime = 1;
+        tf.isvalid = true;
+        tf.priority = mega::TransferList::PRIORITY_START + i * mega::TransferList::PRIORITY_STEP;
+        tf.tempurls = {"http://gfs262n309.userstorage.mega.co.nz/dl/" + std::to_string(i)};
+
+        client->transfercacheadd(&tf, &committer);
+
+        CachedFile file;
+        client->tctable->put(mega::MegaClient::CACHEDFILE, &file, &client->tckey);
+    }
+}
 }
 
 TEST(Transfer, serialize_unserialize_raid_urls_same_length)
@@ -263,3 +326,91 @@ TEST(Transfer, serialize_unserialize_extreme_length_variation)
     ASSERT_NE(newTf, nullptr);
     checkTransfers(tf, *newTf);
 }
+
+TEST(Transfer, resumeFromCacheInRounds)
+{
+    auto path = std::filesystem::current_path() / "transfer_cache";
+    const mega::MrProper cleanUp(
+        [path]()
+        {
+            std::filesystem::remove_all(path);
+        });
+
+    std::filesystem::create_directory(path);
+    auto folder = mega::LocalPath::fromAbsolutePath(path_u8string(path));
+
+    // more files than are resumed in a round, and records for several chunks
+    const size_t count = mega::MegaClient::RESUMED_FILES_PER_ROUND * 2 + 10;
+
+    mega::MegaApp fillApp;
+    ASSERT_NO_FATAL_FAILURE(fillTransferCache(fillApp, folder, count));
+
+    ResumeApp app;
+    auto client = mt::makeClient(app, new mega::SqliteDbAccess(folder), 2);
+
+    client->enabletransferresumption();
+
+    // every transfer is decrypted, in the order they were cached
+    ASSERT_EQ(client->multi_cachedtransfers[mega::GET].size(), count);
+    EXPECT_EQ(client->transferlist.currentpriority,
+              mega::TransferList::PRIORITY_START + (count - 1) * mega::TransferList::PRIORITY_STEP);
+
+    // but the files are resumed a round at a time
+    EXPECT_EQ(app.resumed.size(), mega::MegaClient::RESUMED_FILES_PER_ROUND);
+    EXPECT_TRUE(client->resumingTransfers());
+    EXPECT_TRUE(std::is_sorted(app.resumed.begin(), app.resumed.end()));
+
+    while (client->resumingTransfers())
+        client->resumeTransferFromDB();
+
+    EXPECT_EQ(app.resumed.size(), count);
+    EXPECT_TRUE(std::is_sorted(app.resumed.begin(), app.resumed.end()));
+
+    // the cached transfers no file was resumed for are purged at the end
+    EXPECT_TRUE(client->multi_cachedtransfers[mega::GET].empty());
+}
+
+// Time from enabling transfer resumption to the first file being resumed,
+// decrypting the transfer cache on the SDK thread only and on worker threads.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST(Transfer, DISABLED_benchmarkResumeFromCache)
+{
+    static constexpr size_t COUNT = 200000;
+
+    auto path = std::filesystem::current_path() / "transfer_cache";
+    const mega::MrProper cleanUp(
+        [path]()
+        {
+            std::filesystem::remove_all(path);
+        });
+
+    for (unsigned threads: {0u, std::thread::hardware_concurrency()})
+    {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directory(path);
+        auto folder = mega::LocalPath::fromAbsolutePath(path_u8string(path));
+
+        mega::MegaApp fillApp;
+        ASSERT_NO_FATAL_FAILURE(fillTransferCache(fillApp, folder, COUNT));
+
+        ResumeApp app;
+        auto client = mt::makeClient(app, new mega::SqliteDbAccess(folder), threads);
+
+        auto started = std::chrono::steady_clock::now();
+        client->enabletransferresumption();
+        auto loaded = std::chrono::steady_clock::now();
+
+        ASSERT_EQ(client->multi_cachedtransfers[mega::GET].size(), COUNT);
+        ASSERT_FALSE(app.resumed.empty());
+
+        auto ms = [](auto elapsed)
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+        };
+
+        std::cout << COUNT << " transfers, " << threads << " worker threads: first file resumed after "
+                  << ms(app.firstResumed - started) << "ms, transfers loaded after "
+                  << ms(loaded - started) << "ms" << std::endl;
+    }
+}
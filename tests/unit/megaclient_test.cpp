@@ -5,6 +5,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <filesystem>
 
 using namespace mega;
@@ -74,4 +75,105 @@ TEST_F(MegaClientTest, isValidLocalSyncRoot_NotAFolder)
     EXPECT_EQ(sWarn, NO_SYNC_WARNING);
 }
 
-} // namespace
\ No newline at end of file
+// Records the outcome of each putnodes.
+class PutnodesApp: public MegaApp
+{
+public:
+    void putnodes_result(const Error& e,
+                         targettype_t,
+                         vector<NewNode>& nn,
+                         bool,
+                         int tag,
+                         const std::map<std::string, std::string>&) override
+    {
+        results.emplace_back(tag, e);
+        nodes.emplace_back(nn.size());
+    }
+
+    std::vector<std::pair<int, error>> results;
+    std::vector<size_t> nodes;
+};
+
+NewNode makeUploadNode()
+{
+    NewNode node;
+
+    node.source = NEW_UPLOAD;
+    node.type = FILENODE;
+    node.nodekey.assign(FILENODEKEYLENGTH, 'k');
+    node.attrstring.reset(new std::string("attributes"));
+    std::fill(node.uploadtoken.begin(), node.uploadtoken.end(), 't');
+
+    return node;
+}
+
+size_t occurrences(const std::string& haystack, const std::string& needle)
+{
+    size_t count = 0;
+
+    for (auto i = haystack.find(needle); i != std::string::npos; i = haystack.find(needle, i + 1))
+        ++count;
+
+    return count;
+}
+
+TEST(MegaClientBatchedPutnodes, smallUploadsToTheSameFolderShareACommand)
+{
+    PutnodesApp app;
+    auto client = mt::makeClient(app);
+
+    byte key[SymmCipher::KEYLENGTH] = {1};
+    client->key.setkey(key);
+
+    NodeHandle folder = NodeHandle().set6byte(0x1234);
+    NodeHandle other = NodeHandle().set6byte(0x5678);
+
+    for (int tag = 1; tag <= 3; ++tag)
+    {
+        client->putnodesOfSmallUpload(folder,
+                                      NoVersioning,
+                                      makeUploadNode(),
+                                      tag,
+                                      PUTNODES_APP,
+                                      nullptr,
+                                      false,
+                                      std::nullopt);
+    }
+
+    client->putnodesOfSmallUpload(other,
+                                  NoVersioning,
+                                  makeUploadNode(),
+                                  4,
+                                  PUTNODES_APP,
+                                  nullptr,
+                                  false,
+                                  std::nullopt);
+
+    // Nothing goes out until the batches are sent.
+    EXPECT_FALSE(client->reqs.readyToSend());
+
+    client->sendBatchedPutnodes();
+    ASSERT_TRUE(client->reqs.readyToSend());
+
+    bool fetchingNodes = false;
+    std::string idempotenceId;
+    auto request = client->reqs.serverrequest(fetchingNodes, client.get(), idempotenceId);
+
+    EXPECT_EQ(occurrences(request, R"("a":"p")"), 2u);
+    EXPECT_EQ(occurrences(request, R"("t":0)"), 4u);
+
+    // A failed command fails every upload in it, each reported with its own tag.
+    client->reqs.serverresponse("[-9,-11]", client.get());
+
+    ASSERT_EQ(app.results.size(), 4u);
+
+    std::sort(app.results.begin(), app.results.end());
+
+    for (int tag = 1; tag <= 3; ++tag)
+        EXPECT_EQ(app.results[static_cast<size_t>(tag - 1)], std::make_pair(tag, API_ENOENT));
+
+    EXPECT_EQ(app.results[3], std::make_pair(4, API_EACCESS));
+    EXPECT_EQ(app.nodes, std::vector<size_t>(4, 1u));
+}
+
+} // namespace
@@ -44,7 +44,9 @@ mega::handle nextFsId()
     return fsId++;
 }
 
-std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app, mega::DbAccess* dbAccess)
+std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app,
+                                             mega::DbAccess* dbAccess,
+                                             unsigned workerThreadCount)
 {
     struct HttpIo : mega::HttpIO
     {
@@ -68,7 +70,7 @@ std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app, mega::DbAccess*
     auto waiter = std::make_shared<WAIT_CLASS>();
 
     std::shared_ptr<mega::MegaClient> client{
-        new mega::MegaClient{&app, waiter, httpio, dbAccess, nullptr, "unit_test", 0},
+        new mega::MegaClient{&app, waiter, httpio, dbAccess, nullptr, "unit_test", workerThreadCount},
         deleter};
 
     return client;
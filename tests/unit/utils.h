@@ -31,7 +31,9 @@ class FsNode;
 
 mega::handle nextFsId();
 
-std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app, mega::DbAccess* dbAccess  = nullptr);
+std::shared_ptr<mega::MegaClient> makeClient(mega::MegaApp& app,
+                                             mega::DbAccess* dbAccess = nullptr,
+                                             unsigned workerThreadCount = 0);
 
 mega::Node& makeNode(mega::MegaClient& client, mega::nodetype_t type, mega::NodeHandle handle, mega::Node* parent = nullptr);
 
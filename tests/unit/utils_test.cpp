@@ -30,6 +30,8 @@
 #include <mega/utils.h>
 
 #include <algorithm>
+#include <chrono>
+#include <iostream>
 #include <vector>
 
 TEST(utils, readLines)
@@ -435,6 +437,124 @@ TEST_F(ComparatorTest, CompareLocalPathAgainstString)
     }
 }
 
+TEST_F(ComparatorTest, CollationKeysOrderAsCompareUtf)
+{
+    const vector<string> names = {"",
+                                  "a",
+                                  "A",
+                                  "abc",
+                                  "ABD",
+                                  "ab",
+                                  "a b",
+                                  "Zebra",
+                                  "zebra",
+                                  "caf\xc3\xa9",
+                                  "CAF\xc3\x89",
+                                  "stra\xc3\x9f" "e",
+                                  "\xce\xa3\xce\xb9",
+                                  "\xcf\x83\xce\xb9",
+                                  "\xf0\x9f\x98\x80",
+                                  "a%41",
+                                  "aA",
+                                  "a%2f",
+                                  "a/",
+                                  "%zz",
+                                  "100%"};
+
+    auto sign = [](int value)
+    {
+        return (value > 0) - (value < 0);
+    };
+
+    for (auto caseInsensitive: {false, true})
+    {
+        for (auto& lhs: names)
+        {
+            for (auto& rhs: names)
+            {
+                for (auto unescaping: {0, 1, 2, 3})
+                {
+                    auto lhsUnescaping = (unescaping & 1) != 0;
+                    auto rhsUnescaping = (unescaping & 2) != 0;
+
+                    UtfCollationKey lhsKey(lhs, lhsUnescaping, caseInsensitive);
+                    UtfCollationKey rhsKey(rhs, rhsUnescaping, caseInsensitive);
+
+                    ASSERT_EQ(sign(lhsKey.compare(rhsKey)),
+                              sign(compareUtf(lhs, lhsUnescaping, rhs, rhsUnescaping, caseInsensitive)))
+                        << lhs << " " << rhs << " " << caseInsensitive << " " << unescaping;
+                }
+            }
+        }
+    }
+
+    // only names with escapes to decode can't be ordered by key
+    EXPECT_TRUE(UtfCollationKey("caf\xc3\xa9", true, true).keyed());
+    EXPECT_TRUE(UtfCollationKey("a%41", false, true).keyed());
+    EXPECT_FALSE(UtfCollationKey("a%41", true, true).keyed());
+}
+
+// Sorts the names in folders of several sizes as computeSyncTriplets does,
+// comparing them with compareUtf and through collation keys.
+//
+// Run with --gtest_also_run_disabled_tests.
+TEST_F(ComparatorTest, DISABLED_benchmarkCollationKeys)
+{
+    for (size_t count: {10000u, 100000u, 1000000u})
+    {
+        vector<string> names;
+        names.reserve(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            // mostly ASCII, with some accented names
+            names.emplace_back((i % 10 ? "IMG_" : "F\xc3\xb6to_") + std::to_string(i * 7919 % count) +
+                               ".jpg");
+        }
+
+        auto time = [](auto&& f)
+        {
+            auto started = std::chrono::steady_clock::now();
+            f();
+            auto elapsed = std::chrono::steady_clock::now() - started;
+            return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+        };
+
+        auto byCompareUtf = names;
+        auto compareUtfTime = time([&byCompareUtf]()
+        {
+            std::sort(byCompareUtf.begin(), byCompareUtf.end(), [](const string& lhs, const string& rhs)
+            {
+                return compareUtf(lhs, true, rhs, true, true) < 0;
+            });
+        });
+
+        vector<string> byKey;
+        auto keyTime = time([&names, &byKey]()
+        {
+            vector<UtfCollationKey> keys;
+            keys.reserve(names.size());
+
+            for (auto& name: names)
+                keys.emplace_back(name, true, true);
+
+            std::sort(keys.begin(), keys.end(), [](const UtfCollationKey& lhs, const UtfCollationKey& rhs)
+            {
+                return lhs.compare(rhs) < 0;
+            });
+
+            byKey.reserve(keys.size());
+            for (auto& key: keys)
+                byKey.emplace_back(key.name());
+        });
+
+        EXPECT_EQ(byKey, byCompareUtf);
+
+        std::cout << count << " names: compareUtf " << compareUtfTime << "ms, collation keys "
+                  << keyTime << "ms" << std::endl;
+    }
+}
+
 TEST(Conversion, HexVal)
 {
     // Decimal [0-9]
@@ -1989,3 +2109,27 @@ TEST(DNS, cache_resolved_urls_succeeds)
     // Make sure the bad URI wasn't added to the cache.
     EXPECT_EQ(expected, io.getCachedDNSEntries());
 }
+
+TEST(TLS, serialize_sessions_round_trip)
+{
+    std::vector<TlsSession> sessions = {{"a.com:443", "hmac-a", "ticket-a", 2000},
+                                        {"", "hmac-b", std::string("\0ticket\0b", 9), 3000},
+                                        {"c.com:443", "hmac-c", "ticket-c", 500}};
+
+    std::string data;
+    serializeTlsSessions(sessions, data);
+
+    // Sessions that expired are dropped.
+    std::vector<TlsSession> restored;
+    ASSERT_TRUE(unserializeTlsSessions(data, 1000, restored));
+    ASSERT_EQ(restored.size(), 2u);
+    EXPECT_EQ(restored[0], sessions[0]);
+    EXPECT_EQ(restored[1], sessions[1]);
+
+    // Truncated blobs are rejected.
+    data.resize(data.size() - 1);
+    EXPECT_FALSE(unserializeTlsSessions(data, 1000, restored));
+
+    // So are unknown versions.
+    EXPECT_FALSE(unserializeTlsSessions(std::string(1, '\x02'), 1000, restored));
+}
@@ -7,10 +7,13 @@
 #include "mega/gfx/worker/command_serializer.h"
 #include "mega/gfx/worker/commands.h"
 #include "mega/gfx/worker/comms.h"
+#include "mega/gfx/worker/shared_memory.h"
 #include "mega/logging.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <iterator>
 #include <numeric>
 
@@ -53,7 +56,9 @@ GfxTaskResult GfxProcessor::process(const GfxTask& task)
 
     // generate thumbnails
     LOG_info << "generate for, " << path;
-    auto images = mGfxProvider->generateImages(path, sortedDimensions);
+    auto provider = leaseProvider();
+    auto images = provider->generateImages(path, sortedDimensions);
+    returnProvider(std::move(provider));
 
     // assign back to original order
     for (decltype(images)::size_type i = 0; i < images.size(); ++i)
@@ -64,6 +69,27 @@ GfxTaskResult GfxProcessor::process(const GfxTask& task)
     return GfxTaskResult(std::move(outputImages), GfxTaskProcessStatus::SUCCESS);
 }
 
+std::unique_ptr<IGfxProvider> GfxProcessor::leaseProvider()
+{
+    {
+        std::lock_guard<std::mutex> g(mProvidersMutex);
+        if (!mProviders.empty())
+        {
+            auto provider = std::move(mProviders.back());
+            mProviders.pop_back();
+            return provider;
+        }
+    }
+
+    return std::make_unique<GfxProviderFreeImage>();
+}
+
+void GfxProcessor::returnProvider(std::unique_ptr<IGfxProvider> provider)
+{
+    std::lock_guard<std::mutex> g(mProvidersMutex);
+    mProviders.emplace_back(std::move(provider));
+}
+
 //
 // Put more probmatic format (likely crash) by freeimage here in extraFormatsByWorker
 // note order by length of ext. If we has this order: .tiff.tif, the match with .tif fails
@@ -86,6 +112,7 @@ RequestProcessor::RequestProcessor(size_t threadCount,
                                    size_t maxQueueSize)
                                    : mGfxProcessor()
                                    , mThreadPool(threadCount, maxQueueSize)
+                                   , mBatchPool(threadCount, CommandNewGfxBatch::MAX_TASKS)
 {
 }
 
@@ -133,6 +160,11 @@ bool RequestProcessor::process(std::unique_ptr<IEndpoint> endpoint)
                 processGfx(sharedEndpoint.get(), dynamic_cast<CommandNewGfx*>(command.get()));
                 break;
             }
+            case CommandType::NEW_GFX_BATCH:
+            {
+                processGfxBatch(sharedEndpoint.get(), dynamic_cast<CommandNewGfxBatch*>(command.get()));
+                break;
+            }
             case CommandType::SUPPORT_FORMATS:
             {
                 processSupportFormats(sharedEndpoint.get());
@@ -180,6 +212,101 @@ void RequestProcessor::processGfx(IEndpoint* endpoint, CommandNewGfx* request)
     writer.writeCommand(&response, WRITE_TIMEOUT);
 }
 
+void RequestProcessor::processGfxBatch(IEndpoint* endpoint, CommandNewGfxBatch* request)
+{
+    assert(endpoint);
+    assert(request);
+
+    LOG_info << "gfx batch processing, " << request->Tasks.size() << " tasks";
+
+    // State shared with the threads of mBatchPool, which may outlive this call
+    // if they were queued but never claimed a task
+    struct Batch
+    {
+        std::vector<GfxTask> tasks;
+        std::vector<GfxBatchResult> results;
+        std::unique_ptr<SharedMemory> sharedMemory;
+        std::atomic<size_t> sharedOffset{0};
+        std::atomic<size_t> next{0};
+        size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    auto batch = std::make_shared<Batch>();
+    batch->tasks = std::move(request->Tasks);
+    batch->results.resize(batch->tasks.size());
+
+    if (!request->SharedMemoryName.empty())
+    {
+        batch->sharedMemory = SharedMemory::open(request->SharedMemoryName, request->SharedMemorySize);
+        if (!batch->sharedMemory)
+        {
+            LOG_warn << "gfx batch couldn't open shared memory, images are sent inline";
+        }
+    }
+
+    // Claim tasks until none is left
+    auto work = [this](Batch& batch)
+    {
+        for (size_t i; (i = batch.next++) < batch.tasks.size(); )
+        {
+            auto result = mGfxProcessor.process(batch.tasks[i]);
+
+            auto& batchResult = batch.results[i];
+            batchResult.ProcessStatus = result.ProcessStatus;
+
+            for (auto& image : result.OutputImages)
+            {
+                GfxBatchImage batchImage;
+
+                // Images that don't fit in the shared memory go inline
+                auto shared = batch.sharedMemory && !image.empty();
+                auto offset = shared ? batch.sharedOffset.fetch_add(image.size()) : 0;
+                if (shared && offset + image.size() <= batch.sharedMemory->size())
+                {
+                    std::copy(image.begin(), image.end(), batch.sharedMemory->data() + offset);
+                    batchImage.Offset = static_cast<uint32_t>(offset);
+                    batchImage.Length = static_cast<uint32_t>(image.size());
+                }
+                else
+                {
+                    batchImage.Data = std::move(image);
+                }
+
+                batchResult.Images.emplace_back(std::move(batchImage));
+            }
+
+            {
+                std::lock_guard<std::mutex> g(batch.mutex);
+                ++batch.done;
+            }
+            batch.cv.notify_one();
+        }
+    };
+
+    // Helpers beyond what the pool can take are simply not queued
+    for (size_t i = 1; i < batch->tasks.size(); ++i)
+    {
+        if (!mBatchPool.push([batch, work]() { work(*batch); })) break;
+    }
+
+    work(*batch);
+
+    {
+        std::unique_lock<std::mutex> g(batch->mutex);
+        batch->cv.wait(g, [&batch]() { return batch->done == batch->tasks.size(); });
+    }
+
+    CommandNewGfxBatchResponse response;
+    response.Results = std::move(batch->results);
+
+    LOG_info << "gfx batch result, " << response.Results.size() << " tasks";
+
+    ProtocolWriter writer{ endpoint };
+    writer.writeCommand(&response, WRITE_TIMEOUT);
+}
+
 void RequestProcessor::processSupportFormats(IEndpoint* endpoint)
 {
     assert(endpoint);
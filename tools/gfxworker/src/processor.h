@@ -8,6 +8,8 @@
 
 #include <chrono>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace mega {
 namespace gfx {
@@ -24,9 +26,19 @@ public:
     std::string supportedvideoformats() const;
 private:
 
+    // Providers keep the bitmap being processed, so each task leases its own
+    std::unique_ptr<::mega::IGfxProvider> leaseProvider();
+
+    void returnProvider(std::unique_ptr<::mega::IGfxProvider> provider);
+
     mega::FSACCESS_CLASS mFaccess;
 
     std::unique_ptr<::mega::IGfxProvider> mGfxProvider;
+
+    // Idle providers, created on demand and kept for the next tasks
+    std::mutex mProvidersMutex;
+
+    std::vector<std::unique_ptr<::mega::IGfxProvider>> mProviders;
 };
 
 class RequestProcessor
@@ -45,12 +57,18 @@ private:
 
     void processGfx(IEndpoint* endpoint, CommandNewGfx* request);
 
+    void processGfxBatch(IEndpoint* endpoint, CommandNewGfxBatch* request);
+
     void processSupportFormats(IEndpoint* endpoint);
 
     GfxProcessor mGfxProcessor;
 
     ThreadPool mThreadPool;
 
+    // Processes the tasks of batches alongside the thread handling the request,
+    // which takes over any task these threads haven't started
+    ThreadPool mBatchPool;
+
     static constexpr std::chrono::milliseconds READ_TIMEOUT{5000};
 
     static constexpr std::chrono::milliseconds WRITE_TIMEOUT{5000};
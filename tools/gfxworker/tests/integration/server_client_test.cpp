@@ -11,6 +11,7 @@
 
 #include <chrono>
 #include <cstdlib>
+#include <iostream>
 #include <memory>
 #include <system_error>
 #include <thread>
@@ -20,6 +21,9 @@ using mega::gfx::Server;
 using mega::gfx::RequestProcessor;
 using mega::gfx::GfxClient;
 using mega::gfx::GfxCommunicationsClient;
+using mega::gfx::GfxTask;
+using mega::gfx::GfxTaskProcessStatus;
+using mega::gfx::GfxTaskResult;
 using mega::GfxDimension;
 using mega::LocalPath;
 using mega::getCurrentPid;
@@ -96,6 +100,123 @@ TEST_F(ServerClientTest, RunGfxTaskSuccessfully)
     }
 }
 
+TEST_F(ServerClientTest, RunGfxBatchSuccessfully)
+{
+    Server server(
+        std::make_unique<RequestProcessor>(),
+        mEndpointName
+    );
+
+    std::thread serverThread(std::ref(server));
+
+    auto dimensions = std::vector<GfxDimension> {
+        { 200, 0 },     // THUMBNAIL: square thumbnail, cropped from near center
+        { 1000, 1000 }  // PREVIEW: scaled version inside 1000x1000 bounding square
+    };
+
+    std::string testImage{"logo.png"};
+    fs::path testImageLocalPath = fs::path{ExecutableDir::get()} / testImage;
+
+    ASSERT_TRUE(getFileFromArtifactory("test-data/" + testImage, testImageLocalPath));
+
+    // a missing file fails on its own
+    std::vector<GfxTask> tasks {
+        { testImageLocalPath.string(), dimensions },
+        { (fs::path{ExecutableDir::get()} / "missing.png").string(), dimensions },
+        { testImageLocalPath.string(), dimensions }
+    };
+
+    std::vector<GfxTaskResult> results;
+    EXPECT_TRUE(GfxClient(std::make_unique<GfxCommunicationsClient>(mEndpointName))
+                    .runGfxBatch(tasks, results));
+    ASSERT_EQ(results.size(), 3);
+    for (auto i : {0, 2})
+    {
+        EXPECT_EQ(results[i].ProcessStatus, GfxTaskProcessStatus::SUCCESS);
+        ASSERT_EQ(results[i].OutputImages.size(), 2);
+        EXPECT_GT(results[i].OutputImages[0].size(), 4500);
+        EXPECT_GT(results[i].OutputImages[1].size(), 650);
+    }
+    ASSERT_EQ(results[1].OutputImages.size(), 2);
+    EXPECT_TRUE(results[1].OutputImages[0].empty());
+    EXPECT_TRUE(results[1].OutputImages[1].empty());
+
+    // shutdown
+    EXPECT_TRUE(
+        GfxClient(
+            std::make_unique<GfxCommunicationsClient>(mEndpointName)
+        ).runShutDown()
+    );
+
+    if (serverThread.joinable())
+    {
+        serverThread.join();
+    }
+}
+
+// Compares generating the thumbnails and previews of 5000 images one request at a time
+// and in batches. Run with --gtest_also_run_disabled_tests.
+TEST_F(ServerClientTest, DISABLED_BenchmarkGfxBatchAgainstSingleTasks)
+{
+    static constexpr size_t NUM_IMAGES = 5000;
+    static constexpr size_t BATCH_SIZE = 32;
+
+    Server server(
+        std::make_unique<RequestProcessor>(),
+        mEndpointName
+    );
+
+    std::thread serverThread(std::ref(server));
+
+    auto dimensions = std::vector<GfxDimension> {
+        { 200, 0 },
+        { 1000, 1000 }
+    };
+
+    std::string testImage{"logo.png"};
+    fs::path testImageLocalPath = fs::path{ExecutableDir::get()} / testImage;
+
+    ASSERT_TRUE(getFileFromArtifactory("test-data/" + testImage, testImageLocalPath));
+
+    auto started = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_IMAGES; ++i)
+    {
+        std::vector<std::string> images;
+        ASSERT_TRUE(GfxClient(std::make_unique<GfxCommunicationsClient>(mEndpointName))
+                        .runGfxTask(testImageLocalPath.string(), dimensions, images));
+    }
+    auto single = std::chrono::steady_clock::now() - started;
+
+    started = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_IMAGES; i += BATCH_SIZE)
+    {
+        std::vector<GfxTask> tasks(std::min(BATCH_SIZE, NUM_IMAGES - i),
+                                   GfxTask{testImageLocalPath.string(), dimensions});
+        std::vector<GfxTaskResult> results;
+        ASSERT_TRUE(GfxClient(std::make_unique<GfxCommunicationsClient>(mEndpointName))
+                        .runGfxBatch(tasks, results));
+    }
+    auto batched = std::chrono::steady_clock::now() - started;
+
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+
+    std::cout << NUM_IMAGES << " images, single tasks: "
+              << duration_cast<milliseconds>(single).count() << "ms, batches of " << BATCH_SIZE
+              << ": " << duration_cast<milliseconds>(batched).count() << "ms" << std::endl;
+
+    EXPECT_TRUE(
+        GfxClient(
+            std::make_unique<GfxCommunicationsClient>(mEndpointName)
+        ).runShutDown()
+    );
+
+    if (serverThread.joinable())
+    {
+        serverThread.join();
+    }
+}
+
 TEST_F(ServerClientTest, RunHelloRequestResponseSuccessfully)
 {
     Server server(